@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::DeferredDestructionDomain class
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <atomic>
+
+#include "../../Primitives/interface/Object.h"
+
+namespace Diligent
+{
+
+class RefCountersImpl;
+
+/// Deferred destruction domain.
+
+/// By default, when the last strong reference to a reference-counted object is released,
+/// the object is destroyed immediately by the releasing thread. Objects attached to a
+/// destruction domain are instead enqueued when their strong reference counter reaches zero,
+/// and are destroyed in batches when DestroyPendingObjects() is called. This allows moving
+/// the cost of tearing down large object graphs off performance-critical threads, e.g.
+/// to a worker thread, or spreading it across several frames.
+///
+/// \remarks    Once the strong reference counter reaches zero, weak pointers will not be able to
+///             obtain a strong reference to the object, same as if it was destroyed immediately.
+///
+///             DestroyPendingObjects() may be called from multiple threads simultaneously.
+///             Objects that are destroyed by DestroyPendingObjects() may in turn release
+///             the last references to other objects attached to the same domain. These objects
+///             will be added to the end of the queue.
+///
+///             The domain must outlive all objects attached to it.
+class DeferredDestructionDomain
+{
+public:
+    DeferredDestructionDomain() noexcept {}
+
+    /// Destroys all pending objects.
+    ~DeferredDestructionDomain();
+
+    // clang-format off
+    DeferredDestructionDomain           (const DeferredDestructionDomain&) = delete;
+    DeferredDestructionDomain           (DeferredDestructionDomain&&)      = delete;
+    DeferredDestructionDomain& operator=(const DeferredDestructionDomain&) = delete;
+    DeferredDestructionDomain& operator=(DeferredDestructionDomain&&)      = delete;
+    // clang-format on
+
+    /// Attaches the object to the domain.
+
+    /// \param [in] pObject - Object to attach. The object must be created by MakeNewRCObj.
+    ///
+    /// \remarks    If the object shares reference counters with its owner (see MakeNewRCObj),
+    ///             the owner is attached to the domain instead.
+    ///             The object can only be attached to one domain.
+    void Attach(IObject* pObject);
+
+    /// Destroys pending objects.
+
+    /// \param [in] MaxObjects - The maximum number of objects to destroy.
+    ///                          This parameter can be used to limit the time spent on
+    ///                          object destruction, e.g. every frame.
+    ///
+    /// \return     The number of destroyed objects.
+    size_t DestroyPendingObjects(size_t MaxObjects = ~size_t{0});
+
+    /// Returns the number of objects that are waiting to be destroyed.
+    size_t GetNumPendingObjects() const;
+
+    /// Returns the number of attached objects that have not been destroyed yet,
+    /// including pending objects.
+    size_t GetNumAttachedObjects() const
+    {
+        return m_NumAttachedObjects.load();
+    }
+
+private:
+    friend class RefCountersImpl;
+    void Enqueue(RefCountersImpl* pRefCounters);
+
+    mutable std::mutex           m_PendingObjectsMtx;
+    std::deque<RefCountersImpl*> m_PendingObjects;
+
+    // Buffers that DestroyPendingObjects() moves pending objects to
+    std::vector<std::vector<RefCountersImpl*>> m_SpareBuffers;
+
+    std::atomic<size_t> m_NumAttachedObjects{0};
+};
+
+} // namespace Diligent
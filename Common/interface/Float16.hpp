@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Half-precision floating point conversion functions
+
+#include <cstring>
+
+#include "../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Half-precision (16-bit) floating point value
+class Float16
+{
+public:
+    Float16() noexcept {}
+
+    explicit Float16(float f) noexcept :
+        m_Bits{FloatToHalfBits(f)}
+    {}
+
+    static Float16 FromBits(Uint16 Bits) noexcept
+    {
+        Float16 h;
+        h.m_Bits = Bits;
+        return h;
+    }
+
+    operator float() const noexcept
+    {
+        return HalfBitsToFloat(m_Bits);
+    }
+
+    Uint16 GetBits() const noexcept
+    {
+        return m_Bits;
+    }
+
+    /// Converts 32-bit float to half-precision float bits using round-to-nearest-even.
+    /// Values that are too large to be represented are converted to infinity,
+    /// NaNs are converted to quiet NaNs.
+    static Uint16 FloatToHalfBits(float f) noexcept
+    {
+        // https://gist.github.com/rygorous/2156668
+        static constexpr Uint32 F32Infinity = 255u << 23u;
+        static constexpr Uint32 F16Max      = (127u + 16u) << 23u;
+        static constexpr Uint32 DenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23u;
+
+        Uint32 u = 0;
+        std::memcpy(&u, &f, sizeof(u));
+
+        const Uint32 Sign = u & 0x80000000u;
+        u ^= Sign;
+
+        Uint32 Bits = 0;
+        if (u >= F16Max)
+        {
+            // Inf or NaN (all exponent bits set). NaN->qNaN and Inf->Inf
+            Bits = u > F32Infinity ? 0x7E00u : 0x7C00u;
+        }
+        else if (u < (113u << 23u))
+        {
+            // The resulting half is subnormal or zero.
+            // Use a magic value to align 10 mantissa bits at the bottom of the float.
+            // As long as FP addition is round-to-nearest-even, this just works.
+            float fAbs = 0, fMagic = 0;
+            std::memcpy(&fAbs, &u, sizeof(fAbs));
+            std::memcpy(&fMagic, &DenormMagic, sizeof(fMagic));
+            fAbs += fMagic;
+            std::memcpy(&u, &fAbs, sizeof(u));
+            Bits = u - DenormMagic;
+        }
+        else
+        {
+            const Uint32 MantissaOdd = (u >> 13u) & 1u;
+            // Update exponent, rounding bias part 1
+            u += ((15u - 127u) << 23u) + 0xFFFu;
+            // Rounding bias part 2
+            u += MantissaOdd;
+            Bits = u >> 13u;
+        }
+
+        return static_cast<Uint16>(Bits | (Sign >> 16u));
+    }
+
+    /// Converts half-precision float bits to 32-bit float.
+    static float HalfBitsToFloat(Uint16 Bits) noexcept
+    {
+        static constexpr Uint32 ShiftedExp = 0x7C00u << 13u;
+        static constexpr Uint32 Magic      = 113u << 23u;
+
+        Uint32 u = (Bits & 0x7FFFu) << 13u; // Exponent/mantissa bits
+
+        const Uint32 Exp = ShiftedExp & u;
+        u += (127u - 15u) << 23u; // Exponent adjust
+
+        float f = 0;
+        if (Exp == ShiftedExp)
+        {
+            // Inf/NaN: extra exponent adjust
+            u += (128u - 16u) << 23u;
+            std::memcpy(&f, &u, sizeof(f));
+        }
+        else if (Exp == 0)
+        {
+            // Zero/Denormal: extra exponent adjust and renormalize
+            u += 1u << 23u;
+            float fMagic = 0;
+            std::memcpy(&f, &u, sizeof(f));
+            std::memcpy(&fMagic, &Magic, sizeof(fMagic));
+            f -= fMagic;
+        }
+        else
+        {
+            std::memcpy(&f, &u, sizeof(f));
+        }
+
+        if (Bits & 0x8000u)
+            f = -f;
+
+        return f;
+    }
+
+private:
+    Uint16 m_Bits = 0;
+};
+
+} // namespace Diligent
@@ -56,6 +56,9 @@ private:
 
 // Spinlock implementation. This kind of lock should be used in scenarios
 // where simultaneous access is uncommon but possible.
+// The uncontended path is a single compare-exchange. When the lock is contended,
+// the thread backs off exponentially, then yields its time slice and finally
+// parks (sleeps for a short period of time) until the lock is released.
 class LockHelper
 {
 public:
@@ -102,36 +105,20 @@ public:
             return false;
     }
 
+    // The number of spin iterations after which the thread yields its time slice
     static constexpr const int DefaultSpinCountToYield = 256;
 
     static void UnsafeLock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
-        int SpinCount = 0;
-        while (!UnsafeTryLock(LockFlag))
-        {
-            ++SpinCount;
-            if (SpinCount == SpinCountToYield)
-            {
-                SpinCount = 0;
-                YieldThread();
-            }
-        }
+        if (!UnsafeTryLock(LockFlag))
+            WaitForLock(LockFlag, SpinCountToYield);
     }
 
     void Lock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
         VERIFY(m_pLockFlag == NULL, "Object already locked");
-        // Wait for the flag to become unlocked and lock it
-        int SpinCount = 0;
-        while (!TryLock(LockFlag))
-        {
-            ++SpinCount;
-            if (SpinCount == SpinCountToYield)
-            {
-                SpinCount = 0;
-                YieldThread();
-            }
-        }
+        UnsafeLock(LockFlag, SpinCountToYield);
+        m_pLockFlag = &LockFlag;
     }
 
     static void UnsafeUnlock(LockFlag& LockFlag) noexcept
@@ -146,7 +133,33 @@ public:
         m_pLockFlag = NULL;
     }
 
+    /// Lock contention statistics accumulated by all threads
+    struct ContentionStats
+    {
+        /// The number of times a lock could not be acquired on the first attempt
+        Atomics::Int64 NumContendedLocks = 0;
+
+        /// The total number of backoff spin iterations
+        Atomics::Int64 NumSpins = 0;
+
+        /// The number of times a waiting thread yielded its time slice
+        Atomics::Int64 NumYields = 0;
+
+        /// The number of times a waiting thread was parked
+        Atomics::Int64 NumParks = 0;
+    };
+
+    /// Returns the lock contention statistics collected since the start of the application
+    /// or since the last call to ResetContentionStats().
+    static ContentionStats GetContentionStats() noexcept;
+
+    /// Resets the lock contention statistics.
+    static void ResetContentionStats() noexcept;
+
 private:
+    // Slow path: waits for the flag to become unlocked and locks it
+    static void WaitForLock(LockFlag& LockFlag, int SpinCountToYield) noexcept;
+
     static void YieldThread() noexcept;
 
     LockFlag* m_pLockFlag = nullptr;
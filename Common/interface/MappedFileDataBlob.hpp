@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Implementation of the IDataBlob interface over a memory-mapped file
+
+#include <memory>
+#include "../../Primitives/interface/DataBlob.h"
+#include "../../Primitives/interface/FileStream.h"
+#include "../../Platforms/interface/FileSystem.hpp"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Read-only data blob that references the contents of a memory-mapped file.
+
+/// On platforms that do not support memory-mapped files, the contents of the file
+/// are read into memory. The blob cannot be resized, and the memory returned by
+/// GetDataPtr() must not be written to.
+class MappedFileDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    typedef ObjectBase<IDataBlob> TBase;
+
+    MappedFileDataBlob(IReferenceCounters* pRefCounters, std::unique_ptr<BasicMappedFile> pFile);
+
+    /// Maps the file and creates the blob. Returns null if the file can't be mapped.
+    static RefCntAutoPtr<MappedFileDataBlob> Create(const Char* Path, EFileAccessPattern AccessPattern = EFileAccessPattern::Default);
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override;
+
+    /// Mapped file blobs cannot be resized
+    virtual void DILIGENT_CALL_TYPE Resize(size_t NewSize) override;
+
+    /// Returns the size of the file
+    virtual size_t DILIGENT_CALL_TYPE GetSize() const override;
+
+    /// Returns the pointer to the file contents. The memory is read-only.
+    virtual void* DILIGENT_CALL_TYPE GetDataPtr() override;
+
+    /// Returns const pointer to the file contents
+    virtual const void* DILIGENT_CALL_TYPE GetConstDataPtr() const override;
+
+private:
+    std::unique_ptr<BasicMappedFile> m_pFile;
+};
+
+/// Creates a read-only file stream over the memory-mapped file.
+/// If the file can't be mapped, *ppStream is set to null.
+void CreateMappedFileStream(const Char*        Path,
+                            EFileAccessPattern AccessPattern,
+                            IFileStream**      ppStream);
+
+} // namespace Diligent
@@ -40,6 +40,8 @@
 namespace Diligent
 {
 
+class DeferredDestructionDomain;
+
 // This class controls the lifetime of a refcounted object
 class RefCountersImpl final : public IReferenceCounters
 {
@@ -156,50 +158,57 @@ public:
         if (m_ObjectState != ObjectState::Alive)
             return; // Early exit
 
-        // It is essential to INCREMENT REF COUNTER while HOLDING THE LOCK to make sure that
-        // StrongRefCnt > 1 guarantees that the object is alive.
-
-        // If other thread started deleting the object in ReleaseStrongRef(), then m_lNumStrongReferences==0
-        // We must make sure only one thread is allowed to increment the counter to guarantee that if StrongRefCnt > 1,
-        // there is at least one real strong reference left. Otherwise the following scenario may occur:
+        // Weak-to-strong upgrade is lock-free: the strong reference counter is
+        // incremented with compare-exchange ONLY IF IT IS NOT ZERO.
+        //
+        // Once m_lNumStrongReferences reaches zero, ReleaseStrongRef() starts destroying the
+        // object, and the counter must never be incremented again. Otherwise the following
+        // scenario may occur:
         //
         //                                      m_lNumStrongReferences == 1
         //
-        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()        |     Thread 3 - GetObject()
-        //                                     |                                   |
-        //  - Decrement m_lNumStrongReferences | -Increment m_lNumStrongReferences | -Increment m_lNumStrongReferences
-        //  - Read RefCount == 0               | -Read StrongRefCnt==1             | -Read StrongRefCnt==2
-        //    Destroy the object               |                                   | -Return reference to the soon
-        //                                     |                                   |  to expire object
+        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()
+        //                                     |
+        //  - Decrement m_lNumStrongReferences |
+        //  - Read RefCount == 0               | - Increment m_lNumStrongReferences
+        //    Destroy the object               | - Return reference to the soon
+        //                                     |   to expire object
         //
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-
-        auto StrongRefCnt = Atomics::AtomicIncrement(m_lNumStrongReferences);
-
-        // Checking if m_ObjectState == ObjectState::Alive only is not reliable:
+        // If compare-exchange succeeds, there was at least one real strong reference
+        // at that moment, and since we now hold our own reference, the object cannot be destroyed
+        // until we release it. If the counter is zero, the object is either being destroyed or
+        // has not been attached to a strong pointer yet, and no reference is returned:
+        //
+        //                                      m_lNumStrongReferences == 1
         //
-        //           This thread                    |          Another thread
-        //                                          |
-        //   1. Acquire the lock                    |
-        //                                          |    1. Decrement m_lNumStrongReferences
-        //   2. Increment m_lNumStrongReferences    |    2. Test RefCount==0
-        //   3. Read StrongRefCnt == 1              |    3. Start destroying the object
-        //      m_ObjectState == ObjectState::Alive |
-        //   4. DO NOT return the reference to      |    4. Wait for the lock, m_ObjectState == ObjectState::Alive
-        //      the object                          |
-        //   5. Decrement m_lNumStrongReferences    |
-        //                                          |    5. Destroy the object
-
-        if (m_ObjectState == ObjectState::Alive && StrongRefCnt > 1)
+        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()
+        //                                     |
+        //                                     | - Read StrongRefCnt == 1
+        //  - Decrement m_lNumStrongReferences |
+        //  - Read RefCount == 0               | - Try to exchange 1 -> 2, read 0
+        //    Destroy the object               | - DO NOT return the reference
+        //
+        Atomics::Long StrongRefCnt = m_lNumStrongReferences;
+        while (StrongRefCnt > 0)
         {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // QueryInterface() must not lock the object, or a deadlock happens.
-            // The only other two methods that lock the object are ReleaseStrongRef()
-            // and ReleaseWeakRef(), which are never called by QueryInterface()
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
-            pWrapper->QueryInterface(IID_Unknown, ppObject);
+            const auto PrevStrongRefCnt = Atomics::AtomicCompareExchange(m_lNumStrongReferences, StrongRefCnt + 1, StrongRefCnt);
+            if (PrevStrongRefCnt == StrongRefCnt)
+            {
+                VERIFY(m_ObjectState == ObjectState::Alive, "The object must be alive while there are strong references");
+                VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
+                // QueryInterface() must not lock the object, or a deadlock happens.
+                // The only other two methods that lock the object are ReleaseStrongRef()
+                // and ReleaseWeakRef(), which are never called by QueryInterface()
+                auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
+                pWrapper->QueryInterface(IID_Unknown, ppObject);
+
+                // If QueryInterface() failed and all other strong references have been released
+                // in the meantime, we are responsible for destroying the object.
+                ReleaseStrongRef();
+                return;
+            }
+            StrongRefCnt = PrevStrongRefCnt;
         }
-        Atomics::AtomicDecrement(m_lNumStrongReferences);
     }
 
     inline virtual ReferenceCounterValueType GetNumStrongRefs() const override final
@@ -212,10 +221,26 @@ public:
         return m_lNumWeakReferences;
     }
 
+    /// Sets the domain that will destroy the object once its strong reference counter reaches zero.
+
+    /// \return     true if the domain has been set, and false if the reference counters are
+    ///             already attached to a domain or the object is not alive.
+    bool SetDestructionDomain(DeferredDestructionDomain* pDomain)
+    {
+        ThreadingTools::LockHelper Lock(m_LockFlag);
+        if (m_pDestructionDomain != nullptr || m_ObjectState != ObjectState::Alive)
+            return false;
+
+        m_pDestructionDomain = pDomain;
+        return true;
+    }
+
 private:
     template <typename AllocatorType, typename ObjectType>
     friend class MakeNewRCObj;
 
+    friend class DeferredDestructionDomain;
+
     RefCountersImpl() noexcept
     {
         m_lNumStrongReferences = 0;
@@ -291,9 +316,7 @@ private:
         // 1. Decrement m_lNumStrongReferences  |
         //    Read RefCount==0, no lock acquired|
         //                                      |   1. Run GetObject()
-        //                                      |      - acquire the lock
         //                                      |      - increment m_lNumStrongReferences
-        //                                      |      - release the lock
         //                                      |
         //                                      |   2. Run ReleaseWeakRef()
         //                                      |      - decrement m_lNumWeakReferences
@@ -308,37 +331,26 @@ private:
         //  IT IS CRUCIALLY IMPORTANT TO ASSURE THAT ONLY ONE THREAD WILL EVER
         //  EXECUTE THIS CODE
 
-        // The sloution is to atomically increment strong ref counter in GetObject().
-        // There are two possible scenarios depending on who first increments the counter:
+        // The solution is to never increment the strong ref counter once it has reached zero.
+        // GetObject() uses compare-exchange and only increments the counter if it is greater than zero.
+        // There are two possible scenarios depending on who first modifies the counter:
 
 
-        //                                                     Scenario I
+        //                                   Scenario I
         //
-        //             This thread              |      Another thread - GetObject()         |   One more thread - GetObject()
-        //                                      |                                           |
-        //                       m_lNumStrongReferences == 1                                |
-        //                                      |                                           |
-        //                                      |   1. Acquire the lock                     |
-        // 1. Decrement m_lNumStrongReferences  |                                           |   1. Wait for the lock
-        // 2. Read RefCount==0                  |   2. Increment m_lNumStrongReferences     |
-        // 3. Start destroying the object       |   3. Read StrongRefCnt == 1               |
-        // 4. Wait for the lock                 |   4. DO NOT return the reference          |
-        //                                      |      to the object                        |
-        //                                      |   5. Decrement m_lNumStrongReferences     |
-        // _  _  _  _  _  _  _  _  _  _  _  _  _|   6. Release the lock _  _  _  _  _  _  _ |_  _  _  _  _  _  _  _  _  _  _  _  _  _
-        //                                      |                                           |   2. Acquire the lock
-        //                                      |                                           |   3. Increment m_lNumStrongReferences
-        //                                      |                                           |   4. Read StrongRefCnt == 1
-        //                                      |                                           |   5. DO NOT return the reference
-        //                                      |                                           |      to the object
-        //                                      |                                           |   6. Decrement m_lNumStrongReferences
-        //  _  _  _  _  _  _  _  _  _  _  _  _  | _  _  _  _  _  _  _  _  _  _  _  _  _  _  | _ 7. Release the lock _  _  _  _  _  _
-        // 5. Acquire the lock                  |                                           |
-        //   - m_lNumStrongReferences==0        |                                           |
-        // 6. DESTROY the object                |                                           |
-        //                                      |                                           |
-
-        //  GetObject() MUST BE SERIALIZED for this to work properly!
+        //             This thread              |      Another thread - GetObject()
+        //                                      |
+        //                       m_lNumStrongReferences == 1
+        //                                      |
+        //                                      |   1. Read StrongRefCnt == 1
+        // 1. Decrement m_lNumStrongReferences  |
+        // 2. Read RefCount==0                  |   2. Try to exchange 1 -> 2, read 0
+        // 3. Start destroying the object       |   3. DO NOT return the reference
+        //                                      |      to the object
+        // 4. Acquire the lock                  |
+        //   - m_lNumStrongReferences==0        |
+        // 5. DESTROY the object                |
+        //                                      |
 
 
         //                                   Scenario II
@@ -347,109 +359,136 @@ private:
         //                                      |
         //                       m_lNumStrongReferences == 1
         //                                      |
-        //                                      |   1. Acquire the lock
-        //                                      |   2. Increment m_lNumStrongReferences
+        //                                      |   1. Exchange 1 -> 2
         // 1. Decrement m_lNumStrongReferences  |
         // 2. Read RefCount>0                   |
-        // 3. DO NOT destroy the object         |   3. Read StrongRefCnt > 1 (while m_lNumStrongReferences == 1)
-        //                                      |   4. Return the reference to the object
+        // 3. DO NOT destroy the object         |   2. Return the reference to the object
         //                                      |       - Increment m_lNumStrongReferences
-        //                                      |   5. Decrement m_lNumStrongReferences
+        //                                      |   3. Decrement m_lNumStrongReferences
 
-#ifdef DILIGENT_DEBUG
-        {
-            Atomics::Long NumStrongRefs = m_lNumStrongReferences;
-            VERIFY(NumStrongRefs == 0 || NumStrongRefs == 1, "Num strong references (", NumStrongRefs, ") is expected to be 0 or 1");
-        }
-#endif
+        VERIFY(m_lNumStrongReferences == 0, "Num strong references (", static_cast<Atomics::Long>(m_lNumStrongReferences), ") is expected to be 0");
 
         // Acquire the lock.
         ThreadingTools::LockHelper Lock(m_LockFlag);
 
-        // GetObject() first acquires the lock, and only then increments and
-        // decrements the ref counter. If it reads 1 after incremeting the counter,
-        // it does not return the reference to the object and decrements the counter.
-        // If we acquired the lock, GetObject() will not start until we are done
+        // GetObject() never increments the counter once it has reached zero,
+        // so no other thread can resurrect the object.
+        // The lock serializes access to the object wrapper and the object state
+        // with ReleaseWeakRef().
         VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive);
 
         // Extra caution
         if (m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive)
         {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // We cannot destroy the object while reference counters are locked as this will
-            // cause a deadlock in cases like this:
-            //
-            //    A ==sp==> B ---wp---> A
-            //
-            //    RefCounters_A.Lock();
-            //    delete A{
-            //      A.~dtor(){
-            //          B.~dtor(){
-            //              wpA.ReleaseWeakRef(){
-            //                  RefCounters_A.Lock(); // Deadlock
-            //
-
-            // So we copy the object wrapper and destroy the object after unlocking the
-            // reference counters
-            size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
-            for (size_t i = 0; i < ObjectWrapperBufferSize; ++i)
-                ObjectWrapperBufferCopy[i] = m_ObjectWrapperBuffer[i];
+            if (m_pDestructionDomain != nullptr)
+            {
+                // Hand the object over to the destruction domain. Since the object is not alive
+                // anymore, GetObject() will not return it. Since it is not destroyed yet,
+                // ReleaseWeakRef() will not destroy the reference counters.
+                m_ObjectState = ObjectState::PendingDestruction;
+
+                auto* pDomain = m_pDestructionDomain;
+                // <this> may be destroyed by another thread as soon as it is enqueued
+                Lock.Unlock();
+                EnqueuePendingObject(pDomain, this);
+            }
+            else
+            {
+                DestroyAttachedObject(Lock);
+            }
+        }
+    }
+
+    // Adds the reference counters to the domain's destruction queue. Defined in
+    // DeferredDestructionDomain.cpp to keep the domain out of this header.
+    static void EnqueuePendingObject(DeferredDestructionDomain* pDomain, RefCountersImpl* pRefCounters);
+
+    // Destroys the object that was handed over to the destruction domain
+    void DestroyPendingObject()
+    {
+        ThreadingTools::LockHelper Lock(m_LockFlag);
+        VERIFY(m_ObjectState == ObjectState::PendingDestruction, "The object is not pending destruction");
+        DestroyAttachedObject(Lock);
+    }
+
+    // Destroys the object attached to the reference counters. The reference counters
+    // must be locked by Lock, and are unlocked by this method.
+    void DestroyAttachedObject(ThreadingTools::LockHelper& Lock)
+    {
+        VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
+        // We cannot destroy the object while reference counters are locked as this will
+        // cause a deadlock in cases like this:
+        //
+        //    A ==sp==> B ---wp---> A
+        //
+        //    RefCounters_A.Lock();
+        //    delete A{
+        //      A.~dtor(){
+        //          B.~dtor(){
+        //              wpA.ReleaseWeakRef(){
+        //                  RefCounters_A.Lock(); // Deadlock
+        //
+
+        // So we copy the object wrapper and destroy the object after unlocking the
+        // reference counters
+        size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
+        for (size_t i = 0; i < ObjectWrapperBufferSize; ++i)
+            ObjectWrapperBufferCopy[i] = m_ObjectWrapperBuffer[i];
 #ifdef DILIGENT_DEBUG
-            memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
+        memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
 #endif
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
-
-            // In a multithreaded environment, reference counters object may
-            // be destroyed at any time while m_pObject->~dtor() is running.
-            // NOTE: m_pObject may not be the only object referencing m_pRefCounters.
-            //       All objects that are owned by m_pObject will point to the same
-            //       reference counters object.
-
-            // Note that this is the only place where m_ObjectState is
-            // modified after the ref counters object has been created
-            m_ObjectState = ObjectState::Destroyed;
-            // The object is now detached from the reference counters and it is if
-            // it was destroyed since no one can obtain access to it.
-
-
-            // It is essentially important to check the number of weak references
-            // while the object is locked. Otherwise reference counters object
-            // may be destroyed twice if ReleaseWeakRef() is executed by other thread:
-            //
-            //             This thread             |    Another thread - ReleaseWeakRef()
-            //                                     |
-            // 1. Decrement m_lNumStrongReferences,|
-            //    m_lNumStrongReferences==0,       |
-            //    acquire the lock, destroy        |
-            //    the obj, release the lock        |
-            //    m_lNumWeakReferences == 1        |
-            //                                     |   1. Aacquire the lock,
-            //                                     |      decrement m_lNumWeakReferences,
-            //                                     |      m_lNumWeakReferences == 0,
-            //                                     |      m_ObjectState == ObjectState::Destroyed
-            //                                     |
-            // 2. Read m_lNumWeakReferences == 0   |
-            // 3. Destroy the ref counters obj     |   2. Destroy the ref counters obj
-            //
-            bool bDestroyThis = m_lNumWeakReferences == 0;
-            // ReleaseWeakRef() decrements m_lNumWeakReferences, and checks it for
-            // zero only after acquiring the lock. So if m_lNumWeakReferences==0, no
-            // weak reference-related code may be running
-
-
-            // We must explicitly unlock the object now to avoid deadlocks. Also,
-            // if this is deleted, this->m_LockFlag will expire, which will cause
-            // Lock.~LockHelper() to crash
-            Lock.Unlock();
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
 
-            // Destroy referenced object
-            pWrapper->DestroyObject();
+        // In a multithreaded environment, reference counters object may
+        // be destroyed at any time while m_pObject->~dtor() is running.
+        // NOTE: m_pObject may not be the only object referencing m_pRefCounters.
+        //       All objects that are owned by m_pObject will point to the same
+        //       reference counters object.
 
-            // Note that <this> may be destroyed here already,
-            // see comments in ~ControlledObjectType()
-            if (bDestroyThis)
-                SelfDestroy();
-        }
+        // Note that this and TryDestroyObject() are the only places where
+        // m_ObjectState is modified after the ref counters object has been created
+        m_ObjectState = ObjectState::Destroyed;
+        // The object is now detached from the reference counters and it is if
+        // it was destroyed since no one can obtain access to it.
+
+
+        // It is essentially important to check the number of weak references
+        // while the object is locked. Otherwise reference counters object
+        // may be destroyed twice if ReleaseWeakRef() is executed by other thread:
+        //
+        //             This thread             |    Another thread - ReleaseWeakRef()
+        //                                     |
+        // 1. Decrement m_lNumStrongReferences,|
+        //    m_lNumStrongReferences==0,       |
+        //    acquire the lock, destroy        |
+        //    the obj, release the lock        |
+        //    m_lNumWeakReferences == 1        |
+        //                                     |   1. Aacquire the lock,
+        //                                     |      decrement m_lNumWeakReferences,
+        //                                     |      m_lNumWeakReferences == 0,
+        //                                     |      m_ObjectState == ObjectState::Destroyed
+        //                                     |
+        // 2. Read m_lNumWeakReferences == 0   |
+        // 3. Destroy the ref counters obj     |   2. Destroy the ref counters obj
+        //
+        bool bDestroyThis = m_lNumWeakReferences == 0;
+        // ReleaseWeakRef() decrements m_lNumWeakReferences, and checks it for
+        // zero only after acquiring the lock. So if m_lNumWeakReferences==0, no
+        // weak reference-related code may be running
+
+
+        // We must explicitly unlock the object now to avoid deadlocks. Also,
+        // if this is deleted, this->m_LockFlag will expire, which will cause
+        // Lock.~LockHelper() to crash
+        Lock.Unlock();
+
+        // Destroy referenced object
+        pWrapper->DestroyObject();
+
+        // Note that <this> may be destroyed here already,
+        // see comments in ~ControlledObjectType()
+        if (bDestroyThis)
+            SelfDestroy();
     }
 
     void SelfDestroy()
@@ -488,9 +527,12 @@ private:
     {
         NotInitialized,
         Alive,
+        PendingDestruction,
         Destroyed
     };
     volatile ObjectState m_ObjectState = ObjectState::NotInitialized;
+
+    DeferredDestructionDomain* m_pDestructionDomain = nullptr;
 };
 
 
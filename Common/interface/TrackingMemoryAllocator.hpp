@@ -0,0 +1,304 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::TrackingMemoryAllocator class
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <chrono>
+
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Memory allocator that forwards all requests to another allocator and keeps
+/// per-tag, per-subsystem and per-allocation-site statistics.
+
+/// The allocator uses the dbgDescription, dbgFileName and dbgLineNumber arguments
+/// of IMemoryAllocator::Allocate to attribute every allocation:
+/// - a *tag* is the allocation description string (e.g. "Memory for string pool");
+/// - a *subsystem* is the module the allocation originates from, which is derived
+///   from the source file path (e.g. "GraphicsEngineVulkan" for
+///   .../Graphics/GraphicsEngineVulkan/src/BufferVkImpl.cpp);
+/// - an *allocation site* is the unique (description, file, line) triple.
+///
+/// Every block is prefixed with a small header that records its size and site, so that
+/// Free() does not need a pointer lookup. Statistics are kept in several shards, each
+/// protected by its own mutex, and every thread updates the shard selected by its id, so
+/// that threads do not contend for a single lock. Every shard caches sites by the identity
+/// of the string pointers passed to Allocate (which are literals in all engine call sites),
+/// so after the first allocation from a given site, tracking costs a hash lookup and a few
+/// counter updates. Different pointers to equal strings are counted as one site. Once the
+/// number of pointer triples cached by a shard reaches a limit (which may happen if
+/// descriptions or file names are built at run time), the sites of new triples are found
+/// by the contents of the strings on every allocation.
+///
+/// Peak values are tracked per shard and summed when statistics are requested. The sum is
+/// exact when all allocations are made and released by one thread, and is an upper bound
+/// of the actual peak otherwise.
+///
+/// To track all engine allocations, create the allocator before the engine factory and
+/// pass it to SetRawAllocator():
+///
+///     static TrackingMemoryAllocator TrackingAllocator;
+///     SetRawAllocator(&TrackingAllocator);
+///
+/// \note   All memory allocated through the tracking allocator must be released through it,
+///         and the allocator must outlive all allocations it made.
+class TrackingMemoryAllocator final : public IMemoryAllocator
+{
+public:
+    /// Memory usage statistics of a group of allocations
+    struct UsageStats
+    {
+        /// The number of bytes currently allocated
+        size_t LiveBytes = 0;
+
+        /// The maximum value LiveBytes has ever reached
+        size_t PeakLiveBytes = 0;
+
+        /// The number of currently live allocations
+        size_t NumLiveAllocations = 0;
+
+        /// The total number of allocations made so far
+        Uint64 NumAllocations = 0;
+
+        /// The total number of bytes allocated so far
+        Uint64 TotalAllocatedBytes = 0;
+    };
+
+    /// Statistics of a tag or a subsystem
+    struct BucketStats
+    {
+        String     Name;
+        UsageStats Stats;
+    };
+
+    /// Statistics of a single allocation site
+    struct SiteStats
+    {
+        String     Description;
+        String     FileName;
+        Int32      LineNumber = 0;
+        UsageStats Stats;
+    };
+
+    /// Memory usage snapshot
+    struct Snapshot
+    {
+        /// Statistics of all allocations made through the allocator
+        UsageStats Total;
+
+        /// Per-tag statistics, sorted by live bytes in descending order
+        std::vector<BucketStats> Tags;
+
+        /// Per-subsystem statistics, sorted by live bytes in descending order
+        std::vector<BucketStats> Subsystems;
+
+        /// The most frequent allocation sites, sorted by the total number
+        /// of allocations in descending order
+        std::vector<SiteStats> HotSites;
+    };
+
+    /// \param [in] pBaseAllocator - Allocator that performs the actual allocations.
+    ///                              If null, DefaultRawMemoryAllocator is used.
+    explicit TrackingMemoryAllocator(IMemoryAllocator* pBaseAllocator = nullptr);
+    ~TrackingMemoryAllocator();
+
+    // clang-format off
+    TrackingMemoryAllocator           (const TrackingMemoryAllocator&)  = delete;
+    TrackingMemoryAllocator           (      TrackingMemoryAllocator&&) = delete;
+    TrackingMemoryAllocator& operator=(const TrackingMemoryAllocator&)  = delete;
+    TrackingMemoryAllocator& operator=(      TrackingMemoryAllocator&&) = delete;
+    // clang-format on
+
+    /// Allocates block of memory through the base allocator and records it
+    virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final;
+
+    /// Releases memory
+    virtual void Free(void* Ptr) override final;
+
+    /// Returns statistics of all allocations made through the allocator.
+    UsageStats GetTotalStats() const;
+
+    /// Returns a snapshot of the memory usage.
+
+    /// \param [in] MaxHotSites - The maximum number of allocation sites to return.
+    Snapshot GetSnapshot(size_t MaxHotSites = 16) const;
+
+    /// Writes the memory usage snapshot to the log.
+
+    /// \param [in] MaxEntries - The maximum number of tags, subsystems and allocation
+    ///                          sites to print.
+    void DumpSnapshot(size_t MaxEntries = 16) const;
+
+    /// Enables periodic dumps of the memory usage snapshot to the log.
+
+    /// \param [in] IntervalInSeconds - Minimum time between two consecutive dumps.
+    ///                                 Zero disables periodic dumps.
+    ///
+    /// \remarks    The allocator does not create any threads. Elapsed time is checked
+    ///             from Allocate() once in every 1024 allocations, and the dump is
+    ///             written by the thread that made the allocation.
+    void SetPeriodicDumpInterval(double IntervalInSeconds);
+
+    /// Resets peak values of all statistics to the current live values.
+    void ResetPeaks();
+
+private:
+    struct AllocationHeader;
+
+    // Identifies an allocation site by the string pointers
+    struct SiteKey
+    {
+        const Char* Description;
+        const char* FileName;
+        Int32       LineNumber;
+
+        bool operator==(const SiteKey& rhs) const
+        {
+            return Description == rhs.Description && FileName == rhs.FileName && LineNumber == rhs.LineNumber;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const SiteKey& Key) const;
+        };
+    };
+
+    // Identifies an allocation site by the contents of the strings
+    struct SiteContentKey
+    {
+        String Description;
+        String FileName;
+        Int32  LineNumber;
+
+        bool operator==(const SiteContentKey& rhs) const
+        {
+            return Description == rhs.Description && FileName == rhs.FileName && LineNumber == rhs.LineNumber;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const SiteContentKey& Key) const;
+        };
+    };
+
+    struct SiteInfo
+    {
+        String Description;
+        String FileName;
+        Int32  LineNumber   = 0;
+        Uint32 TagIdx       = 0;
+        Uint32 SubsystemIdx = 0;
+    };
+
+    // Counters of a shard. Allocations may be released by a thread that uses another shard,
+    // so the live values of a single shard may be negative.
+    struct ShardCounters
+    {
+        Int64  LiveBytes           = 0;
+        Int64  PeakLiveBytes       = 0;
+        Int64  NumLiveAllocations  = 0;
+        Uint64 NumAllocations      = 0;
+        Uint64 TotalAllocatedBytes = 0;
+
+        void AddAllocation(size_t Size);
+        void RemoveAllocation(size_t Size);
+        void ResetPeak();
+
+        // Adds the counters of another shard
+        void Accumulate(const ShardCounters& Counters);
+
+        UsageStats GetStats() const;
+    };
+
+    struct ShardSiteCounters
+    {
+        ShardCounters Counters;
+
+        // Copied from the site info on first use
+        Uint32 TagIdx       = ~0u;
+        Uint32 SubsystemIdx = ~0u;
+    };
+
+    struct Shard
+    {
+        std::mutex Mtx;
+
+        ShardCounters                  Total;
+        std::vector<ShardSiteCounters> Sites;
+        std::vector<ShardCounters>     Tags;
+        std::vector<ShardCounters>     Subsystems;
+
+        // Cache of the site indices
+        std::unordered_map<SiteKey, Uint32, SiteKey::Hasher> SiteKeyToIdx;
+    };
+
+    static constexpr Uint32 NumShardsLog2 = 4;
+    static constexpr size_t NumShards     = size_t{1} << NumShardsLog2;
+
+    Shard& GetThreadShard();
+
+    // Must be called while the shard mutex is locked
+    ShardSiteCounters& GetShardSite(Shard& Shard, Uint32 SiteIdx);
+
+    Uint32 FindOrAddSite(const Char* dbgDescription, const char* dbgFileName, Int32 dbgLineNumber);
+    Uint32 FindOrAddBucket(std::vector<String>& Buckets, std::unordered_map<String, Uint32>& NameToIdx, const String& Name);
+
+    // Sums the counters of all shards. Sites, tags and subsystems are only summed
+    // up to the sizes of the vectors.
+    void SumShards(ShardCounters& Total, std::vector<ShardCounters>& Sites, std::vector<ShardCounters>& Tags, std::vector<ShardCounters>& Subsystems) const;
+
+    IMemoryAllocator& m_BaseAllocator;
+
+    // Const methods lock the shard mutexes
+    mutable std::array<Shard, NumShards> m_Shards;
+
+    // Protects the site, tag and subsystem registry, and the periodic dump settings.
+    // Locked after a shard mutex, never before it.
+    mutable std::mutex m_RegistryMtx;
+
+    std::vector<SiteInfo>                                              m_Sites;
+    std::unordered_map<SiteContentKey, Uint32, SiteContentKey::Hasher> m_SiteContentToIdx;
+    std::vector<String>                                                m_Tags;
+    std::unordered_map<String, Uint32>                                 m_TagNameToIdx;
+    std::vector<String>                                                m_Subsystems;
+    std::unordered_map<String, Uint32>                                 m_SubsystemNameToIdx;
+
+    std::chrono::steady_clock::duration   m_DumpInterval{0};
+    std::chrono::steady_clock::time_point m_NextDumpTime;
+};
+
+} // namespace Diligent
@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::WorkerThreadPool class
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "ThreadSignal.hpp"
+
+namespace Diligent
+{
+
+/// A fixed set of persistent worker threads that execute parallel loops.
+
+/// The threads are created once by the constructor and are woken up by every ParallelFor()
+/// call, so that algorithms that run many short parallel loops (e.g. one loop per mip level
+/// or per frame) do not pay the cost of creating and joining threads every time.
+///
+/// \remarks    The pool is not thread-safe: ParallelFor() must not be called by several
+///             threads at the same time, and must not be called from a task.
+class WorkerThreadPool
+{
+public:
+    /// Task function that receives the index of the task to execute.
+    using TaskFuncType = std::function<void(Uint32 TaskIndex)>;
+
+    /// \param [in] NumWorkers - The number of worker threads to create. The thread that
+    ///                          calls ParallelFor() also executes tasks, so the pool
+    ///                          runs up to NumWorkers + 1 tasks at the same time.
+    explicit WorkerThreadPool(Uint32 NumWorkers);
+
+    // clang-format off
+    WorkerThreadPool           (const WorkerThreadPool&) = delete;
+    WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
+    WorkerThreadPool           (WorkerThreadPool&&)      = delete;
+    WorkerThreadPool& operator=(WorkerThreadPool&&)      = delete;
+    // clang-format on
+
+    ~WorkerThreadPool();
+
+    /// Executes TaskFunc for every task index in [0, NumTasks) and waits until all tasks are complete.
+
+    /// \param [in] NumTasks   - The number of tasks to execute.
+    /// \param [in] TaskFunc   - Function that executes one task. It is called concurrently from
+    ///                          multiple threads and must not throw.
+    /// \param [in] MaxThreads - The maximum number of threads, including the calling thread,
+    ///                          to execute the tasks. Tasks are distributed between the threads
+    ///                          dynamically in the order of their indices.
+    void ParallelFor(Uint32 NumTasks, const TaskFuncType& TaskFunc, Uint32 MaxThreads = ~Uint32{0});
+
+    Uint32 GetNumWorkers() const { return static_cast<Uint32>(m_Workers.size()); }
+
+private:
+    void WorkerThreadFunc(Uint32 WorkerIndex);
+    void RunTasks();
+
+    std::vector<std::thread> m_Workers;
+
+    // One signal per worker: positive value starts running tasks, negative value stops the thread
+    std::unique_ptr<ThreadingTools::Signal[]> m_WorkerSignals;
+    ThreadingTools::Signal                    m_TasksDoneSignal;
+    std::atomic_int                           m_NumWorkersRunning{0};
+
+    // Parameters of the current ParallelFor() call
+    const TaskFuncType* m_pTaskFunc = nullptr;
+    Uint32              m_NumTasks  = 0;
+    std::atomic<Uint32> m_NextTask{0};
+};
+
+} // namespace Diligent
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "DeferredDestructionDomain.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include "RefCountedObjectImpl.hpp"
+
+namespace Diligent
+{
+
+DeferredDestructionDomain::~DeferredDestructionDomain()
+{
+    // Destroying pending objects may release more objects attached to the domain
+    while (DestroyPendingObjects() != 0)
+    {
+    }
+    VERIFY(m_NumAttachedObjects == 0, "There are ", m_NumAttachedObjects.load(),
+           " object(s) attached to the destruction domain that are still alive. The domain must outlive all objects attached to it.");
+}
+
+void DeferredDestructionDomain::Attach(IObject* pObject)
+{
+    VERIFY_EXPR(pObject != nullptr);
+    auto* pRefCounters = ValidatedCast<RefCountersImpl>(pObject->GetReferenceCounters());
+    if (pRefCounters->SetDestructionDomain(this))
+    {
+        ++m_NumAttachedObjects;
+    }
+    else
+    {
+        LOG_WARNING_MESSAGE("The object is already attached to a destruction domain or is not alive");
+    }
+}
+
+void DeferredDestructionDomain::Enqueue(RefCountersImpl* pRefCounters)
+{
+    std::lock_guard<std::mutex> Lock{m_PendingObjectsMtx};
+    m_PendingObjects.push_back(pRefCounters);
+}
+
+void RefCountersImpl::EnqueuePendingObject(DeferredDestructionDomain* pDomain, RefCountersImpl* pRefCounters)
+{
+    pDomain->Enqueue(pRefCounters);
+}
+
+size_t DeferredDestructionDomain::DestroyPendingObjects(size_t MaxObjects)
+{
+    std::vector<RefCountersImpl*> ObjectsToDestroy;
+    {
+        std::lock_guard<std::mutex> Lock{m_PendingObjectsMtx};
+        if (m_PendingObjects.empty() || MaxObjects == 0)
+            return 0;
+
+        // Reuse one of the buffers released by previous calls to avoid allocating memory every time.
+        // There can be as many buffers in use as there are threads destroying objects at the same time.
+        if (!m_SpareBuffers.empty())
+        {
+            ObjectsToDestroy.swap(m_SpareBuffers.back());
+            m_SpareBuffers.pop_back();
+        }
+
+        const auto NumObjects = std::min(MaxObjects, m_PendingObjects.size());
+        ObjectsToDestroy.reserve(NumObjects);
+        for (size_t i = 0; i < NumObjects; ++i)
+        {
+            ObjectsToDestroy.push_back(m_PendingObjects.front());
+            m_PendingObjects.pop_front();
+        }
+    }
+
+    // Objects must be destroyed without holding the mutex as their destructors
+    // may release the last references to other objects attached to this domain.
+    for (auto* pRefCounters : ObjectsToDestroy)
+    {
+        pRefCounters->DestroyPendingObject();
+        --m_NumAttachedObjects;
+    }
+
+    const auto NumDestroyedObjects = ObjectsToDestroy.size();
+    ObjectsToDestroy.clear();
+    {
+        std::lock_guard<std::mutex> Lock{m_PendingObjectsMtx};
+        m_SpareBuffers.emplace_back(std::move(ObjectsToDestroy));
+    }
+
+    return NumDestroyedObjects;
+}
+
+size_t DeferredDestructionDomain::GetNumPendingObjects() const
+{
+    std::lock_guard<std::mutex> Lock{m_PendingObjectsMtx};
+    return m_PendingObjects.size();
+}
+
+} // namespace Diligent
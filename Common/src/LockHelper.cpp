@@ -26,14 +26,135 @@
  */
 
 #include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#    include <immintrin.h>
+#endif
+
 #include "LockHelper.hpp"
 
 namespace ThreadingTools
 {
 
+namespace
+{
+
+// The maximum number of pause instructions issued between two consecutive
+// attempts to acquire the lock.
+constexpr int MaxBackoffSpins = 64;
+
+// The number of times the thread yields its time slice before it gets parked.
+constexpr int MaxYieldsBeforePark = 16;
+
+// Park duration range, in microseconds.
+constexpr int MinParkTimeUs = 10;
+constexpr int MaxParkTimeUs = 500;
+
+inline void PauseCPU() noexcept
+{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#elif (defined(__arm__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+struct AtomicContentionStats
+{
+    std::atomic<Atomics::Int64> NumContendedLocks{0};
+    std::atomic<Atomics::Int64> NumSpins{0};
+    std::atomic<Atomics::Int64> NumYields{0};
+    std::atomic<Atomics::Int64> NumParks{0};
+};
+
+AtomicContentionStats& GetAtomicContentionStats() noexcept
+{
+    static AtomicContentionStats Stats;
+    return Stats;
+}
+
+} // namespace
+
 void LockHelper::YieldThread() noexcept
 {
     std::this_thread::yield();
 }
 
+void LockHelper::WaitForLock(LockFlag& LockFlag, int SpinCountToYield) noexcept
+{
+    // Statistics are only updated on the slow path and are accumulated locally
+    // to keep the traffic on the shared counters low.
+    Atomics::Int64 NumSpins  = 0;
+    Atomics::Int64 NumYields = 0;
+    Atomics::Int64 NumParks  = 0;
+
+    int Backoff    = 1;
+    int SpinCount  = 0;
+    int YieldCount = 0;
+    int ParkTimeUs = MinParkTimeUs;
+    while (true)
+    {
+        for (int i = 0; i < Backoff; ++i)
+            PauseCPU();
+        NumSpins += Backoff;
+        SpinCount += Backoff;
+
+        // Only attempt the compare-exchange when the flag looks unlocked to avoid
+        // invalidating the cache line owned by the lock holder.
+        if (LockFlag == LockFlag::LOCK_FLAG_UNLOCKED && UnsafeTryLock(LockFlag))
+            break;
+
+        if (Backoff < MaxBackoffSpins)
+            Backoff *= 2;
+
+        if (SpinCount >= SpinCountToYield)
+        {
+            SpinCount = 0;
+            if (YieldCount < MaxYieldsBeforePark)
+            {
+                ++YieldCount;
+                ++NumYields;
+                YieldThread();
+            }
+            else
+            {
+                ++NumParks;
+                std::this_thread::sleep_for(std::chrono::microseconds{ParkTimeUs});
+                ParkTimeUs = std::min(ParkTimeUs * 2, MaxParkTimeUs);
+            }
+        }
+    }
+
+    auto& Stats = GetAtomicContentionStats();
+    Stats.NumContendedLocks.fetch_add(1, std::memory_order_relaxed);
+    Stats.NumSpins.fetch_add(NumSpins, std::memory_order_relaxed);
+    if (NumYields != 0)
+        Stats.NumYields.fetch_add(NumYields, std::memory_order_relaxed);
+    if (NumParks != 0)
+        Stats.NumParks.fetch_add(NumParks, std::memory_order_relaxed);
+}
+
+LockHelper::ContentionStats LockHelper::GetContentionStats() noexcept
+{
+    const auto&     Stats = GetAtomicContentionStats();
+    ContentionStats Res;
+    Res.NumContendedLocks = Stats.NumContendedLocks.load(std::memory_order_relaxed);
+    Res.NumSpins          = Stats.NumSpins.load(std::memory_order_relaxed);
+    Res.NumYields         = Stats.NumYields.load(std::memory_order_relaxed);
+    Res.NumParks          = Stats.NumParks.load(std::memory_order_relaxed);
+    return Res;
+}
+
+void LockHelper::ResetContentionStats() noexcept
+{
+    auto& Stats = GetAtomicContentionStats();
+    Stats.NumContendedLocks.store(0, std::memory_order_relaxed);
+    Stats.NumSpins.store(0, std::memory_order_relaxed);
+    Stats.NumYields.store(0, std::memory_order_relaxed);
+    Stats.NumParks.store(0, std::memory_order_relaxed);
+}
+
 } // namespace ThreadingTools
@@ -0,0 +1,92 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "MappedFileDataBlob.hpp"
+#include "MemoryFileStream.hpp"
+#include "RefCountedObjectImpl.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+MappedFileDataBlob::MappedFileDataBlob(IReferenceCounters* pRefCounters, std::unique_ptr<BasicMappedFile> pFile) :
+    TBase{pRefCounters},
+    m_pFile{std::move(pFile)}
+{
+    VERIFY_EXPR(m_pFile);
+}
+
+RefCntAutoPtr<MappedFileDataBlob> MappedFileDataBlob::Create(const Char* Path, EFileAccessPattern AccessPattern)
+{
+    auto pFile = FileSystem::MapFile(Path, AccessPattern);
+    if (!pFile)
+        return RefCntAutoPtr<MappedFileDataBlob>{};
+
+    return RefCntAutoPtr<MappedFileDataBlob>{MakeNewRCObj<MappedFileDataBlob>()(std::move(pFile))};
+}
+
+void MappedFileDataBlob::Resize(size_t NewSize)
+{
+    UNEXPECTED("Memory-mapped file blobs can't be resized");
+}
+
+size_t MappedFileDataBlob::GetSize() const
+{
+    return m_pFile->GetSize();
+}
+
+void* MappedFileDataBlob::GetDataPtr()
+{
+    return const_cast<void*>(m_pFile->GetData());
+}
+
+const void* MappedFileDataBlob::GetConstDataPtr() const
+{
+    return m_pFile->GetData();
+}
+
+IMPLEMENT_QUERY_INTERFACE(MappedFileDataBlob, IID_DataBlob, TBase)
+
+
+void CreateMappedFileStream(const Char*        Path,
+                            EFileAccessPattern AccessPattern,
+                            IFileStream**      ppStream)
+{
+    DEV_CHECK_ERR(ppStream != nullptr, "Null pointer provided");
+    *ppStream = nullptr;
+
+    auto pBlob = MappedFileDataBlob::Create(Path, AccessPattern);
+    if (!pBlob)
+        return;
+
+    *ppStream = MakeNewRCObj<MemoryFileStream>()(pBlob);
+    (*ppStream)->AddRef();
+}
+
+} // namespace Diligent
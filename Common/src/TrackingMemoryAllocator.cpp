@@ -0,0 +1,482 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "TrackingMemoryAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <functional>
+
+#include "DefaultRawMemoryAllocator.hpp"
+#include "HashUtils.hpp"
+#include "../../Primitives/interface/Errors.hpp"
+
+namespace Diligent
+{
+
+struct TrackingMemoryAllocator::AllocationHeader
+{
+    size_t Size;
+    Uint32 SiteIdx;
+};
+
+// The header must preserve the alignment of the memory returned by the base allocator
+static constexpr size_t AllocationHeaderSize = (sizeof(size_t) + sizeof(Uint32) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+// Elapsed time for periodic dumps is only checked once in this many allocations from a shard
+static constexpr Uint64 DumpCheckPeriod = 1024;
+
+// The maximum number of pointer triples cached by a shard. When the limit is reached, the
+// sites of the new triples are found by the contents of the strings on every allocation.
+static constexpr size_t MaxSiteKeysPerShard = 4096;
+
+static constexpr Uint32 InvalidIdx = ~0u;
+
+size_t TrackingMemoryAllocator::SiteKey::Hasher::operator()(const SiteKey& Key) const
+{
+    return ComputeHash(Key.Description, Key.FileName, Key.LineNumber);
+}
+
+size_t TrackingMemoryAllocator::SiteContentKey::Hasher::operator()(const SiteContentKey& Key) const
+{
+    return ComputeHash(Key.Description, Key.FileName, Key.LineNumber);
+}
+
+static String GetSubsystemName(const char* FileName)
+{
+    if (FileName == nullptr || *FileName == 0)
+        return "<Unknown>";
+
+    // Split the path into directory components, e.g.
+    // "C:\DiligentCore\Graphics\GraphicsEngineVulkan\src\BufferVkImpl.cpp" -> {"C:", "DiligentCore", "Graphics", "GraphicsEngineVulkan", "src"}
+    std::vector<String> Dirs;
+    for (const char* c = FileName; *c != 0;)
+    {
+        const char* End = c;
+        while (*End != 0 && *End != '/' && *End != '\\')
+            ++End;
+        if (*End == 0)
+            break; // File name
+        if (End > c)
+            Dirs.emplace_back(c, End);
+        c = End + 1;
+    }
+
+    // The module name is the directory that contains the src/include/interface folder
+    for (size_t i = Dirs.size(); i > 1; --i)
+    {
+        const auto& Dir = Dirs[i - 1];
+        if (Dir == "src" || Dir == "include" || Dir == "interface")
+            return Dirs[i - 2];
+    }
+
+    return !Dirs.empty() ? Dirs.back() : String{"<Unknown>"};
+}
+
+void TrackingMemoryAllocator::ShardCounters::AddAllocation(size_t Size)
+{
+    LiveBytes += static_cast<Int64>(Size);
+    PeakLiveBytes = std::max(PeakLiveBytes, LiveBytes);
+    ++NumLiveAllocations;
+    ++NumAllocations;
+    TotalAllocatedBytes += Size;
+}
+
+void TrackingMemoryAllocator::ShardCounters::RemoveAllocation(size_t Size)
+{
+    LiveBytes -= static_cast<Int64>(Size);
+    --NumLiveAllocations;
+}
+
+void TrackingMemoryAllocator::ShardCounters::ResetPeak()
+{
+    PeakLiveBytes = std::max(LiveBytes, Int64{0});
+}
+
+void TrackingMemoryAllocator::ShardCounters::Accumulate(const ShardCounters& Counters)
+{
+    LiveBytes += Counters.LiveBytes;
+    PeakLiveBytes += Counters.PeakLiveBytes;
+    NumLiveAllocations += Counters.NumLiveAllocations;
+    NumAllocations += Counters.NumAllocations;
+    TotalAllocatedBytes += Counters.TotalAllocatedBytes;
+}
+
+TrackingMemoryAllocator::UsageStats TrackingMemoryAllocator::ShardCounters::GetStats() const
+{
+    // Shards are summed one by one, so allocations that are made and released by different
+    // threads while the counters are being summed may result in small negative values
+    UsageStats Stats;
+    Stats.LiveBytes           = static_cast<size_t>(std::max(LiveBytes, Int64{0}));
+    Stats.PeakLiveBytes       = static_cast<size_t>(std::max(PeakLiveBytes, LiveBytes));
+    Stats.NumLiveAllocations  = static_cast<size_t>(std::max(NumLiveAllocations, Int64{0}));
+    Stats.NumAllocations      = NumAllocations;
+    Stats.TotalAllocatedBytes = TotalAllocatedBytes;
+    return Stats;
+}
+
+TrackingMemoryAllocator::TrackingMemoryAllocator(IMemoryAllocator* pBaseAllocator) :
+    m_BaseAllocator{pBaseAllocator != nullptr ? *pBaseAllocator : DefaultRawMemoryAllocator::GetAllocator()}
+{
+    static_assert(sizeof(AllocationHeader) <= AllocationHeaderSize, "Allocation header does not fit into the reserved space");
+}
+
+TrackingMemoryAllocator::~TrackingMemoryAllocator()
+{
+    const auto Total = GetTotalStats();
+    if (Total.NumLiveAllocations != 0)
+    {
+        LOG_WARNING_MESSAGE("Tracking memory allocator is destroyed while ", Total.NumLiveAllocations,
+                            " allocation(s) (", Total.LiveBytes, " bytes) are still alive");
+    }
+}
+
+TrackingMemoryAllocator::Shard& TrackingMemoryAllocator::GetThreadShard()
+{
+    // Thread ids are often aligned addresses, so the hash is mixed before selecting the shard
+    const auto Hash = static_cast<Uint64>(std::hash<std::thread::id>{}(std::this_thread::get_id())) * Uint64{0x9E3779B97F4A7C15};
+    return m_Shards[static_cast<size_t>(Hash >> (64 - NumShardsLog2))];
+}
+
+TrackingMemoryAllocator::ShardSiteCounters& TrackingMemoryAllocator::GetShardSite(Shard& Shard, Uint32 SiteIdx)
+{
+    if (SiteIdx < Shard.Sites.size() && Shard.Sites[SiteIdx].TagIdx != InvalidIdx)
+        return Shard.Sites[SiteIdx];
+
+    Uint32 TagIdx       = InvalidIdx;
+    Uint32 SubsystemIdx = InvalidIdx;
+    {
+        std::lock_guard<std::mutex> Lock{m_RegistryMtx};
+        DEV_CHECK_ERR(SiteIdx < m_Sites.size(), "Invalid allocation header. The memory was not allocated by this allocator or is corrupted.");
+        TagIdx       = m_Sites[SiteIdx].TagIdx;
+        SubsystemIdx = m_Sites[SiteIdx].SubsystemIdx;
+    }
+
+    if (SiteIdx >= Shard.Sites.size())
+        Shard.Sites.resize(SiteIdx + 1);
+    if (TagIdx >= Shard.Tags.size())
+        Shard.Tags.resize(TagIdx + 1);
+    if (SubsystemIdx >= Shard.Subsystems.size())
+        Shard.Subsystems.resize(SubsystemIdx + 1);
+
+    auto& Site        = Shard.Sites[SiteIdx];
+    Site.TagIdx       = TagIdx;
+    Site.SubsystemIdx = SubsystemIdx;
+    return Site;
+}
+
+Uint32 TrackingMemoryAllocator::FindOrAddBucket(std::vector<String>& Buckets, std::unordered_map<String, Uint32>& NameToIdx, const String& Name)
+{
+    auto it = NameToIdx.find(Name);
+    if (it != NameToIdx.end())
+        return it->second;
+
+    const auto Idx = static_cast<Uint32>(Buckets.size());
+    Buckets.emplace_back(Name);
+    NameToIdx.emplace(Name, Idx);
+    return Idx;
+}
+
+Uint32 TrackingMemoryAllocator::FindOrAddSite(const Char* dbgDescription, const char* dbgFileName, Int32 dbgLineNumber)
+{
+    // Different pointers to equal strings result in the same site
+    SiteContentKey Key{
+        dbgDescription != nullptr ? dbgDescription : "<No description>",
+        dbgFileName != nullptr ? dbgFileName : "<Unknown>",
+        dbgLineNumber,
+    };
+
+    std::lock_guard<std::mutex> Lock{m_RegistryMtx};
+
+    auto it = m_SiteContentToIdx.find(Key);
+    if (it != m_SiteContentToIdx.end())
+        return it->second;
+
+    SiteInfo Site;
+    Site.Description  = Key.Description;
+    Site.FileName     = Key.FileName;
+    Site.LineNumber   = dbgLineNumber;
+    Site.TagIdx       = FindOrAddBucket(m_Tags, m_TagNameToIdx, Site.Description);
+    Site.SubsystemIdx = FindOrAddBucket(m_Subsystems, m_SubsystemNameToIdx, GetSubsystemName(dbgFileName));
+
+    const auto Idx = static_cast<Uint32>(m_Sites.size());
+    m_Sites.emplace_back(std::move(Site));
+    m_SiteContentToIdx.emplace(std::move(Key), Idx);
+    return Idx;
+}
+
+void* TrackingMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+{
+    VERIFY_EXPR(Size > 0);
+
+    auto* pRawMem = reinterpret_cast<Uint8*>(m_BaseAllocator.Allocate(Size + AllocationHeaderSize, dbgDescription, dbgFileName, dbgLineNumber));
+    if (pRawMem == nullptr)
+        return nullptr;
+
+    auto& Shard = GetThreadShard();
+
+    bool DumpCheckRequired = false;
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        // Sites are cached by the string pointers, which is cheap to hash
+        const SiteKey Key{dbgDescription, dbgFileName, dbgLineNumber};
+
+        Uint32 SiteIdx = InvalidIdx;
+
+        auto it = Shard.SiteKeyToIdx.find(Key);
+        if (it != Shard.SiteKeyToIdx.end())
+        {
+            SiteIdx = it->second;
+        }
+        else
+        {
+            SiteIdx = FindOrAddSite(dbgDescription, dbgFileName, dbgLineNumber);
+            if (Shard.SiteKeyToIdx.size() < MaxSiteKeysPerShard)
+                Shard.SiteKeyToIdx.emplace(Key, SiteIdx);
+        }
+
+        auto& Site = GetShardSite(Shard, SiteIdx);
+        Site.Counters.AddAllocation(Size);
+        Shard.Tags[Site.TagIdx].AddAllocation(Size);
+        Shard.Subsystems[Site.SubsystemIdx].AddAllocation(Size);
+        Shard.Total.AddAllocation(Size);
+
+        auto* pHeader    = reinterpret_cast<AllocationHeader*>(pRawMem);
+        pHeader->Size    = Size;
+        pHeader->SiteIdx = SiteIdx;
+
+        DumpCheckRequired = (Shard.Total.NumAllocations % DumpCheckPeriod) == 0;
+    }
+
+    if (DumpCheckRequired)
+    {
+        bool DumpSnapshotRequired = false;
+        {
+            std::lock_guard<std::mutex> Lock{m_RegistryMtx};
+            if (m_DumpInterval.count() > 0)
+            {
+                const auto CurrTime = std::chrono::steady_clock::now();
+                if (CurrTime >= m_NextDumpTime)
+                {
+                    m_NextDumpTime       = CurrTime + m_DumpInterval;
+                    DumpSnapshotRequired = true;
+                }
+            }
+        }
+
+        // Log the snapshot outside of the lock
+        if (DumpSnapshotRequired)
+            DumpSnapshot();
+    }
+
+    return pRawMem + AllocationHeaderSize;
+}
+
+void TrackingMemoryAllocator::Free(void* Ptr)
+{
+    if (Ptr == nullptr)
+        return;
+
+    auto* pRawMem = reinterpret_cast<Uint8*>(Ptr) - AllocationHeaderSize;
+    {
+        const auto* pHeader = reinterpret_cast<const AllocationHeader*>(pRawMem);
+
+        auto& Shard = GetThreadShard();
+
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        auto& Site = GetShardSite(Shard, pHeader->SiteIdx);
+        Site.Counters.RemoveAllocation(pHeader->Size);
+        Shard.Tags[Site.TagIdx].RemoveAllocation(pHeader->Size);
+        Shard.Subsystems[Site.SubsystemIdx].RemoveAllocation(pHeader->Size);
+        Shard.Total.RemoveAllocation(pHeader->Size);
+    }
+    m_BaseAllocator.Free(pRawMem);
+}
+
+void TrackingMemoryAllocator::SumShards(ShardCounters& Total, std::vector<ShardCounters>& Sites, std::vector<ShardCounters>& Tags, std::vector<ShardCounters>& Subsystems) const
+{
+    for (auto& Shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        Total.Accumulate(Shard.Total);
+        for (size_t i = 0; i < std::min(Sites.size(), Shard.Sites.size()); ++i)
+            Sites[i].Accumulate(Shard.Sites[i].Counters);
+        for (size_t i = 0; i < std::min(Tags.size(), Shard.Tags.size()); ++i)
+            Tags[i].Accumulate(Shard.Tags[i]);
+        for (size_t i = 0; i < std::min(Subsystems.size(), Shard.Subsystems.size()); ++i)
+            Subsystems[i].Accumulate(Shard.Subsystems[i]);
+    }
+}
+
+TrackingMemoryAllocator::UsageStats TrackingMemoryAllocator::GetTotalStats() const
+{
+    ShardCounters              Total;
+    std::vector<ShardCounters> Empty;
+    SumShards(Total, Empty, Empty, Empty);
+    return Total.GetStats();
+}
+
+TrackingMemoryAllocator::Snapshot TrackingMemoryAllocator::GetSnapshot(size_t MaxHotSites) const
+{
+    Snapshot Snap;
+
+    std::vector<SiteStats> Sites;
+    {
+        std::lock_guard<std::mutex> Lock{m_RegistryMtx};
+
+        Snap.Tags.resize(m_Tags.size());
+        for (size_t i = 0; i < m_Tags.size(); ++i)
+            Snap.Tags[i].Name = m_Tags[i];
+
+        Snap.Subsystems.resize(m_Subsystems.size());
+        for (size_t i = 0; i < m_Subsystems.size(); ++i)
+            Snap.Subsystems[i].Name = m_Subsystems[i];
+
+        Sites.resize(m_Sites.size());
+        for (size_t i = 0; i < m_Sites.size(); ++i)
+        {
+            Sites[i].Description = m_Sites[i].Description;
+            Sites[i].FileName    = m_Sites[i].FileName;
+            Sites[i].LineNumber  = m_Sites[i].LineNumber;
+        }
+    }
+
+    // Sites, tags and subsystems that are added while the shards are being summed are ignored
+    {
+        ShardCounters              Total;
+        std::vector<ShardCounters> SiteCounters(Sites.size());
+        std::vector<ShardCounters> TagCounters(Snap.Tags.size());
+        std::vector<ShardCounters> SubsystemCounters(Snap.Subsystems.size());
+        SumShards(Total, SiteCounters, TagCounters, SubsystemCounters);
+
+        Snap.Total = Total.GetStats();
+        for (size_t i = 0; i < Sites.size(); ++i)
+            Sites[i].Stats = SiteCounters[i].GetStats();
+        for (size_t i = 0; i < Snap.Tags.size(); ++i)
+            Snap.Tags[i].Stats = TagCounters[i].GetStats();
+        for (size_t i = 0; i < Snap.Subsystems.size(); ++i)
+            Snap.Subsystems[i].Stats = SubsystemCounters[i].GetStats();
+    }
+
+    const auto SortBuckets = [](std::vector<BucketStats>& Buckets) {
+        std::sort(Buckets.begin(), Buckets.end(),
+                  [](const BucketStats& lhs, const BucketStats& rhs) {
+                      if (lhs.Stats.LiveBytes != rhs.Stats.LiveBytes)
+                          return lhs.Stats.LiveBytes > rhs.Stats.LiveBytes;
+                      return lhs.Stats.PeakLiveBytes > rhs.Stats.PeakLiveBytes;
+                  });
+    };
+    SortBuckets(Snap.Tags);
+    SortBuckets(Snap.Subsystems);
+
+    const auto NumHotSites = std::min(MaxHotSites, Sites.size());
+    std::partial_sort(Sites.begin(), Sites.begin() + NumHotSites, Sites.end(),
+                      [](const SiteStats& lhs, const SiteStats& rhs) {
+                          return lhs.Stats.NumAllocations > rhs.Stats.NumAllocations;
+                      });
+    Sites.resize(NumHotSites);
+    Snap.HotSites = std::move(Sites);
+
+    return Snap;
+}
+
+static std::ostream& operator<<(std::ostream& os, const TrackingMemoryAllocator::UsageStats& Stats)
+{
+    const auto PrintSize = [&os](Uint64 Size) {
+        if (Size >= (Uint64{1} << 20))
+            os << std::fixed << std::setprecision(2) << static_cast<double>(Size) / double{1 << 20} << " MB";
+        else if (Size >= (Uint64{1} << 10))
+            os << std::fixed << std::setprecision(2) << static_cast<double>(Size) / double{1 << 10} << " KB";
+        else
+            os << Size << " B";
+    };
+
+    os << "live ";
+    PrintSize(Stats.LiveBytes);
+    os << " in " << Stats.NumLiveAllocations << " allocations, peak ";
+    PrintSize(Stats.PeakLiveBytes);
+    os << ", total " << Stats.NumAllocations << " allocations (";
+    PrintSize(Stats.TotalAllocatedBytes);
+    os << ')';
+    return os;
+}
+
+void TrackingMemoryAllocator::DumpSnapshot(size_t MaxEntries) const
+{
+    const auto Snap = GetSnapshot(MaxEntries);
+
+    std::stringstream ss;
+    ss << "Memory usage: " << Snap.Total;
+
+    const auto PrintBuckets = [&](const char* Title, const std::vector<BucketStats>& Buckets) {
+        ss << '\n'
+           << Title << ':';
+        for (size_t i = 0; i < std::min(MaxEntries, Buckets.size()); ++i)
+            ss << "\n    " << Buckets[i].Name << ": " << Buckets[i].Stats;
+    };
+    PrintBuckets("Subsystems", Snap.Subsystems);
+    PrintBuckets("Tags", Snap.Tags);
+
+    ss << "\nHot allocation sites:";
+    for (const auto& Site : Snap.HotSites)
+        ss << "\n    '" << Site.Description << "' (" << Site.FileName << ", " << Site.LineNumber << "): " << Site.Stats;
+
+    LOG_INFO_MESSAGE(ss.str());
+}
+
+void TrackingMemoryAllocator::SetPeriodicDumpInterval(double IntervalInSeconds)
+{
+    std::lock_guard<std::mutex> Lock{m_RegistryMtx};
+
+    m_DumpInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>{std::max(IntervalInSeconds, 0.0)});
+    m_NextDumpTime = std::chrono::steady_clock::now() + m_DumpInterval;
+}
+
+void TrackingMemoryAllocator::ResetPeaks()
+{
+    for (auto& Shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        Shard.Total.ResetPeak();
+        for (auto& Site : Shard.Sites)
+            Site.Counters.ResetPeak();
+        for (auto& Tag : Shard.Tags)
+            Tag.ResetPeak();
+        for (auto& Subsystem : Shard.Subsystems)
+            Subsystem.ResetPeak();
+    }
+}
+
+} // namespace Diligent
@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "WorkerThreadPool.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+WorkerThreadPool::WorkerThreadPool(Uint32 NumWorkers) :
+    m_WorkerSignals{new ThreadingTools::Signal[NumWorkers]}
+{
+    m_Workers.reserve(NumWorkers);
+    for (Uint32 i = 0; i < NumWorkers; ++i)
+        m_Workers.emplace_back(&WorkerThreadPool::WorkerThreadFunc, this, i);
+}
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+    for (size_t i = 0; i < m_Workers.size(); ++i)
+        m_WorkerSignals[i].Trigger(false, -1);
+    for (auto& Worker : m_Workers)
+        Worker.join();
+}
+
+void WorkerThreadPool::WorkerThreadFunc(Uint32 WorkerIndex)
+{
+    auto& Signal = m_WorkerSignals[WorkerIndex];
+    for (;;)
+    {
+        if (Signal.Wait(true, 1) < 0)
+            return;
+
+        RunTasks();
+
+        if (m_NumWorkersRunning.fetch_sub(1) == 1)
+            m_TasksDoneSignal.Trigger();
+    }
+}
+
+void WorkerThreadPool::RunTasks()
+{
+    for (auto Task = m_NextTask.fetch_add(1); Task < m_NumTasks; Task = m_NextTask.fetch_add(1))
+        (*m_pTaskFunc)(Task);
+}
+
+void WorkerThreadPool::ParallelFor(Uint32 NumTasks, const TaskFuncType& TaskFunc, Uint32 MaxThreads)
+{
+    VERIFY(m_pTaskFunc == nullptr, "ParallelFor() must not be called recursively or from multiple threads");
+    if (NumTasks == 0)
+        return;
+
+    // The calling thread runs tasks too
+    const auto NumWorkersToRun = std::min({GetNumWorkers(), NumTasks - 1, std::max(MaxThreads, 1u) - 1});
+    if (NumWorkersToRun == 0)
+    {
+        for (Uint32 Task = 0; Task < NumTasks; ++Task)
+            TaskFunc(Task);
+        return;
+    }
+
+    m_pTaskFunc = &TaskFunc;
+    m_NumTasks  = NumTasks;
+    m_NextTask.store(0);
+
+    m_NumWorkersRunning.store(static_cast<int>(NumWorkersToRun));
+    for (Uint32 i = 0; i < NumWorkersToRun; ++i)
+        m_WorkerSignals[i].Trigger();
+
+    RunTasks();
+
+    m_TasksDoneSignal.Wait(true, 1);
+
+    m_pTaskFunc = nullptr;
+    m_NumTasks  = 0;
+}
+
+} // namespace Diligent
@@ -46,6 +46,21 @@ inline float SRGBToLinear(float x)
 float LinearToSRGB(Uint8 x);
 float SRGBToLinear(Uint8 x);
 
+/// Converts an array of 8-bit sRGB values to linear floating-point values.
+void SRGBToLinear(const Uint8* pSRGB, float* pLinear, size_t Count);
+
+/// Converts an array of linear floating-point values to 8-bit sRGB values.
+
+/// Input values are clamped to [0, 1] range, NaNs are converted to 0.
+/// The error does not exceed 0.6 of the 8-bit quantization step.
+void LinearToSRGB(const float* pLinear, Uint8* pSRGB, size_t Count);
+
+/// Converts an array of RGBA8 texels to RGBA16F texels.
+
+/// If IsSRGB is true, color channels are converted from sRGB to linear space.
+/// Alpha channel is always linear.
+void RGBA8ToRGBA16F(const Uint8* pRGBA8, Uint16* pRGBA16F, size_t NumTexels, bool IsSRGB);
+
 inline float FastLinearToSRGB(float x)
 {
     return x < 0.0031308f ? 12.92f * x : 1.13005f * sqrtf(std::abs(x - 0.00228f)) - 0.13448f * x + 0.005719f;
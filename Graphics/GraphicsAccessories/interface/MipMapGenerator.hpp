@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// CPU mip map generation functions
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+
+namespace Diligent
+{
+
+/// Filter that is used to compute coarse mip levels
+enum MIP_FILTER_TYPE : Uint8
+{
+    /// Box filter. Every coarse texel is the area-weighted average of the
+    /// fine texels it covers.
+    MIP_FILTER_TYPE_BOX = 0,
+
+    /// Kaiser-windowed sinc filter. Produces sharper mip levels
+    /// than the box filter at a higher cost.
+    MIP_FILTER_TYPE_KAISER,
+
+    MIP_FILTER_TYPE_NUM_TYPES
+};
+
+/// ComputeMipLevel function attributes
+struct ComputeMipLevelAttribs
+{
+    /// Texture format.
+    TEXTURE_FORMAT Format = TEX_FORMAT_UNKNOWN;
+
+    /// Fine mip level width.
+    Uint32 FineMipWidth = 0;
+
+    /// Fine mip level height.
+    Uint32 FineMipHeight = 0;
+
+    /// Pointer to the fine mip level data.
+    const void* pFineMipData = nullptr;
+
+    /// Fine mip level row stride, in bytes.
+    size_t FineMipStride = 0;
+
+    /// Pointer to the coarse mip level data.
+    /// Coarse mip level dimensions are max(FineMipWidth/2, 1) x max(FineMipHeight/2, 1).
+    void* pCoarseMipData = nullptr;
+
+    /// Coarse mip level row stride, in bytes.
+    size_t CoarseMipStride = 0;
+
+    /// Mip filter type.
+    MIP_FILTER_TYPE FilterType = MIP_FILTER_TYPE_BOX;
+
+    /// The number of threads to use. Zero means the number of hardware threads.
+    /// Rows of the coarse mip level are split between the threads.
+    Uint32 NumThreads = 1;
+};
+
+/// Returns true if mip levels of textures in the given format can be computed on the CPU.
+
+/// \remarks    All uncompressed color formats with known component types are supported, as well as
+///             D16_UNORM and D32_FLOAT depth formats. Typeless, depth-stencil, compressed
+///             and sub-sampled formats are not supported.
+bool IsMipGenerationSupported(TEXTURE_FORMAT Format);
+
+/// Computes the coarse mip level from the fine mip level.
+
+/// \remarks    All filtering is performed in linear space in 32-bit floating point precision.
+///             Color components of sRGB textures are converted to linear space before filtering
+///             and back to sRGB afterwards. Alpha is always filtered in linear space.
+void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs);
+
+
+/// Mip level data used by GenerateMipChain function
+struct MipLevelData
+{
+    /// Pointer to the mip level data.
+    void* pData = nullptr;
+
+    /// Row stride, in bytes.
+    size_t Stride = 0;
+};
+
+/// GenerateMipChain function attributes
+struct GenerateMipChainAttribs
+{
+    /// Texture format.
+    TEXTURE_FORMAT Format = TEX_FORMAT_UNKNOWN;
+
+    /// Width of the most detailed mip level.
+    Uint32 Width = 0;
+
+    /// Height of the most detailed mip level.
+    Uint32 Height = 0;
+
+    /// The number of mip levels, including the most detailed one.
+    Uint32 MipLevels = 0;
+
+    /// Pointer to the array of MipLevels mip level descriptions.
+    /// The first element must contain the data of the most detailed mip level,
+    /// all other levels are written by the function.
+    const MipLevelData* pMipLevels = nullptr;
+
+    /// Mip filter type.
+    MIP_FILTER_TYPE FilterType = MIP_FILTER_TYPE_BOX;
+
+    /// The number of threads to use. Zero means the number of hardware threads.
+    /// The threads are created once and are shared by all mip levels of the chain.
+    Uint32 NumThreads = 1;
+};
+
+/// Generates the mip chain by successively computing every mip level from the previous one.
+void GenerateMipChain(const GenerateMipChainAttribs& Attribs);
+
+} // namespace Diligent
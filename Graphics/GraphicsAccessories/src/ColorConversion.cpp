@@ -27,7 +27,18 @@
 
 #include <array>
 #include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_COLOR_CONVERSION_USE_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define DILIGENT_COLOR_CONVERSION_USE_SSE2 0
+#endif
+
 #include "ColorConversion.h"
+#include "Float16.hpp"
+#include "DebugUtilities.hpp"
 
 namespace Diligent
 {
@@ -71,10 +82,144 @@ public:
         return m_ToLinear[x];
     }
 
+    const float* GetData() const
+    {
+        return m_ToLinear.data();
+    }
+
 private:
     std::array<float, 256> m_ToLinear;
 };
 
+const SRGBToLinearMap& GetSRGBToLinearMap()
+{
+    static const SRGBToLinearMap map;
+    return map;
+}
+
+// Converts linear floats to 8-bit sRGB values using piecewise-linear approximation.
+// The range [2^-13, 1) is split into 8 buckets per octave, and every bucket stores
+// the bias and the slope of the chord connecting the bucket end points
+// (https://gist.github.com/rygorous/2203834).
+class LinearToSRGB8Map
+{
+public:
+    static constexpr Uint32 MinValueBits  = (127u - 13u) << 23u;
+    static constexpr Uint32 AlmostOneBits = 0x3F7FFFFFu; // 1 - 2^-24
+    static constexpr Uint32 BucketShift   = 20u;         // 3 mantissa bits select the bucket
+    static constexpr Uint32 NumBuckets    = 13u << (23u - BucketShift);
+
+    LinearToSRGB8Map() noexcept
+    {
+        for (Uint32 i = 0; i < NumBuckets; ++i)
+        {
+            const auto StartBits = MinValueBits + (i << BucketShift);
+            const auto EndBits   = StartBits + (1u << BucketShift);
+
+            const auto x0    = BitsToFloat(StartBits);
+            const auto x1    = BitsToFloat(EndBits);
+            const auto Start = 255.0 * LinearToSRGB(x0);
+            const auto End   = 255.0 * LinearToSRGB(x1);
+
+            // The function is concave, so the chord lies below it. Shift the chord up
+            // by half of its maximum deviation to minimize the absolute error.
+            double MaxDeviation = 0;
+            for (Uint32 s = 1; s < 64; ++s)
+            {
+                const auto w = static_cast<double>(s) / 64.0;
+                const auto x = static_cast<float>(x0 + (x1 - x0) * w);
+                MaxDeviation = std::max(MaxDeviation, 255.0 * LinearToSRGB(x) - (Start + (End - Start) * w));
+            }
+
+            // Bias is stored with 7 fractional bits and includes 0.5 for rounding.
+            // Scale is the increment per 1/256 of the bucket with 16 fractional bits.
+            const auto Bias  = static_cast<Uint32>((Start + MaxDeviation * 0.5 + 0.5) * 128.0 + 0.5);
+            const auto Scale = static_cast<Uint32>((End - Start) * 256.0 + 0.5);
+            VERIFY_EXPR(Bias <= 0xFFFFu && Scale <= 0x7FFFu);
+            m_Table[i] = (Bias << 16u) | Scale;
+        }
+    }
+
+    Uint8 operator()(float f) const
+    {
+        static constexpr float MinValue  = 1.f / 8192.f;
+        static constexpr float AlmostOne = 1.f - 1.f / 16777216.f;
+
+        // The comparison also handles NaNs
+        if (!(f > MinValue))
+            f = MinValue;
+        if (f > AlmostOne)
+            f = AlmostOne;
+
+        Uint32 Bits = 0;
+        std::memcpy(&Bits, &f, sizeof(Bits));
+
+        const auto Entry = m_Table[(Bits - MinValueBits) >> BucketShift];
+        const auto Bias  = (Entry >> 16u) << 9u;
+        const auto Scale = Entry & 0xFFFFu;
+        const auto t     = (Bits >> 12u) & 0xFFu;
+        return static_cast<Uint8>((Bias + Scale * t) >> 16u);
+    }
+
+#if DILIGENT_COLOR_CONVERSION_USE_SSE2
+    // Converts four values and returns them in the low 32 bits of the result
+    __m128i Convert4(__m128 f) const
+    {
+        const __m128 MinValue  = _mm_castsi128_ps(_mm_set1_epi32(MinValueBits));
+        const __m128 AlmostOne = _mm_castsi128_ps(_mm_set1_epi32(AlmostOneBits));
+
+        // _mm_max_ps returns the second operand if either operand is NaN
+        const __m128i Bits = _mm_castps_si128(_mm_min_ps(_mm_max_ps(f, MinValue), AlmostOne));
+
+        alignas(16) Uint32 Idx[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(Idx), _mm_srli_epi32(_mm_sub_epi32(Bits, _mm_set1_epi32(MinValueBits)), BucketShift));
+
+        const __m128i Entry = _mm_setr_epi32(static_cast<int>(m_Table[Idx[0]]), static_cast<int>(m_Table[Idx[1]]),
+                                             static_cast<int>(m_Table[Idx[2]]), static_cast<int>(m_Table[Idx[3]]));
+
+        const __m128i Bias = _mm_slli_epi32(_mm_srli_epi32(Entry, 16), 9);
+        const __m128i t    = _mm_and_si128(_mm_srli_epi32(Bits, 12), _mm_set1_epi32(0xFF));
+        // Upper 16 bits of t are zero, so madd computes Scale * t
+        const __m128i Res = _mm_srli_epi32(_mm_add_epi32(Bias, _mm_madd_epi16(Entry, t)), 16);
+
+        const __m128i Res16 = _mm_packs_epi32(Res, Res);
+        return _mm_packus_epi16(Res16, Res16);
+    }
+#endif
+
+private:
+    static float BitsToFloat(Uint32 Bits)
+    {
+        float f = 0;
+        std::memcpy(&f, &Bits, sizeof(f));
+        return f;
+    }
+
+    std::array<Uint32, NumBuckets> m_Table;
+};
+
+// Maps 8-bit values to half-precision floats
+class RGBA8ToRGBA16FMap
+{
+public:
+    RGBA8ToRGBA16FMap() noexcept
+    {
+        const auto& SRGBMap = GetSRGBToLinearMap();
+        for (Uint32 i = 0; i < 256; ++i)
+        {
+            m_UnormToHalf[i] = Float16::FloatToHalfBits(static_cast<float>(i) / 255.f);
+            m_SRGBToHalf[i]  = Float16::FloatToHalfBits(SRGBMap[static_cast<Uint8>(i)]);
+        }
+    }
+
+    const Uint16* GetUnormTable() const { return m_UnormToHalf.data(); }
+    const Uint16* GetSRGBTable() const { return m_SRGBToHalf.data(); }
+
+private:
+    std::array<Uint16, 256> m_UnormToHalf;
+    std::array<Uint16, 256> m_SRGBToHalf;
+};
+
 } // namespace
 
 float LinearToSRGB(Uint8 x)
@@ -85,8 +230,54 @@ float LinearToSRGB(Uint8 x)
 
 float SRGBToLinear(Uint8 x)
 {
-    static const SRGBToLinearMap map;
-    return map[x];
+    return GetSRGBToLinearMap()[x];
+}
+
+void SRGBToLinear(const Uint8* pSRGB, float* pLinear, size_t Count)
+{
+    const auto* Table = GetSRGBToLinearMap().GetData();
+
+    size_t i = 0;
+    for (; i + 4 <= Count; i += 4)
+    {
+        pLinear[i + 0] = Table[pSRGB[i + 0]];
+        pLinear[i + 1] = Table[pSRGB[i + 1]];
+        pLinear[i + 2] = Table[pSRGB[i + 2]];
+        pLinear[i + 3] = Table[pSRGB[i + 3]];
+    }
+    for (; i < Count; ++i)
+        pLinear[i] = Table[pSRGB[i]];
+}
+
+void LinearToSRGB(const float* pLinear, Uint8* pSRGB, size_t Count)
+{
+    static const LinearToSRGB8Map map;
+
+    size_t i = 0;
+#if DILIGENT_COLOR_CONVERSION_USE_SSE2
+    for (; i + 4 <= Count; i += 4)
+    {
+        const auto Res = _mm_cvtsi128_si32(map.Convert4(_mm_loadu_ps(pLinear + i)));
+        std::memcpy(pSRGB + i, &Res, 4);
+    }
+#endif
+    for (; i < Count; ++i)
+        pSRGB[i] = map(pLinear[i]);
+}
+
+void RGBA8ToRGBA16F(const Uint8* pRGBA8, Uint16* pRGBA16F, size_t NumTexels, bool IsSRGB)
+{
+    static const RGBA8ToRGBA16FMap map;
+
+    const auto* UnormTable = map.GetUnormTable();
+    const auto* ColorTable = IsSRGB ? map.GetSRGBTable() : UnormTable;
+    for (size_t i = 0; i < NumTexels * 4; i += 4)
+    {
+        pRGBA16F[i + 0] = ColorTable[pRGBA8[i + 0]];
+        pRGBA16F[i + 1] = ColorTable[pRGBA8[i + 1]];
+        pRGBA16F[i + 2] = ColorTable[pRGBA8[i + 2]];
+        pRGBA16F[i + 3] = UnormTable[pRGBA8[i + 3]];
+    }
 }
 
 } // namespace Diligent
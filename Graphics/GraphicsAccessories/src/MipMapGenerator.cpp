@@ -0,0 +1,861 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "MipMapGenerator.hpp"
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DILIGENT_MIP_GEN_USE_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define DILIGENT_MIP_GEN_USE_SSE2 0
+#endif
+
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "Float16.hpp"
+#include "BasicMath.hpp"
+#include "DebugUtilities.hpp"
+#include "WorkerThreadPool.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Every texel is expanded to 4 floats for filtering
+constexpr Uint32 NumFilterChannels = 4;
+
+// The number of coarse rows that are processed at once by one thread.
+// This limits the size of the intermediate buffer.
+constexpr Uint32 RowBlockSize = 64;
+
+// The minimum number of coarse rows to justify running a separate thread
+constexpr Uint32 MinRowsPerThread = 16;
+
+// Kaiser filter parameters (half-width is in coarse texels)
+constexpr float KaiserHalfWidth = 3.f;
+constexpr float KaiserAlpha     = 4.f;
+
+enum class TexelEncoding
+{
+    Unsupported,
+    Unorm,
+    Snorm,
+    Uint,
+    Sint,
+    Float,
+    UnormSRGB,
+    RGB10A2Unorm,
+    RGB10A2Uint,
+    R11G11B10Float,
+    RGB9E5,
+    B5G6R5Unorm,
+    B5G5R5A1Unorm
+};
+
+struct TexelFormatInfo
+{
+    TexelEncoding Encoding      = TexelEncoding::Unsupported;
+    Uint32        ComponentSize = 0;
+    Uint32        NumComponents = 0;
+};
+
+TexelFormatInfo GetTexelFormatInfo(TEXTURE_FORMAT Format)
+{
+    TexelFormatInfo Info;
+    if (Format == TEX_FORMAT_UNKNOWN || Format >= TEX_FORMAT_NUM_FORMATS)
+        return Info;
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    if (FmtAttribs.IsTypeless)
+        return Info;
+
+    Info.ComponentSize = FmtAttribs.ComponentSize;
+    Info.NumComponents = FmtAttribs.NumComponents;
+
+    // clang-format off
+    switch (Format)
+    {
+        case TEX_FORMAT_RGB10A2_UNORM:     Info.Encoding = TexelEncoding::RGB10A2Unorm;   return Info;
+        case TEX_FORMAT_RGB10A2_UINT:      Info.Encoding = TexelEncoding::RGB10A2Uint;    return Info;
+        case TEX_FORMAT_R11G11B10_FLOAT:   Info.Encoding = TexelEncoding::R11G11B10Float; return Info;
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:  Info.Encoding = TexelEncoding::RGB9E5;         return Info;
+        case TEX_FORMAT_B5G6R5_UNORM:      Info.Encoding = TexelEncoding::B5G6R5Unorm;    return Info;
+        case TEX_FORMAT_B5G5R5A1_UNORM:    Info.Encoding = TexelEncoding::B5G5R5A1Unorm;  return Info;
+
+        case TEX_FORMAT_R1_UNORM:
+        case TEX_FORMAT_RG8_B8G8_UNORM:
+        case TEX_FORMAT_G8R8_G8B8_UNORM:
+            return Info;
+
+        default:
+            break;
+    }
+    // clang-format on
+
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_FLOAT:
+            Info.Encoding = TexelEncoding::Float;
+            break;
+
+        case COMPONENT_TYPE_SNORM:
+            Info.Encoding = TexelEncoding::Snorm;
+            break;
+
+        case COMPONENT_TYPE_UNORM:
+            Info.Encoding = TexelEncoding::Unorm;
+            break;
+
+        case COMPONENT_TYPE_UNORM_SRGB:
+            Info.Encoding = TexelEncoding::UnormSRGB;
+            break;
+
+        case COMPONENT_TYPE_SINT:
+            Info.Encoding = TexelEncoding::Sint;
+            break;
+
+        case COMPONENT_TYPE_UINT:
+            Info.Encoding = TexelEncoding::Uint;
+            break;
+
+        case COMPONENT_TYPE_DEPTH:
+            // D16_UNORM or D32_FLOAT
+            Info.Encoding = FmtAttribs.ComponentSize == 2 ? TexelEncoding::Unorm : TexelEncoding::Float;
+            break;
+
+        default:
+            break;
+    }
+
+    return Info;
+}
+
+
+template <typename ComponentType, typename DecodeFuncType>
+void DecodeComponents(const void* pSrc, Uint32 Width, Uint32 NumComponents, float* pDst, DecodeFuncType Decode)
+{
+    const auto* pSrcComps = static_cast<const ComponentType*>(pSrc);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            pDst[x * NumFilterChannels + c] = Decode(pSrcComps[x * NumComponents + c], c);
+        for (Uint32 c = NumComponents; c < NumFilterChannels; ++c)
+            pDst[x * NumFilterChannels + c] = 0;
+    }
+}
+
+template <typename ComponentType, typename EncodeFuncType>
+void EncodeComponents(const float* pSrc, Uint32 Width, Uint32 NumComponents, void* pDst, EncodeFuncType Encode)
+{
+    auto* pDstComps = static_cast<ComponentType*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x)
+    {
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            pDstComps[x * NumComponents + c] = Encode(pSrc[x * NumFilterChannels + c], c);
+    }
+}
+
+template <typename PackedType, typename DecodeFuncType>
+void DecodePacked(const void* pSrc, Uint32 Width, float* pDst, DecodeFuncType Decode)
+{
+    const auto* pSrcTexels = static_cast<const PackedType*>(pSrc);
+    for (Uint32 x = 0; x < Width; ++x)
+        Decode(pSrcTexels[x], pDst + x * NumFilterChannels);
+}
+
+template <typename PackedType, typename EncodeFuncType>
+void EncodePacked(const float* pSrc, Uint32 Width, void* pDst, EncodeFuncType Encode)
+{
+    auto* pDstTexels = static_cast<PackedType*>(pDst);
+    for (Uint32 x = 0; x < Width; ++x)
+        pDstTexels[x] = Encode(pSrc + x * NumFilterChannels);
+}
+
+inline float Saturate(float f)
+{
+    return std::min(std::max(f, 0.f), 1.f);
+}
+
+template <typename IntType>
+IntType UnormFromFloat(float f, Uint32 MaxValue)
+{
+    return static_cast<IntType>(Saturate(f) * static_cast<float>(MaxValue) + 0.5f);
+}
+
+template <typename IntType>
+IntType SnormFromFloat(float f, Uint32 MaxValue)
+{
+    f = std::min(std::max(f, -1.f), 1.f) * static_cast<float>(MaxValue);
+    return static_cast<IntType>(f >= 0 ? f + 0.5f : f - 0.5f);
+}
+
+template <typename IntType>
+IntType UintFromFloat(float f)
+{
+    // Use double to correctly handle 32-bit integers
+    const double d = std::min(std::max(static_cast<double>(f) + 0.5, 0.0), static_cast<double>(std::numeric_limits<IntType>::max()));
+    return static_cast<IntType>(d);
+}
+
+template <typename IntType>
+IntType SintFromFloat(float f)
+{
+    double d = static_cast<double>(f);
+    d        = d >= 0 ? d + 0.5 : d - 0.5;
+    d        = std::min(std::max(d, static_cast<double>(std::numeric_limits<IntType>::min())), static_cast<double>(std::numeric_limits<IntType>::max()));
+    return static_cast<IntType>(d);
+}
+
+// Unsigned 11- and 10-bit floats have 5-bit exponent and 6- and 5-bit mantissa
+// respectively, and can be converted from/to half-precision floats by shifting the bits.
+inline float SmallFloatToFloat(Uint32 Bits, Uint32 MantissaShift)
+{
+    return Float16::HalfBitsToFloat(static_cast<Uint16>(Bits << MantissaShift));
+}
+
+inline Uint32 FloatToSmallFloat(float f, Uint32 MantissaShift)
+{
+    if (f != f)
+        return (0x7C00u >> MantissaShift) | 1u; // NaN
+
+    Uint32 HalfBits = Float16::FloatToHalfBits(f > 0 ? f : 0.f);
+    if (HalfBits >= 0x7C00u)
+        return 0x7C00u >> MantissaShift; // Infinity
+
+    // Round to nearest even
+    HalfBits += ((1u << (MantissaShift - 1u)) - 1u) + ((HalfBits >> MantissaShift) & 1u);
+    // Clamp to the maximum finite value
+    return std::min(HalfBits >> MantissaShift, (0x7C00u >> MantissaShift) - 1u);
+}
+
+void DecodeRGB9E5(Uint32 Texel, float* pDst)
+{
+    const auto Exponent = static_cast<int>(Texel >> 27u);
+    const auto Scale    = std::ldexp(1.f, Exponent - 15 - 9);
+
+    pDst[0] = static_cast<float>((Texel >> 0u) & 0x1FFu) * Scale;
+    pDst[1] = static_cast<float>((Texel >> 9u) & 0x1FFu) * Scale;
+    pDst[2] = static_cast<float>((Texel >> 18u) & 0x1FFu) * Scale;
+    pDst[3] = 1;
+}
+
+Uint32 EncodeRGB9E5(const float* pSrc)
+{
+    // https://www.khronos.org/registry/OpenGL/extensions/EXT/EXT_texture_shared_exponent.txt
+    constexpr float MaxValue = static_cast<float>(0x1FF << 7);
+
+    float rgb[3];
+    for (Uint32 c = 0; c < 3; ++c)
+        rgb[c] = pSrc[c] == pSrc[c] ? std::min(std::max(pSrc[c], 0.f), MaxValue) : 0.f;
+
+    const float MaxRGB = std::max(std::max(rgb[0], rgb[1]), rgb[2]);
+    if (MaxRGB == 0)
+        return 0;
+
+    int Exponent = 0;
+    std::frexp(MaxRGB, &Exponent);
+    int SharedExp = std::max(-16, Exponent - 1) + 1 + 15;
+
+    float Scale = std::ldexp(1.f, SharedExp - 15 - 9);
+    if (static_cast<Uint32>(MaxRGB / Scale + 0.5f) == 512)
+    {
+        Scale *= 2;
+        ++SharedExp;
+    }
+
+    Uint32 Texel = static_cast<Uint32>(SharedExp) << 27u;
+    for (Uint32 c = 0; c < 3; ++c)
+        Texel |= std::min(static_cast<Uint32>(rgb[c] / Scale + 0.5f), 0x1FFu) << (c * 9u);
+    return Texel;
+}
+
+void DecodeRow(const TexelFormatInfo& Fmt, const void* pSrc, Uint32 Width, float* pDst)
+{
+    const auto NumComps = Fmt.NumComponents;
+    switch (Fmt.Encoding)
+    {
+        case TexelEncoding::Unorm:
+            if (Fmt.ComponentSize == 1)
+                DecodeComponents<Uint8>(pSrc, Width, NumComps, pDst, [](Uint8 v, Uint32) { return static_cast<float>(v) / 255.f; });
+            else
+                DecodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](Uint16 v, Uint32) { return static_cast<float>(v) / 65535.f; });
+            break;
+
+        case TexelEncoding::Snorm:
+            if (Fmt.ComponentSize == 1)
+                DecodeComponents<Int8>(pSrc, Width, NumComps, pDst, [](Int8 v, Uint32) { return std::max(static_cast<float>(v) / 127.f, -1.f); });
+            else
+                DecodeComponents<Int16>(pSrc, Width, NumComps, pDst, [](Int16 v, Uint32) { return std::max(static_cast<float>(v) / 32767.f, -1.f); });
+            break;
+
+        case TexelEncoding::Uint:
+            if (Fmt.ComponentSize == 1)
+                DecodeComponents<Uint8>(pSrc, Width, NumComps, pDst, [](Uint8 v, Uint32) { return static_cast<float>(v); });
+            else if (Fmt.ComponentSize == 2)
+                DecodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](Uint16 v, Uint32) { return static_cast<float>(v); });
+            else
+                DecodeComponents<Uint32>(pSrc, Width, NumComps, pDst, [](Uint32 v, Uint32) { return static_cast<float>(v); });
+            break;
+
+        case TexelEncoding::Sint:
+            if (Fmt.ComponentSize == 1)
+                DecodeComponents<Int8>(pSrc, Width, NumComps, pDst, [](Int8 v, Uint32) { return static_cast<float>(v); });
+            else if (Fmt.ComponentSize == 2)
+                DecodeComponents<Int16>(pSrc, Width, NumComps, pDst, [](Int16 v, Uint32) { return static_cast<float>(v); });
+            else
+                DecodeComponents<Int32>(pSrc, Width, NumComps, pDst, [](Int32 v, Uint32) { return static_cast<float>(v); });
+            break;
+
+        case TexelEncoding::Float:
+            if (Fmt.ComponentSize == 2)
+                DecodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](Uint16 v, Uint32) { return Float16::HalfBitsToFloat(v); });
+            else
+                DecodeComponents<float>(pSrc, Width, NumComps, pDst, [](float v, Uint32) { return v; });
+            break;
+
+        case TexelEncoding::UnormSRGB:
+        {
+            // All sRGB formats have four components
+            VERIFY_EXPR(NumComps == NumFilterChannels);
+            SRGBToLinear(static_cast<const Uint8*>(pSrc), pDst, size_t{Width} * NumFilterChannels);
+            // Alpha channel is always linear
+            const auto* pSrcComps = static_cast<const Uint8*>(pSrc);
+            for (Uint32 x = 0; x < Width; ++x)
+                pDst[x * NumFilterChannels + 3] = static_cast<float>(pSrcComps[x * NumFilterChannels + 3]) / 255.f;
+            break;
+        }
+
+        case TexelEncoding::RGB10A2Unorm:
+        case TexelEncoding::RGB10A2Uint:
+        {
+            const float Scale  = Fmt.Encoding == TexelEncoding::RGB10A2Unorm ? 1.f / 1023.f : 1.f;
+            const float AScale = Fmt.Encoding == TexelEncoding::RGB10A2Unorm ? 1.f / 3.f : 1.f;
+            DecodePacked<Uint32>(pSrc, Width, pDst,
+                                 [Scale, AScale](Uint32 Texel, float* pTexel) //
+                                 {
+                                     pTexel[0] = static_cast<float>((Texel >> 0u) & 0x3FFu) * Scale;
+                                     pTexel[1] = static_cast<float>((Texel >> 10u) & 0x3FFu) * Scale;
+                                     pTexel[2] = static_cast<float>((Texel >> 20u) & 0x3FFu) * Scale;
+                                     pTexel[3] = static_cast<float>((Texel >> 30u) & 0x3u) * AScale;
+                                 });
+            break;
+        }
+
+        case TexelEncoding::R11G11B10Float:
+            DecodePacked<Uint32>(pSrc, Width, pDst,
+                                 [](Uint32 Texel, float* pTexel) //
+                                 {
+                                     pTexel[0] = SmallFloatToFloat((Texel >> 0u) & 0x7FFu, 4);
+                                     pTexel[1] = SmallFloatToFloat((Texel >> 11u) & 0x7FFu, 4);
+                                     pTexel[2] = SmallFloatToFloat((Texel >> 22u) & 0x3FFu, 5);
+                                     pTexel[3] = 1;
+                                 });
+            break;
+
+        case TexelEncoding::RGB9E5:
+            DecodePacked<Uint32>(pSrc, Width, pDst, DecodeRGB9E5);
+            break;
+
+        case TexelEncoding::B5G6R5Unorm:
+            DecodePacked<Uint16>(pSrc, Width, pDst,
+                                 [](Uint16 Texel, float* pTexel) //
+                                 {
+                                     pTexel[0] = static_cast<float>((Texel >> 0u) & 0x1Fu) / 31.f;
+                                     pTexel[1] = static_cast<float>((Texel >> 5u) & 0x3Fu) / 63.f;
+                                     pTexel[2] = static_cast<float>((Texel >> 11u) & 0x1Fu) / 31.f;
+                                     pTexel[3] = 1;
+                                 });
+            break;
+
+        case TexelEncoding::B5G5R5A1Unorm:
+            DecodePacked<Uint16>(pSrc, Width, pDst,
+                                 [](Uint16 Texel, float* pTexel) //
+                                 {
+                                     pTexel[0] = static_cast<float>((Texel >> 0u) & 0x1Fu) / 31.f;
+                                     pTexel[1] = static_cast<float>((Texel >> 5u) & 0x1Fu) / 31.f;
+                                     pTexel[2] = static_cast<float>((Texel >> 10u) & 0x1Fu) / 31.f;
+                                     pTexel[3] = static_cast<float>((Texel >> 15u) & 0x01u);
+                                 });
+            break;
+
+        default:
+            UNEXPECTED("Unexpected texel encoding");
+    }
+}
+
+void EncodeRow(const TexelFormatInfo& Fmt, const float* pSrc, Uint32 Width, void* pDst)
+{
+    const auto NumComps = Fmt.NumComponents;
+    switch (Fmt.Encoding)
+    {
+        case TexelEncoding::Unorm:
+            if (Fmt.ComponentSize == 1)
+                EncodeComponents<Uint8>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return UnormFromFloat<Uint8>(f, 255); });
+            else
+                EncodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return UnormFromFloat<Uint16>(f, 65535); });
+            break;
+
+        case TexelEncoding::Snorm:
+            if (Fmt.ComponentSize == 1)
+                EncodeComponents<Int8>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return SnormFromFloat<Int8>(f, 127); });
+            else
+                EncodeComponents<Int16>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return SnormFromFloat<Int16>(f, 32767); });
+            break;
+
+        case TexelEncoding::Uint:
+            if (Fmt.ComponentSize == 1)
+                EncodeComponents<Uint8>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return UintFromFloat<Uint8>(f); });
+            else if (Fmt.ComponentSize == 2)
+                EncodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return UintFromFloat<Uint16>(f); });
+            else
+                EncodeComponents<Uint32>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return UintFromFloat<Uint32>(f); });
+            break;
+
+        case TexelEncoding::Sint:
+            if (Fmt.ComponentSize == 1)
+                EncodeComponents<Int8>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return SintFromFloat<Int8>(f); });
+            else if (Fmt.ComponentSize == 2)
+                EncodeComponents<Int16>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return SintFromFloat<Int16>(f); });
+            else
+                EncodeComponents<Int32>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return SintFromFloat<Int32>(f); });
+            break;
+
+        case TexelEncoding::Float:
+            if (Fmt.ComponentSize == 2)
+                EncodeComponents<Uint16>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return Float16::FloatToHalfBits(f); });
+            else
+                EncodeComponents<float>(pSrc, Width, NumComps, pDst, [](float f, Uint32) { return f; });
+            break;
+
+        case TexelEncoding::UnormSRGB:
+        {
+            VERIFY_EXPR(NumComps == NumFilterChannels);
+            auto* pDstComps = static_cast<Uint8*>(pDst);
+            LinearToSRGB(pSrc, pDstComps, size_t{Width} * NumFilterChannels);
+            for (Uint32 x = 0; x < Width; ++x)
+                pDstComps[x * NumFilterChannels + 3] = UnormFromFloat<Uint8>(pSrc[x * NumFilterChannels + 3], 255);
+            break;
+        }
+
+        case TexelEncoding::RGB10A2Unorm:
+            EncodePacked<Uint32>(pSrc, Width, pDst,
+                                 [](const float* pTexel) //
+                                 {
+                                     return (UnormFromFloat<Uint32>(pTexel[0], 1023) << 0u) |
+                                         (UnormFromFloat<Uint32>(pTexel[1], 1023) << 10u) |
+                                         (UnormFromFloat<Uint32>(pTexel[2], 1023) << 20u) |
+                                         (UnormFromFloat<Uint32>(pTexel[3], 3) << 30u);
+                                 });
+            break;
+
+        case TexelEncoding::RGB10A2Uint:
+            EncodePacked<Uint32>(pSrc, Width, pDst,
+                                 [](const float* pTexel) //
+                                 {
+                                     return (std::min(UintFromFloat<Uint32>(pTexel[0]), 1023u) << 0u) |
+                                         (std::min(UintFromFloat<Uint32>(pTexel[1]), 1023u) << 10u) |
+                                         (std::min(UintFromFloat<Uint32>(pTexel[2]), 1023u) << 20u) |
+                                         (std::min(UintFromFloat<Uint32>(pTexel[3]), 3u) << 30u);
+                                 });
+            break;
+
+        case TexelEncoding::R11G11B10Float:
+            EncodePacked<Uint32>(pSrc, Width, pDst,
+                                 [](const float* pTexel) //
+                                 {
+                                     return (FloatToSmallFloat(pTexel[0], 4) << 0u) |
+                                         (FloatToSmallFloat(pTexel[1], 4) << 11u) |
+                                         (FloatToSmallFloat(pTexel[2], 5) << 22u);
+                                 });
+            break;
+
+        case TexelEncoding::RGB9E5:
+            EncodePacked<Uint32>(pSrc, Width, pDst, EncodeRGB9E5);
+            break;
+
+        case TexelEncoding::B5G6R5Unorm:
+            EncodePacked<Uint16>(pSrc, Width, pDst,
+                                 [](const float* pTexel) //
+                                 {
+                                     return static_cast<Uint16>((UnormFromFloat<Uint32>(pTexel[0], 31) << 0u) |
+                                                                (UnormFromFloat<Uint32>(pTexel[1], 63) << 5u) |
+                                                                (UnormFromFloat<Uint32>(pTexel[2], 31) << 11u));
+                                 });
+            break;
+
+        case TexelEncoding::B5G5R5A1Unorm:
+            EncodePacked<Uint16>(pSrc, Width, pDst,
+                                 [](const float* pTexel) //
+                                 {
+                                     return static_cast<Uint16>((UnormFromFloat<Uint32>(pTexel[0], 31) << 0u) |
+                                                                (UnormFromFloat<Uint32>(pTexel[1], 31) << 5u) |
+                                                                (UnormFromFloat<Uint32>(pTexel[2], 31) << 10u) |
+                                                                (UnormFromFloat<Uint32>(pTexel[3], 1) << 15u));
+                                 });
+            break;
+
+        default:
+            UNEXPECTED("Unexpected texel encoding");
+    }
+}
+
+
+// Separable 1D filter kernel that maps fine texels to coarse texels
+struct FilterKernel
+{
+    // Taps of coarse texel i are [Offsets[i], Offsets[i+1])
+    std::vector<Uint32> Offsets;
+    std::vector<Uint32> Indices;
+    std::vector<float>  Weights;
+};
+
+float Sinc(float x)
+{
+    if (std::abs(x) < 1e-4f)
+        return 1.f;
+
+    x *= PI_F;
+    return std::sin(x) / x;
+}
+
+// Zeroth-order modified Bessel function of the first kind
+float BesselI0(float x)
+{
+    const float HalfX2 = x * x * 0.25f;
+
+    float Sum  = 1;
+    float Term = 1;
+    for (int k = 1; k < 64 && Term > Sum * 1e-8f; ++k)
+    {
+        Term *= HalfX2 / static_cast<float>(k * k);
+        Sum += Term;
+    }
+    return Sum;
+}
+
+float KaiserWindowedSinc(float x)
+{
+    if (std::abs(x) >= KaiserHalfWidth)
+        return 0;
+
+    const float t = x / KaiserHalfWidth;
+    return Sinc(x) * BesselI0(KaiserAlpha * std::sqrt(1.f - t * t)) / BesselI0(KaiserAlpha);
+}
+
+FilterKernel BuildFilterKernel(Uint32 FineSize, Uint32 CoarseSize, MIP_FILTER_TYPE FilterType)
+{
+    FilterKernel Kernel;
+    Kernel.Offsets.reserve(size_t{CoarseSize} + 1);
+
+    const float Scale = static_cast<float>(FineSize) / static_cast<float>(CoarseSize);
+    for (Uint32 x = 0; x < CoarseSize; ++x)
+    {
+        const auto FirstTap = Kernel.Indices.size();
+        Kernel.Offsets.push_back(static_cast<Uint32>(FirstTap));
+
+        const float Start  = static_cast<float>(x) * Scale;
+        const float End    = static_cast<float>(x + 1) * Scale;
+        const float Center = (Start + End) * 0.5f;
+
+        int FirstFine = 0, LastFine = 0;
+        if (FilterType == MIP_FILTER_TYPE_KAISER)
+        {
+            FirstFine = static_cast<int>(std::floor(Center - KaiserHalfWidth * Scale));
+            LastFine  = static_cast<int>(std::ceil(Center + KaiserHalfWidth * Scale));
+        }
+        else
+        {
+            FirstFine = static_cast<int>(std::floor(Start));
+            LastFine  = static_cast<int>(std::ceil(End));
+        }
+
+        float TotalWeight = 0;
+        for (int i = FirstFine; i < LastFine; ++i)
+        {
+            float Weight = 0;
+            if (FilterType == MIP_FILTER_TYPE_KAISER)
+            {
+                Weight = KaiserWindowedSinc((static_cast<float>(i) + 0.5f - Center) / Scale);
+            }
+            else
+            {
+                // Area of the fine texel covered by the coarse texel footprint
+                Weight = std::min(static_cast<float>(i + 1), End) - std::max(static_cast<float>(i), Start);
+            }
+            if (Weight == 0)
+                continue;
+
+            // Clamp texture address mode. Since indices are monotonic, clamped
+            // duplicates are always adjacent and can be merged.
+            const auto Index = static_cast<Uint32>(std::min(std::max(i, 0), static_cast<int>(FineSize) - 1));
+            if (Kernel.Indices.size() > FirstTap && Kernel.Indices.back() == Index)
+            {
+                Kernel.Weights.back() += Weight;
+            }
+            else
+            {
+                Kernel.Indices.push_back(Index);
+                Kernel.Weights.push_back(Weight);
+            }
+            TotalWeight += Weight;
+        }
+        VERIFY_EXPR(Kernel.Indices.size() > FirstTap && TotalWeight != 0);
+
+        for (size_t t = FirstTap; t < Kernel.Weights.size(); ++t)
+            Kernel.Weights[t] /= TotalWeight;
+    }
+    Kernel.Offsets.push_back(static_cast<Uint32>(Kernel.Indices.size()));
+
+    return Kernel;
+}
+
+
+// Filters one row of 4-channel texels
+void FilterRow(const float* pSrc, const FilterKernel& Kernel, Uint32 DstWidth, float* pDst)
+{
+    for (Uint32 x = 0; x < DstWidth; ++x)
+    {
+        const auto FirstTap = Kernel.Offsets[x];
+        const auto LastTap  = Kernel.Offsets[x + 1];
+#if DILIGENT_MIP_GEN_USE_SSE2
+        __m128 Acc = _mm_setzero_ps();
+        for (auto t = FirstTap; t < LastTap; ++t)
+        {
+            const __m128 Texel = _mm_loadu_ps(pSrc + Kernel.Indices[t] * NumFilterChannels);
+            Acc                = _mm_add_ps(Acc, _mm_mul_ps(Texel, _mm_set1_ps(Kernel.Weights[t])));
+        }
+        _mm_storeu_ps(pDst + x * NumFilterChannels, Acc);
+#else
+        float Acc[NumFilterChannels] = {};
+        for (auto t = FirstTap; t < LastTap; ++t)
+        {
+            const auto* pTexel = pSrc + Kernel.Indices[t] * NumFilterChannels;
+            const auto  Weight = Kernel.Weights[t];
+            for (Uint32 c = 0; c < NumFilterChannels; ++c)
+                Acc[c] += pTexel[c] * Weight;
+        }
+        for (Uint32 c = 0; c < NumFilterChannels; ++c)
+            pDst[x * NumFilterChannels + c] = Acc[c];
+#endif
+    }
+}
+
+// Computes pDst += pSrc * Weight
+void AccumulateRow(const float* pSrc, float Weight, size_t NumFloats, float* pDst)
+{
+    VERIFY_EXPR(NumFloats % NumFilterChannels == 0);
+#if DILIGENT_MIP_GEN_USE_SSE2
+    const __m128 w = _mm_set1_ps(Weight);
+    for (size_t i = 0; i < NumFloats; i += 4)
+    {
+        const __m128 Src = _mm_loadu_ps(pSrc + i);
+        _mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_mul_ps(Src, w)));
+    }
+#else
+    for (size_t i = 0; i < NumFloats; ++i)
+        pDst[i] += pSrc[i] * Weight;
+#endif
+}
+
+class MipLevelComputer
+{
+public:
+    MipLevelComputer(const ComputeMipLevelAttribs& Attribs, const TexelFormatInfo& Fmt) :
+        m_Attribs{Attribs},
+        m_Fmt{Fmt},
+        m_CoarseWidth{std::max(Attribs.FineMipWidth / 2u, 1u)},
+        m_CoarseHeight{std::max(Attribs.FineMipHeight / 2u, 1u)},
+        m_HorzKernel{BuildFilterKernel(Attribs.FineMipWidth, m_CoarseWidth, Attribs.FilterType)},
+        m_VertKernel{BuildFilterKernel(Attribs.FineMipHeight, m_CoarseHeight, Attribs.FilterType)}
+    {}
+
+    Uint32 GetCoarseHeight() const { return m_CoarseHeight; }
+
+    // Computes coarse rows [StartRow, EndRow)
+    void ComputeRows(Uint32 StartRow, Uint32 EndRow) const
+    {
+        const size_t CoarseRowSize = size_t{m_CoarseWidth} * NumFilterChannels;
+
+        std::vector<float> FineRow(size_t{m_Attribs.FineMipWidth} * NumFilterChannels);
+        std::vector<float> CoarseRow(CoarseRowSize);
+        std::vector<float> HorzFilteredRows;
+
+        for (auto BlockStart = StartRow; BlockStart < EndRow; BlockStart += RowBlockSize)
+        {
+            const auto BlockEnd = std::min(BlockStart + RowBlockSize, EndRow);
+
+            // Fine rows referenced by the block are contiguous
+            const auto FirstFineRow = m_VertKernel.Indices[m_VertKernel.Offsets[BlockStart]];
+            const auto LastFineRow  = m_VertKernel.Indices[m_VertKernel.Offsets[BlockEnd] - 1];
+            VERIFY_EXPR(FirstFineRow <= LastFineRow);
+
+            HorzFilteredRows.resize((LastFineRow - FirstFineRow + 1) * CoarseRowSize);
+            for (auto FineRowIdx = FirstFineRow; FineRowIdx <= LastFineRow; ++FineRowIdx)
+            {
+                const auto* pSrcRow = static_cast<const Uint8*>(m_Attribs.pFineMipData) + FineRowIdx * m_Attribs.FineMipStride;
+                DecodeRow(m_Fmt, pSrcRow, m_Attribs.FineMipWidth, FineRow.data());
+                FilterRow(FineRow.data(), m_HorzKernel, m_CoarseWidth, &HorzFilteredRows[(FineRowIdx - FirstFineRow) * CoarseRowSize]);
+            }
+
+            for (auto y = BlockStart; y < BlockEnd; ++y)
+            {
+                std::fill(CoarseRow.begin(), CoarseRow.end(), 0.f);
+                for (auto t = m_VertKernel.Offsets[y]; t < m_VertKernel.Offsets[y + 1]; ++t)
+                {
+                    const auto FineRowIdx = m_VertKernel.Indices[t];
+                    VERIFY_EXPR(FineRowIdx >= FirstFineRow && FineRowIdx <= LastFineRow);
+                    AccumulateRow(&HorzFilteredRows[(FineRowIdx - FirstFineRow) * CoarseRowSize], m_VertKernel.Weights[t], CoarseRowSize, CoarseRow.data());
+                }
+
+                auto* pDstRow = static_cast<Uint8*>(m_Attribs.pCoarseMipData) + y * m_Attribs.CoarseMipStride;
+                EncodeRow(m_Fmt, CoarseRow.data(), m_CoarseWidth, pDstRow);
+            }
+        }
+    }
+
+private:
+    const ComputeMipLevelAttribs& m_Attribs;
+    const TexelFormatInfo&        m_Fmt;
+
+    const Uint32 m_CoarseWidth;
+    const Uint32 m_CoarseHeight;
+
+    const FilterKernel m_HorzKernel;
+    const FilterKernel m_VertKernel;
+};
+
+Uint32 GetNumMipThreads(Uint32 RequestedThreads, Uint32 CoarseHeight)
+{
+    const auto NumThreads = RequestedThreads != 0 ? RequestedThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    return std::min(NumThreads, std::max(CoarseHeight / MinRowsPerThread, 1u));
+}
+
+// Computes the coarse mip level using the calling thread and the workers of the pool, if provided
+bool ComputeMipLevelImpl(const ComputeMipLevelAttribs& Attribs, WorkerThreadPool* pPool)
+{
+    const auto Fmt = GetTexelFormatInfo(Attribs.Format);
+    if (Fmt.Encoding == TexelEncoding::Unsupported)
+    {
+        LOG_ERROR_MESSAGE("Mip generation is not supported for ", GetTextureFormatAttribs(Attribs.Format).Name, " format");
+        return false;
+    }
+
+    DEV_CHECK_ERR(Attribs.FineMipWidth > 0 && Attribs.FineMipHeight > 0, "Fine mip level must not be empty");
+    DEV_CHECK_ERR(Attribs.pFineMipData != nullptr, "Fine mip level data must not be null");
+    DEV_CHECK_ERR(Attribs.pCoarseMipData != nullptr, "Coarse mip level data must not be null");
+    DEV_CHECK_ERR(Attribs.FilterType < MIP_FILTER_TYPE_NUM_TYPES, "Invalid filter type");
+#ifdef DILIGENT_DEVELOPMENT
+    {
+        const auto TexelSize = GetTextureFormatAttribs(Attribs.Format).GetElementSize();
+        DEV_CHECK_ERR(Attribs.FineMipStride >= size_t{Attribs.FineMipWidth} * TexelSize, "Fine mip level stride is too small");
+        DEV_CHECK_ERR(Attribs.CoarseMipStride >= size_t{std::max(Attribs.FineMipWidth / 2u, 1u)} * TexelSize, "Coarse mip level stride is too small");
+    }
+#endif
+
+    const MipLevelComputer Computer{Attribs, Fmt};
+
+    const auto CoarseHeight = Computer.GetCoarseHeight();
+
+    // Small mip levels are computed by the calling thread only
+    const auto NumRanges = pPool != nullptr ? GetNumMipThreads(pPool->GetNumWorkers() + 1, CoarseHeight) : 1u;
+    if (NumRanges <= 1)
+    {
+        Computer.ComputeRows(0, CoarseHeight);
+        return true;
+    }
+
+    // Every thread processes one contiguous range of rows, which minimizes the number
+    // of fine rows that are filtered horizontally by more than one thread.
+    const auto RowsPerRange = (CoarseHeight + NumRanges - 1) / NumRanges;
+    pPool->ParallelFor(NumRanges,
+                       [&Computer, CoarseHeight, RowsPerRange](Uint32 Range) {
+                           const auto StartRow = std::min(Range * RowsPerRange, CoarseHeight);
+                           const auto EndRow   = std::min(StartRow + RowsPerRange, CoarseHeight);
+                           if (StartRow < EndRow)
+                               Computer.ComputeRows(StartRow, EndRow);
+                       });
+
+    return true;
+}
+
+} // namespace
+
+bool IsMipGenerationSupported(TEXTURE_FORMAT Format)
+{
+    return GetTexelFormatInfo(Format).Encoding != TexelEncoding::Unsupported;
+}
+
+void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
+{
+    const auto NumThreads = GetNumMipThreads(Attribs.NumThreads, std::max(Attribs.FineMipHeight / 2u, 1u));
+
+    std::unique_ptr<WorkerThreadPool> pPool;
+    if (NumThreads > 1)
+        pPool.reset(new WorkerThreadPool{NumThreads - 1});
+
+    ComputeMipLevelImpl(Attribs, pPool.get());
+}
+
+void GenerateMipChain(const GenerateMipChainAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.pMipLevels != nullptr || Attribs.MipLevels == 0, "Mip levels must not be null");
+    if (Attribs.MipLevels <= 1)
+        return;
+
+    // Worker threads are created once for the entire chain. The first coarse mip level is
+    // the largest one, so it determines the maximum number of threads that can be used.
+    const auto NumThreads = GetNumMipThreads(Attribs.NumThreads, std::max(Attribs.Height / 2u, 1u));
+
+    std::unique_ptr<WorkerThreadPool> pPool;
+    if (NumThreads > 1)
+        pPool.reset(new WorkerThreadPool{NumThreads - 1});
+
+    ComputeMipLevelAttribs MipAttribs;
+    MipAttribs.Format     = Attribs.Format;
+    MipAttribs.FilterType = Attribs.FilterType;
+    for (Uint32 Mip = 1; Mip < Attribs.MipLevels; ++Mip)
+    {
+        MipAttribs.FineMipWidth    = std::max(Attribs.Width >> (Mip - 1), 1u);
+        MipAttribs.FineMipHeight   = std::max(Attribs.Height >> (Mip - 1), 1u);
+        MipAttribs.pFineMipData    = Attribs.pMipLevels[Mip - 1].pData;
+        MipAttribs.FineMipStride   = Attribs.pMipLevels[Mip - 1].Stride;
+        MipAttribs.pCoarseMipData  = Attribs.pMipLevels[Mip].pData;
+        MipAttribs.CoarseMipStride = Attribs.pMipLevels[Mip].Stride;
+        if (!ComputeMipLevelImpl(MipAttribs, pPool.get()))
+            break;
+    }
+}
+
+} // namespace Diligent
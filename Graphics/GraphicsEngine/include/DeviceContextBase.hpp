@@ -1381,6 +1381,8 @@ void DeviceContextBase<BaseInterface, ImplementationTraits>::
                   "Source texture '", SrcTexDesc.Name, "' of a resolve operation is not multi-sampled");
     DEV_CHECK_ERR(DstTexDesc.SampleCount == 1,
                   "Destination texture '", DstTexDesc.Name, "' of a resolve operation is multi-sampled");
+    DEV_CHECK_ERR((SrcTexDesc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) == 0,
+                  "Source texture '", SrcTexDesc.Name, "' of a resolve operation is memoryless. Use resolve attachments of a render pass instead");
     auto SrcMipLevelProps = GetMipLevelProperties(SrcTexDesc, ResolveAttribs.SrcMipLevel);
     auto DstMipLevelProps = GetMipLevelProperties(DstTexDesc, ResolveAttribs.DstMipLevel);
     DEV_CHECK_ERR(SrcMipLevelProps.LogicalWidth == DstMipLevelProps.LogicalWidth && SrcMipLevelProps.LogicalHeight == DstMipLevelProps.LogicalHeight,
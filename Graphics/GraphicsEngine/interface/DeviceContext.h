@@ -1205,6 +1205,19 @@ DILIGENT_BEGIN_INTERFACE(IDeviceContext, IObject)
                                             ICommandList* pCommandList) PURE;
 
 
+    /// Executes recorded commands in multiple command lists.
+
+    /// \param [in] NumCommandLists - The number of command lists to execute.
+    /// \param [in] ppCommandLists  - Pointer to the array of NumCommandLists command lists to execute.
+    /// \remarks Command lists are executed in the order they appear in the array.
+    ///          Backends that support it submit all command lists to the queue at once,
+    ///          which is considerably more efficient than calling ExecuteCommandList() for every list.
+    ///          After command lists are executed, they are no longer valid and should be released.
+    VIRTUAL void METHOD(ExecuteCommandLists)(THIS_
+                                             Uint32               NumCommandLists,
+                                             ICommandList* const* ppCommandLists) PURE;
+
+
     /// Tells the GPU to set a fence to a specified value after all previous work has completed.
 
     /// \note The method does not flush the context (an application can do this explcitly if needed)
@@ -1521,6 +1534,7 @@ DILIGENT_END_INTERFACE
 #    define IDeviceContext_ClearRenderTarget(This, ...)         CALL_IFACE_METHOD(DeviceContext, ClearRenderTarget,         This, __VA_ARGS__)
 #    define IDeviceContext_FinishCommandList(This, ...)         CALL_IFACE_METHOD(DeviceContext, FinishCommandList,         This, __VA_ARGS__)
 #    define IDeviceContext_ExecuteCommandList(This, ...)        CALL_IFACE_METHOD(DeviceContext, ExecuteCommandList,        This, __VA_ARGS__)
+#    define IDeviceContext_ExecuteCommandLists(This, ...)       CALL_IFACE_METHOD(DeviceContext, ExecuteCommandLists,       This, __VA_ARGS__)
 #    define IDeviceContext_SignalFence(This, ...)               CALL_IFACE_METHOD(DeviceContext, SignalFence,               This, __VA_ARGS__)
 #    define IDeviceContext_WaitForFence(This, ...)              CALL_IFACE_METHOD(DeviceContext, WaitForFence,              This, __VA_ARGS__)
 #    define IDeviceContext_WaitForIdle(This, ...)               CALL_IFACE_METHOD(DeviceContext, WaitForIdle,               This, __VA_ARGS__)
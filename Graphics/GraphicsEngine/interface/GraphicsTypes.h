@@ -935,7 +935,22 @@ DILIGENT_TYPED_ENUM(MISC_TEXTURE_FLAGS, Uint8)
     /// Allow automatic mipmap generation with ITextureView::GenerateMips()
 
     /// \note A texture must be created with BIND_RENDER_TARGET bind flag
-    MISC_TEXTURE_FLAG_GENERATE_MIPS = 0x01
+    MISC_TEXTURE_FLAG_GENERATE_MIPS = 0x01,
+
+    /// The texture is a transient attachment whose contents are only used within a render pass
+    /// (e.g. a multisampled color or depth buffer that is resolved at the end of the pass).
+
+    /// In Vulkan backend, the texture is created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and is
+    /// backed by lazily-allocated memory when the device exposes such memory type, so that on tiled
+    /// GPUs it may never require physical memory. Other backends create a regular texture.
+    ///
+    /// \note  A memoryless texture may only be bound as a render target, depth-stencil buffer or input
+    ///        attachment, must have a single mip level and USAGE_DEFAULT usage, and can't be initialized
+    ///        with data, copied, resolved with IDeviceContext::ResolveTextureSubresource() or cleared
+    ///        when it is not bound to the context. For memory to not be committed,
+    ///        render pass attachments that use the texture should not use ATTACHMENT_LOAD_OP_LOAD and
+    ///        ATTACHMENT_STORE_OP_STORE operations.
+    MISC_TEXTURE_FLAG_MEMORYLESS    = 0x02
 };
 DEFINE_FLAG_ENUM_OPERATORS(MISC_TEXTURE_FLAGS)
 
@@ -1875,6 +1890,17 @@ struct EngineGLCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     /// provide additional runtime checking, validation, and logging
     /// functionality while possibly incurring performance penalties
     bool CreateDebugContext     DEFAULT_INITIALIZER(false);
+
+    /// Maximum number of vertex array objects kept in the VAO cache of every GL context.
+
+    /// When the cache is full, the least recently used VAO is released.
+    Uint32 VAOCacheSize         DEFAULT_INITIALIZER(1024);
+
+    /// Maximum number of framebuffer objects kept in the FBO cache of every GL context.
+
+    /// When the cache is full, the least recently used FBO is released.
+    /// The value is clamped to at least 2.
+    Uint32 FBOCacheSize         DEFAULT_INITIALIZER(256);
 };
 typedef struct EngineGLCreateInfo EngineGLCreateInfo;
 
@@ -2194,6 +2220,16 @@ struct EngineVkCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
     /// Upload heap is used to update resources with UpdateData()
     Uint32 UploadHeapPageSize               DEFAULT_INITIALIZER(1 << 20);
 
+    /// Page size of the staging memory that is allocated by the render device to
+    /// upload the initial data of resources created inside an upload batch
+    /// (see IRenderDeviceVk::BeginUploadBatch()).
+    Uint32 UploadBatchPageSize              DEFAULT_INITIALIZER(4 << 20);
+
+    /// Maximum total size of the serialized shader resources that the render device
+    /// keeps to avoid reflecting the same SPIRV byte code again. When the limit is
+    /// exceeded, the least recently used data is evicted. Zero disables the cache.
+    Uint32 ShaderReflectionCacheSize        DEFAULT_INITIALIZER(8 << 20);
+
     /// Size of the dynamic heap (the buffer that is used to suballocate 
     /// memory for dynamic resources) shared by all contexts.
     Uint32 DynamicHeapSize                  DEFAULT_INITIALIZER(8 << 20);
@@ -247,7 +247,8 @@ struct ShaderCreateInfo
     /// If shader byte code is provided, FilePath and Source members must be null
     /// \note. This option is supported for D3D11, D3D12 and Vulkan backends.
     ///        For D3D11 and D3D12 backends, HLSL bytecode should be provided. Vulkan
-    ///        backend expects SPIRV bytecode.
+    ///        backend expects SPIRV bytecode, which may also be compressed by the
+    ///        SPIR-V post-processing pipeline (see SPIRVUtils.hpp in ShaderTools).
     ///        The bytecode must contain reflection information. If shaders were compiled
     ///        using fxc, make sure that /Qstrip_reflect option is *not* specified.
     ///        HLSL shaders need to be compiled against 4.0 profile or higher.
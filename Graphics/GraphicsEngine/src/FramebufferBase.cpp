@@ -100,6 +100,19 @@ void ValidateFramebufferDesc(const FramebufferDesc& Desc)
                                             " does not match the sample count (", Uint32{AttDesc.SampleCount},
                                             ") defined by the render pass for the same attachment.");
         }
+
+        if (TexDesc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS)
+        {
+            bool LoadsOrStores = AttDesc.LoadOp == ATTACHMENT_LOAD_OP_LOAD || AttDesc.StoreOp == ATTACHMENT_STORE_OP_STORE;
+            if (GetTextureFormatAttribs(AttDesc.Format).ComponentType == COMPONENT_TYPE_DEPTH_STENCIL)
+                LoadsOrStores = LoadsOrStores || AttDesc.StencilLoadOp == ATTACHMENT_LOAD_OP_LOAD || AttDesc.StencilStoreOp == ATTACHMENT_STORE_OP_STORE;
+            if (LoadsOrStores)
+            {
+                LOG_WARNING_MESSAGE("Memoryless texture '", TexDesc.Name, "' is used as attachment ", i, " of framebuffer '",
+                                    (Desc.Name ? Desc.Name : ""), "' with ATTACHMENT_LOAD_OP_LOAD or ATTACHMENT_STORE_OP_STORE operation. "
+                                                                  "This will likely force the physical memory to be allocated for the texture.");
+            }
+        }
     }
 
     for (Uint32 i = 0; i < RPDesc.SubpassCount; ++i)
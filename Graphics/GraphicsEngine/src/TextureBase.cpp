@@ -145,6 +145,24 @@ void ValidateTextureDesc(const TextureDesc& Desc)
     {
         LOG_TEXTURE_ERROR_AND_THROW("USAGE_UNIFIED textures are currently not supported");
     }
+
+    if (Desc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS)
+    {
+        if (Desc.Usage != USAGE_DEFAULT)
+            LOG_TEXTURE_ERROR_AND_THROW("Memoryless textures must use USAGE_DEFAULT usage");
+
+        if ((Desc.BindFlags & ~(BIND_RENDER_TARGET | BIND_DEPTH_STENCIL | BIND_INPUT_ATTACHMENT)) != 0)
+            LOG_TEXTURE_ERROR_AND_THROW("Memoryless textures may only be bound as render target, depth-stencil or input attachment");
+
+        if ((Desc.BindFlags & (BIND_RENDER_TARGET | BIND_DEPTH_STENCIL)) == 0)
+            LOG_TEXTURE_ERROR_AND_THROW("Memoryless textures must be created with BIND_RENDER_TARGET or BIND_DEPTH_STENCIL flag");
+
+        if (Desc.MipLevels != 1)
+            LOG_TEXTURE_ERROR_AND_THROW("Memoryless textures must have one mip level (", Desc.MipLevels, " levels specified)");
+
+        if (Desc.MiscFlags & MISC_TEXTURE_FLAG_GENERATE_MIPS)
+            LOG_TEXTURE_ERROR_AND_THROW("Mipmaps cannot be autogenerated for memoryless textures");
+    }
 }
 
 
@@ -265,6 +283,9 @@ void ValidateCopyTextureParams(const CopyTextureAttribs& CopyAttribs)
     const auto& SrcTexDesc = CopyAttribs.pSrcTexture->GetDesc();
     const auto& DstTexDesc = CopyAttribs.pDstTexture->GetDesc();
     auto        pSrcBox    = CopyAttribs.pSrcBox;
+
+    DEV_CHECK_ERR((SrcTexDesc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) == 0, "Memoryless texture '", SrcTexDesc.Name, "' can't be used as copy source");
+    DEV_CHECK_ERR((DstTexDesc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) == 0, "Memoryless texture '", DstTexDesc.Name, "' can't be used as copy destination");
     if (pSrcBox == nullptr)
     {
         auto MipLevelAttribs = GetMipLevelProperties(SrcTexDesc, CopyAttribs.SrcMipLevel);
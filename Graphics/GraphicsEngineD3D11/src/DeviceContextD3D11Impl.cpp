@@ -1958,6 +1958,13 @@ void DeviceContextD3D11Impl::ExecuteCommandList(ICommandList* pCommandList)
 #endif
 }
 
+void DeviceContextD3D11Impl::ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists)
+{
+    DEV_CHECK_ERR(NumCommandLists == 0 || ppCommandLists != nullptr, "ppCommandLists must not be null when NumCommandLists is not zero");
+    for (Uint32 i = 0; i < NumCommandLists; ++i)
+        ExecuteCommandList(ppCommandLists[i]);
+}
+
 
 static CComPtr<ID3D11Query> CreateD3D11QueryEvent(ID3D11Device* pd3d11Device)
 {
@@ -1526,7 +1526,7 @@ void DeviceContextD3D12Impl::UpdateTexture(ITexture*                      pTextu
     }
     else
     {
-        CopyTextureRegion(SubresData.pSrcBuffer, 0, SubresData.Stride, SubresData.DepthStride,
+        CopyTextureRegion(SubresData.pSrcBuffer, SubresData.SrcOffset, SubresData.Stride, SubresData.DepthStride,
                           *pTexD3D12, DstSubResIndex, *pBox,
                           SrcBufferTransitionMode, TextureTransitionMode);
     }
@@ -2013,6 +2013,13 @@ void DeviceContextD3D12Impl::ExecuteCommandList(ICommandList* pCommandList)
     pDeferredCtx->m_SubmittedBuffersCmdQueueMask |= Uint64{1} << m_CommandQueueId;
 }
 
+void DeviceContextD3D12Impl::ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists)
+{
+    DEV_CHECK_ERR(NumCommandLists == 0 || ppCommandLists != nullptr, "ppCommandLists must not be null when NumCommandLists is not zero");
+    for (Uint32 i = 0; i < NumCommandLists; ++i)
+        ExecuteCommandList(ppCommandLists[i]);
+}
+
 void DeviceContextD3D12Impl::SignalFence(IFence* pFence, Uint64 Value)
 {
     VERIFY(!m_bIsDeferred, "Fence can only be signaled from immediate context");
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "BufferGL.h"
 #include "BufferBase.hpp"
 #include "GLObjectWrapper.hpp"
@@ -96,6 +98,10 @@ private:
     GLObjectWrappers::GLBufferObj m_GlBuffer;
     const Uint32                  m_BindTarget;
     const GLenum                  m_GLUsageHint;
+
+    // Number of VAO cache entries that reference this buffer in all GL contexts.
+    // When it is zero, the buffer does not need to be removed from the caches.
+    std::atomic<Uint32> m_NumVAOCacheRefs{0};
 };
 
 } // namespace Diligent
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <list>
+
 #include "GraphicsTypes.h"
 #include "TextureView.h"
 #include "LockHelper.hpp"
@@ -37,11 +39,19 @@ namespace Diligent
 {
 
 class TextureViewGLImpl;
+class TextureBaseGL;
 
+/// FBO cache keeps at most Capacity framebuffer objects and evicts
+/// the least recently used one when a new FBO needs to be created.
 class FBOCache
 {
 public:
-    FBOCache();
+    // Two FBOs are used simultaneously when resolving or reading back textures,
+    // so the cache must be able to hold at least that many.
+    static constexpr Uint32 MinCapacity     = 2;
+    static constexpr Uint32 DefaultCapacity = 256;
+
+    explicit FBOCache(Uint32 Capacity = DefaultCapacity);
     ~FBOCache();
 
     // clang-format off
@@ -63,6 +73,17 @@ public:
 
     void OnReleaseTexture(ITexture* pTexture);
 
+    struct CacheStats
+    {
+        Uint64 NumHits          = 0;
+        Uint64 NumMisses        = 0;
+        Uint64 NumEvictions     = 0;
+        Uint64 NumInvalidations = 0;
+        Uint32 NumEntries       = 0;
+        Uint32 Capacity         = 0;
+    };
+    CacheStats GetStats();
+
 private:
     // This structure is used as the key to find FBO
     struct FBOCacheKey
@@ -90,13 +111,42 @@ private:
     };
 
 
+    using LRUListType = std::list<const FBOCacheKey*>;
+
+    struct CacheEntry
+    {
+        explicit CacheEntry(GLObjectWrappers::GLFrameBufferObj&& _FBO) :
+            FBO{std::move(_FBO)}
+        {}
+
+        GLObjectWrappers::GLFrameBufferObj FBO;
+
+        // Position of this entry in the LRU list
+        LRUListType::iterator LRUIt;
+
+        // Textures attached to the FBO. Every texture is listed only once,
+        // and its m_NumFBOCacheRefs counter accounts for this entry.
+        TextureBaseGL* Textures[MAX_RENDER_TARGETS + 1] = {};
+        Uint32         NumTextures                      = 0;
+    };
+    using CacheMapType = std::unordered_map<FBOCacheKey, CacheEntry, FBOCacheKeyHashFunc>;
+
+    // Releases the FBO and removes all back-references to it. The cache must be locked.
+    void EraseEntry(CacheMapType::iterator EntryIt);
+
     friend class RenderDeviceGLImpl;
-    ThreadingTools::LockFlag                                                                 m_CacheLockFlag;
-    std::unordered_map<FBOCacheKey, GLObjectWrappers::GLFrameBufferObj, FBOCacheKeyHashFunc> m_Cache;
+    ThreadingTools::LockFlag m_CacheLockFlag;
+    CacheMapType             m_Cache;
+
+    // Keys of all cached FBOs, the most recently used one is at the front
+    LRUListType  m_LRUList;
+    const Uint32 m_Capacity;
 
     // Multimap that sets up correspondence between unique texture id and all
     // FBOs it is used in
-    std::unordered_multimap<UniqueIdentifier, FBOCacheKey> m_TexIdToKey;
+    std::unordered_multimap<UniqueIdentifier, const FBOCacheKey*> m_TexIdToKey;
+
+    CacheStats m_Stats;
 };
 
 } // namespace Diligent
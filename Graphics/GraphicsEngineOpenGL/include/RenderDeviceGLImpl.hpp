@@ -164,6 +164,10 @@ protected:
     ThreadingTools::LockFlag                                     m_FBOCacheLockFlag;
     std::unordered_map<GLContext::NativeGLContextType, FBOCache> m_FBOCache;
 
+    // Maximum number of entries in every VAO and FBO cache
+    const Uint32 m_VAOCacheSize;
+    const Uint32 m_FBOCacheSize;
+
     std::unique_ptr<TexRegionRender> m_pTexRegionRender;
 
 private:
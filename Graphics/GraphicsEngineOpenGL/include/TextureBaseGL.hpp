@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "BaseInterfacesGL.h"
 #include "TextureGL.h"
 #include "TextureBase.hpp"
@@ -133,6 +135,13 @@ protected:
     const GLenum                   m_BindTarget;
     const GLenum                   m_GLTexFormat;
     //Uint32 m_uiMapTarget;
+
+private:
+    friend class FBOCache;
+
+    // Number of FBO cache entries that use this texture in all GL contexts.
+    // When it is zero, the texture does not need to be removed from the caches.
+    std::atomic<Uint32> m_NumFBOCacheRefs{0};
 };
 
 } // namespace Diligent
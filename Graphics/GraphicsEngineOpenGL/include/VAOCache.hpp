@@ -28,6 +28,7 @@
 #pragma once
 
 #include <cstring>
+#include <list>
 #include "GraphicsTypes.h"
 #include "Buffer.h"
 #include "InputLayout.h"
@@ -39,10 +40,16 @@
 namespace Diligent
 {
 
+class BufferGLImpl;
+
+/// VAO cache keeps at most Capacity vertex array objects and evicts
+/// the least recently used one when a new VAO needs to be created.
 class VAOCache
 {
 public:
-    VAOCache();
+    static constexpr Uint32 DefaultCapacity = 1024;
+
+    explicit VAOCache(Uint32 Capacity = DefaultCapacity);
     ~VAOCache();
 
     // clang-format off
@@ -62,6 +69,17 @@ public:
     void OnDestroyBuffer(IBuffer* pBuffer);
     void OnDestroyPSO(IPipelineState* pPSO);
 
+    struct CacheStats
+    {
+        Uint64 NumHits          = 0;
+        Uint64 NumMisses        = 0;
+        Uint64 NumEvictions     = 0;
+        Uint64 NumInvalidations = 0;
+        Uint32 NumEntries       = 0;
+        Uint32 Capacity         = 0;
+    };
+    CacheStats GetStats();
+
 private:
     // This structure is used as the key to find VAO
     struct VAOCacheKey
@@ -125,12 +143,42 @@ private:
     };
 
 
+    using LRUListType = std::list<const VAOCacheKey*>;
+
+    struct CacheEntry
+    {
+        explicit CacheEntry(GLObjectWrappers::GLVertexArrayObj&& _VAO) :
+            VAO{std::move(_VAO)}
+        {}
+
+        GLObjectWrappers::GLVertexArrayObj VAO;
+
+        // Position of this entry in the LRU list
+        LRUListType::iterator LRUIt;
+
+        // Objects referenced by the VAO. Every buffer is listed only once,
+        // and its m_NumVAOCacheRefs counter accounts for this entry.
+        const IPipelineState* pPSO                          = nullptr;
+        BufferGLImpl*         Buffers[MAX_BUFFER_SLOTS + 1] = {};
+        Uint32                NumBuffers                    = 0;
+    };
+    using CacheMapType = std::unordered_map<VAOCacheKey, CacheEntry, VAOCacheKeyHashFunc>;
+
+    // Releases the VAO and removes all back-references to it. The cache must be locked.
+    void EraseEntry(CacheMapType::iterator EntryIt);
+
     friend class RenderDeviceGLImpl;
-    ThreadingTools::LockFlag                                                                 m_CacheLockFlag;
-    std::unordered_map<VAOCacheKey, GLObjectWrappers::GLVertexArrayObj, VAOCacheKeyHashFunc> m_Cache;
+    ThreadingTools::LockFlag m_CacheLockFlag;
+    CacheMapType             m_Cache;
+
+    // Keys of all cached VAOs, the most recently used one is at the front
+    LRUListType  m_LRUList;
+    const Uint32 m_Capacity;
+
+    std::unordered_multimap<const IPipelineState*, const VAOCacheKey*> m_PSOToKey;
+    std::unordered_multimap<const IBuffer*, const VAOCacheKey*>        m_BuffToKey;
 
-    std::unordered_multimap<const IPipelineState*, VAOCacheKey> m_PSOToKey;
-    std::unordered_multimap<const IBuffer*, VAOCacheKey>        m_BuffToKey;
+    CacheStats m_Stats;
 
     // Any draw command fails if no VAO is bound. We will use this empty
     // VAO for draw commands with null input layout, such as these that
@@ -212,7 +212,9 @@ BufferGLImpl::BufferGLImpl(IReferenceCounters*        pRefCounters,
 
 BufferGLImpl::~BufferGLImpl()
 {
-    static_cast<RenderDeviceGLImpl*>(GetDevice())->OnDestroyBuffer(this);
+    // Only walk the VAO caches if there are VAOs that use this buffer
+    if (m_NumVAOCacheRefs.load() != 0)
+        static_cast<RenderDeviceGLImpl*>(GetDevice())->OnDestroyBuffer(this);
 }
 
 IMPLEMENT_QUERY_INTERFACE(BufferGLImpl, IID_BufferGL, TBufferBase)
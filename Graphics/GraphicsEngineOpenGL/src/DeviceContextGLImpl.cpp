@@ -1286,6 +1286,11 @@ void DeviceContextGLImpl::ExecuteCommandList(class ICommandList* pCommandList)
     LOG_ERROR("Deferred contexts are not supported in OpenGL mode");
 }
 
+void DeviceContextGLImpl::ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists)
+{
+    LOG_ERROR("Deferred contexts are not supported in OpenGL mode");
+}
+
 void DeviceContextGLImpl::SignalFence(IFence* pFence, Uint64 Value)
 {
     VERIFY(!m_bIsDeferred, "Fence can only be signaled from immediate context");
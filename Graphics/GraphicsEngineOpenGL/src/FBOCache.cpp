@@ -83,7 +83,8 @@ std::size_t FBOCache::FBOCacheKeyHashFunc::operator()(const FBOCacheKey& Key) co
 }
 
 
-FBOCache::FBOCache()
+FBOCache::FBOCache(Uint32 Capacity) :
+    m_Capacity{std::max(Capacity, Uint32{MinCapacity})}
 {
     m_Cache.max_load_factor(0.5f);
     m_TexIdToKey.max_load_factor(0.5f);
@@ -92,21 +93,59 @@ FBOCache::FBOCache()
 FBOCache::~FBOCache()
 {
     VERIFY(m_Cache.empty(), "FBO cache is not empty. Are there any unreleased objects?");
+    VERIFY(m_LRUList.empty(), "LRU list is not empty");
     VERIFY(m_TexIdToKey.empty(), "TexIdToKey cache is not empty.");
 }
 
+void FBOCache::EraseEntry(CacheMapType::iterator EntryIt)
+{
+    const auto* pKey  = &EntryIt->first;
+    auto&       Entry = EntryIt->second;
+
+    for (Uint32 i = 0; i < Entry.NumTextures; ++i)
+    {
+        auto* pTexGL     = Entry.Textures[i];
+        auto  EqualRange = m_TexIdToKey.equal_range(pTexGL->GetUniqueID());
+        auto  It         = EqualRange.first;
+        while (It != EqualRange.second && It->second != pKey)
+            ++It;
+        VERIFY(It != EqualRange.second, "Texture back-reference to the FBO is not found");
+        if (It != EqualRange.second)
+            m_TexIdToKey.erase(It);
+
+        VERIFY_EXPR(pTexGL->m_NumFBOCacheRefs > 0);
+        pTexGL->m_NumFBOCacheRefs.fetch_sub(1);
+    }
+
+    m_LRUList.erase(Entry.LRUIt);
+    m_Cache.erase(EntryIt);
+}
+
 void FBOCache::OnReleaseTexture(ITexture* pTexture)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto* pTexGL = ValidatedCast<TextureBaseGL>(pTexture);
-    // Find all FBOs that this texture used in
-    auto EqualRange = m_TexIdToKey.equal_range(pTexGL->GetUniqueID());
-    for (auto It = EqualRange.first; It != EqualRange.second; ++It)
+    auto*      pTexGL = ValidatedCast<TextureBaseGL>(pTexture);
+    const auto TexId  = pTexGL->GetUniqueID();
+    // Find all FBOs that this texture used in. EraseEntry() removes
+    // the back-reference, so always look up the first remaining one.
+    for (auto It = m_TexIdToKey.find(TexId); It != m_TexIdToKey.end(); It = m_TexIdToKey.find(TexId))
     {
-        m_Cache.erase(It->second);
+        auto EntryIt = m_Cache.find(*It->second);
+        VERIFY_EXPR(EntryIt != m_Cache.end());
+        EraseEntry(EntryIt);
+        ++m_Stats.NumInvalidations;
     }
-    m_TexIdToKey.erase(EqualRange.first, EqualRange.second);
+}
+
+FBOCache::CacheStats FBOCache::GetStats()
+{
+    ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
+
+    auto Stats       = m_Stats;
+    Stats.NumEntries = static_cast<Uint32>(m_Cache.size());
+    Stats.Capacity   = m_Capacity;
+    return Stats;
 }
 
 GLObjectWrappers::GLFrameBufferObj FBOCache::CreateFBO(GLContextState&    ContextState,
@@ -268,25 +307,56 @@ const GLObjectWrappers::GLFrameBufferObj& FBOCache::GetFBO(Uint32             Nu
     auto It = m_Cache.find(Key);
     if (It != m_Cache.end())
     {
-        return It->second;
+        // Move the FBO to the front of the LRU list
+        m_LRUList.splice(m_LRUList.begin(), m_LRUList, It->second.LRUIt);
+        ++m_Stats.NumHits;
+        return It->second.FBO;
     }
     else
     {
+        ++m_Stats.NumMisses;
+
+        // Evict the least recently used FBO if the cache is full
+        while (m_Cache.size() >= m_Capacity)
+        {
+            auto EvictIt = m_Cache.find(*m_LRUList.back());
+            VERIFY_EXPR(EvictIt != m_Cache.end());
+            EraseEntry(EvictIt);
+            ++m_Stats.NumEvictions;
+        }
+
         // Create a new FBO
         auto NewFBO = CreateFBO(ContextState, NumRenderTargets, ppRTVs, pDSV);
 
-        auto NewElems = m_Cache.emplace(std::make_pair(Key, std::move(NewFBO)));
+        auto NewElems = m_Cache.emplace(Key, CacheEntry{std::move(NewFBO)});
         // New element must be actually inserted
         VERIFY(NewElems.second, "New element was not inserted");
-        if (Key.DSId != 0)
-            m_TexIdToKey.insert(std::make_pair(Key.DSId, Key));
-        for (Uint32 rt = 0; rt < NumRenderTargets; ++rt)
+        const auto* pKey  = &NewElems.first->first;
+        auto&       Entry = NewElems.first->second;
+
+        m_LRUList.push_front(pKey);
+        Entry.LRUIt = m_LRUList.begin();
+
+        auto AddTexture = [&](TextureViewGLImpl* pView) //
         {
-            if (Key.RTIds[rt] != 0)
-                m_TexIdToKey.insert(std::make_pair(Key.RTIds[rt], Key));
-        }
+            if (pView == nullptr)
+                return;
+            auto* pTexGL = pView->GetTexture<TextureBaseGL>();
+            // The same texture may be attached multiple times
+            for (Uint32 i = 0; i < Entry.NumTextures; ++i)
+            {
+                if (Entry.Textures[i] == pTexGL)
+                    return;
+            }
+            Entry.Textures[Entry.NumTextures++] = pTexGL;
+            pTexGL->m_NumFBOCacheRefs.fetch_add(1);
+            m_TexIdToKey.emplace(pTexGL->GetUniqueID(), pKey);
+        };
+        for (Uint32 rt = 0; rt < NumRenderTargets; ++rt)
+            AddTexture(ppRTVs[rt]);
+        AddTexture(pDSV);
 
-        return NewElems.first->second;
+        return Entry.FBO;
     }
 }
 
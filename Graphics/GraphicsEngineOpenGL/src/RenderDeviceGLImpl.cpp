@@ -153,7 +153,9 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
         }
     },
     // Device caps must be filled in before the constructor of Pipeline Cache is called!
-    m_GLContext{InitAttribs, m_DeviceCaps, pSCDesc}
+    m_GLContext   {InitAttribs, m_DeviceCaps, pSCDesc},
+    m_VAOCacheSize{InitAttribs.VAOCacheSize},
+    m_FBOCacheSize{InitAttribs.FBOCacheSize}
 // clang-format on
 {
     GLint NumExtensions = 0;
@@ -462,6 +464,18 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
 
 RenderDeviceGLImpl::~RenderDeviceGLImpl()
 {
+    for (auto& VAOCacheIt : m_VAOCache)
+    {
+        const auto Stats = VAOCacheIt.second.GetStats();
+        LOG_INFO_MESSAGE("VAO cache stats: ", Stats.NumHits, " hits, ", Stats.NumMisses, " misses, ",
+                         Stats.NumEvictions, " evictions, ", Stats.NumInvalidations, " invalidations");
+    }
+    for (auto& FBOCacheIt : m_FBOCache)
+    {
+        const auto Stats = FBOCacheIt.second.GetStats();
+        LOG_INFO_MESSAGE("FBO cache stats: ", Stats.NumHits, " hits, ", Stats.NumMisses, " misses, ",
+                         Stats.NumEvictions, " evictions, ", Stats.NumInvalidations, " invalidations");
+    }
 }
 
 IMPLEMENT_QUERY_INTERFACE(RenderDeviceGLImpl, IID_RenderDeviceGL, TRenderDeviceBase)
@@ -1227,7 +1241,11 @@ void RenderDeviceGLImpl::TestTextureFormat(TEXTURE_FORMAT TexFormat)
 FBOCache& RenderDeviceGLImpl::GetFBOCache(GLContext::NativeGLContextType Context)
 {
     ThreadingTools::LockHelper FBOCacheLock(m_FBOCacheLockFlag);
-    return m_FBOCache[Context];
+
+    auto It = m_FBOCache.find(Context);
+    if (It == m_FBOCache.end())
+        It = m_FBOCache.emplace(std::piecewise_construct, std::forward_as_tuple(Context), std::forward_as_tuple(m_FBOCacheSize)).first;
+    return It->second;
 }
 
 void RenderDeviceGLImpl::OnReleaseTexture(ITexture* pTexture)
@@ -1240,7 +1258,11 @@ void RenderDeviceGLImpl::OnReleaseTexture(ITexture* pTexture)
 VAOCache& RenderDeviceGLImpl::GetVAOCache(GLContext::NativeGLContextType Context)
 {
     ThreadingTools::LockHelper VAOCacheLock(m_VAOCacheLockFlag);
-    return m_VAOCache[Context];
+
+    auto It = m_VAOCache.find(Context);
+    if (It == m_VAOCache.end())
+        It = m_VAOCache.emplace(std::piecewise_construct, std::forward_as_tuple(Context), std::forward_as_tuple(m_VAOCacheSize)).first;
+    return It->second;
 }
 
 void RenderDeviceGLImpl::OnDestroyPSO(IPipelineState* pPSO)
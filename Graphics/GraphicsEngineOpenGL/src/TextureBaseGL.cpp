@@ -341,8 +341,10 @@ TextureBaseGL::~TextureBaseGL()
     // NOTE: we cannot check if BIND_RENDER_TARGET
     // flag is set, because CopyData() can bind
     // texture as render target even when no flag
-    // is set
-    static_cast<RenderDeviceGLImpl*>(GetDevice())->OnReleaseTexture(this);
+    // is set. The counter is maintained by the FBO caches
+    // and tells if there are any FBOs to release.
+    if (m_NumFBOCacheRefs.load() != 0)
+        static_cast<RenderDeviceGLImpl*>(GetDevice())->OnReleaseTexture(this);
 }
 
 IMPLEMENT_QUERY_INTERFACE(TextureBaseGL, IID_TextureGL, TTextureBase)
@@ -38,7 +38,8 @@
 namespace Diligent
 {
 
-VAOCache::VAOCache() :
+VAOCache::VAOCache(Uint32 Capacity) :
+    m_Capacity{std::max(Capacity, 1u)},
     m_EmptyVAO{true}
 {
     m_Cache.max_load_factor(0.5f);
@@ -49,32 +50,80 @@ VAOCache::VAOCache() :
 VAOCache::~VAOCache()
 {
     VERIFY(m_Cache.empty(), "VAO cache is not empty. Are there any unreleased objects?");
+    VERIFY(m_LRUList.empty(), "LRU list is not empty");
     VERIFY(m_PSOToKey.empty(), "PSOToKey hash is not empty");
     VERIFY(m_BuffToKey.empty(), "BuffToKey hash is not empty");
 }
 
+void VAOCache::EraseEntry(CacheMapType::iterator EntryIt)
+{
+    const auto* pKey  = &EntryIt->first;
+    auto&       Entry = EntryIt->second;
+
+    {
+        auto EqualRange = m_PSOToKey.equal_range(Entry.pPSO);
+        auto It         = EqualRange.first;
+        while (It != EqualRange.second && It->second != pKey)
+            ++It;
+        VERIFY(It != EqualRange.second, "PSO back-reference to the VAO is not found");
+        if (It != EqualRange.second)
+            m_PSOToKey.erase(It);
+    }
+
+    for (Uint32 i = 0; i < Entry.NumBuffers; ++i)
+    {
+        auto* pBuffer    = Entry.Buffers[i];
+        auto  EqualRange = m_BuffToKey.equal_range(pBuffer);
+        auto  It         = EqualRange.first;
+        while (It != EqualRange.second && It->second != pKey)
+            ++It;
+        VERIFY(It != EqualRange.second, "Buffer back-reference to the VAO is not found");
+        if (It != EqualRange.second)
+            m_BuffToKey.erase(It);
+
+        VERIFY_EXPR(pBuffer->m_NumVAOCacheRefs > 0);
+        pBuffer->m_NumVAOCacheRefs.fetch_sub(1);
+    }
+
+    m_LRUList.erase(Entry.LRUIt);
+    m_Cache.erase(EntryIt);
+}
+
 void VAOCache::OnDestroyBuffer(IBuffer* pBuffer)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto EqualRange = m_BuffToKey.equal_range(pBuffer);
-    for (auto It = EqualRange.first; It != EqualRange.second; ++It)
+    // EraseEntry() removes the back-reference, so always look up the first remaining one
+    for (auto It = m_BuffToKey.find(pBuffer); It != m_BuffToKey.end(); It = m_BuffToKey.find(pBuffer))
     {
-        m_Cache.erase(It->second);
+        auto EntryIt = m_Cache.find(*It->second);
+        VERIFY_EXPR(EntryIt != m_Cache.end());
+        EraseEntry(EntryIt);
+        ++m_Stats.NumInvalidations;
     }
-    m_BuffToKey.erase(EqualRange.first, EqualRange.second);
 }
 
 void VAOCache::OnDestroyPSO(IPipelineState* pPSO)
 {
     ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
 
-    auto EqualRange = m_PSOToKey.equal_range(pPSO);
-    for (auto It = EqualRange.first; It != EqualRange.second; ++It)
+    for (auto It = m_PSOToKey.find(pPSO); It != m_PSOToKey.end(); It = m_PSOToKey.find(pPSO))
     {
-        m_Cache.erase(It->second);
+        auto EntryIt = m_Cache.find(*It->second);
+        VERIFY_EXPR(EntryIt != m_Cache.end());
+        EraseEntry(EntryIt);
+        ++m_Stats.NumInvalidations;
     }
-    m_PSOToKey.erase(EqualRange.first, EqualRange.second);
+}
+
+VAOCache::CacheStats VAOCache::GetStats()
+{
+    ThreadingTools::LockHelper CacheLock(m_CacheLockFlag);
+
+    auto Stats       = m_Stats;
+    Stats.NumEntries = static_cast<Uint32>(m_Cache.size());
+    Stats.Capacity   = m_Capacity;
+    return Stats;
 }
 
 const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*                pPSO,
@@ -162,7 +211,10 @@ const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*
     auto It = m_Cache.find(Key);
     if (It != m_Cache.end())
     {
-        return It->second;
+        // Move the VAO to the front of the LRU list
+        m_LRUList.splice(m_LRUList.begin(), m_LRUList, It->second.LRUIt);
+        ++m_Stats.NumHits;
+        return It->second.VAO;
     }
     else
     {
@@ -219,18 +271,48 @@ const GLObjectWrappers::GLVertexArrayObj& VAOCache::GetVAO(IPipelineState*
             GLState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, pIndBufferOGL->m_GlBuffer, ResetVAO);
         }
 
-        auto NewElems = m_Cache.emplace(std::make_pair(Key, std::move(NewVAO)));
+        ++m_Stats.NumMisses;
+
+        // Evict the least recently used VAO if the cache is full
+        while (m_Cache.size() >= m_Capacity)
+        {
+            auto EvictIt = m_Cache.find(*m_LRUList.back());
+            VERIFY_EXPR(EvictIt != m_Cache.end());
+            EraseEntry(EvictIt);
+            ++m_Stats.NumEvictions;
+        }
+
+        auto NewElems = m_Cache.emplace(Key, CacheEntry{std::move(NewVAO)});
         // New element must be actually inserted
         VERIFY(NewElems.second, "New element was not inserted into the cache");
-        m_PSOToKey.insert(std::make_pair(pPSO, Key));
-        for (Uint32 Slot = 0; Slot < Key.NumUsedSlots; ++Slot)
+        const auto* pKey  = &NewElems.first->first;
+        auto&       Entry = NewElems.first->second;
+
+        m_LRUList.push_front(pKey);
+        Entry.LRUIt = m_LRUList.begin();
+
+        Entry.pPSO = pPSO;
+        m_PSOToKey.emplace(pPSO, pKey);
+
+        auto AddBuffer = [&](BufferGLImpl* pBuffer) //
         {
-            auto* pCurrBuff = VertexBuffers[Slot];
-            if (pCurrBuff)
-                m_BuffToKey.insert(std::make_pair(pCurrBuff, Key));
-        }
+            if (pBuffer == nullptr)
+                return;
+            // The same buffer may be bound to multiple slots
+            for (Uint32 i = 0; i < Entry.NumBuffers; ++i)
+            {
+                if (Entry.Buffers[i] == pBuffer)
+                    return;
+            }
+            Entry.Buffers[Entry.NumBuffers++] = pBuffer;
+            pBuffer->m_NumVAOCacheRefs.fetch_add(1);
+            m_BuffToKey.emplace(pBuffer, pKey);
+        };
+        for (Uint32 Slot = 0; Slot < Key.NumUsedSlots; ++Slot)
+            AddBuffer(VertexBuffers[Slot]);
+        AddBuffer(pIndexBufferGL);
 
-        return NewElems.first->second;
+        return Entry.VAO;
     }
 }
 
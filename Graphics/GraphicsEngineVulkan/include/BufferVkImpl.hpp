@@ -111,6 +111,9 @@ public:
         return (GetAccessFlags() & AccessFlags) == AccessFlags;
     }
 
+    // ID of the upload batch that initializes the resource, or 0 if the initialization commands have been submitted
+    Uint64 GetUploadBatchId() const { return m_UploadBatchId; }
+
     void* GetCPUAddress()
     {
         VERIFY_EXPR(m_Desc.Usage == USAGE_STAGING || m_Desc.Usage == USAGE_UNIFIED);
@@ -131,6 +134,7 @@ private:
 
     VulkanUtilities::BufferWrapper          m_VulkanBuffer;
     VulkanUtilities::VulkanMemoryAllocation m_MemoryAllocation;
+    Uint64                                  m_UploadBatchId = 0;
 };
 
 } // namespace Diligent
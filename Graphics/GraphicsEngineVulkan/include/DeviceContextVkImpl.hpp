@@ -231,6 +231,9 @@ public:
     /// Implementation of IDeviceContext::ExecuteCommandList() in Vulkan backend.
     virtual void DILIGENT_CALL_TYPE ExecuteCommandList(class ICommandList* pCommandList) override final;
 
+    /// Implementation of IDeviceContext::ExecuteCommandLists() in Vulkan backend.
+    virtual void DILIGENT_CALL_TYPE ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists) override final;
+
     /// Implementation of IDeviceContext::SignalFence() in Vulkan backend.
     virtual void DILIGENT_CALL_TYPE SignalFence(IFence* pFence, Uint64 Value) override final;
 
@@ -278,6 +281,13 @@ public:
     /// Implementation of IDeviceContextVk::BufferMemoryBarrier().
     virtual void DILIGENT_CALL_TYPE BufferMemoryBarrier(IBuffer* pBuffer, VkAccessFlags NewAccessFlags) override final;
 
+    /// Implementation of IDeviceContextVk::GetQueryData().
+    virtual bool DILIGENT_CALL_TYPE GetQueryData(Uint32         NumQueries,
+                                                 IQuery* const* ppQueries,
+                                                 void*          pData,
+                                                 Uint32         DataStride,
+                                                 bool           AutoInvalidate) override final;
+
 
     void AddWaitSemaphore(ManagedSemaphore* pWaitSemaphore, VkPipelineStageFlags WaitDstStageMask)
     {
@@ -321,6 +331,10 @@ public:
 
     size_t GetNumCommandsInCtx() const { return m_State.NumCommands; }
 
+    /// Returns the number of times rebinding descriptor sets with dynamic offsets was skipped
+    /// because no dynamic buffer used by the committed resources was remapped.
+    Uint64 GetNumSkippedDynamicRebinds() const { return m_NumSkippedDynamicRebinds; }
+
     __forceinline VulkanUtilities::VulkanCommandBuffer& GetCommandBuffer()
     {
         EnsureVkCmdBuffer();
@@ -359,6 +373,9 @@ private:
     void               CommitViewports();
     void               CommitScissorRects();
 
+    // Submits commands recorded by this context followed by the command lists, if any, in a single batch
+    void Flush(Uint32 NumCommandLists, ICommandList* const* ppCommandLists);
+
     __forceinline void TransitionOrVerifyBufferState(BufferVkImpl&                  Buffer,
                                                      RESOURCE_STATE_TRANSITION_MODE TransitionMode,
                                                      RESOURCE_STATE                 RequiredState,
@@ -423,6 +440,7 @@ private:
     __forceinline void          PrepareForIndexedDraw(DRAW_FLAGS Flags, VALUE_TYPE IndexType);
     __forceinline BufferVkImpl* PrepareIndirectDrawAttribsBuffer(IBuffer* pAttribsBuffer, RESOURCE_STATE_TRANSITION_MODE TransitonMode);
     __forceinline void          PrepareForDispatchCompute();
+    __forceinline void          BindDescriptorSetsWithDynamicOffsets();
 
     void DvpLogRenderPass_PSOMismatch();
 
@@ -459,6 +477,9 @@ private:
     std::vector<VkSemaphore> m_VkWaitSemaphores;
     std::vector<VkSemaphore> m_VkSignalSemaphores;
 
+    // Command buffers submitted by the Flush() call; kept as a member to avoid reallocations
+    std::vector<VkCommandBuffer> m_VkCmdBuffsToSubmit;
+
     // List of fences to signal next time the command context is flushed
     std::vector<std::pair<Uint64, RefCntAutoPtr<IFence>>> m_PendingFences;
 
@@ -497,6 +518,11 @@ private:
     DynamicDescriptorSetAllocator            m_DynamicDescrSetAllocator;
 
     PipelineLayout::DescriptorSetBindInfo m_DescrSetBindInfo;
+
+    // Incremented every time a dynamic buffer is given new dynamic space in this
+    // context, which changes its dynamic offset
+    Uint32                                m_DynamicBufferVersion     = 0;
+    Uint64                                m_NumSkippedDynamicRebinds = 0;
     std::shared_ptr<GenerateMipsVkHelper> m_GenerateMipsHelper;
     RefCntAutoPtr<IShaderResourceBinding> m_GenerateMipsSRB;
 
@@ -43,6 +43,7 @@ namespace Diligent
 class RenderDeviceVkImpl;
 class DeviceContextVkImpl;
 class ShaderResourceCacheVk;
+class PipelineLayoutCache;
 
 /// Implementation of the Diligent::PipelineLayout class
 class PipelineLayout
@@ -51,8 +52,10 @@ public:
     static VkDescriptorType GetVkDescriptorType(const SPIRVShaderResourceAttribs& Res);
 
     PipelineLayout();
-    void Release(RenderDeviceVkImpl* pDeviceVkImpl, Uint64 CommandQueueMask);
-    void Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice);
+    void Release(RenderDeviceVkImpl* pDeviceVkImpl);
+    // Descriptor set layouts and the pipeline layout are obtained from the device-wide cache,
+    // so pipeline states with identical resource layouts share the same Vulkan objects.
+    void Finalize(RenderDeviceVkImpl* pDeviceVkImpl, Uint64 CommandQueueMask);
 
     VkPipelineLayout GetVkPipelineLayout() const { return m_LayoutMgr.GetVkPipelineLayout(); }
 
@@ -60,7 +63,7 @@ public:
 
     void InitResourceCache(RenderDeviceVkImpl*    pDeviceVkImpl,
                            ShaderResourceCacheVk& ResourceCache,
-                           IMemoryAllocator&      CacheMemAllocator,
+                           void*                  pCacheMemory,
                            const char*            DbgPipelineName) const;
 
     void AllocateResourceSlot(const SPIRVShaderResourceAttribs& ResAttribs,
@@ -80,7 +83,8 @@ public:
 
     bool IsSameAs(const PipelineLayout& RS) const
     {
-        return m_LayoutMgr == RS.m_LayoutMgr;
+        // Identical layouts share the same Vulkan object unless they use different immutable samplers
+        return GetVkPipelineLayout() == RS.GetVkPipelineLayout() || m_LayoutMgr == RS.m_LayoutMgr;
     }
     size_t GetHash() const
     {
@@ -102,6 +106,9 @@ public:
         Uint32                       DynamicOffsetCount      = 0;
         bool                         DynamicBuffersPresent   = false;
         bool                         DynamicDescriptorsBound = false;
+        // Version of dynamic buffers in the device context when the sets were last bound
+        // with dynamic offsets (see DeviceContextVkImpl::m_DynamicBufferVersion)
+        Uint32 DynamicBufferVersion = 0;
 #ifdef DILIGENT_DEBUG
         const PipelineLayout* pDbgPipelineLayout = nullptr;
 #endif
@@ -142,8 +149,9 @@ public:
                                DescriptorSetBindInfo&       BindInfo,
                                VkDescriptorSet              VkDynamicDescrSet) const;
 
-    // Computes dynamic offsets and binds descriptor sets
-    __forceinline void BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer& CmdBuffer,
+    // Computes dynamic offsets and binds descriptor sets. If the sets have already been bound
+    // and none of the offsets has changed, the binding is skipped and the function returns false.
+    __forceinline bool BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer& CmdBuffer,
                                                             Uint32                                CtxId,
                                                             DeviceContextVkImpl*                  pCtxVkImpl,
                                                             DescriptorSetBindInfo&                BindInfo) const;
@@ -162,17 +170,17 @@ private:
             DescriptorSetLayout& operator = (DescriptorSetLayout&&)      = delete;
             // clang-format on
 
-            uint32_t                                    TotalDescriptors      = 0;
-            int8_t                                      SetIndex              = -1;
-            uint8_t                                     NumDynamicDescriptors = 0; // Total number of uniform and storage buffers, counting all array elements
-            uint16_t                                    NumLayoutBindings     = 0;
-            VkDescriptorSetLayoutBinding*               pBindings             = nullptr;
-            VulkanUtilities::DescriptorSetLayoutWrapper VkLayout;
+            uint32_t                      TotalDescriptors      = 0;
+            int8_t                        SetIndex              = -1;
+            uint8_t                       NumDynamicDescriptors = 0; // Total number of uniform and storage buffers, counting all array elements
+            uint16_t                      NumLayoutBindings     = 0;
+            VkDescriptorSetLayoutBinding* pBindings             = nullptr;
+            VkDescriptorSetLayout         VkLayout              = VK_NULL_HANDLE; // Owned by the PipelineLayoutCache
 
             ~DescriptorSetLayout();
             void AddBinding(const VkDescriptorSetLayoutBinding& Binding, IMemoryAllocator& MemAllocator);
-            void Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice, IMemoryAllocator& MemAllocator, VkDescriptorSetLayoutBinding* pNewBindings);
-            void Release(RenderDeviceVkImpl* pRenderDeviceVk, IMemoryAllocator& MemAllocator, Uint64 CommandQueueMask);
+            void Finalize(PipelineLayoutCache& LayoutCache, Uint64 CommandQueueMask, IMemoryAllocator& MemAllocator, VkDescriptorSetLayoutBinding* pNewBindings);
+            void Release(PipelineLayoutCache& LayoutCache, IMemoryAllocator& MemAllocator);
 
             bool   operator==(const DescriptorSetLayout& rhs) const;
             bool   operator!=(const DescriptorSetLayout& rhs) const { return !(*this == rhs); }
@@ -193,8 +201,8 @@ private:
         DescriptorSetLayoutManager& operator= (DescriptorSetLayoutManager&&)      = delete;
         // clang-format on
 
-        void Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice);
-        void Release(RenderDeviceVkImpl* pRenderDeviceVk, Uint64 CommandQueueMask);
+        void Finalize(PipelineLayoutCache& LayoutCache, Uint64 CommandQueueMask);
+        void Release(PipelineLayoutCache& LayoutCache);
 
         DescriptorSetLayout&       GetDescriptorSet(SHADER_RESOURCE_VARIABLE_TYPE VarType) { return m_DescriptorSetLayouts[VarType == SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC ? 1 : 0]; }
         const DescriptorSetLayout& GetDescriptorSet(SHADER_RESOURCE_VARIABLE_TYPE VarType) const { return m_DescriptorSetLayouts[VarType == SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC ? 1 : 0]; }
@@ -214,7 +222,7 @@ private:
 
     private:
         IMemoryAllocator&                                                                           m_MemAllocator;
-        VulkanUtilities::PipelineLayoutWrapper                                                      m_VkPipelineLayout;
+        VkPipelineLayout                                                                            m_VkPipelineLayout = VK_NULL_HANDLE; // Owned by the PipelineLayoutCache
         std::array<DescriptorSetLayout, 2>                                                          m_DescriptorSetLayouts;
         std::vector<VkDescriptorSetLayoutBinding, STDAllocatorRawMem<VkDescriptorSetLayoutBinding>> m_LayoutBindings;
         uint8_t                                                                                     m_ActiveSets = 0;
@@ -225,7 +233,7 @@ private:
 };
 
 
-__forceinline void PipelineLayout::BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer& CmdBuffer,
+__forceinline bool PipelineLayout::BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer& CmdBuffer,
                                                                         Uint32                                CtxId,
                                                                         DeviceContextVkImpl*                  pCtxVkImpl,
                                                                         DescriptorSetBindInfo&                BindInfo) const
@@ -246,10 +254,15 @@ __forceinline void PipelineLayout::BindDescriptorSetsWithDynamicOffsets(VulkanUt
     VERIFY_EXPR(BindInfo.DynamicOffsets.size() >= BindInfo.DynamicOffsetCount);
 #endif
 
-    auto NumOffsetsWritten = BindInfo.pResourceCache->GetDynamicBufferOffsets(CtxId, pCtxVkImpl, BindInfo.DynamicOffsets);
+    bool OffsetsChanged    = false;
+    auto NumOffsetsWritten = BindInfo.pResourceCache->GetDynamicBufferOffsets(CtxId, pCtxVkImpl, BindInfo.DynamicOffsets, OffsetsChanged);
     VERIFY_EXPR(NumOffsetsWritten == BindInfo.DynamicOffsetCount);
     (void)NumOffsetsWritten;
 
+    // The offsets are still valid for the sets currently bound in the command buffer
+    if (BindInfo.DynamicDescriptorsBound && !OffsetsChanged)
+        return false;
+
     // Note that there is one global dynamic buffer from which all dynamic resources are suballocated in Vulkan back-end,
     // and this buffer is not resizable, so the buffer handle can never change.
 
@@ -267,6 +280,7 @@ __forceinline void PipelineLayout::BindDescriptorSetsWithDynamicOffsets(VulkanUt
                                  BindInfo.DynamicOffsets.data());
 
     BindInfo.DynamicDescriptorsBound = true;
+    return true;
 }
 
 } // namespace Diligent
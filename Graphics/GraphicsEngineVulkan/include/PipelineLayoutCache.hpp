@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::PipelineLayoutCache class
+
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <mutex>
+#include "HashUtils.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "VulkanUtilities/VulkanObjectWrappers.hpp"
+
+namespace Diligent
+{
+
+class RenderDeviceVkImpl;
+class PipelineStateVkImpl;
+
+/// Device-wide cache of Vulkan descriptor set layouts and pipeline layouts.
+
+/// Pipeline states with identical resource layouts share the same Vulkan objects.
+/// Every Get*() call increments the reference counter of the returned object and
+/// must be paired with the corresponding Release*() call.
+class PipelineLayoutCache
+{
+public:
+    static constexpr Uint32 MaxDescriptorSets = 2;
+
+    PipelineLayoutCache(RenderDeviceVkImpl& DeviceVk) noexcept;
+
+    // clang-format off
+    PipelineLayoutCache             (const PipelineLayoutCache&) = delete;
+    PipelineLayoutCache             (PipelineLayoutCache&&)      = delete;
+    PipelineLayoutCache& operator = (const PipelineLayoutCache&) = delete;
+    PipelineLayoutCache& operator = (PipelineLayoutCache&&)      = delete;
+    // clang-format on
+
+    ~PipelineLayoutCache();
+
+    VkDescriptorSetLayout GetDescriptorSetLayout(const VkDescriptorSetLayoutBinding* pBindings, Uint32 NumBindings, Uint64 CommandQueueMask);
+    void                  ReleaseDescriptorSetLayout(VkDescriptorSetLayout vkSetLayout);
+
+    // Descriptor set layouts must stay referenced for as long as the pipeline layout
+    // that uses them is, i.e. the pipeline layout must be released first.
+    VkPipelineLayout GetPipelineLayout(const VkDescriptorSetLayout* pSetLayouts, Uint32 NumSets, Uint64 CommandQueueMask);
+    void             ReleasePipelineLayout(VkPipelineLayout vkPipelineLayout);
+
+    // Returns the pipeline state that new pipelines with the given layout and bind point
+    // should be derived from, or null if there is no such pipeline.
+    RefCntAutoPtr<PipelineStateVkImpl> GetBasePipeline(VkPipelineLayout vkPipelineLayout, VkPipelineBindPoint BindPoint);
+
+    // Makes the pipeline state the base pipeline for its layout and bind point,
+    // unless there already is a live one.
+    void SetBasePipeline(VkPipelineLayout vkPipelineLayout, VkPipelineBindPoint BindPoint, PipelineStateVkImpl* pPSO);
+
+private:
+    struct DescriptorSetLayoutKey
+    {
+        DescriptorSetLayoutKey(const VkDescriptorSetLayoutBinding* pBindings, Uint32 NumBindings);
+
+        bool operator==(const DescriptorSetLayoutKey& rhs) const;
+
+        // pImmutableSamplers members are always null
+        std::vector<VkDescriptorSetLayoutBinding> Bindings;
+        // Immutable samplers of all bindings (descriptorCount handles for every binding that
+        // has immutable samplers and a single null handle for every binding that does not)
+        std::vector<VkSampler> ImmutableSamplers;
+
+        size_t Hash = 0;
+    };
+
+    struct PipelineLayoutKey
+    {
+        PipelineLayoutKey(const VkDescriptorSetLayout* pSetLayouts, Uint32 NumSets);
+
+        bool operator==(const PipelineLayoutKey& rhs) const
+        {
+            return Hash == rhs.Hash && NumSets == rhs.NumSets && SetLayouts == rhs.SetLayouts;
+        }
+
+        Uint32                                               NumSets    = 0;
+        std::array<VkDescriptorSetLayout, MaxDescriptorSets> SetLayouts = {};
+
+        size_t Hash = 0;
+    };
+
+    struct KeyHash
+    {
+        template <typename KeyType>
+        std::size_t operator()(const KeyType& Key) const
+        {
+            return Key.Hash;
+        }
+    };
+
+    struct DescriptorSetLayoutEntry
+    {
+        VulkanUtilities::DescriptorSetLayoutWrapper Layout;
+
+        Uint32 RefCount         = 0;
+        Uint64 CommandQueueMask = 0; // Combined mask of all pipeline states that use the layout
+    };
+
+    struct PipelineLayoutEntry
+    {
+        VulkanUtilities::PipelineLayoutWrapper Layout;
+
+        Uint32 RefCount         = 0;
+        Uint64 CommandQueueMask = 0;
+
+        // Base pipelines for derivatives (graphics and compute)
+        RefCntWeakPtr<PipelineStateVkImpl> BasePipelines[2];
+    };
+
+    static Uint32 GetBasePipelineIndex(VkPipelineBindPoint BindPoint)
+    {
+        return BindPoint == VK_PIPELINE_BIND_POINT_COMPUTE ? 1 : 0;
+    }
+
+    RenderDeviceVkImpl& m_DeviceVkImpl;
+
+    std::mutex m_Mutex;
+
+    std::unordered_map<DescriptorSetLayoutKey, DescriptorSetLayoutEntry, KeyHash> m_SetLayouts;
+    std::unordered_map<PipelineLayoutKey, PipelineLayoutEntry, KeyHash>           m_PipelineLayouts;
+
+    // Pointers to elements of unordered_map are never invalidated
+    std::unordered_map<VkDescriptorSetLayout, const DescriptorSetLayoutKey*> m_SetLayoutKeys;
+    std::unordered_map<VkPipelineLayout, const PipelineLayoutKey*>           m_PipelineLayoutKeys;
+};
+
+} // namespace Diligent
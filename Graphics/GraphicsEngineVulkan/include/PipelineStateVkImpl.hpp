@@ -92,12 +92,12 @@ public:
                                             RESOURCE_STATE_TRANSITION_MODE         StateTransitionMode,
                                             PipelineLayout::DescriptorSetBindInfo* pDescrSetBindInfo) const;
 
-    __forceinline void BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer&  CmdBuffer,
+    __forceinline bool BindDescriptorSetsWithDynamicOffsets(VulkanUtilities::VulkanCommandBuffer&  CmdBuffer,
                                                             Uint32                                 CtxId,
                                                             DeviceContextVkImpl*                   pCtxVkImpl,
                                                             PipelineLayout::DescriptorSetBindInfo& BindInfo)
     {
-        m_PipelineLayout.BindDescriptorSetsWithDynamicOffsets(CmdBuffer, CtxId, pCtxVkImpl, BindInfo);
+        return m_PipelineLayout.BindDescriptorSetsWithDynamicOffsets(CmdBuffer, CtxId, pCtxVkImpl, BindInfo);
     }
 
     const PipelineLayout& GetPipelineLayout() const { return m_PipelineLayout; }
@@ -113,6 +113,24 @@ public:
         return m_SRBMemAllocator;
     }
 
+    // Every shader resource binding object keeps all its data in a single memory block
+    // allocated from the SRB memory allocator:
+    //
+    // |  VarMgr[0]  | ... |  VarMgr[Ns-1]  |  Vars of stage 0  | ... |  Vars of stage Ns-1  |  Resource cache data  |
+    //
+    //  Ns = GetNumShaderStages()
+    struct SRBMemoryLayout
+    {
+        std::array<size_t, MAX_SHADERS_IN_PIPELINE> VarDataOffsets = {};
+
+        size_t CacheDataOffset = 0;
+        size_t TotalSize       = 0;
+    };
+    const SRBMemoryLayout& GetSRBMemoryLayout() const
+    {
+        return m_SRBMemLayout;
+    }
+
     static RenderPassDesc GetImplicitRenderPassDesc(Uint32                                                        NumRenderTargets,
                                                     const TEXTURE_FORMAT                                          RTVFormats[],
                                                     TEXTURE_FORMAT                                                DSVFormat,
@@ -149,6 +167,7 @@ private:
 
     // SRB memory allocator must be declared before m_pDefaultShaderResBinding
     SRBMemoryAllocator m_SRBMemAllocator;
+    SRBMemoryLayout    m_SRBMemLayout;
 
     VulkanUtilities::PipelineWrapper m_Pipeline;
     PipelineLayout                   m_PipelineLayout;
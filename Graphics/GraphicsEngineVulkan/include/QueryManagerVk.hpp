@@ -29,25 +29,33 @@
 
 #include <mutex>
 #include <array>
-#include <deque>
 #include <vector>
+#include <memory>
 
 #include "Query.h"
+#include "VariableSizeAllocationsManager.hpp"
 #include "VulkanUtilities/VulkanLogicalDevice.hpp"
 #include "VulkanUtilities/VulkanPhysicalDevice.hpp"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
 #include "VulkanUtilities/VulkanCommandBuffer.hpp"
+#include "VulkanUtilities/VulkanMemoryManager.hpp"
 
 namespace Diligent
 {
 
 class RenderDeviceVkImpl;
 
+// Query manager is owned by an immediate context.
+// Queries are allocated by the context in contiguous ranges. Results of all queries ended
+// in a command buffer are copied into a host-visible readback buffer with a few
+// vkCmdCopyQueryPoolResults commands when the command buffer is submitted, so that
+// reading the results does not require calling vkGetQueryPoolResults for every query.
 class QueryManagerVk
 {
 public:
     QueryManagerVk(RenderDeviceVkImpl* RenderDeviceVk,
-                   const Uint32        QueryHeapSizes[]);
+                   const Uint32        QueryHeapSizes[],
+                   Uint32              CommandQueueId);
     ~QueryManagerVk();
 
     // clang-format off
@@ -59,8 +67,17 @@ public:
 
     static constexpr Uint32 InvalidIndex = static_cast<Uint32>(-1);
 
+    // Allocates a single query from the current range of the context.
+    // Must only be called from the thread that owns the context.
     Uint32 AllocateQuery(QUERY_TYPE Type);
-    void   DiscardQuery(QUERY_TYPE Type, Uint32 Index);
+
+    // Allocates a range of contiguous queries and returns the index of the first one,
+    // or InvalidIndex if there is no free range of the requested size.
+    Uint32 AllocateQueryRange(QUERY_TYPE Type, Uint32 Count);
+
+    // Queries may be discarded from any thread
+    void DiscardQuery(QUERY_TYPE Type, Uint32 Index);
+    void DiscardQueryRange(QUERY_TYPE Type, Uint32 FirstIndex, Uint32 Count);
 
     VkQueryPool GetQueryPool(QUERY_TYPE Type)
     {
@@ -74,22 +91,76 @@ public:
 
     Uint32 ResetStaleQueries(VulkanUtilities::VulkanCommandBuffer& CmdBuff);
 
+    // Marks the query as ended in the current command buffer so that its
+    // results will be copied to the readback buffer by CopyEndedQueryResults().
+    // Must only be called from the thread that owns the context.
+    void OnQueryEnded(QUERY_TYPE Type, Uint32 Index)
+    {
+        m_Heaps[Type].EndedQueries.push_back(Index);
+    }
+
+    // Records commands that copy results of all queries ended in the current command buffer to the readback buffer.
+    // Must be called before ResetStaleQueries() as a query may be ended and discarded in the same command buffer.
+    Uint32 CopyEndedQueryResults(VulkanUtilities::VulkanCommandBuffer& CmdBuff);
+
+    // Returns the number of 64-bit values written for every query of the given type,
+    // not including the availability value that follows them.
+    Uint32 GetNumQueryResults(QUERY_TYPE Type) const
+    {
+        return m_Heaps[Type].NumResults;
+    }
+
+    // Returns the pointer to the query results in the readback buffer, or null if the readback buffer is not available.
+    // The results are only valid once the command buffer that ended the query has completed.
+    const Uint64* GetQueryResults(QUERY_TYPE Type, Uint32 Index) const
+    {
+        const auto& HeapInfo = m_Heaps[Type];
+        if (m_pReadbackData == nullptr)
+            return nullptr;
+        VERIFY_EXPR(Index < HeapInfo.QueryCount);
+        return m_pReadbackData + HeapInfo.ReadbackOffset + size_t{Index} * (HeapInfo.NumResults + 1);
+    }
+
 private:
+    void CreateReadbackBuffer(RenderDeviceVkImpl* pRenderDeviceVk);
+
     struct QueryHeapInfo
     {
         VulkanUtilities::QueryPoolWrapper vkQueryPool;
 
-        std::deque<Uint32>  AvailableQueries;
+        // Free query ranges, protected by m_HeapMutex
+        std::unique_ptr<VariableSizeAllocationsManager> FreeQueries;
+
         std::vector<Uint32> StaleQueries;
 
+        // The range the context allocates queries from. Only accessed by the context thread.
+        Uint32 CurrRangeFirst = 0;
+        Uint32 CurrRangeEnd   = 0;
+
+        // Queries ended in the current command buffer. Only accessed by the context thread.
+        std::vector<Uint32> EndedQueries;
+
         Uint32 PoolSize            = 0;
+        Uint32 QueryCount          = 0; // The number of queries in Vulkan pool (twice the pool size for duration queries)
+        Uint32 RangeSize           = 1;
         Uint32 MaxAllocatedQueries = 0;
+
+        // The number of 64-bit results per query and the offset of the first query, in 64-bit values, in the readback buffer
+        Uint32 NumResults     = 1;
+        size_t ReadbackOffset = 0;
     };
 
     std::mutex                                      m_HeapMutex;
     std::array<QueryHeapInfo, QUERY_TYPE_NUM_TYPES> m_Heaps;
 
     Uint64 m_CounterFrequency = 0;
+
+    RenderDeviceVkImpl* const m_pDevice;
+    const Uint32              m_CommandQueueId;
+
+    VulkanUtilities::BufferWrapper          m_ReadbackBuffer;
+    VulkanUtilities::VulkanMemoryAllocation m_ReadbackMemory;
+    const Uint64*                           m_pReadbackData = nullptr;
 };
 
 } // namespace Diligent
@@ -71,7 +71,17 @@ public:
     bool OnEndQuery(IDeviceContext* pContext);
     bool OnBeginQuery(IDeviceContext* pContext);
 
+    Uint64 GetEndFenceValue() const
+    {
+        return m_QueryEndFenceValue;
+    }
+
+    // Reads the query data assuming that the command buffer that ended the query has completed.
+    bool ReadData(void* pData);
+
 private:
+    bool ReadResults(Uint32 QueryIdx, Uint64* pResults, Uint32 NumResults);
+
     bool AllocateQueries();
     void DiscardQueries();
 
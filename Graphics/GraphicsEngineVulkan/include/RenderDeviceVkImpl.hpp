@@ -30,6 +30,9 @@
 /// \file
 /// Declaration of Diligent::RenderDeviceVkImpl class
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
 
 #include "RenderDeviceVk.h"
 #include "RenderDeviceBase.hpp"
@@ -47,6 +50,8 @@
 #include "VulkanUploadHeap.hpp"
 #include "FramebufferCache.hpp"
 #include "RenderPassCache.hpp"
+#include "PipelineLayoutCache.hpp"
+#include "ShaderReflectionCache.hpp"
 #include "CommandPoolManager.hpp"
 #include "DXCompiler.hpp"
 
@@ -133,6 +138,18 @@ public:
                                                                    RESOURCE_STATE    InitialState,
                                                                    IBuffer**         ppBuffer) override final;
 
+    /// Implementation of IRenderDeviceVk::BeginUploadBatch().
+    virtual void DILIGENT_CALL_TYPE BeginUploadBatch() override final;
+
+    /// Implementation of IRenderDeviceVk::EndUploadBatch().
+    virtual void DILIGENT_CALL_TYPE EndUploadBatch() override final;
+
+    /// Implementation of IRenderDeviceVk::ClearShaderReflectionCache().
+    virtual void DILIGENT_CALL_TYPE ClearShaderReflectionCache() override final
+    {
+        m_ShaderReflectionCache.Clear();
+    }
+
     /// Implementation of IRenderDevice::IdleGPU() in Vulkan backend.
     virtual void DILIGENT_CALL_TYPE IdleGPU() override final;
 
@@ -143,6 +160,33 @@ public:
     void AllocateTransientCmdPool(VulkanUtilities::CommandPoolWrapper& CmdPool, VkCommandBuffer& vkCmdBuff, const Char* DebugPoolName = nullptr);
     void ExecuteAndDisposeTransientCmdBuff(Uint32 QueueIndex, VkCommandBuffer vkCmdBuff, VulkanUtilities::CommandPoolWrapper&& CmdPool);
 
+    struct ResourceUploadSpace
+    {
+        VkBuffer     vkBuffer    = VK_NULL_HANDLE;
+        VkDeviceSize Offset      = 0;
+        Uint8*       pCPUAddress = nullptr;
+    };
+    using ResourceUploadDataWriter     = std::function<void(const ResourceUploadSpace& UploadSpace)>;
+    using ResourceInitCommandsRecorder = std::function<void(VkCommandBuffer vkCmdBuff, const ResourceUploadSpace& UploadSpace)>;
+
+    // Records commands that initialize a resource. UploadSize bytes of host-visible staging memory are
+    // provided to the writer and then to the recorder; the offset is a multiple of UploadAlignment (which
+    // does not need to be a power of two). The writer may be empty if UploadSize is zero.
+    // If an upload batch is active, the commands are appended to the batch command buffer and are submitted
+    // by EndUploadBatch(). The writer is called without holding the batch mutex, so that threads can
+    // copy their data in parallel; only the recorder is serialized. Otherwise, a transient command buffer
+    // is submitted to the queue immediately.
+    // Returns the ID of the batch the commands were recorded into, or 0 if they have been submitted.
+    Uint64 RecordResourceInitCommands(VkDeviceSize                        UploadSize,
+                                      VkDeviceSize                        UploadAlignment,
+                                      const ResourceUploadDataWriter&     WriteData,
+                                      const ResourceInitCommandsRecorder& Recorder,
+                                      const Char*                         ResourceName);
+
+    // Keeps the resource alive until the upload batch that initializes it is submitted, so that
+    // its Vulkan objects are not released before the commands that reference them.
+    void RetainUntilUploadBatchSubmitted(IDeviceObject* pResource, Uint64 UploadBatchId);
+
     /// Implementation of IRenderDevice::ReleaseStaleResources() in Vulkan backend.
     virtual void DILIGENT_CALL_TYPE ReleaseStaleResources(bool ForceRelease = false) override final;
 
@@ -160,6 +204,9 @@ public:
     FramebufferCache& GetFramebufferCache() { return m_FramebufferCache; }
     RenderPassCache&  GetImplicitRenderPassCache() { return m_ImplicitRenderPassCache; }
 
+    PipelineLayoutCache&   GetPipelineLayoutCache() { return m_PipelineLayoutCache; }
+    ShaderReflectionCache& GetShaderReflectionCache() { return m_ShaderReflectionCache; }
+
     VulkanUtilities::VulkanMemoryAllocation AllocateMemory(const VkMemoryRequirements& MemReqs, VkMemoryPropertyFlags MemoryProperties)
     {
         return m_MemoryMgr.Allocate(MemReqs, MemoryProperties);
@@ -189,6 +236,20 @@ private:
     //      * SubmittedFenceValue    - fence value associated with the submitted command buffer
     void SubmitCommandBuffer(Uint32 QueueIndex, const VkSubmitInfo& SubmitInfo, Uint64& SubmittedCmdBuffNumber, Uint64& SubmittedFenceValue, std::vector<std::pair<Uint64, RefCntAutoPtr<IFence>>>* pFences);
 
+    struct StagingBuffer
+    {
+        VulkanUtilities::BufferWrapper          Buffer;
+        VulkanUtilities::VulkanMemoryAllocation Memory;
+        Uint8*                                  pCPUAddress = nullptr;
+        VkDeviceSize                            Size        = 0;
+        VkDeviceSize                            UsedSize    = 0;
+    };
+    StagingBuffer CreateStagingBuffer(VkDeviceSize Size, const Char* Name);
+    void          ReleaseStagingBuffer(StagingBuffer&& Staging, Uint32 QueueIndex);
+
+    // Must be called while m_UploadBatchMtx is locked
+    void SubmitUploadBatch();
+
     std::shared_ptr<VulkanUtilities::VulkanInstance>       m_VulkanInstance;
     std::unique_ptr<VulkanUtilities::VulkanPhysicalDevice> m_PhysicalDevice;
     std::shared_ptr<VulkanUtilities::VulkanLogicalDevice>  m_LogicalVkDevice;
@@ -197,6 +258,8 @@ private:
 
     FramebufferCache       m_FramebufferCache;
     RenderPassCache        m_ImplicitRenderPassCache;
+    PipelineLayoutCache    m_PipelineLayoutCache;
+    ShaderReflectionCache  m_ShaderReflectionCache;
     DescriptorSetAllocator m_DescriptorSetAllocator;
     DescriptorPoolManager  m_DynamicDescriptorPool;
 
@@ -209,6 +272,21 @@ private:
 
     VulkanDynamicMemoryManager m_DynamicMemoryManager;
 
+    // Upload batch state. Resources created while the batch is active record their
+    // initialization commands into a shared command buffer and sub-allocate staging
+    // memory from the batch pages.
+    std::mutex                                m_UploadBatchMtx;
+    Uint32                                    m_UploadBatchDepth = 0;
+    Uint64                                    m_UploadBatchId    = 1;
+    VulkanUtilities::CommandPoolWrapper       m_UploadBatchCmdPool;
+    VkCommandBuffer                           m_UploadBatchCmdBuff = VK_NULL_HANDLE;
+    std::vector<StagingBuffer>                m_UploadBatchPages;
+    std::vector<RefCntAutoPtr<IDeviceObject>> m_UploadBatchResources;
+
+    // The number of resources that are writing their data into the batch pages.
+    // The batch is not submitted until all of them have recorded their commands.
+    Uint32 m_NumPendingUploads = 0;
+
     std::unique_ptr<IDXCompiler> m_pDxCompiler;
 };
 
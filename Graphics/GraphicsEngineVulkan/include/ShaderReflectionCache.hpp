@@ -0,0 +1,125 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ShaderReflectionCache class
+
+#include <unordered_map>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
+#include "Shader.h"
+
+namespace Diligent
+{
+
+/// Device-wide cache of the serialized SPIRV shader resources.
+
+/// Shaders created from the same SPIRV byte code restore their resources from the data
+/// produced by SPIRVShaderResources::Serialize() instead of reflecting the byte code again.
+/// The total size of the cached data is bounded: when it exceeds the limit, the least
+/// recently used entries are evicted.
+class ShaderReflectionCache
+{
+public:
+    using SerializedDataType = std::shared_ptr<const std::vector<Uint8>>;
+
+    /// \param [in] MaxSize - Maximum total size of the cached data, in bytes.
+    ///                       Zero disables the cache.
+    explicit ShaderReflectionCache(size_t MaxSize) :
+        m_MaxSize{MaxSize}
+    {}
+
+    // clang-format off
+    ShaderReflectionCache             (const ShaderReflectionCache&) = delete;
+    ShaderReflectionCache             (ShaderReflectionCache&&)      = delete;
+    ShaderReflectionCache& operator = (const ShaderReflectionCache&) = delete;
+    ShaderReflectionCache& operator = (ShaderReflectionCache&&)      = delete;
+    // clang-format on
+
+    /// Returns the serialized resources of the byte code, or null if the cache does not contain them.
+    SerializedDataType Find(const std::vector<uint32_t>& SPIRV, SHADER_TYPE ShaderType, const char* CombinedSamplerSuffix);
+
+    /// Adds the serialized resources of the byte code to the cache and evicts the least
+    /// recently used entries if the size limit is exceeded. Data that is larger than the
+    /// limit is not cached.
+    void Add(const std::vector<uint32_t>& SPIRV, SHADER_TYPE ShaderType, const char* CombinedSamplerSuffix, std::vector<Uint8>&& Data);
+
+    /// Removes all entries from the cache. The data that has already been returned
+    /// by Find() remains valid.
+    void Clear();
+
+    /// Returns the total size of the cached data, in bytes.
+    size_t GetSize();
+
+private:
+    // The key only selects the candidate data. The data itself is validated against
+    // the byte code when the resources are restored.
+    struct ReflectionCacheKey
+    {
+        ReflectionCacheKey(const std::vector<uint32_t>& SPIRV, SHADER_TYPE _ShaderType, const char* CombinedSamplerSuffix);
+
+        size_t      SPIRVHash;
+        size_t      SPIRVSize;
+        SHADER_TYPE ShaderType;
+        bool        UseCombinedSamplers;
+        std::string CombinedSamplerSuffix;
+
+        bool   operator==(const ReflectionCacheKey& rhs) const;
+        size_t GetHash() const;
+    };
+
+    struct ReflectionCacheKeyHash
+    {
+        std::size_t operator()(const ReflectionCacheKey& Key) const
+        {
+            return Key.GetHash();
+        }
+    };
+
+    // Most recently used keys are at the front of the list
+    using LRUListType = std::list<ReflectionCacheKey>;
+
+    struct CacheEntry
+    {
+        SerializedDataType    pData;
+        LRUListType::iterator LRUIt;
+    };
+
+    const size_t m_MaxSize;
+
+    std::mutex                                                                 m_Mutex;
+    std::unordered_map<ReflectionCacheKey, CacheEntry, ReflectionCacheKeyHash> m_Cache;
+    LRUListType                                                                m_LRUList;
+    size_t                                                                     m_Size = 0;
+};
+
+} // namespace Diligent
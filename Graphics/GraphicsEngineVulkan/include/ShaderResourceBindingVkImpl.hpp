@@ -30,12 +30,15 @@
 /// \file
 /// Declaration of Diligent::ShaderResourceBindingVkImpl class
 
+#include <memory>
+
 #include "ShaderResourceBindingVk.h"
 #include "RenderDeviceVk.h"
 #include "ShaderResourceBindingBase.hpp"
 #include "ShaderBase.hpp"
 #include "ShaderResourceCacheVk.hpp"
 #include "ShaderVariableVk.hpp"
+#include "STDAllocator.hpp"
 
 namespace Diligent
 {
@@ -43,7 +46,7 @@ namespace Diligent
 class PipelineStateVkImpl;
 
 /// Implementation of the Diligent::IShaderResourceBindingVk interface
-// sizeof(ShaderResourceBindingVkImpl) == 72 (x64, msvc, Release)
+// sizeof(ShaderResourceBindingVkImpl) == 88 (x64, msvc, Release)
 class ShaderResourceBindingVkImpl final : public ShaderResourceBindingBase<IShaderResourceBindingVk, PipelineStateVkImpl>
 {
 public:
@@ -76,6 +79,11 @@ public:
     bool StaticResourcesInitialized() const { return m_bStaticResourcesInitialized; }
 
 private:
+    // Single memory block that holds shader variable managers, shader variables and
+    // resource cache data (see PipelineStateVkImpl::SRBMemoryLayout).
+    // Must be declared before m_ShaderResourceCache so that it is released after the cache.
+    std::unique_ptr<void, STDDeleterRawMem<void>> m_MemoryBuffer;
+
     ShaderResourceCacheVk    m_ShaderResourceCache;
     ShaderVariableManagerVk* m_pShaderVarMgrs = nullptr;
 
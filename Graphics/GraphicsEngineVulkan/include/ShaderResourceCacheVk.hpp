@@ -93,6 +93,9 @@ public:
     static size_t GetRequiredMemorySize(Uint32 NumSets, Uint32 SetSizes[]);
 
     void InitializeSets(IMemoryAllocator& MemAllocator, Uint32 NumSets, Uint32 SetSizes[]);
+    // Initializes the sets in the memory owned by the caller. The memory must be at least
+    // GetRequiredMemorySize() bytes large and must outlive the cache.
+    void InitializeSets(void* pMemory, Uint32 NumSets, Uint32 SetSizes[]);
     void InitializeResources(Uint32 Set, Uint32 Offset, Uint32 ArraySize, SPIRVShaderResourceAttribs::ResourceType Type);
 
     // sizeof(Resource) == 16 (x64, msvc, Release)
@@ -197,7 +200,9 @@ public:
     template <bool VerifyOnly>
     void TransitionResources(DeviceContextVkImpl* pCtxVkImpl);
 
-    __forceinline Uint32 GetDynamicBufferOffsets(Uint32 CtxId, DeviceContextVkImpl* pCtxVkImpl, std::vector<uint32_t>& Offsets) const;
+    // Writes dynamic offsets of all uniform and storage buffers to Offsets. OffsetsChanged is set to true
+    // if any of the offsets differs from the value that was previously stored in the array.
+    __forceinline Uint32 GetDynamicBufferOffsets(Uint32 CtxId, DeviceContextVkImpl* pCtxVkImpl, std::vector<uint32_t>& Offsets, bool& OffsetsChanged) const;
 
 private:
     Resource* GetFirstResourcePtr()
@@ -209,6 +214,7 @@ private:
         return reinterpret_cast<const Resource*>(reinterpret_cast<const DescriptorSet*>(m_pMemory) + m_NumSets);
     }
 
+    // Null if the memory is owned by the caller
     IMemoryAllocator* m_pAllocator = nullptr;
     void*             m_pMemory    = nullptr;
     Uint16            m_NumSets    = 0;
@@ -226,7 +232,8 @@ private:
 
 __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(Uint32                 CtxId,
                                                                     DeviceContextVkImpl*   pCtxVkImpl,
-                                                                    std::vector<uint32_t>& Offsets) const
+                                                                    std::vector<uint32_t>& Offsets,
+                                                                    bool&                  OffsetsChanged) const
 {
     // If any of the sets being bound include dynamic uniform or storage buffers, then
     // pDynamicOffsets includes one element for each array element in each dynamic descriptor
@@ -250,6 +257,7 @@ __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(Uint32
 
             const auto* pBufferVk = Res.pObject.RawPtr<const BufferVkImpl>();
             auto        Offset    = pBufferVk != nullptr ? pBufferVk->GetDynamicOffset(CtxId, pCtxVkImpl) : 0;
+            OffsetsChanged        = OffsetsChanged || Offsets[OffsetInd] != Offset;
             Offsets[OffsetInd++]  = Offset;
 
             ++res;
@@ -265,6 +273,7 @@ __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(Uint32
             const auto* pBufferVkView = Res.pObject.RawPtr<const BufferViewVkImpl>();
             const auto* pBufferVk     = pBufferVkView != nullptr ? pBufferVkView->GetBufferVk() : 0;
             auto        Offset        = pBufferVk != nullptr ? pBufferVk->GetDynamicOffset(CtxId, pCtxVkImpl) : 0;
+            OffsetsChanged            = OffsetsChanged || Offsets[OffsetInd] != Offset;
             Offsets[OffsetInd++]      = Offset;
 
             ++res;
@@ -80,9 +80,20 @@ public:
                             Uint32                               NumAllowedTypes,
                             ShaderResourceCacheVk&               ResourceCache);
 
+    // Creates variables in the memory owned by the caller. The memory must be at least
+    // GetRequiredMemorySize() bytes large and must outlive the manager.
+    ShaderVariableManagerVk(IObject&                             Owner,
+                            const ShaderResourceLayoutVk&        SrcLayout,
+                            void*                                pVariablesMemory,
+                            const SHADER_RESOURCE_VARIABLE_TYPE* AllowedVarTypes,
+                            Uint32                               NumAllowedTypes,
+                            ShaderResourceCacheVk&               ResourceCache);
+
     ~ShaderVariableManagerVk();
 
     void DestroyVariables(IMemoryAllocator& Allocator);
+    // Destroys variables created in the memory owned by the caller
+    void DestroyVariables();
 
     ShaderVariableVkImpl* GetVariable(const Char* Name);
     ShaderVariableVkImpl* GetVariable(Uint32 Index);
@@ -101,6 +112,10 @@ private:
 
     Uint32 GetVariableIndex(const ShaderVariableVkImpl& Variable);
 
+    void InitVariables(const ShaderResourceLayoutVk&        SrcLayout,
+                       const SHADER_RESOURCE_VARIABLE_TYPE* AllowedVarTypes,
+                       Uint32                               NumAllowedTypes);
+
     IObject& m_Owner;
     // Variable mgr is owned by either Pipeline state object (in which case m_ResourceCache references
     // static resource cache owned by the same PSO object), or by SRB object (in which case
@@ -108,14 +123,14 @@ private:
     // (which the variables reference) are guaranteed to be alive while the manager is alive.
     ShaderResourceCacheVk& m_ResourceCache;
 
-    // Memory is allocated through the allocator provided by the pipeline state. If allocation granularity > 1, fixed block
-    // memory allocator is used. This ensures that all resources from different shader resource bindings reside in
-    // continuous memory. If allocation granularity == 1, raw allocator is used.
+    // Memory is either allocated through the allocator provided by the pipeline state, or is a part
+    // of the single memory block that shader resource binding allocates for all its data.
     ShaderVariableVkImpl* m_pVariables   = nullptr;
     Uint32                m_NumVariables = 0;
 
 #ifdef DILIGENT_DEBUG
-    IMemoryAllocator& m_DbgAllocator;
+    // Null if the memory is owned by the caller
+    IMemoryAllocator* const m_pDbgAllocator;
 #endif
 };
 
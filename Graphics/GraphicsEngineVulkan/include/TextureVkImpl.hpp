@@ -97,6 +97,9 @@ public:
         return StagingDataCPUAddress;
     }
 
+    // ID of the upload batch that initializes the resource, or 0 if the initialization commands have been submitted
+    Uint64 GetUploadBatchId() const { return m_UploadBatchId; }
+
     void InvalidateStagingRange(VkDeviceSize Offset, VkDeviceSize Size);
 
     // Buffer offset must be a multiple of 4 (18.4)
@@ -115,6 +118,7 @@ protected:
     VulkanUtilities::VulkanMemoryAllocation m_MemoryAllocation;
     VkDeviceSize                            m_StagingDataAlignedOffset;
     bool                                    m_bCSBasedMipGenerationSupported = false;
+    Uint64                                  m_UploadBatchId                  = 0;
 };
 
 } // namespace Diligent
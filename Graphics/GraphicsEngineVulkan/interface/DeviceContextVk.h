@@ -89,6 +89,27 @@ DILIGENT_BEGIN_INTERFACE(IDeviceContextVk, IDeviceContext)
 
     /// Unlocks the command queue that was previously locked by IDeviceContextVk::LockCommandQueue().
     VIRTUAL void METHOD(UnlockCommandQueue)(THIS) PURE;
+
+    /// Reads the data of multiple queries at once.
+
+    /// \param [in]  NumQueries     - The number of queries.
+    /// \param [in]  ppQueries      - Pointer to the array of NumQueries queries. All queries must have been
+    ///                               ended in this context.
+    /// \param [out] pData          - Pointer to the array of query data structures, one for every query.
+    ///                               The structure type must match the query type.
+    /// \param [in]  DataStride     - The stride, in bytes, between query data structures in pData array.
+    /// \param [in]  AutoInvalidate - Whether to invalidate the queries if the data of all queries is available.
+    /// \return   true if the data of all queries is available, and false otherwise.
+    ///
+    /// \remarks  Results of all queries ended in a command buffer are copied to a readback buffer
+    ///           when the command buffer is submitted. This method checks the fence once and reads the results
+    ///           from the readback memory, which is considerably faster than calling IQuery::GetData() for every query.
+    VIRTUAL bool METHOD(GetQueryData)(THIS_
+                                      Uint32               NumQueries,
+                                      IQuery* const*       ppQueries,
+                                      void*                pData,
+                                      Uint32               DataStride,
+                                      bool                 AutoInvalidate DEFAULT_VALUE(true)) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -102,6 +123,7 @@ DILIGENT_END_INTERFACE
 #    define IDeviceContextVk_BufferMemoryBarrier(This, ...)   CALL_IFACE_METHOD(DeviceContextVk, BufferMemoryBarrier,   This, __VA_ARGS__)
 #    define IDeviceContextVk_LockCommandQueue(This)           CALL_IFACE_METHOD(DeviceContextVk, LockCommandQueue,      This)
 #    define IDeviceContextVk_UnlockCommandQueue(This)         CALL_IFACE_METHOD(DeviceContextVk, UnlockCommandQueue,    This)
+#    define IDeviceContextVk_GetQueryData(This, ...)          CALL_IFACE_METHOD(DeviceContextVk, GetQueryData,          This, __VA_ARGS__)
 
 // clang-format on
 
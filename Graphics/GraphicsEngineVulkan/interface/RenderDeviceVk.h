@@ -112,6 +112,30 @@ DILIGENT_BEGIN_INTERFACE(IRenderDeviceVk, IRenderDevice)
                                                         const BufferDesc REF BuffDesc,
                                                         RESOURCE_STATE       InitialState,
                                                         IBuffer**            ppBuffer) PURE;
+
+    /// Begins a resource upload batch
+
+    /// While the batch is active, textures and buffers created with initial data by any thread
+    /// sub-allocate their staging memory from shared upload pages and record the copy commands
+    /// into a single command buffer that is submitted by EndUploadBatch(), instead of
+    /// performing one queue submission per resource.
+    ///
+    /// \note  Batches may be nested; the commands are submitted when the outermost batch ends,
+    ///        or, if other threads are still creating resources at that moment, when the last
+    ///        of them has recorded its commands.
+    ///        Resources created inside the batch must not be used by device contexts until
+    ///        the batch has been ended. They may be released before that: the device keeps
+    ///        them alive until the batch commands have been submitted.
+    VIRTUAL void METHOD(BeginUploadBatch)(THIS) PURE;
+
+    /// Ends the resource upload batch started by BeginUploadBatch() and submits
+    /// the recorded initialization commands to the GPU.
+    VIRTUAL void METHOD(EndUploadBatch)(THIS) PURE;
+
+    /// Releases the serialized shader resources kept by the device to avoid reflecting
+    /// the same SPIRV byte code again (see EngineVkCreateInfo::ShaderReflectionCacheSize).
+    /// Shaders that have already been created are not affected.
+    VIRTUAL void METHOD(ClearShaderReflectionCache)(THIS) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -129,6 +153,9 @@ DILIGENT_END_INTERFACE
 #    define IRenderDeviceVk_IsFenceSignaled(This, ...)                CALL_IFACE_METHOD(RenderDeviceVk, IsFenceSignaled,                This, __VA_ARGS__)
 #    define IRenderDeviceVk_CreateTextureFromVulkanImage(This, ...)   CALL_IFACE_METHOD(RenderDeviceVk, CreateTextureFromVulkanImage,   This, __VA_ARGS__)
 #    define IRenderDeviceVk_CreateBufferFromVulkanResource(This, ...) CALL_IFACE_METHOD(RenderDeviceVk, CreateBufferFromVulkanResource, This, __VA_ARGS__)
+#    define IRenderDeviceVk_BeginUploadBatch(This)                    CALL_IFACE_METHOD(RenderDeviceVk, BeginUploadBatch,               This)
+#    define IRenderDeviceVk_EndUploadBatch(This)                      CALL_IFACE_METHOD(RenderDeviceVk, EndUploadBatch,                 This)
+#    define IRenderDeviceVk_ClearShaderReflectionCache(This)          CALL_IFACE_METHOD(RenderDeviceVk, ClearShaderReflectionCache,     This)
 
 // clang-format on
 
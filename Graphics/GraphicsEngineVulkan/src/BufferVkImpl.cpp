@@ -254,82 +254,34 @@ BufferVkImpl::BufferVkImpl(IReferenceCounters*        pRefCounters,
             }
             else
             {
-                VkBufferCreateInfo VkStaginBuffCI = VkBuffCI;
-                VkStaginBuffCI.usage              = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-                std::string StagingBufferName = "Upload buffer for '";
-                StagingBufferName += m_Desc.Name;
-                StagingBufferName += '\'';
-                VulkanUtilities::BufferWrapper StagingBuffer = LogicalDevice.CreateBuffer(VkStaginBuffCI, StagingBufferName.c_str());
-
-                VkMemoryRequirements StagingBufferMemReqs = LogicalDevice.GetBufferMemoryRequirements(StagingBuffer);
-                VERIFY(IsPowerOfTwo(StagingBufferMemReqs.alignment), "Alignment is not power of 2!");
-
-                // VK_MEMORY_PROPERTY_HOST_COHERENT_BIT bit specifies that the host cache management commands vkFlushMappedMemoryRanges
-                // and vkInvalidateMappedMemoryRanges are NOT needed to flush host writes to the device or make device writes visible
-                // to the host (10.2)
-                auto StagingMemoryAllocation = pRenderDeviceVk->AllocateMemory(StagingBufferMemReqs, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-                auto StagingBufferMemory     = StagingMemoryAllocation.Page->GetVkMemory();
-                auto AlignedStagingMemOffset = Align(VkDeviceSize{StagingMemoryAllocation.UnalignedOffset}, StagingBufferMemReqs.alignment);
-                VERIFY_EXPR(StagingMemoryAllocation.Size >= StagingBufferMemReqs.size + (AlignedStagingMemOffset - StagingMemoryAllocation.UnalignedOffset));
-
-                auto* StagingData = reinterpret_cast<uint8_t*>(StagingMemoryAllocation.Page->GetCPUMemory());
-                if (StagingData == nullptr)
-                    LOG_ERROR_AND_THROW("Failed to allocate staging data for buffer '", m_Desc.Name, '\'');
-                memcpy(StagingData + AlignedStagingMemOffset, pBuffData->pData, pBuffData->DataSize);
-
-                err = LogicalDevice.BindBufferMemory(StagingBuffer, StagingBufferMemory, AlignedStagingMemOffset);
-                CHECK_VK_ERROR_AND_THROW(err, "Failed to bind staging bufer memory");
-
-                VulkanUtilities::CommandPoolWrapper CmdPool;
-                VkCommandBuffer                     vkCmdBuff;
-                pRenderDeviceVk->AllocateTransientCmdPool(CmdPool, vkCmdBuff, "Transient command pool to copy staging data to a device buffer");
-
-                auto EnabledGraphicsShaderStages = LogicalDevice.GetEnabledGraphicsShaderStages();
-                VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, StagingBuffer, 0, VK_ACCESS_TRANSFER_READ_BIT, EnabledGraphicsShaderStages);
                 InitialState              = RESOURCE_STATE_COPY_DEST;
                 VkAccessFlags AccessFlags = ResourceStateFlagsToVkAccessFlags(InitialState);
                 VERIFY_EXPR(AccessFlags == VK_ACCESS_TRANSFER_WRITE_BIT);
-                VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, m_VulkanBuffer, 0, AccessFlags, EnabledGraphicsShaderStages);
-
-                // Copy commands MUST be recorded outside of a render pass instance. This is OK here
-                // as copy will be the only command in the cmd buffer
-                VkBufferCopy BuffCopy = {};
-                BuffCopy.srcOffset    = 0;
-                BuffCopy.dstOffset    = 0;
-                BuffCopy.size         = VkBuffCI.size;
-                vkCmdCopyBuffer(vkCmdBuff, StagingBuffer, m_VulkanBuffer, 1, &BuffCopy);
-
-                Uint32 QueueIndex = 0;
-                pRenderDeviceVk->ExecuteAndDisposeTransientCmdBuff(QueueIndex, vkCmdBuff, std::move(CmdPool));
-
-
-                // After command buffer is submitted, safe-release staging resources. This strategy
-                // is little overconservative as the resources will only be released after the
-                // first command buffer submitted through the immediate context is complete
-
-                // Next Cmd Buff| Next Fence |               This Thread                      |           Immediate Context
-                //              |            |                                                |
-                //      N       |     F      |                                                |
-                //              |            |                                                |
-                //              |            |  ExecuteAndDisposeTransientCmdBuff(vkCmdBuff)  |
-                //              |            |  - SubmittedCmdBuffNumber = N                  |
-                //              |            |  - SubmittedFenceValue = F                     |
-                //     N+1 -  - | -  F+1  -  |                                                |
-                //              |            |  Release(StagingBuffer)                        |
-                //              |            |  - {N+1, StagingBuffer} -> Stale Objects       |
-                //              |            |                                                |
-                //              |            |                                                |
-                //              |            |                                                | ExecuteCommandBuffer()
-                //              |            |                                                | - SubmittedCmdBuffNumber = N+1
-                //              |            |                                                | - SubmittedFenceValue = F+1
-                //     N+2 -  - | -  F+2  -  |  -   -   -   -   -   -   -   -   -   -   -   - |
-                //              |            |                                                | - DiscardStaleVkObjects(N+1, F+1)
-                //              |            |                                                |   - {F+1, StagingBuffer} -> Release Queue
-                //              |            |                                                |
-
-                pRenderDeviceVk->SafeReleaseDeviceObject(std::move(StagingBuffer), Uint64{1} << Uint64{QueueIndex});
-                pRenderDeviceVk->SafeReleaseDeviceObject(std::move(StagingMemoryAllocation), Uint64{1} << Uint64{QueueIndex});
+                VERIFY(pBuffData->DataSize <= VkBuffCI.size, "Initial data size exceeds the buffer size");
+
+                // Staging memory is released after the copy command is complete (see RenderDeviceVkImpl::ReleaseStagingBuffer)
+                m_UploadBatchId = pRenderDeviceVk->RecordResourceInitCommands(
+                    pBuffData->DataSize, 4,
+                    [&](const RenderDeviceVkImpl::ResourceUploadSpace& UploadSpace) //
+                    {
+                        VERIFY_EXPR(UploadSpace.pCPUAddress != nullptr);
+                        memcpy(UploadSpace.pCPUAddress, pBuffData->pData, pBuffData->DataSize);
+                    },
+                    [&](VkCommandBuffer vkCmdBuff, const RenderDeviceVkImpl::ResourceUploadSpace& UploadSpace) //
+                    {
+                        auto EnabledGraphicsShaderStages = LogicalDevice.GetEnabledGraphicsShaderStages();
+                        VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, UploadSpace.vkBuffer, 0, VK_ACCESS_TRANSFER_READ_BIT, EnabledGraphicsShaderStages);
+                        VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, m_VulkanBuffer, 0, AccessFlags, EnabledGraphicsShaderStages);
+
+                        // Copy commands MUST be recorded outside of a render pass instance. This is OK here
+                        // as the command buffer only contains resource initialization commands
+                        VkBufferCopy BuffCopy = {};
+                        BuffCopy.srcOffset    = UploadSpace.Offset;
+                        BuffCopy.dstOffset    = 0;
+                        BuffCopy.size         = pBuffData->DataSize;
+                        vkCmdCopyBuffer(vkCmdBuff, UploadSpace.vkBuffer, m_VulkanBuffer, 1, &BuffCopy);
+                    },
+                    m_Desc.Name);
             }
         }
 
@@ -102,7 +102,7 @@ DeviceContextVkImpl::DeviceContextVkImpl(IReferenceCounters*                   p
 {
     if (!m_bIsDeferred)
     {
-        m_QueryMgr.reset(new QueryManagerVk{pDeviceVkImpl, EngineCI.QueryPoolSizes});
+        m_QueryMgr.reset(new QueryManagerVk{pDeviceVkImpl, EngineCI.QueryPoolSizes, CommandQueueId});
     }
 
     m_GenerateMipsHelper->CreateSRB(&m_GenerateMipsSRB);
@@ -421,6 +421,23 @@ void DeviceContextVkImpl::DvpLogRenderPass_PSOMismatch()
     LOG_ERROR_MESSAGE(ss.str());
 }
 
+void DeviceContextVkImpl::BindDescriptorSetsWithDynamicOffsets()
+{
+    // Dynamic offsets may only change when a dynamic buffer is mapped with MAP_FLAG_DISCARD.
+    // If this has not happened since the sets were bound, there is no need to even compute the offsets.
+    if (m_DescrSetBindInfo.DynamicDescriptorsBound && m_DescrSetBindInfo.DynamicBufferVersion == m_DynamicBufferVersion)
+    {
+        ++m_NumSkippedDynamicRebinds;
+        return;
+    }
+
+    // Other dynamic buffers may have been remapped, in which case the offsets are the same
+    if (!m_pPipelineState->BindDescriptorSetsWithDynamicOffsets(GetCommandBuffer(), m_ContextId, this, m_DescrSetBindInfo))
+        ++m_NumSkippedDynamicRebinds;
+
+    m_DescrSetBindInfo.DynamicBufferVersion = m_DynamicBufferVersion;
+}
+
 void DeviceContextVkImpl::PrepareForDraw(DRAW_FLAGS Flags)
 {
 #ifdef DILIGENT_DEVELOPMENT
@@ -459,7 +476,7 @@ void DeviceContextVkImpl::PrepareForDraw(DRAW_FLAGS Flags)
         if (!m_DescrSetBindInfo.DynamicDescriptorsBound ||
             (m_DescrSetBindInfo.DynamicBuffersPresent && (Flags & DRAW_FLAG_DYNAMIC_RESOURCE_BUFFERS_INTACT) == 0))
         {
-            m_pPipelineState->BindDescriptorSetsWithDynamicOffsets(GetCommandBuffer(), m_ContextId, this, m_DescrSetBindInfo);
+            BindDescriptorSetsWithDynamicOffsets();
         }
     }
 #if 0
@@ -608,7 +625,7 @@ void DeviceContextVkImpl::PrepareForDispatchCompute()
     {
         if (!m_DescrSetBindInfo.DynamicDescriptorsBound || m_DescrSetBindInfo.DynamicBuffersPresent)
         {
-            m_pPipelineState->BindDescriptorSetsWithDynamicOffsets(GetCommandBuffer(), m_ContextId, this, m_DescrSetBindInfo);
+            BindDescriptorSetsWithDynamicOffsets();
         }
     }
 #if 0
@@ -716,6 +733,8 @@ void DeviceContextVkImpl::ClearDepthStencil(ITextureView*                  pView
 
         auto* pTexture   = pVkDSV->GetTexture();
         auto* pTextureVk = ValidatedCast<TextureVkImpl>(pTexture);
+        DEV_CHECK_ERR((pTextureVk->GetDesc().MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) == 0,
+                      "Memoryless depth-stencil buffer '", pTextureVk->GetDesc().Name, "' can only be cleared when it is bound to the context");
 
         // Image layout must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL (17.1)
         TransitionOrVerifyTextureState(*pTextureVk, StateTransitionMode, RESOURCE_STATE_COPY_DEST, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -839,6 +858,8 @@ void DeviceContextVkImpl::ClearRenderTarget(ITextureView* pView, const float* RG
 
         auto* pTexture   = pVkRTV->GetTexture();
         auto* pTextureVk = ValidatedCast<TextureVkImpl>(pTexture);
+        DEV_CHECK_ERR((pTextureVk->GetDesc().MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) == 0,
+                      "Memoryless render target '", pTextureVk->GetDesc().Name, "' can only be cleared when it is bound to the context");
 
         // Image layout must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL (17.1)
         TransitionOrVerifyTextureState(*pTextureVk, StateTransitionMode, RESOURCE_STATE_COPY_DEST, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -928,6 +949,11 @@ void DeviceContextVkImpl::FinishFrame()
 }
 
 void DeviceContextVkImpl::Flush()
+{
+    Flush(0, nullptr);
+}
+
+void DeviceContextVkImpl::Flush(Uint32 NumCommandLists, ICommandList* const* ppCommandLists)
 {
     if (m_bIsDeferred)
     {
@@ -956,6 +982,9 @@ void DeviceContextVkImpl::Flush()
     {
         if (m_QueryMgr)
         {
+            // Query results must be copied before the queries are reset as a query
+            // may be ended and discarded in the same command buffer
+            m_State.NumCommands += m_QueryMgr->CopyEndedQueryResults(m_CommandBuffer);
             m_State.NumCommands += m_QueryMgr->ResetStaleQueries(m_CommandBuffer);
         }
 
@@ -969,11 +998,32 @@ void DeviceContextVkImpl::Flush()
             m_CommandBuffer.FlushBarriers();
             m_CommandBuffer.EndCommandBuffer();
 
-            SubmitInfo.commandBufferCount = 1;
-            SubmitInfo.pCommandBuffers    = &vkCmdBuff;
+            m_VkCmdBuffsToSubmit.push_back(vkCmdBuff);
         }
     }
 
+    // Command buffers recorded by deferred contexts are submitted in the same batch
+    // right after the commands of this context
+    const auto FirstCmdListBuffIdx = m_VkCmdBuffsToSubmit.size();
+
+    std::vector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs;
+    DeferredCtxs.reserve(NumCommandLists);
+    for (Uint32 i = 0; i < NumCommandLists; ++i)
+    {
+        auto* pCmdListVk = ValidatedCast<CommandListVkImpl>(ppCommandLists[i]);
+
+        VkCommandBuffer               vkCmdListBuff = VK_NULL_HANDLE;
+        RefCntAutoPtr<IDeviceContext> pDeferredCtx;
+        pCmdListVk->Close(vkCmdListBuff, pDeferredCtx);
+        VERIFY(vkCmdListBuff != VK_NULL_HANDLE, "Trying to execute empty command buffer");
+        VERIFY_EXPR(pDeferredCtx);
+        m_VkCmdBuffsToSubmit.push_back(vkCmdListBuff);
+        DeferredCtxs.emplace_back(std::move(pDeferredCtx));
+    }
+
+    SubmitInfo.commandBufferCount = static_cast<uint32_t>(m_VkCmdBuffsToSubmit.size());
+    SubmitInfo.pCommandBuffers    = SubmitInfo.commandBufferCount != 0 ? m_VkCmdBuffsToSubmit.data() : nullptr;
+
     VERIFY_EXPR(m_VkWaitSemaphores.size() == m_WaitSemaphores.size());
     VERIFY_EXPR(m_VkSignalSemaphores.size() == m_SignalSemaphores.size());
 
@@ -1000,6 +1050,17 @@ void DeviceContextVkImpl::Flush()
         DisposeCurrentCmdBuffer(m_CommandQueueId, SubmittedFenceValue);
     }
 
+    for (size_t i = 0; i < DeferredCtxs.size(); ++i)
+    {
+        auto* pDeferredCtxVkImpl = DeferredCtxs[i].RawPtr<DeviceContextVkImpl>();
+        // Set the bit in the deferred context cmd queue mask corresponding to cmd queue of this context
+        pDeferredCtxVkImpl->m_SubmittedBuffersCmdQueueMask |= Uint64{1} << m_CommandQueueId;
+        // It is OK to dispose command buffer from another thread. We are not going to
+        // record any commands and only need to add the buffer to the queue
+        pDeferredCtxVkImpl->DisposeVkCmdBuffer(m_CommandQueueId, m_VkCmdBuffsToSubmit[FirstCmdListBuffIdx + i], SubmittedFenceValue);
+    }
+    m_VkCmdBuffsToSubmit.clear();
+
     m_State = ContextState{};
     m_DescrSetBindInfo.Reset();
     m_CommandBuffer.Reset();
@@ -1469,6 +1530,7 @@ void DeviceContextVkImpl::MapBuffer(IBuffer* pBuffer, MAP_TYPE MapType, MAP_FLAG
             if ((MapFlags & MAP_FLAG_DISCARD) != 0 || DynAllocation.pDynamicMemMgr == nullptr)
             {
                 DynAllocation = AllocateDynamicSpace(BuffDesc.uiSizeInBytes, pBufferVk->m_DynamicOffsetAlignment);
+                ++m_DynamicBufferVersion;
             }
             else
             {
@@ -1555,7 +1617,37 @@ void DeviceContextVkImpl::UpdateTexture(ITexture*                      pTexture,
 
     if (SubresData.pSrcBuffer != nullptr)
     {
-        UNSUPPORTED("Copying buffer to texture is not implemented");
+        auto*       pSrcBuffVk = ValidatedCast<BufferVkImpl>(SubresData.pSrcBuffer);
+        const auto& TexDesc    = pTexVk->GetDesc();
+        const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
+        VERIFY(TexDesc.SampleCount == 1, "Only single-sample textures can be updated with vkCmdCopyBufferToImage()");
+
+        // bufferRowLength is specified in texels. If the image is compressed, it must be a multiple
+        // of the compressed texel block width (18.4)
+        Uint32 SrcStrideInTexels = 0;
+        if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+        {
+            DEV_CHECK_ERR((SubresData.Stride % FmtAttribs.ComponentSize) == 0, "Source buffer stride (", SubresData.Stride,
+                          ") must be a multiple of the compressed block size (", Uint32{FmtAttribs.ComponentSize}, ")");
+            SrcStrideInTexels = SubresData.Stride / Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.BlockWidth};
+        }
+        else
+        {
+            const auto TexelSize = Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+            DEV_CHECK_ERR((SubresData.Stride % TexelSize) == 0, "Source buffer stride (", SubresData.Stride,
+                          ") must be a multiple of the texel size (", TexelSize, ")");
+            SrcStrideInTexels = SubresData.Stride / TexelSize;
+            // bufferImageHeight is zero, so the planes must be tightly packed
+            DEV_CHECK_ERR(DstBox.MaxZ - DstBox.MinZ == 1 || SubresData.DepthStride == SubresData.Stride * (DstBox.MaxY - DstBox.MinY),
+                          "Source buffer depth stride (", SubresData.DepthStride, ") must be equal to the stride times the region height");
+        }
+
+        EnsureVkCmdBuffer();
+        TransitionOrVerifyBufferState(*pSrcBuffVk, SrcBufferStateTransitionMode, RESOURCE_STATE_COPY_SOURCE, VK_ACCESS_TRANSFER_READ_BIT,
+                                      "Using buffer as copy source (DeviceContextVkImpl::UpdateTexture)");
+        const auto SrcOffset = SubresData.SrcOffset + pSrcBuffVk->GetDynamicOffset(m_ContextId, this);
+        CopyBufferToTexture(pSrcBuffVk->GetVkBuffer(), SrcOffset, SrcStrideInTexels, *pTexVk,
+                            DstBox, MipLevel, Slice, TextureStateTransitionModee);
     }
     else
     {
@@ -2130,6 +2222,11 @@ void DeviceContextVkImpl::FinishCommandList(class ICommandList** ppCommandList)
 }
 
 void DeviceContextVkImpl::ExecuteCommandList(class ICommandList* pCommandList)
+{
+    ExecuteCommandLists(1, &pCommandList);
+}
+
+void DeviceContextVkImpl::ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists)
 {
     if (m_bIsDeferred)
     {
@@ -2137,31 +2234,15 @@ void DeviceContextVkImpl::ExecuteCommandList(class ICommandList* pCommandList)
         return;
     }
 
-    Flush();
-
-    InvalidateState();
+    if (NumCommandLists == 0)
+        return;
+    DEV_CHECK_ERR(ppCommandLists != nullptr, "ppCommandLists must not be null when NumCommandLists is not zero");
 
-    CommandListVkImpl* pCmdListVk = ValidatedCast<CommandListVkImpl>(pCommandList);
-    VkCommandBuffer    vkCmdBuff  = VK_NULL_HANDLE;
+    // Commands recorded in this context as well as all command lists are submitted
+    // to the queue with a single vkQueueSubmit call that signals a single fence value.
+    Flush(NumCommandLists, ppCommandLists);
 
-    RefCntAutoPtr<IDeviceContext> pDeferredCtx;
-    pCmdListVk->Close(vkCmdBuff, pDeferredCtx);
-    VERIFY(vkCmdBuff != VK_NULL_HANDLE, "Trying to execute empty command buffer");
-    VERIFY_EXPR(pDeferredCtx);
-    VkSubmitInfo SubmitInfo = {};
-
-    SubmitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    SubmitInfo.pNext              = nullptr;
-    SubmitInfo.commandBufferCount = 1;
-    SubmitInfo.pCommandBuffers    = &vkCmdBuff;
-    VERIFY_EXPR(m_PendingFences.empty());
-    auto pDeferredCtxVkImpl  = pDeferredCtx.RawPtr<DeviceContextVkImpl>();
-    auto SubmittedFenceValue = m_pDevice->ExecuteCommandBuffer(m_CommandQueueId, SubmitInfo, this, nullptr);
-    // Set the bit in the deferred context cmd queue mask corresponding to cmd queue of this context
-    pDeferredCtxVkImpl->m_SubmittedBuffersCmdQueueMask |= Uint64{1} << m_CommandQueueId;
-    // It is OK to dispose command buffer from another thread. We are not going to
-    // record any commands and only need to add the buffer to the queue
-    pDeferredCtxVkImpl->DisposeVkCmdBuffer(m_CommandQueueId, vkCmdBuff, SubmittedFenceValue);
+    InvalidateState();
 }
 
 void DeviceContextVkImpl::SignalFence(IFence* pFence, Uint64 Value)
@@ -2244,6 +2325,9 @@ void DeviceContextVkImpl::EndQuery(IQuery* pQuery)
     if (QueryType == QUERY_TYPE_TIMESTAMP || QueryType == QUERY_TYPE_DURATION)
     {
         m_CommandBuffer.WriteTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, vkQueryPool, Idx);
+        if (QueryType == QUERY_TYPE_DURATION)
+            m_QueryMgr->OnQueryEnded(QueryType, pQueryVkImpl->GetQueryPoolIndex(0));
+        m_QueryMgr->OnQueryEnded(QueryType, Idx);
     }
     else
     {
@@ -2270,9 +2354,43 @@ void DeviceContextVkImpl::EndQuery(IQuery* pQuery)
 
         --m_ActiveQueriesCounter;
         m_CommandBuffer.EndQuery(vkQueryPool, Idx, 1u << QueryType);
+        m_QueryMgr->OnQueryEnded(QueryType, Idx);
     }
 }
 
+bool DeviceContextVkImpl::GetQueryData(Uint32 NumQueries, IQuery* const* ppQueries, void* pData, Uint32 DataStride, bool AutoInvalidate)
+{
+    if (NumQueries == 0)
+        return true;
+
+    DEV_CHECK_ERR(ppQueries != nullptr, "ppQueries must not be null");
+    DEV_CHECK_ERR(pData != nullptr, "pData must not be null");
+
+    // Check the completed fence value once for all queries
+    const auto CompletedFenceValue = m_pDevice->GetCompletedFenceValue(m_CommandQueueId);
+    for (Uint32 i = 0; i < NumQueries; ++i)
+    {
+        const auto* pQueryVk = ValidatedCast<const QueryVkImpl>(ppQueries[i]);
+        if (pQueryVk->GetEndFenceValue() > CompletedFenceValue)
+            return false;
+    }
+
+    bool AllAvailable = true;
+    for (Uint32 i = 0; i < NumQueries; ++i)
+    {
+        auto* pQueryData = reinterpret_cast<Uint8*>(pData) + size_t{DataStride} * i;
+        AllAvailable     = ValidatedCast<QueryVkImpl>(ppQueries[i])->ReadData(pQueryData) && AllAvailable;
+    }
+
+    if (AllAvailable && AutoInvalidate)
+    {
+        for (Uint32 i = 0; i < NumQueries; ++i)
+            ppQueries[i]->Invalidate();
+    }
+
+    return AllAvailable;
+}
+
 
 void DeviceContextVkImpl::TransitionImageLayout(ITexture* pTexture, VkImageLayout NewLayout)
 {
@@ -28,6 +28,7 @@
 #include "pch.h"
 
 #include "PipelineLayout.hpp"
+#include "PipelineLayoutCache.hpp"
 #include "ShaderResourceLayoutVk.hpp"
 #include "ShaderVkImpl.hpp"
 #include "RenderDeviceVkImpl.hpp"
@@ -153,28 +154,26 @@ void PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::ReserveMem
     }
 }
 
-void PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice,
-                                                                               IMemoryAllocator&                           MemAllocator,
-                                                                               VkDescriptorSetLayoutBinding*               pNewBindings)
+void PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::Finalize(PipelineLayoutCache&          LayoutCache,
+                                                                               Uint64                        CommandQueueMask,
+                                                                               IMemoryAllocator&             MemAllocator,
+                                                                               VkDescriptorSetLayoutBinding* pNewBindings)
 {
     VERIFY_EXPR(memcmp(pBindings, pNewBindings, sizeof(VkDescriptorSetLayoutBinding) * NumLayoutBindings) == 0);
 
-    VkDescriptorSetLayoutCreateInfo SetLayoutCI = {};
-
-    SetLayoutCI.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    SetLayoutCI.pNext        = nullptr;
-    SetLayoutCI.flags        = 0;
-    SetLayoutCI.bindingCount = NumLayoutBindings;
-    SetLayoutCI.pBindings    = pBindings;
-    VkLayout                 = LogicalDevice.CreateDescriptorSetLayout(SetLayoutCI);
+    VkLayout = LayoutCache.GetDescriptorSetLayout(pBindings, NumLayoutBindings, CommandQueueMask);
 
     MemAllocator.Free(pBindings);
     pBindings = pNewBindings;
 }
 
-void PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::Release(RenderDeviceVkImpl* pRenderDeviceVk, IMemoryAllocator& MemAllocator, Uint64 CommandQueueMask)
+void PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::Release(PipelineLayoutCache& LayoutCache, IMemoryAllocator& MemAllocator)
 {
-    pRenderDeviceVk->SafeReleaseDeviceObject(std::move(VkLayout), CommandQueueMask);
+    if (VkLayout != VK_NULL_HANDLE)
+    {
+        LayoutCache.ReleaseDescriptorSetLayout(VkLayout);
+        VkLayout = VK_NULL_HANDLE;
+    }
     for (uint32_t b = 0; b < NumLayoutBindings; ++b)
     {
         if (pBindings[b].pImmutableSamplers != nullptr)
@@ -231,7 +230,7 @@ size_t PipelineLayout::DescriptorSetLayoutManager::DescriptorSetLayout::GetHash(
     return Hash;
 }
 
-void PipelineLayout::DescriptorSetLayoutManager::Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice)
+void PipelineLayout::DescriptorSetLayoutManager::Finalize(PipelineLayoutCache& LayoutCache, Uint64 CommandQueueMask)
 {
     size_t TotalBindings = 0;
     for (const auto& Layout : m_DescriptorSetLayouts)
@@ -247,7 +246,7 @@ void PipelineLayout::DescriptorSetLayoutManager::Finalize(const VulkanUtilities:
         if (Layout.SetIndex >= 0)
         {
             std::copy(Layout.pBindings, Layout.pBindings + Layout.NumLayoutBindings, m_LayoutBindings.begin() + BindingOffset);
-            Layout.Finalize(LogicalDevice, m_MemAllocator, &m_LayoutBindings[BindingOffset]);
+            Layout.Finalize(LayoutCache, CommandQueueMask, m_MemAllocator, &m_LayoutBindings[BindingOffset]);
             BindingOffset += Layout.NumLayoutBindings;
             ActiveDescrSetLayouts[Layout.SetIndex] = Layout.VkLayout;
         }
@@ -259,26 +258,22 @@ void PipelineLayout::DescriptorSetLayoutManager::Finalize(const VulkanUtilities:
                 m_ActiveSets == 2 && ActiveDescrSetLayouts[0] != VK_NULL_HANDLE && ActiveDescrSetLayouts[1] != VK_NULL_HANDLE);
     // clang-format on
 
-    VkPipelineLayoutCreateInfo PipelineLayoutCI = {};
-
-    PipelineLayoutCI.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    PipelineLayoutCI.pNext                  = nullptr;
-    PipelineLayoutCI.flags                  = 0; // reserved for future use
-    PipelineLayoutCI.setLayoutCount         = m_ActiveSets;
-    PipelineLayoutCI.pSetLayouts            = PipelineLayoutCI.setLayoutCount != 0 ? ActiveDescrSetLayouts.data() : nullptr;
-    PipelineLayoutCI.pushConstantRangeCount = 0;
-    PipelineLayoutCI.pPushConstantRanges    = nullptr;
-    m_VkPipelineLayout                      = LogicalDevice.CreatePipelineLayout(PipelineLayoutCI);
+    m_VkPipelineLayout = LayoutCache.GetPipelineLayout(ActiveDescrSetLayouts.data(), m_ActiveSets, CommandQueueMask);
 
     VERIFY_EXPR(BindingOffset == TotalBindings);
 }
 
-void PipelineLayout::DescriptorSetLayoutManager::Release(RenderDeviceVkImpl* pRenderDeviceVk, Uint64 CommandQueueMask)
+void PipelineLayout::DescriptorSetLayoutManager::Release(PipelineLayoutCache& LayoutCache)
 {
-    for (auto& Layout : m_DescriptorSetLayouts)
-        Layout.Release(pRenderDeviceVk, m_MemAllocator, CommandQueueMask);
+    // The pipeline layout must be released before the descriptor set layouts it references
+    if (m_VkPipelineLayout != VK_NULL_HANDLE)
+    {
+        LayoutCache.ReleasePipelineLayout(m_VkPipelineLayout);
+        m_VkPipelineLayout = VK_NULL_HANDLE;
+    }
 
-    pRenderDeviceVk->SafeReleaseDeviceObject(std::move(m_VkPipelineLayout), CommandQueueMask);
+    for (auto& Layout : m_DescriptorSetLayouts)
+        Layout.Release(LayoutCache, m_MemAllocator);
 }
 
 PipelineLayout::DescriptorSetLayoutManager::~DescriptorSetLayoutManager()
@@ -358,9 +353,9 @@ PipelineLayout::PipelineLayout() :
 {
 }
 
-void PipelineLayout::Release(RenderDeviceVkImpl* pDeviceVkImpl, Uint64 CommandQueueMask)
+void PipelineLayout::Release(RenderDeviceVkImpl* pDeviceVkImpl)
 {
-    m_LayoutMgr.Release(pDeviceVkImpl, CommandQueueMask);
+    m_LayoutMgr.Release(pDeviceVkImpl->GetPipelineLayoutCache());
 }
 
 void PipelineLayout::AllocateResourceSlot(const SPIRVShaderResourceAttribs& ResAttribs,
@@ -381,9 +376,9 @@ void PipelineLayout::AllocateResourceSlot(const SPIRVShaderResourceAttribs& ResA
     SPIRV[ResAttribs.DescriptorSetDecorationOffset] = DescriptorSet;
 }
 
-void PipelineLayout::Finalize(const VulkanUtilities::VulkanLogicalDevice& LogicalDevice)
+void PipelineLayout::Finalize(RenderDeviceVkImpl* pDeviceVkImpl, Uint64 CommandQueueMask)
 {
-    m_LayoutMgr.Finalize(LogicalDevice);
+    m_LayoutMgr.Finalize(pDeviceVkImpl->GetPipelineLayoutCache(), CommandQueueMask);
 }
 
 std::array<Uint32, 2> PipelineLayout::GetDescriptorSetSizes(Uint32& NumSets) const
@@ -410,7 +405,7 @@ std::array<Uint32, 2> PipelineLayout::GetDescriptorSetSizes(Uint32& NumSets) con
 
 void PipelineLayout::InitResourceCache(RenderDeviceVkImpl*    pDeviceVkImpl,
                                        ShaderResourceCacheVk& ResourceCache,
-                                       IMemoryAllocator&      CacheMemAllocator,
+                                       void*                  pCacheMemory,
                                        const char*            DbgPipelineName) const
 {
     Uint32 NumSets  = 0;
@@ -418,7 +413,7 @@ void PipelineLayout::InitResourceCache(RenderDeviceVkImpl*    pDeviceVkImpl,
 
     // This call only initializes descriptor sets (ShaderResourceCacheVk::DescriptorSet) in the resource cache
     // Resources are initialized by source layout when shader resource binding objects are created
-    ResourceCache.InitializeSets(CacheMemAllocator, NumSets, SetSizes.data());
+    ResourceCache.InitializeSets(pCacheMemory, NumSets, SetSizes.data());
 
     const auto& StaticAndMutSet = m_LayoutMgr.GetDescriptorSet(SHADER_RESOURCE_VARIABLE_TYPE_STATIC);
     if (StaticAndMutSet.SetIndex >= 0)
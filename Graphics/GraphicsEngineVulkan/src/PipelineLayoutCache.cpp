@@ -0,0 +1,253 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "PipelineLayoutCache.hpp"
+#include "RenderDeviceVkImpl.hpp"
+#include "PipelineStateVkImpl.hpp"
+
+namespace Diligent
+{
+
+PipelineLayoutCache::DescriptorSetLayoutKey::DescriptorSetLayoutKey(const VkDescriptorSetLayoutBinding* pBindings, Uint32 NumBindings) :
+    Bindings{pBindings, pBindings + NumBindings}
+{
+    Hash = ComputeHash(NumBindings);
+    for (auto& Binding : Bindings)
+    {
+        if (Binding.pImmutableSamplers != nullptr)
+        {
+            ImmutableSamplers.insert(ImmutableSamplers.end(), Binding.pImmutableSamplers, Binding.pImmutableSamplers + Binding.descriptorCount);
+            for (uint32_t s = 0; s < Binding.descriptorCount; ++s)
+                HashCombine(Hash, Binding.pImmutableSamplers[s]);
+        }
+        else
+        {
+            ImmutableSamplers.push_back(VK_NULL_HANDLE);
+        }
+        Binding.pImmutableSamplers = nullptr;
+
+        HashCombine(Hash, Binding.binding, static_cast<size_t>(Binding.descriptorType), Binding.descriptorCount, static_cast<size_t>(Binding.stageFlags));
+    }
+}
+
+bool PipelineLayoutCache::DescriptorSetLayoutKey::operator==(const DescriptorSetLayoutKey& rhs) const
+{
+    // clang-format off
+    if (Hash                     != rhs.Hash                     ||
+        Bindings.size()          != rhs.Bindings.size()          ||
+        ImmutableSamplers        != rhs.ImmutableSamplers)
+        return false;
+    // clang-format on
+
+    for (size_t b = 0; b < Bindings.size(); ++b)
+    {
+        const auto& B0 = Bindings[b];
+        const auto& B1 = rhs.Bindings[b];
+        // clang-format off
+        if (B0.binding         != B1.binding         ||
+            B0.descriptorType  != B1.descriptorType  ||
+            B0.descriptorCount != B1.descriptorCount ||
+            B0.stageFlags      != B1.stageFlags)
+            return false;
+        // clang-format on
+    }
+
+    return true;
+}
+
+PipelineLayoutCache::PipelineLayoutKey::PipelineLayoutKey(const VkDescriptorSetLayout* pSetLayouts, Uint32 _NumSets) :
+    NumSets{_NumSets}
+{
+    VERIFY_EXPR(NumSets <= MaxDescriptorSets);
+    Hash = ComputeHash(NumSets);
+    for (Uint32 s = 0; s < NumSets; ++s)
+    {
+        SetLayouts[s] = pSetLayouts[s];
+        HashCombine(Hash, SetLayouts[s]);
+    }
+}
+
+
+PipelineLayoutCache::PipelineLayoutCache(RenderDeviceVkImpl& DeviceVk) noexcept :
+    m_DeviceVkImpl{DeviceVk}
+{}
+
+PipelineLayoutCache::~PipelineLayoutCache()
+{
+    // All layouts must have been released by the pipeline states that use them
+    VERIFY(m_PipelineLayouts.empty(), "Pipeline layout cache is not empty. Not all pipeline states have been destroyed");
+    VERIFY(m_SetLayouts.empty(), "Descriptor set layout cache is not empty. Not all pipeline states have been destroyed");
+}
+
+
+VkDescriptorSetLayout PipelineLayoutCache::GetDescriptorSetLayout(const VkDescriptorSetLayoutBinding* pBindings, Uint32 NumBindings, Uint64 CommandQueueMask)
+{
+    DescriptorSetLayoutKey Key{pBindings, NumBindings};
+
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto it = m_SetLayouts.find(Key);
+    if (it == m_SetLayouts.end())
+    {
+        VkDescriptorSetLayoutCreateInfo SetLayoutCI = {};
+
+        SetLayoutCI.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        SetLayoutCI.pNext        = nullptr;
+        SetLayoutCI.flags        = 0;
+        SetLayoutCI.bindingCount = NumBindings;
+        SetLayoutCI.pBindings    = pBindings;
+
+        DescriptorSetLayoutEntry NewEntry;
+        NewEntry.Layout = m_DeviceVkImpl.GetLogicalDevice().CreateDescriptorSetLayout(SetLayoutCI);
+
+        it = m_SetLayouts.emplace(std::move(Key), std::move(NewEntry)).first;
+        m_SetLayoutKeys.emplace(it->second.Layout, &it->first);
+    }
+
+    auto& Entry = it->second;
+    ++Entry.RefCount;
+    Entry.CommandQueueMask |= CommandQueueMask;
+    return Entry.Layout;
+}
+
+void PipelineLayoutCache::ReleaseDescriptorSetLayout(VkDescriptorSetLayout vkSetLayout)
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto key_it = m_SetLayoutKeys.find(vkSetLayout);
+    if (key_it == m_SetLayoutKeys.end())
+    {
+        UNEXPECTED("Descriptor set layout is not found in the cache");
+        return;
+    }
+
+    auto it = m_SetLayouts.find(*key_it->second);
+    VERIFY_EXPR(it != m_SetLayouts.end() && it->second.RefCount > 0);
+    if (--it->second.RefCount == 0)
+    {
+        m_DeviceVkImpl.SafeReleaseDeviceObject(std::move(it->second.Layout), it->second.CommandQueueMask);
+        m_SetLayoutKeys.erase(key_it);
+        m_SetLayouts.erase(it);
+    }
+}
+
+
+VkPipelineLayout PipelineLayoutCache::GetPipelineLayout(const VkDescriptorSetLayout* pSetLayouts, Uint32 NumSets, Uint64 CommandQueueMask)
+{
+    PipelineLayoutKey Key{pSetLayouts, NumSets};
+
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto it = m_PipelineLayouts.find(Key);
+    if (it == m_PipelineLayouts.end())
+    {
+        VkPipelineLayoutCreateInfo PipelineLayoutCI = {};
+
+        PipelineLayoutCI.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        PipelineLayoutCI.pNext                  = nullptr;
+        PipelineLayoutCI.flags                  = 0; // reserved for future use
+        PipelineLayoutCI.setLayoutCount         = NumSets;
+        PipelineLayoutCI.pSetLayouts            = NumSets != 0 ? pSetLayouts : nullptr;
+        PipelineLayoutCI.pushConstantRangeCount = 0;
+        PipelineLayoutCI.pPushConstantRanges    = nullptr;
+
+        PipelineLayoutEntry NewEntry;
+        NewEntry.Layout = m_DeviceVkImpl.GetLogicalDevice().CreatePipelineLayout(PipelineLayoutCI);
+
+        it = m_PipelineLayouts.emplace(std::move(Key), std::move(NewEntry)).first;
+        m_PipelineLayoutKeys.emplace(it->second.Layout, &it->first);
+    }
+
+    auto& Entry = it->second;
+    ++Entry.RefCount;
+    Entry.CommandQueueMask |= CommandQueueMask;
+    return Entry.Layout;
+}
+
+void PipelineLayoutCache::ReleasePipelineLayout(VkPipelineLayout vkPipelineLayout)
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto key_it = m_PipelineLayoutKeys.find(vkPipelineLayout);
+    if (key_it == m_PipelineLayoutKeys.end())
+    {
+        UNEXPECTED("Pipeline layout is not found in the cache");
+        return;
+    }
+
+    auto it = m_PipelineLayouts.find(*key_it->second);
+    VERIFY_EXPR(it != m_PipelineLayouts.end() && it->second.RefCount > 0);
+    if (--it->second.RefCount == 0)
+    {
+        m_DeviceVkImpl.SafeReleaseDeviceObject(std::move(it->second.Layout), it->second.CommandQueueMask);
+        m_PipelineLayoutKeys.erase(key_it);
+        m_PipelineLayouts.erase(it);
+    }
+}
+
+
+RefCntAutoPtr<PipelineStateVkImpl> PipelineLayoutCache::GetBasePipeline(VkPipelineLayout vkPipelineLayout, VkPipelineBindPoint BindPoint)
+{
+    RefCntAutoPtr<PipelineStateVkImpl> pBasePSO;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mutex};
+
+        auto key_it = m_PipelineLayoutKeys.find(vkPipelineLayout);
+        if (key_it != m_PipelineLayoutKeys.end())
+        {
+            auto it = m_PipelineLayouts.find(*key_it->second);
+            VERIFY_EXPR(it != m_PipelineLayouts.end());
+            // The strong reference keeps the base pipeline alive while the derivative is being created
+            pBasePSO = it->second.BasePipelines[GetBasePipelineIndex(BindPoint)].Lock();
+        }
+    }
+    return pBasePSO;
+}
+
+void PipelineLayoutCache::SetBasePipeline(VkPipelineLayout vkPipelineLayout, VkPipelineBindPoint BindPoint, PipelineStateVkImpl* pPSO)
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto key_it = m_PipelineLayoutKeys.find(vkPipelineLayout);
+    if (key_it == m_PipelineLayoutKeys.end())
+    {
+        UNEXPECTED("Pipeline layout is not found in the cache");
+        return;
+    }
+
+    auto it = m_PipelineLayouts.find(*key_it->second);
+    VERIFY_EXPR(it != m_PipelineLayouts.end());
+
+    auto& BasePipeline = it->second.BasePipelines[GetBasePipelineIndex(BindPoint)];
+    // Do not use Lock() here as releasing the strong reference under the mutex may
+    // destroy the pipeline state, which will try to acquire the mutex again
+    if (!BasePipeline.IsValid())
+        BasePipeline = pPSO;
+}
+
+} // namespace Diligent
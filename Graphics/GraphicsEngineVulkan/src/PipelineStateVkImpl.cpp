@@ -36,6 +36,7 @@
 #include "ShaderResourceBindingVkImpl.hpp"
 #include "EngineMemory.h"
 #include "StringTools.hpp"
+#include "Align.hpp"
 
 
 #if !DILIGENT_NO_HLSL
@@ -193,10 +194,24 @@ static void InitPipelineShaderStages(const VulkanUtilities::VulkanLogicalDevice&
 }
 
 
+// Every pipeline allows derivatives. If there is a pipeline with the same layout, the new pipeline
+// is created as its derivative, which lets the implementation reuse the state of the parent.
+template <typename PipelineCIType>
+static void InitPipelineDerivative(PipelineCIType& PipelineCI, VkPipeline vkBasePipeline)
+{
+    PipelineCI.flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+    if (vkBasePipeline != VK_NULL_HANDLE)
+        PipelineCI.flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+
+    PipelineCI.basePipelineHandle = vkBasePipeline; // a pipeline to derive from
+    PipelineCI.basePipelineIndex  = -1;             // an index into the pCreateInfos parameter to use as a pipeline to derive from
+}
+
 static void CreateComputePipeline(RenderDeviceVkImpl*                           pDeviceVk,
                                   std::vector<VkPipelineShaderStageCreateInfo>& Stages,
                                   const PipelineLayout&                         Layout,
                                   const PipelineStateDesc&                      Desc,
+                                  VkPipeline                                    vkBasePipeline,
                                   VulkanUtilities::PipelineWrapper&             Pipeline)
 {
     const auto& LogicalDevice = pDeviceVk->GetLogicalDevice();
@@ -208,8 +223,7 @@ static void CreateComputePipeline(RenderDeviceVkImpl*
 #ifdef DILIGENT_DEBUG
     PipelineCI.flags = VK_PIPELINE_CREATE_DISABLE_OPTIMIZATION_BIT;
 #endif
-    PipelineCI.basePipelineHandle = VK_NULL_HANDLE; // a pipeline to derive from
-    PipelineCI.basePipelineIndex  = -1;             // an index into the pCreateInfos parameter to use as a pipeline to derive from
+    InitPipelineDerivative(PipelineCI, vkBasePipeline);
 
     PipelineCI.stage  = Stages[0];
     PipelineCI.layout = Layout.GetVkPipelineLayout();
@@ -222,6 +236,7 @@ static void CreateGraphicsPipeline(RenderDeviceVkImpl*
                                    std::vector<VkPipelineShaderStageCreateInfo>& Stages,
                                    const PipelineLayout&                         Layout,
                                    const PipelineStateDesc&                      Desc,
+                                   VkPipeline                                    vkBasePipeline,
                                    VulkanUtilities::PipelineWrapper&             Pipeline,
                                    RefCntAutoPtr<IRenderPass>&                   pRenderPass)
 {
@@ -393,10 +408,9 @@ static void CreateGraphicsPipeline(RenderDeviceVkImpl*
     PipelineCI.pDynamicState         = &DynamicStateCI;
 
 
-    PipelineCI.renderPass         = pRenderPass.RawPtr<IRenderPassVk>()->GetVkRenderPass();
-    PipelineCI.subpass            = Desc.GraphicsPipeline.SubpassIndex;
-    PipelineCI.basePipelineHandle = VK_NULL_HANDLE; // a pipeline to derive from
-    PipelineCI.basePipelineIndex  = -1;             // an index into the pCreateInfos parameter to use as a pipeline to derive from
+    PipelineCI.renderPass = pRenderPass.RawPtr<IRenderPassVk>()->GetVkRenderPass();
+    PipelineCI.subpass    = Desc.GraphicsPipeline.SubpassIndex;
+    InitPipelineDerivative(PipelineCI, vkBasePipeline);
 
     Pipeline = LogicalDevice.CreateGraphicsPipeline(PipelineCI, VK_NULL_HANDLE, Desc.Name);
 }
@@ -449,24 +463,32 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
                                        m_Desc.ResourceLayout, m_PipelineLayout,
                                        (CreateInfo.Flags & PSO_CREATE_FLAG_IGNORE_MISSING_VARIABLES) == 0,
                                        (CreateInfo.Flags & PSO_CREATE_FLAG_IGNORE_MISSING_STATIC_SAMPLERS) == 0);
-    m_PipelineLayout.Finalize(LogicalDevice);
+    m_PipelineLayout.Finalize(pDeviceVk, m_Desc.CommandQueueMask);
 
-    if (m_Desc.SRBAllocationGranularity > 1)
     {
-        std::array<size_t, MAX_SHADERS_IN_PIPELINE> ShaderVariableDataSizes = {};
+        // Compute the layout of the memory block that holds all data of a shader resource binding
+        size_t MemOffset = sizeof(ShaderVariableManagerVk) * GetNumShaderStages();
         for (Uint32 s = 0; s < GetNumShaderStages(); ++s)
         {
             const SHADER_RESOURCE_VARIABLE_TYPE AllowedVarTypes[] = {SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE, SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC};
 
-            Uint32 UnusedNumVars       = 0;
-            ShaderVariableDataSizes[s] = ShaderVariableManagerVk::GetRequiredMemorySize(m_ShaderResourceLayouts[s], AllowedVarTypes, _countof(AllowedVarTypes), UnusedNumVars);
+            Uint32 UnusedNumVars = 0;
+            auto   VarDataSize   = ShaderVariableManagerVk::GetRequiredMemorySize(m_ShaderResourceLayouts[s], AllowedVarTypes, _countof(AllowedVarTypes), UnusedNumVars);
+
+            m_SRBMemLayout.VarDataOffsets[s] = MemOffset;
+            MemOffset                        = Align(MemOffset + VarDataSize, sizeof(void*));
         }
 
         Uint32 NumSets            = 0;
         auto   DescriptorSetSizes = m_PipelineLayout.GetDescriptorSetSizes(NumSets);
         auto   CacheMemorySize    = ShaderResourceCacheVk::GetRequiredMemorySize(NumSets, DescriptorSetSizes.data());
 
-        m_SRBMemAllocator.Initialize(m_Desc.SRBAllocationGranularity, GetNumShaderStages(), ShaderVariableDataSizes.data(), 1, &CacheMemorySize);
+        m_SRBMemLayout.CacheDataOffset = MemOffset;
+        m_SRBMemLayout.TotalSize       = MemOffset + CacheMemorySize;
+
+        // Data blocks of all SRBs created from this pipeline are allocated from a single fixed-block pool
+        if (m_Desc.SRBAllocationGranularity > 1)
+            m_SRBMemAllocator.Initialize(m_Desc.SRBAllocationGranularity, 0, nullptr, 1, &m_SRBMemLayout.TotalSize);
     }
 
     // Create shader modules and initialize shader stages
@@ -474,16 +496,24 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
     std::vector<VulkanUtilities::ShaderModuleWrapper> ShaderModules;
     InitPipelineShaderStages(LogicalDevice, ShaderStages, ShaderModules, VkShaderStages);
 
+    // Pipelines that share the layout are created as derivatives of the first one.
+    // The strong reference keeps the base pipeline alive until the new pipeline is created.
+    auto&      LayoutCache    = pDeviceVk->GetPipelineLayoutCache();
+    const auto BindPoint      = m_Desc.IsComputePipeline() ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+    auto       pBasePSO       = LayoutCache.GetBasePipeline(m_PipelineLayout.GetVkPipelineLayout(), BindPoint);
+    VkPipeline vkBasePipeline = pBasePSO ? pBasePSO->GetVkPipeline() : VK_NULL_HANDLE;
+
     // Create pipeline
     switch (m_Desc.PipelineType)
     {
         // clang-format off
         case PIPELINE_TYPE_GRAPHICS:
-        case PIPELINE_TYPE_MESH:     CreateGraphicsPipeline(  pDeviceVk, VkShaderStages, m_PipelineLayout, m_Desc, m_Pipeline, m_pRenderPass);  break;
-        case PIPELINE_TYPE_COMPUTE:  CreateComputePipeline(   pDeviceVk, VkShaderStages, m_PipelineLayout, m_Desc, m_Pipeline);                 break;
+        case PIPELINE_TYPE_MESH:     CreateGraphicsPipeline(  pDeviceVk, VkShaderStages, m_PipelineLayout, m_Desc, vkBasePipeline, m_Pipeline, m_pRenderPass);  break;
+        case PIPELINE_TYPE_COMPUTE:  CreateComputePipeline(   pDeviceVk, VkShaderStages, m_PipelineLayout, m_Desc, vkBasePipeline, m_Pipeline);                 break;
         default:                     UNEXPECTED("unknown pipeline type");
             // clang-format on
     }
+    LayoutCache.SetBasePipeline(m_PipelineLayout.GetVkPipelineLayout(), BindPoint, this);
 
     m_HasStaticResources    = false;
     m_HasNonStaticResources = false;
@@ -504,7 +534,7 @@ PipelineStateVkImpl::PipelineStateVkImpl(IReferenceCounters*            pRefCoun
 PipelineStateVkImpl::~PipelineStateVkImpl()
 {
     m_pDevice->SafeReleaseDeviceObject(std::move(m_Pipeline), m_Desc.CommandQueueMask);
-    m_PipelineLayout.Release(m_pDevice, m_Desc.CommandQueueMask);
+    m_PipelineLayout.Release(m_pDevice);
 
     auto& RawAllocator = GetRawAllocator();
     for (Uint32 s = 0; s < GetNumShaderStages() * 2; ++s)
@@ -544,6 +574,11 @@ bool PipelineStateVkImpl::IsCompatibleWith(const IPipelineState* pPSO) const
         return true;
 
     const PipelineStateVkImpl* pPSOVk = ValidatedCast<const PipelineStateVkImpl>(pPSO);
+    // Pipeline layouts are shared through the device-wide cache, so PSOs with identical
+    // resource layouts use the same Vulkan pipeline layout object.
+    if (m_PipelineLayout.GetVkPipelineLayout() == pPSOVk->m_PipelineLayout.GetVkPipelineLayout())
+        return true;
+
     if (m_ShaderResourceLayoutHash != pPSOVk->m_ShaderResourceLayoutHash)
         return false;
 
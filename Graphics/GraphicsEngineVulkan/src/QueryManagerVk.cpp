@@ -31,12 +31,16 @@
 #include "RenderDeviceVkImpl.hpp"
 #include "GraphicsAccessories.hpp"
 #include "VulkanUtilities/VulkanCommandBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
 
 namespace Diligent
 {
 
 QueryManagerVk::QueryManagerVk(RenderDeviceVkImpl* pRenderDeviceVk,
-                               const Uint32        QueryHeapSizes[])
+                               const Uint32        QueryHeapSizes[],
+                               Uint32              CommandQueueId) :
+    m_pDevice{pRenderDeviceVk},
+    m_CommandQueueId{CommandQueueId}
 {
     const auto& LogicalDevice  = pRenderDeviceVk->GetLogicalDevice();
     const auto& PhysicalDevice = pRenderDeviceVk->GetPhysicalDevice();
@@ -67,6 +71,8 @@ QueryManagerVk::QueryManagerVk(RenderDeviceVkImpl* pRenderDeviceVk,
 
         auto& HeapInfo    = m_Heaps[QueryType];
         HeapInfo.PoolSize = QueryHeapSizes[QueryType];
+        if (HeapInfo.PoolSize == 0)
+            continue;
 
         VkQueryPoolCreateInfo QueryPoolCI = {};
 
@@ -108,6 +114,12 @@ QueryManagerVk::QueryManagerVk(RenderDeviceVkImpl* pRenderDeviceVk,
                     QueryPoolCI.pipelineStatistics |= VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT;
                 if (EnabledShaderStages & VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT)
                     QueryPoolCI.pipelineStatistics |= VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT;
+
+                // Pipeline statistics queries write one integer value for each bit that is enabled in the
+                // pipelineStatistics when the pool is created (17.2)
+                HeapInfo.NumResults = 0;
+                for (auto Bits = QueryPoolCI.pipelineStatistics; Bits != 0; Bits &= Bits - 1)
+                    ++HeapInfo.NumResults;
             }
             break;
 
@@ -119,21 +131,79 @@ QueryManagerVk::QueryManagerVk(RenderDeviceVkImpl* pRenderDeviceVk,
         if (QueryType == QUERY_TYPE_DURATION)
             QueryPoolCI.queryCount *= 2;
 
+        HeapInfo.QueryCount  = QueryPoolCI.queryCount;
         HeapInfo.vkQueryPool = LogicalDevice.CreateQueryPool(QueryPoolCI, "QueryManagerVk: query pool");
 
         // After query pool creation, each query must be reset before it is used.
         // Queries must also be reset between uses (17.2).
         vkCmdResetQueryPool(vkCmdBuff, HeapInfo.vkQueryPool, 0, QueryPoolCI.queryCount);
 
-        HeapInfo.AvailableQueries.resize(HeapInfo.PoolSize);
-        for (Uint32 i = 0; i < HeapInfo.PoolSize; ++i)
-        {
-            HeapInfo.AvailableQueries[i] = i;
-        }
+        HeapInfo.FreeQueries.reset(new VariableSizeAllocationsManager{HeapInfo.QueryCount, DefaultRawMemoryAllocator::GetAllocator()});
+        // Allocate queries in ranges so that queries ended one after another occupy
+        // contiguous slots and their results can be copied with a single command
+        HeapInfo.RangeSize = std::max(std::min(HeapInfo.QueryCount / 8, Uint32{64}), Uint32{1});
     }
 
     Uint32 QueueIndex = 0;
     pRenderDeviceVk->ExecuteAndDisposeTransientCmdBuff(QueueIndex, vkCmdBuff, std::move(CmdPool));
+
+    CreateReadbackBuffer(pRenderDeviceVk);
+}
+
+void QueryManagerVk::CreateReadbackBuffer(RenderDeviceVkImpl* pRenderDeviceVk)
+{
+    size_t ReadbackSize = 0; // In 64-bit values
+    for (auto& HeapInfo : m_Heaps)
+    {
+        HeapInfo.ReadbackOffset = ReadbackSize;
+        // Every query result is followed by the availability value
+        ReadbackSize += size_t{HeapInfo.QueryCount} * (HeapInfo.NumResults + 1);
+    }
+    if (ReadbackSize == 0)
+        return;
+
+    const auto& LogicalDevice   = pRenderDeviceVk->GetLogicalDevice();
+    const auto& PhysicalDevice  = pRenderDeviceVk->GetPhysicalDevice();
+    auto&       GlobalMemoryMgr = pRenderDeviceVk->GetGlobalMemoryManager();
+
+    VkBufferCreateInfo ReadbackBufferCI = {};
+
+    ReadbackBufferCI.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    ReadbackBufferCI.pNext                 = nullptr;
+    ReadbackBufferCI.flags                 = 0;
+    ReadbackBufferCI.size                  = ReadbackSize * sizeof(Uint64);
+    ReadbackBufferCI.usage                 = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    ReadbackBufferCI.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+    ReadbackBufferCI.queueFamilyIndexCount = 0;
+    ReadbackBufferCI.pQueueFamilyIndices   = nullptr;
+
+    auto ReadbackBuffer  = LogicalDevice.CreateBuffer(ReadbackBufferCI, "QueryManagerVk: query readback buffer");
+    auto MemReqs         = LogicalDevice.GetBufferMemoryRequirements(ReadbackBuffer);
+    auto MemoryTypeIndex = PhysicalDevice.GetMemoryTypeIndex(MemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (MemoryTypeIndex == VulkanUtilities::VulkanPhysicalDevice::InvalidMemoryTypeIndex)
+    {
+        LOG_WARNING_MESSAGE("Failed to find host-visible memory type for the query readback buffer. Query results will be read individually.");
+        return;
+    }
+
+    auto MemAllocation = GlobalMemoryMgr.Allocate(MemReqs.size, MemReqs.alignment, MemoryTypeIndex, true);
+    if (!MemAllocation.Page)
+    {
+        LOG_WARNING_MESSAGE("Failed to allocate memory for the query readback buffer. Query results will be read individually.");
+        return;
+    }
+
+    auto AlignedOffset = (MemAllocation.UnalignedOffset + (MemReqs.alignment - 1)) & ~(MemReqs.alignment - 1);
+    auto err           = LogicalDevice.BindBufferMemory(ReadbackBuffer, MemAllocation.Page->GetVkMemory(), AlignedOffset);
+    if (err != VK_SUCCESS)
+    {
+        LOG_WARNING_MESSAGE("Failed to bind memory to the query readback buffer. Query results will be read individually.");
+        return;
+    }
+
+    m_pReadbackData  = reinterpret_cast<const Uint64*>(reinterpret_cast<const Uint8*>(MemAllocation.Page->GetCPUMemory()) + AlignedOffset);
+    m_ReadbackBuffer = std::move(ReadbackBuffer);
+    m_ReadbackMemory = std::move(MemAllocation);
 }
 
 QueryManagerVk::~QueryManagerVk()
@@ -143,8 +213,17 @@ QueryManagerVk::~QueryManagerVk()
     for (Uint32 QueryType = QUERY_TYPE_UNDEFINED + 1; QueryType < QUERY_TYPE_NUM_TYPES; ++QueryType)
     {
         auto& HeapInfo = m_Heaps[QueryType];
+        if (!HeapInfo.FreeQueries)
+            continue;
 
-        auto OutstandingQueries = HeapInfo.PoolSize - (HeapInfo.AvailableQueries.size() + HeapInfo.StaleQueries.size());
+        // Return unused queries of the current range and stale queries
+        if (HeapInfo.CurrRangeFirst != HeapInfo.CurrRangeEnd)
+            HeapInfo.FreeQueries->Free(HeapInfo.CurrRangeFirst, HeapInfo.CurrRangeEnd - HeapInfo.CurrRangeFirst);
+        for (auto StaleQuery : HeapInfo.StaleQueries)
+            HeapInfo.FreeQueries->Free(StaleQuery, 1);
+        HeapInfo.StaleQueries.clear();
+
+        auto OutstandingQueries = HeapInfo.FreeQueries->GetUsedSize();
         if (OutstandingQueries != 0)
         {
             if (OutstandingQueries == 1)
@@ -162,64 +241,172 @@ QueryManagerVk::~QueryManagerVk()
         QueryUsageSS << std::endl
                      << std::setw(30) << std::left << GetQueryTypeString(static_cast<QUERY_TYPE>(QueryType)) << ": "
                      << std::setw(4) << std::right << HeapInfo.MaxAllocatedQueries
-                     << '/' << std::setw(4) << HeapInfo.PoolSize;
+                     << '/' << std::setw(4) << HeapInfo.QueryCount;
     }
     LOG_INFO_MESSAGE(QueryUsageSS.str());
+
+    if (m_ReadbackBuffer != VK_NULL_HANDLE)
+    {
+        m_pDevice->SafeReleaseDeviceObject(std::move(m_ReadbackBuffer), Uint64{1} << m_CommandQueueId);
+        m_pDevice->SafeReleaseDeviceObject(std::move(m_ReadbackMemory), Uint64{1} << m_CommandQueueId);
+    }
 }
 
-Uint32 QueryManagerVk::AllocateQuery(QUERY_TYPE Type)
+Uint32 QueryManagerVk::AllocateQueryRange(QUERY_TYPE Type, Uint32 Count)
 {
+    VERIFY_EXPR(Count > 0);
     std::lock_guard<std::mutex> Lock(m_HeapMutex);
 
-    Uint32 Index            = InvalidIndex;
-    auto&  HeapInfo         = m_Heaps[Type];
-    auto&  AvailableQueries = HeapInfo.AvailableQueries;
-    if (!AvailableQueries.empty())
+    auto& HeapInfo = m_Heaps[Type];
+    if (!HeapInfo.FreeQueries)
+        return InvalidIndex;
+
+    auto Allocation = HeapInfo.FreeQueries->Allocate(Count, 1);
+    if (!Allocation.IsValid())
+        return InvalidIndex;
+
+    VERIFY_EXPR(Allocation.Size == Count);
+    HeapInfo.MaxAllocatedQueries = std::max(HeapInfo.MaxAllocatedQueries, static_cast<Uint32>(HeapInfo.FreeQueries->GetUsedSize()));
+    return static_cast<Uint32>(Allocation.UnalignedOffset);
+}
+
+Uint32 QueryManagerVk::AllocateQuery(QUERY_TYPE Type)
+{
+    auto& HeapInfo = m_Heaps[Type];
+    if (HeapInfo.CurrRangeFirst == HeapInfo.CurrRangeEnd)
     {
-        Index = HeapInfo.AvailableQueries.back();
-        AvailableQueries.pop_back();
-        HeapInfo.MaxAllocatedQueries = std::max(HeapInfo.MaxAllocatedQueries, HeapInfo.PoolSize - static_cast<Uint32>(AvailableQueries.size()));
+        // The current range is exhausted - allocate a new one. If the pool is fragmented,
+        // fall back to smaller ranges.
+        for (auto RangeSize = HeapInfo.RangeSize; RangeSize > 0; RangeSize /= 2)
+        {
+            auto FirstIndex = AllocateQueryRange(Type, RangeSize);
+            if (FirstIndex != InvalidIndex)
+            {
+                HeapInfo.CurrRangeFirst = FirstIndex;
+                HeapInfo.CurrRangeEnd   = FirstIndex + RangeSize;
+                break;
+            }
+        }
+        if (HeapInfo.CurrRangeFirst == HeapInfo.CurrRangeEnd)
+            return InvalidIndex;
     }
 
-    return Index;
+    return HeapInfo.CurrRangeFirst++;
 }
 
 void QueryManagerVk::DiscardQuery(QUERY_TYPE Type, Uint32 Index)
+{
+    DiscardQueryRange(Type, Index, 1);
+}
+
+void QueryManagerVk::DiscardQueryRange(QUERY_TYPE Type, Uint32 FirstIndex, Uint32 Count)
 {
     std::lock_guard<std::mutex> Lock(m_HeapMutex);
 
     auto& HeapInfo = m_Heaps[Type];
-    VERIFY(Index < HeapInfo.PoolSize, "Query index ", Index, " is out of range");
+    VERIFY(FirstIndex + Count <= HeapInfo.QueryCount, "Query range [", FirstIndex, ", ", FirstIndex + Count, ") is out of range");
 #ifdef DILIGENT_DEBUG
-    for (const auto& ind : HeapInfo.AvailableQueries)
-    {
-        VERIFY(ind != Index, "Index ", Index, " already present in available queries list");
-    }
     for (const auto& ind : HeapInfo.StaleQueries)
     {
-        VERIFY(ind != Index, "Index ", Index, " already present in stale queries list");
+        VERIFY(ind < FirstIndex || ind >= FirstIndex + Count, "Index ", ind, " already present in stale queries list");
     }
 #endif
-    HeapInfo.StaleQueries.push_back(Index);
+    for (Uint32 Index = FirstIndex; Index < FirstIndex + Count; ++Index)
+        HeapInfo.StaleQueries.push_back(Index);
 }
 
 Uint32 QueryManagerVk::ResetStaleQueries(VulkanUtilities::VulkanCommandBuffer& CmdBuff)
 {
     std::lock_guard<std::mutex> Lock(m_HeapMutex);
 
-    Uint32 NumQueriesReset = 0;
+    Uint32 NumCommands = 0;
     for (auto& HeapInfo : m_Heaps)
     {
-        for (auto& StaleQuery : HeapInfo.StaleQueries)
+        auto& StaleQueries = HeapInfo.StaleQueries;
+        if (StaleQueries.empty())
+            continue;
+
+        // Reset contiguous runs of stale queries with a single command
+        std::sort(StaleQueries.begin(), StaleQueries.end());
+        for (size_t RunStart = 0; RunStart < StaleQueries.size();)
         {
-            CmdBuff.ResetQueryPool(HeapInfo.vkQueryPool, StaleQuery, 1);
-            HeapInfo.AvailableQueries.push_front(StaleQuery);
-            ++NumQueriesReset;
+            auto RunEnd = RunStart + 1;
+            while (RunEnd < StaleQueries.size() && StaleQueries[RunEnd] == StaleQueries[RunEnd - 1] + 1)
+                ++RunEnd;
+
+            const auto FirstQuery = StaleQueries[RunStart];
+            const auto QueryCount = static_cast<Uint32>(RunEnd - RunStart);
+            CmdBuff.ResetQueryPool(HeapInfo.vkQueryPool, FirstQuery, QueryCount);
+            // The reset is executed before any command that uses the queries in subsequent command buffers
+            HeapInfo.FreeQueries->Free(FirstQuery, QueryCount);
+            ++NumCommands;
+
+            RunStart = RunEnd;
         }
-        HeapInfo.StaleQueries.clear();
+        StaleQueries.clear();
+    }
+
+    return NumCommands;
+}
+
+Uint32 QueryManagerVk::CopyEndedQueryResults(VulkanUtilities::VulkanCommandBuffer& CmdBuff)
+{
+    if (m_ReadbackBuffer == VK_NULL_HANDLE)
+    {
+        for (auto& HeapInfo : m_Heaps)
+            HeapInfo.EndedQueries.clear();
+        return 0;
+    }
+
+    Uint32 NumCommands = 0;
+    for (auto& HeapInfo : m_Heaps)
+    {
+        auto& EndedQueries = HeapInfo.EndedQueries;
+        if (EndedQueries.empty())
+            continue;
+
+        if (NumCommands == 0)
+        {
+            // Make sure that copies from previously submitted command buffers are complete
+            // before the readback buffer is overwritten
+            CmdBuff.BufferMemoryBarrier(m_ReadbackBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            ++NumCommands;
+        }
+
+        // Queries are allocated from contiguous ranges, so results of most queries
+        // are copied with a single command
+        std::sort(EndedQueries.begin(), EndedQueries.end());
+        EndedQueries.erase(std::unique(EndedQueries.begin(), EndedQueries.end()), EndedQueries.end());
+
+        const auto Stride = VkDeviceSize{HeapInfo.NumResults + 1} * sizeof(Uint64);
+        for (size_t RunStart = 0; RunStart < EndedQueries.size();)
+        {
+            auto RunEnd = RunStart + 1;
+            while (RunEnd < EndedQueries.size() && EndedQueries[RunEnd] == EndedQueries[RunEnd - 1] + 1)
+                ++RunEnd;
+
+            const auto FirstQuery = EndedQueries[RunStart];
+            // All queries in the run have been ended, so waiting for the results is safe.
+            CmdBuff.CopyQueryPoolResults(HeapInfo.vkQueryPool, FirstQuery, static_cast<uint32_t>(RunEnd - RunStart),
+                                         m_ReadbackBuffer, HeapInfo.ReadbackOffset * sizeof(Uint64) + FirstQuery * Stride, Stride,
+                                         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+            ++NumCommands;
+
+            RunStart = RunEnd;
+        }
+        EndedQueries.clear();
+    }
+
+    if (NumCommands != 0)
+    {
+        // Make the results visible to the host
+        CmdBuff.BufferMemoryBarrier(m_ReadbackBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+        ++NumCommands;
     }
 
-    return NumQueriesReset;
+    return NumCommands;
 }
 
 } // namespace Diligent
@@ -132,162 +132,158 @@ bool QueryVkImpl::OnEndQuery(IDeviceContext* pContext)
     return true;
 }
 
-bool QueryVkImpl::GetData(void* pData, Uint32 DataSize, bool AutoInvalidate)
+bool QueryVkImpl::ReadResults(Uint32 QueryIdx, Uint64* pResults, Uint32 NumResults)
 {
-    auto CmdQueueId          = m_pContext.RawPtr<DeviceContextVkImpl>()->GetCommandQueueId();
-    auto CompletedFenceValue = m_pDevice->GetCompletedFenceValue(CmdQueueId);
-    bool DataAvailable       = false;
-    if (CompletedFenceValue >= m_QueryEndFenceValue)
+    auto* pQueryMgr = m_pContext.RawPtr<DeviceContextVkImpl>()->GetQueryManager();
+    VERIFY_EXPR(pQueryMgr != nullptr);
+    VERIFY_EXPR(NumResults == pQueryMgr->GetNumQueryResults(m_Desc.Type) + 1);
+
+    // Results of all queries are copied to the readback buffer when the command buffer is submitted
+    if (const auto* pReadbackResults = pQueryMgr->GetQueryResults(m_Desc.Type, QueryIdx))
     {
-        auto* pQueryMgr = m_pContext.RawPtr<DeviceContextVkImpl>()->GetQueryManager();
-        VERIFY_EXPR(pQueryMgr != nullptr);
-        const auto& LogicalDevice = m_pDevice->GetLogicalDevice();
-        auto        vkQueryPool   = pQueryMgr->GetQueryPool(m_Desc.Type);
+        memcpy(pResults, pReadbackResults, sizeof(Uint64) * NumResults);
+        return pResults[NumResults - 1] != 0;
+    }
+
+    // If VK_QUERY_RESULT_WITH_AVAILABILITY_BIT is set, the final integer value written for each query
+    // is non-zero if the query's status was available or zero if the status was unavailable.
+
+    // Applications must take care to ensure that use of the VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+    // bit has the desired effect.
+    // For example, if a query has been used previously and a command buffer records the commands
+    // vkCmdResetQueryPool, vkCmdBeginQuery, and vkCmdEndQuery for that query, then the query will
+    // remain in the available state until vkResetQueryPoolEXT is called or the vkCmdResetQueryPool
+    // command executes on a queue. Applications can use fences or events to ensure that a query has
+    // already been reset before checking for its results or availability status. Otherwise, a stale
+    // value could be returned from a previous use of the query.
+    const auto& LogicalDevice = m_pDevice->GetLogicalDevice();
+
+    auto res = LogicalDevice.GetQueryPoolResults(pQueryMgr->GetQueryPool(m_Desc.Type), QueryIdx, 1,
+                                                 sizeof(Uint64) * NumResults, pResults, 0,
+                                                 VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    return res == VK_SUCCESS && pResults[NumResults - 1] != 0;
+}
+
+bool QueryVkImpl::ReadData(void* pData)
+{
+    if (m_QueryPoolIndex[0] == QueryManagerVk::InvalidIndex)
+        return false;
+
+    auto* pQueryMgr = m_pContext.RawPtr<DeviceContextVkImpl>()->GetQueryManager();
+    VERIFY_EXPR(pQueryMgr != nullptr);
 
-        switch (m_Desc.Type)
+    // Query result values followed by the availability value
+    std::array<Uint64, 16> Results       = {};
+    const auto             NumResults    = pQueryMgr->GetNumQueryResults(m_Desc.Type) + 1;
+    bool                   DataAvailable = false;
+    VERIFY_EXPR(NumResults <= Results.size());
+
+    switch (m_Desc.Type)
+    {
+        case QUERY_TYPE_OCCLUSION:
         {
-            case QUERY_TYPE_OCCLUSION:
+            DataAvailable = ReadResults(m_QueryPoolIndex[0], Results.data(), NumResults);
+            if (DataAvailable && pData != nullptr)
             {
-                std::array<uint64_t, 2> Results = {};
-                // If VK_QUERY_RESULT_WITH_AVAILABILITY_BIT is set, the final integer value written for each query
-                // is non-zero if the query's status was available or zero if the status was unavailable.
-
-                // Applications must take care to ensure that use of the VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
-                // bit has the desired effect.
-                // For example, if a query has been used previously and a command buffer records the commands
-                // vkCmdResetQueryPool, vkCmdBeginQuery, and vkCmdEndQuery for that query, then the query will
-                // remain in the available state until vkResetQueryPoolEXT is called or the vkCmdResetQueryPool
-                // command executes on a queue. Applications can use fences or events to ensure that a query has
-                // already been reset before checking for its results or availability status. Otherwise, a stale
-                // value could be returned from a previous use of the query.
-                auto res = LogicalDevice.GetQueryPoolResults(vkQueryPool, m_QueryPoolIndex[0], 1,
-                                                             sizeof(Results[0]) * Results.size(), Results.data(), 0,
-                                                             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
-
-                DataAvailable = (res == VK_SUCCESS && Results[1] != 0);
-                if (DataAvailable && pData != nullptr)
-                {
-                    auto& QueryData      = *reinterpret_cast<QueryDataOcclusion*>(pData);
-                    QueryData.NumSamples = Results[0];
-                }
+                auto& QueryData      = *reinterpret_cast<QueryDataOcclusion*>(pData);
+                QueryData.NumSamples = Results[0];
             }
-            break;
+        }
+        break;
 
-            case QUERY_TYPE_BINARY_OCCLUSION:
+        case QUERY_TYPE_BINARY_OCCLUSION:
+        {
+            DataAvailable = ReadResults(m_QueryPoolIndex[0], Results.data(), NumResults);
+            if (DataAvailable && pData != nullptr)
             {
-                std::array<uint64_t, 2> Results = {};
-
-                auto res = LogicalDevice.GetQueryPoolResults(vkQueryPool, m_QueryPoolIndex[0], 1,
-                                                             sizeof(Results[0]) * Results.size(), Results.data(), 0,
-                                                             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
-
-                DataAvailable = (res == VK_SUCCESS && Results[1] != 0);
-                if (DataAvailable && pData != nullptr)
-                {
-                    auto& QueryData           = *reinterpret_cast<QueryDataBinaryOcclusion*>(pData);
-                    QueryData.AnySamplePassed = Results[0] != 0;
-                }
+                auto& QueryData           = *reinterpret_cast<QueryDataBinaryOcclusion*>(pData);
+                QueryData.AnySamplePassed = Results[0] != 0;
             }
-            break;
+        }
+        break;
 
-            case QUERY_TYPE_TIMESTAMP:
+        case QUERY_TYPE_TIMESTAMP:
+        {
+            DataAvailable = ReadResults(m_QueryPoolIndex[0], Results.data(), NumResults);
+            if (DataAvailable && pData != nullptr)
             {
-                std::array<uint64_t, 2> Results = {};
-
-                auto res = LogicalDevice.GetQueryPoolResults(vkQueryPool, m_QueryPoolIndex[0], 1,
-                                                             sizeof(Results[0]) * Results.size(), Results.data(), 0,
-                                                             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
-
-                DataAvailable = (res == VK_SUCCESS && Results[1] != 0);
-                if (DataAvailable && pData != nullptr)
-                {
-                    auto& QueryData     = *reinterpret_cast<QueryDataTimestamp*>(pData);
-                    QueryData.Counter   = Results[0];
-                    QueryData.Frequency = pQueryMgr->GetCounterFrequency();
-                }
+                auto& QueryData     = *reinterpret_cast<QueryDataTimestamp*>(pData);
+                QueryData.Counter   = Results[0];
+                QueryData.Frequency = pQueryMgr->GetCounterFrequency();
             }
-            break;
+        }
+        break;
 
-            case QUERY_TYPE_PIPELINE_STATISTICS:
+        case QUERY_TYPE_PIPELINE_STATISTICS:
+        {
+            // Pipeline statistics queries write one integer value for each bit that is enabled in the
+            // pipelineStatistics when the pool is created, and the statistics values are written in bit
+            // order starting from the least significant bit. (17.2)
+            DataAvailable = ReadResults(m_QueryPoolIndex[0], Results.data(), NumResults);
+            if (DataAvailable && pData != nullptr)
             {
-                // Pipeline statistics queries write one integer value for each bit that is enabled in the
-                // pipelineStatistics when the pool is created, and the statistics values are written in bit
-                // order starting from the least significant bit. (17.2)
+                auto& QueryData = *reinterpret_cast<QueryDataPipelineStatistics*>(pData);
 
-                std::array<Uint64, 12> Results;
+                const auto EnabledShaderStages = m_pDevice->GetLogicalDevice().GetEnabledGraphicsShaderStages();
 
-                auto res = LogicalDevice.GetQueryPoolResults(vkQueryPool, m_QueryPoolIndex[0], 1,
-                                                             sizeof(Results[0]) * Results.size(), Results.data(), 0,
-                                                             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+                auto Idx = 0;
 
-                DataAvailable = (res == VK_SUCCESS);
-                if (DataAvailable && pData != nullptr)
+                QueryData.InputVertices   = Results[Idx++]; // INPUT_ASSEMBLY_VERTICES_BIT   = 0x00000001
+                QueryData.InputPrimitives = Results[Idx++]; // INPUT_ASSEMBLY_PRIMITIVES_BIT = 0x00000002
+                QueryData.VSInvocations   = Results[Idx++]; // VERTEX_SHADER_INVOCATIONS_BIT = 0x00000004
+                if (EnabledShaderStages & VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT)
                 {
-                    auto& QueryData = *reinterpret_cast<QueryDataPipelineStatistics*>(pData);
-
-                    const auto EnabledShaderStages = LogicalDevice.GetEnabledGraphicsShaderStages();
-
-                    auto Idx = 0;
-
-                    QueryData.InputVertices   = Results[Idx++]; // INPUT_ASSEMBLY_VERTICES_BIT   = 0x00000001
-                    QueryData.InputPrimitives = Results[Idx++]; // INPUT_ASSEMBLY_PRIMITIVES_BIT = 0x00000002
-                    QueryData.VSInvocations   = Results[Idx++]; // VERTEX_SHADER_INVOCATIONS_BIT = 0x00000004
-                    if (EnabledShaderStages & VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT)
-                    {
-                        QueryData.GSInvocations = Results[Idx++]; // GEOMETRY_SHADER_INVOCATIONS_BIT = 0x00000008
-                        QueryData.GSPrimitives  = Results[Idx++]; // GEOMETRY_SHADER_PRIMITIVES_BIT  = 0x00000010
-                    }
-                    QueryData.ClippingInvocations = Results[Idx++]; // CLIPPING_INVOCATIONS_BIT         = 0x00000020
-                    QueryData.ClippingPrimitives  = Results[Idx++]; // CLIPPING_PRIMITIVES_BIT          = 0x00000040
-                    QueryData.PSInvocations       = Results[Idx++]; // FRAGMENT_SHADER_INVOCATIONS_BIT  = 0x00000080
-
-                    if (EnabledShaderStages & VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT)
-                        QueryData.HSInvocations = Results[Idx++]; // TESSELLATION_CONTROL_SHADER_PATCHES_BIT        = 0x00000100
+                    QueryData.GSInvocations = Results[Idx++]; // GEOMETRY_SHADER_INVOCATIONS_BIT = 0x00000008
+                    QueryData.GSPrimitives  = Results[Idx++]; // GEOMETRY_SHADER_PRIMITIVES_BIT  = 0x00000010
+                }
+                QueryData.ClippingInvocations = Results[Idx++]; // CLIPPING_INVOCATIONS_BIT         = 0x00000020
+                QueryData.ClippingPrimitives  = Results[Idx++]; // CLIPPING_PRIMITIVES_BIT          = 0x00000040
+                QueryData.PSInvocations       = Results[Idx++]; // FRAGMENT_SHADER_INVOCATIONS_BIT  = 0x00000080
 
-                    if (EnabledShaderStages & VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT)
-                        QueryData.DSInvocations = Results[Idx++]; // TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT = 0x00000200
+                if (EnabledShaderStages & VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT)
+                    QueryData.HSInvocations = Results[Idx++]; // TESSELLATION_CONTROL_SHADER_PATCHES_BIT        = 0x00000100
 
-                    QueryData.CSInvocations = Results[Idx++]; // COMPUTE_SHADER_INVOCATIONS_BIT = 0x00000400
+                if (EnabledShaderStages & VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT)
+                    QueryData.DSInvocations = Results[Idx++]; // TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT = 0x00000200
 
-                    DataAvailable = Results[Idx] != 0;
-                }
+                QueryData.CSInvocations = Results[Idx++]; // COMPUTE_SHADER_INVOCATIONS_BIT = 0x00000400
             }
-            break;
-
-
-            case QUERY_TYPE_DURATION:
-            {
-                uint64_t StartCounter = 0;
-                uint64_t EndCounter   = 0;
+        }
+        break;
 
-                DataAvailable = true;
-                for (Uint32 i = 0; i < 2; ++i)
-                {
-                    std::array<uint64_t, 2> Results = {};
 
-                    auto res = LogicalDevice.GetQueryPoolResults(vkQueryPool, m_QueryPoolIndex[i], 1,
-                                                                 sizeof(Results[0]) * Results.size(), Results.data(), 0,
-                                                                 VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        case QUERY_TYPE_DURATION:
+        {
+            DataAvailable           = ReadResults(m_QueryPoolIndex[0], Results.data(), NumResults);
+            const auto StartCounter = Results[0];
+            DataAvailable           = ReadResults(m_QueryPoolIndex[1], Results.data(), NumResults) && DataAvailable;
+            const auto EndCounter   = Results[0];
 
-                    if (res != VK_SUCCESS || Results[1] == 0)
-                        DataAvailable = false;
+            if (DataAvailable && pData != nullptr)
+            {
+                auto& QueryData = *reinterpret_cast<QueryDataTimestamp*>(pData);
+                VERIFY_EXPR(EndCounter >= StartCounter);
+                QueryData.Counter   = EndCounter - StartCounter;
+                QueryData.Frequency = pQueryMgr->GetCounterFrequency();
+            }
+        }
+        break;
 
-                    (i == 0 ? StartCounter : EndCounter) = Results[0];
-                }
+        default:
+            UNEXPECTED("Unexpected query type");
+    }
 
-                if (DataAvailable && pData != nullptr)
-                {
-                    auto& QueryData = *reinterpret_cast<QueryDataTimestamp*>(pData);
-                    VERIFY_EXPR(EndCounter >= StartCounter);
-                    QueryData.Counter   = EndCounter - StartCounter;
-                    QueryData.Frequency = pQueryMgr->GetCounterFrequency();
-                }
-            }
-            break;
+    return DataAvailable;
+}
 
-            default:
-                UNEXPECTED("Unexpected query type");
-        }
+bool QueryVkImpl::GetData(void* pData, Uint32 DataSize, bool AutoInvalidate)
+{
+    auto CmdQueueId          = m_pContext.RawPtr<DeviceContextVkImpl>()->GetCommandQueueId();
+    auto CompletedFenceValue = m_pDevice->GetCompletedFenceValue(CmdQueueId);
+    bool DataAvailable       = false;
+    if (CompletedFenceValue >= m_QueryEndFenceValue)
+    {
+        DataAvailable = ReadData(pData);
     }
 
     if (DataAvailable && pData != nullptr && AutoInvalidate)
@@ -40,6 +40,7 @@
 #include "RenderPassVkImpl.hpp"
 #include "FramebufferVkImpl.hpp"
 #include "EngineMemory.h"
+#include "Align.hpp"
 
 namespace Diligent
 {
@@ -84,6 +85,8 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
     m_EngineAttribs          {EngineCI                 },
     m_FramebufferCache       {*this                    },
     m_ImplicitRenderPassCache{*this                    },
+    m_PipelineLayoutCache    {*this                    },
+    m_ShaderReflectionCache  {EngineCI.ShaderReflectionCacheSize},
     m_DescriptorSetAllocator
     {
         *this,
@@ -251,6 +254,12 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
 
 RenderDeviceVkImpl::~RenderDeviceVkImpl()
 {
+    {
+        std::lock_guard<std::mutex> BatchLock{m_UploadBatchMtx};
+        DEV_CHECK_ERR(m_UploadBatchDepth == 0, "Upload batch has not been ended. Every call to BeginUploadBatch() must be matched by a call to EndUploadBatch().");
+        SubmitUploadBatch();
+    }
+
     // Explicitly destroy dynamic heap. This will move resources owned by
     // the heap into release queues
     m_DynamicMemoryManager.Destroy();
@@ -364,6 +373,212 @@ void RenderDeviceVkImpl::ExecuteAndDisposeTransientCmdBuff(Uint32 QueueIndex, Vk
     m_TransientCmdPoolMgr.SafeReleaseCommandPool(std::move(CmdPool), QueueIndex, FenceValue);
 }
 
+RenderDeviceVkImpl::StagingBuffer RenderDeviceVkImpl::CreateStagingBuffer(VkDeviceSize Size, const Char* Name)
+{
+    VkBufferCreateInfo VkStagingBuffCI    = {};
+    VkStagingBuffCI.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    VkStagingBuffCI.pNext                 = nullptr;
+    VkStagingBuffCI.flags                 = 0;
+    VkStagingBuffCI.size                  = Size;
+    VkStagingBuffCI.usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    VkStagingBuffCI.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+    VkStagingBuffCI.queueFamilyIndexCount = 0;
+    VkStagingBuffCI.pQueueFamilyIndices   = nullptr;
+
+    StagingBuffer Staging;
+    Staging.Buffer = m_LogicalVkDevice->CreateBuffer(VkStagingBuffCI, Name);
+    Staging.Size   = Size;
+
+    VkMemoryRequirements StagingBufferMemReqs = m_LogicalVkDevice->GetBufferMemoryRequirements(Staging.Buffer);
+    VERIFY(IsPowerOfTwo(StagingBufferMemReqs.alignment), "Alignment is not power of 2!");
+    // VK_MEMORY_PROPERTY_HOST_COHERENT_BIT bit specifies that the host cache management commands vkFlushMappedMemoryRanges
+    // and vkInvalidateMappedMemoryRanges are NOT needed to flush host writes to the device or make device writes visible
+    // to the host (10.2)
+    Staging.Memory               = AllocateMemory(StagingBufferMemReqs, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    auto AlignedStagingMemOffset = Align(VkDeviceSize{Staging.Memory.UnalignedOffset}, StagingBufferMemReqs.alignment);
+    VERIFY_EXPR(Staging.Memory.Size >= StagingBufferMemReqs.size + (AlignedStagingMemOffset - Staging.Memory.UnalignedOffset));
+
+    auto* StagingData = reinterpret_cast<Uint8*>(Staging.Memory.Page->GetCPUMemory());
+    if (StagingData == nullptr)
+        LOG_ERROR_AND_THROW("Failed to allocate staging memory for '", Name, '\'');
+    Staging.pCPUAddress = StagingData + AlignedStagingMemOffset;
+
+    auto err = m_LogicalVkDevice->BindBufferMemory(Staging.Buffer, Staging.Memory.Page->GetVkMemory(), AlignedStagingMemOffset);
+    CHECK_VK_ERROR_AND_THROW(err, "Failed to bind staging bufer memory");
+
+    return Staging;
+}
+
+void RenderDeviceVkImpl::ReleaseStagingBuffer(StagingBuffer&& Staging, Uint32 QueueIndex)
+{
+    // After the transient command buffer is submitted, safe-release staging resources. This strategy
+    // is little overconservative as the resources will only be released after the
+    // first command buffer submitted through the immediate context is complete
+
+    // Next Cmd Buff| Next Fence |               This Thread                      |           Immediate Context
+    //              |            |                                                |
+    //      N       |     F      |                                                |
+    //              |            |                                                |
+    //              |            |  ExecuteAndDisposeTransientCmdBuff(vkCmdBuff)  |
+    //              |            |  - SubmittedCmdBuffNumber = N                  |
+    //              |            |  - SubmittedFenceValue = F                     |
+    //     N+1 -  - | -  F+1  -  |                                                |
+    //              |            |  Release(StagingBuffer)                        |
+    //              |            |  - {N+1, StagingBuffer} -> Stale Objects       |
+    //              |            |                                                |
+    //              |            |                                                |
+    //              |            |                                                | ExecuteCommandBuffer()
+    //              |            |                                                | - SubmittedCmdBuffNumber = N+1
+    //              |            |                                                | - SubmittedFenceValue = F+1
+    //     N+2 -  - | -  F+2  -  |  -   -   -   -   -   -   -   -   -   -   -   - |
+    //              |            |                                                | - DiscardStaleVkObjects(N+1, F+1)
+    //              |            |                                                |   - {F+1, StagingBuffer} -> Release Queue
+    //              |            |                                                |
+    SafeReleaseDeviceObject(std::move(Staging.Buffer), Uint64{1} << Uint64{QueueIndex});
+    SafeReleaseDeviceObject(std::move(Staging.Memory), Uint64{1} << Uint64{QueueIndex});
+}
+
+Uint64 RenderDeviceVkImpl::RecordResourceInitCommands(VkDeviceSize                        UploadSize,
+                                                      VkDeviceSize                        UploadAlignment,
+                                                      const ResourceUploadDataWriter&     WriteData,
+                                                      const ResourceInitCommandsRecorder& Recorder,
+                                                      const Char*                         ResourceName)
+{
+    VERIFY_EXPR(UploadAlignment > 0);
+    VERIFY(UploadSize == 0 || WriteData, "Data writer must not be empty when upload space is requested");
+
+    {
+        std::unique_lock<std::mutex> BatchLock{m_UploadBatchMtx};
+        if (m_UploadBatchDepth > 0)
+        {
+            if (m_UploadBatchCmdBuff == VK_NULL_HANDLE)
+                AllocateTransientCmdPool(m_UploadBatchCmdPool, m_UploadBatchCmdBuff, "Upload batch command pool");
+
+            ResourceUploadSpace UploadSpace;
+            if (UploadSize > 0)
+            {
+                auto* pPage  = !m_UploadBatchPages.empty() ? &m_UploadBatchPages.back() : nullptr;
+                auto  Offset = pPage != nullptr ? (pPage->UsedSize + UploadAlignment - 1) / UploadAlignment * UploadAlignment : 0;
+                if (pPage == nullptr || Offset + UploadSize > pPage->Size)
+                {
+                    // The remaining space of the previous page is abandoned. Pages are released when the batch is submitted.
+                    const auto PageSize = std::max(UploadSize, VkDeviceSize{m_EngineAttribs.UploadBatchPageSize});
+                    m_UploadBatchPages.emplace_back(CreateStagingBuffer(PageSize, "Upload batch page"));
+                    pPage  = &m_UploadBatchPages.back();
+                    Offset = 0;
+                }
+                pPage->UsedSize = Offset + UploadSize;
+
+                UploadSpace.vkBuffer    = pPage->Buffer;
+                UploadSpace.Offset      = Offset;
+                UploadSpace.pCPUAddress = pPage->pCPUAddress + Offset;
+            }
+
+            // The batch must not be submitted by another thread while the data is being written
+            ++m_NumPendingUploads;
+            BatchLock.unlock();
+
+            // The range belongs to this resource only, so the data is written without holding the mutex
+            if (UploadSize > 0)
+                WriteData(UploadSpace);
+
+            BatchLock.lock();
+            // Command buffer is not thread-safe, so the commands are recorded while the mutex is locked
+            Recorder(m_UploadBatchCmdBuff, UploadSpace);
+
+            const auto BatchId = m_UploadBatchId;
+            // The outermost batch may have been ended while the data was being written
+            if (--m_NumPendingUploads == 0 && m_UploadBatchDepth == 0)
+                SubmitUploadBatch();
+            return BatchId;
+        }
+    }
+
+    StagingBuffer       Staging;
+    ResourceUploadSpace UploadSpace;
+    if (UploadSize > 0)
+    {
+        std::string StagingBufferName = "Upload buffer for '";
+        StagingBufferName += ResourceName;
+        StagingBufferName += '\'';
+        Staging = CreateStagingBuffer(UploadSize, StagingBufferName.c_str());
+
+        UploadSpace.vkBuffer    = Staging.Buffer;
+        UploadSpace.pCPUAddress = Staging.pCPUAddress;
+
+        WriteData(UploadSpace);
+    }
+
+    VulkanUtilities::CommandPoolWrapper CmdPool;
+    VkCommandBuffer                     vkCmdBuff;
+    AllocateTransientCmdPool(CmdPool, vkCmdBuff, "Transient command pool to initialize a resource");
+
+    Recorder(vkCmdBuff, UploadSpace);
+
+    Uint32 QueueIndex = 0;
+    ExecuteAndDisposeTransientCmdBuff(QueueIndex, vkCmdBuff, std::move(CmdPool));
+
+    if (Staging.Buffer != VK_NULL_HANDLE)
+        ReleaseStagingBuffer(std::move(Staging), QueueIndex);
+
+    return 0;
+}
+
+void RenderDeviceVkImpl::RetainUntilUploadBatchSubmitted(IDeviceObject* pResource, Uint64 UploadBatchId)
+{
+    if (UploadBatchId == 0)
+        return;
+
+    std::lock_guard<std::mutex> BatchLock{m_UploadBatchMtx};
+    // The batch may have already been submitted by another thread, in which case the resource
+    // objects are safe-released after the batch command buffer like any other object.
+    if (UploadBatchId == m_UploadBatchId && m_UploadBatchCmdBuff != VK_NULL_HANDLE)
+        m_UploadBatchResources.emplace_back(pResource);
+}
+
+void RenderDeviceVkImpl::BeginUploadBatch()
+{
+    std::lock_guard<std::mutex> BatchLock{m_UploadBatchMtx};
+    ++m_UploadBatchDepth;
+}
+
+void RenderDeviceVkImpl::EndUploadBatch()
+{
+    std::lock_guard<std::mutex> BatchLock{m_UploadBatchMtx};
+    if (m_UploadBatchDepth == 0)
+    {
+        LOG_ERROR_MESSAGE("EndUploadBatch() is called without matching BeginUploadBatch()");
+        return;
+    }
+
+    // If other threads are still writing their data, the last of them submits the batch
+    if (--m_UploadBatchDepth == 0 && m_NumPendingUploads == 0)
+        SubmitUploadBatch();
+}
+
+void RenderDeviceVkImpl::SubmitUploadBatch()
+{
+    if (m_UploadBatchCmdBuff == VK_NULL_HANDLE)
+    {
+        VERIFY(m_UploadBatchPages.empty(), "Upload batch pages must be empty when no commands have been recorded");
+        VERIFY(m_UploadBatchResources.empty(), "Upload batch resources must be empty when no commands have been recorded");
+        return;
+    }
+
+    Uint32 QueueIndex = 0;
+    ExecuteAndDisposeTransientCmdBuff(QueueIndex, m_UploadBatchCmdBuff, std::move(m_UploadBatchCmdPool));
+    m_UploadBatchCmdBuff = VK_NULL_HANDLE;
+    ++m_UploadBatchId;
+
+    for (auto& Page : m_UploadBatchPages)
+        ReleaseStagingBuffer(std::move(Page), QueueIndex);
+    m_UploadBatchPages.clear();
+
+    // The command buffer has been submitted, so the objects of the resources that are
+    // destroyed now are released after it is complete
+    m_UploadBatchResources.clear();
+}
+
 void RenderDeviceVkImpl::SubmitCommandBuffer(Uint32                                                 QueueIndex,
                                              const VkSubmitInfo&                                    SubmitInfo,
                                              Uint64&                                                SubmittedCmdBuffNumber, // Number of the submitted command buffer
@@ -580,6 +795,7 @@ void RenderDeviceVkImpl::CreateBuffer(const BufferDesc& BuffDesc, const BufferDa
             pBufferVk->QueryInterface(IID_Buffer, reinterpret_cast<IObject**>(ppBuffer));
             pBufferVk->CreateDefaultViews();
             OnCreateDeviceObject(pBufferVk);
+            RetainUntilUploadBatchSubmitted(pBufferVk, pBufferVk->GetUploadBatchId());
         } //
     );
 }
@@ -640,6 +856,7 @@ void RenderDeviceVkImpl::CreateTexture(const TextureDesc& TexDesc, const Texture
             pTextureVk->QueryInterface(IID_Texture, reinterpret_cast<IObject**>(ppTexture));
             pTextureVk->CreateDefaultViews();
             OnCreateDeviceObject(pTextureVk);
+            RetainUntilUploadBatchSubmitted(pTextureVk, pTextureVk->GetUploadBatchId());
         } //
     );
 }
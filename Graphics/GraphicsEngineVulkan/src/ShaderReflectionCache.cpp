@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "ShaderReflectionCache.hpp"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+ShaderReflectionCache::ReflectionCacheKey::ReflectionCacheKey(const std::vector<uint32_t>& SPIRV, SHADER_TYPE _ShaderType, const char* _CombinedSamplerSuffix) :
+    // clang-format off
+    SPIRVHash            {0},
+    SPIRVSize            {SPIRV.size()},
+    ShaderType           {_ShaderType},
+    UseCombinedSamplers  {_CombinedSamplerSuffix != nullptr},
+    CombinedSamplerSuffix{_CombinedSamplerSuffix != nullptr ? _CombinedSamplerSuffix : ""}
+// clang-format on
+{
+    for (auto Word : SPIRV)
+        HashCombine(SPIRVHash, Word);
+}
+
+bool ShaderReflectionCache::ReflectionCacheKey::operator==(const ReflectionCacheKey& rhs) const
+{
+    // clang-format off
+    return SPIRVHash             == rhs.SPIRVHash           &&
+           SPIRVSize             == rhs.SPIRVSize           &&
+           ShaderType            == rhs.ShaderType          &&
+           UseCombinedSamplers   == rhs.UseCombinedSamplers &&
+           CombinedSamplerSuffix == rhs.CombinedSamplerSuffix;
+    // clang-format on
+}
+
+size_t ShaderReflectionCache::ReflectionCacheKey::GetHash() const
+{
+    return ComputeHash(SPIRVHash, SPIRVSize, static_cast<Int32>(ShaderType), UseCombinedSamplers, CombinedSamplerSuffix);
+}
+
+ShaderReflectionCache::SerializedDataType ShaderReflectionCache::Find(const std::vector<uint32_t>& SPIRV, SHADER_TYPE ShaderType, const char* CombinedSamplerSuffix)
+{
+    if (m_MaxSize == 0)
+        return nullptr;
+
+    ReflectionCacheKey Key{SPIRV, ShaderType, CombinedSamplerSuffix};
+
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto it = m_Cache.find(Key);
+    if (it == m_Cache.end())
+        return nullptr;
+
+    // Move the entry to the front of the LRU list
+    m_LRUList.splice(m_LRUList.begin(), m_LRUList, it->second.LRUIt);
+    return it->second.pData;
+}
+
+void ShaderReflectionCache::Add(const std::vector<uint32_t>& SPIRV, SHADER_TYPE ShaderType, const char* CombinedSamplerSuffix, std::vector<Uint8>&& Data)
+{
+    const auto DataSize = Data.size();
+    if (DataSize > m_MaxSize)
+        return;
+
+    ReflectionCacheKey Key{SPIRV, ShaderType, CombinedSamplerSuffix};
+    SerializedDataType pData{new std::vector<Uint8>{std::move(Data)}};
+
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    auto it_inserted = m_Cache.emplace(Key, CacheEntry{std::move(pData), m_LRUList.end()});
+    if (!it_inserted.second)
+    {
+        // Another thread has added the same data
+        return;
+    }
+
+    m_LRUList.emplace_front(std::move(Key));
+    it_inserted.first->second.LRUIt = m_LRUList.begin();
+    m_Size += DataSize;
+
+    while (m_Size > m_MaxSize)
+    {
+        VERIFY_EXPR(!m_LRUList.empty());
+        auto it = m_Cache.find(m_LRUList.back());
+        VERIFY_EXPR(it != m_Cache.end());
+        m_Size -= it->second.pData->size();
+        m_Cache.erase(it);
+        m_LRUList.pop_back();
+    }
+}
+
+void ShaderReflectionCache::Clear()
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+
+    m_Cache.clear();
+    m_LRUList.clear();
+    m_Size = 0;
+}
+
+size_t ShaderReflectionCache::GetSize()
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+    return m_Size;
+}
+
+} // namespace Diligent
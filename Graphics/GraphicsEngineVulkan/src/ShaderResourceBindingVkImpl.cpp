@@ -52,12 +52,21 @@ ShaderResourceBindingVkImpl::ShaderResourceBindingVkImpl(IReferenceCounters*  pR
     m_NumShaders = static_cast<decltype(m_NumShaders)>(pPSO->GetNumShaderStages());
 
     auto* pRenderDeviceVkImpl = pPSO->GetDevice();
-    // This will only allocate memory and initialize descriptor sets in the resource cache
+
+    // Allocate memory for all SRB data at once. If allocation granularity > 1, fixed block memory
+    // allocator of the pipeline state is used, so that the data of different SRBs resides in continuous memory.
+    const auto& MemLayout        = pPSO->GetSRBMemoryLayout();
+    auto&       SRBDataAllocator = pPSO->GetSRBMemoryAllocator().GetResourceCacheDataAllocator(0);
+
+    auto* pRawMem    = ALLOCATE_RAW(SRBDataAllocator, "Raw memory for shader resource binding data", MemLayout.TotalSize);
+    m_MemoryBuffer   = std::unique_ptr<void, STDDeleterRawMem<void>>(pRawMem, SRBDataAllocator);
+    auto* pDataStart = reinterpret_cast<Uint8*>(pRawMem);
+
+    // This will only initialize descriptor sets in the resource cache
     // Resources will be initialized by InitializeResourceMemoryInCache()
-    auto& ResourceCacheDataAllocator = pPSO->GetSRBMemoryAllocator().GetResourceCacheDataAllocator(0);
-    pPSO->GetPipelineLayout().InitResourceCache(pRenderDeviceVkImpl, m_ShaderResourceCache, ResourceCacheDataAllocator, pPSO->GetDesc().Name);
+    pPSO->GetPipelineLayout().InitResourceCache(pRenderDeviceVkImpl, m_ShaderResourceCache, pDataStart + MemLayout.CacheDataOffset, pPSO->GetDesc().Name);
 
-    m_pShaderVarMgrs = ALLOCATE(GetRawAllocator(), "Raw memory for ShaderVariableManagerVk", ShaderVariableManagerVk, m_NumShaders);
+    m_pShaderVarMgrs = reinterpret_cast<ShaderVariableManagerVk*>(pDataStart);
 
     for (Uint32 s = 0; s < m_NumShaders; ++s)
     {
@@ -65,8 +74,6 @@ ShaderResourceBindingVkImpl::ShaderResourceBindingVkImpl(IReferenceCounters*  pR
 
         m_ResourceLayoutIndex[ShaderInd] = static_cast<Int8>(s);
 
-        auto& VarDataAllocator = pPSO->GetSRBMemoryAllocator().GetShaderVariableDataAllocator(s);
-
         const auto& SrcLayout = pPSO->GetShaderResLayout(s);
         // Use source layout to initialize resource memory in the cache
         SrcLayout.InitializeResourceMemoryInCache(m_ShaderResourceCache);
@@ -75,7 +82,7 @@ ShaderResourceBindingVkImpl::ShaderResourceBindingVkImpl(IReferenceCounters*  pR
         // Initialize vars manager to reference mutable and dynamic variables
         // Note that the cache has space for all variable types
         const SHADER_RESOURCE_VARIABLE_TYPE VarTypes[] = {SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE, SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC};
-        new (m_pShaderVarMgrs + s) ShaderVariableManagerVk{*this, SrcLayout, VarDataAllocator, VarTypes, _countof(VarTypes), m_ShaderResourceCache};
+        new (m_pShaderVarMgrs + s) ShaderVariableManagerVk{*this, SrcLayout, pDataStart + MemLayout.VarDataOffsets[s], VarTypes, _countof(VarTypes), m_ShaderResourceCache};
     }
 #ifdef DILIGENT_DEBUG
     m_ShaderResourceCache.DbgVerifyResourceInitialization();
@@ -86,12 +93,10 @@ ShaderResourceBindingVkImpl::~ShaderResourceBindingVkImpl()
 {
     for (Uint32 s = 0; s < m_NumShaders; ++s)
     {
-        auto& VarDataAllocator = m_pPSO->GetSRBMemoryAllocator().GetShaderVariableDataAllocator(s);
-        m_pShaderVarMgrs[s].DestroyVariables(VarDataAllocator);
+        m_pShaderVarMgrs[s].DestroyVariables();
         m_pShaderVarMgrs[s].~ShaderVariableManagerVk();
     }
-
-    GetRawAllocator().Free(m_pShaderVarMgrs);
+    // m_MemoryBuffer is released after m_ShaderResourceCache is destroyed
 }
 
 IMPLEMENT_QUERY_INTERFACE(ShaderResourceBindingVkImpl, IID_ShaderResourceBindingVk, TBase)
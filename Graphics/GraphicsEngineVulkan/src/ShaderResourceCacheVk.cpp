@@ -48,6 +48,17 @@ size_t ShaderResourceCacheVk::GetRequiredMemorySize(Uint32 NumSets, Uint32 SetSi
 }
 
 void ShaderResourceCacheVk::InitializeSets(IMemoryAllocator& MemAllocator, Uint32 NumSets, Uint32 SetSizes[])
+{
+    VERIFY(m_pAllocator == nullptr && m_pMemory == nullptr, "Cache already initialized");
+
+    auto  MemorySize = GetRequiredMemorySize(NumSets, SetSizes);
+    void* pMemory    = MemorySize > 0 ? ALLOCATE_RAW(MemAllocator, "Memory for shader resource cache data", MemorySize) : nullptr;
+    InitializeSets(pMemory, NumSets, SetSizes);
+    if (m_pMemory != nullptr)
+        m_pAllocator = &MemAllocator;
+}
+
+void ShaderResourceCacheVk::InitializeSets(void* pMemory, Uint32 NumSets, Uint32 SetSizes[])
 {
     // Memory layout:
     //
@@ -60,7 +71,6 @@ void ShaderResourceCacheVk::InitializeSets(IMemoryAllocator& MemAllocator, Uint3
     //  Ns = m_NumSets
 
     VERIFY(m_pAllocator == nullptr && m_pMemory == nullptr, "Cache already initialized");
-    m_pAllocator = &MemAllocator;
     VERIFY(NumSets < std::numeric_limits<decltype(m_NumSets)>::max(), "NumSets (", NumSets, ") exceed maximum representable value");
     m_NumSets        = static_cast<Uint16>(NumSets);
     m_TotalResources = 0;
@@ -73,7 +83,8 @@ void ShaderResourceCacheVk::InitializeSets(IMemoryAllocator& MemAllocator, Uint3
 #endif
     if (MemorySize > 0)
     {
-        m_pMemory         = ALLOCATE_RAW(*m_pAllocator, "Memory for shader resource cache data", MemorySize);
+        VERIFY(pMemory != nullptr, "Memory for the resource cache data must not be null");
+        m_pMemory         = pMemory;
         auto* pSets       = reinterpret_cast<DescriptorSet*>(m_pMemory);
         auto* pCurrResPtr = reinterpret_cast<Resource*>(pSets + m_NumSets);
         for (Uint32 t = 0; t < NumSets; ++t)
@@ -144,7 +155,8 @@ ShaderResourceCacheVk::~ShaderResourceCacheVk()
         for (Uint32 t = 0; t < m_NumSets; ++t)
             GetDescriptorSet(t).~DescriptorSet();
 
-        m_pAllocator->Free(m_pMemory);
+        if (m_pAllocator != nullptr)
+            m_pAllocator->Free(m_pMemory);
     }
 }
 
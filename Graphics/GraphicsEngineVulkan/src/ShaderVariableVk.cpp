@@ -75,11 +75,10 @@ ShaderVariableManagerVk::ShaderVariableManagerVk(IObject&
     m_Owner        {Owner        },
     m_ResourceCache{ResourceCache}
 #ifdef DILIGENT_DEBUG
-  , m_DbgAllocator {Allocator}
+  , m_pDbgAllocator{&Allocator   }
 #endif
 // clang-format on
 {
-    const Uint32 AllowedTypeBits = GetAllowedTypeBits(AllowedVarTypes, NumAllowedTypes);
     VERIFY_EXPR(m_NumVariables == 0);
     auto MemSize = GetRequiredMemorySize(SrcLayout, AllowedVarTypes, NumAllowedTypes, m_NumVariables);
 
@@ -89,6 +88,41 @@ ShaderVariableManagerVk::ShaderVariableManagerVk(IObject&
     auto* pRawMem = ALLOCATE_RAW(Allocator, "Raw memory buffer for shader variables", MemSize);
     m_pVariables  = reinterpret_cast<ShaderVariableVkImpl*>(pRawMem);
 
+    InitVariables(SrcLayout, AllowedVarTypes, NumAllowedTypes);
+}
+
+ShaderVariableManagerVk::ShaderVariableManagerVk(IObject&                             Owner,
+                                                 const ShaderResourceLayoutVk&        SrcLayout,
+                                                 void*                                pVariablesMemory,
+                                                 const SHADER_RESOURCE_VARIABLE_TYPE* AllowedVarTypes,
+                                                 Uint32                               NumAllowedTypes,
+                                                 ShaderResourceCacheVk&               ResourceCache) :
+    // clang-format off
+    m_Owner        {Owner        },
+    m_ResourceCache{ResourceCache}
+#ifdef DILIGENT_DEBUG
+  , m_pDbgAllocator{nullptr      }
+#endif
+// clang-format on
+{
+    VERIFY_EXPR(m_NumVariables == 0);
+    GetRequiredMemorySize(SrcLayout, AllowedVarTypes, NumAllowedTypes, m_NumVariables);
+
+    if (m_NumVariables == 0)
+        return;
+
+    VERIFY(pVariablesMemory != nullptr, "Memory for shader variables must not be null");
+    m_pVariables = reinterpret_cast<ShaderVariableVkImpl*>(pVariablesMemory);
+
+    InitVariables(SrcLayout, AllowedVarTypes, NumAllowedTypes);
+}
+
+void ShaderVariableManagerVk::InitVariables(const ShaderResourceLayoutVk&        SrcLayout,
+                                            const SHADER_RESOURCE_VARIABLE_TYPE* AllowedVarTypes,
+                                            Uint32                               NumAllowedTypes)
+{
+    const Uint32 AllowedTypeBits = GetAllowedTypeBits(AllowedVarTypes, NumAllowedTypes);
+
     Uint32     VarInd                = 0;
     const bool UsingSeparateSamplers = SrcLayout.IsUsingSeparateSamplers();
     for (SHADER_RESOURCE_VARIABLE_TYPE VarType = SHADER_RESOURCE_VARIABLE_TYPE_STATIC; VarType < SHADER_RESOURCE_VARIABLE_TYPE_NUM_TYPES; VarType = static_cast<SHADER_RESOURCE_VARIABLE_TYPE>(VarType + 1))
@@ -119,7 +153,7 @@ ShaderVariableManagerVk::~ShaderVariableManagerVk()
 
 void ShaderVariableManagerVk::DestroyVariables(IMemoryAllocator& Allocator)
 {
-    VERIFY(&m_DbgAllocator == &Allocator, "Incosistent alloctor");
+    VERIFY(m_pDbgAllocator == &Allocator, "Incosistent alloctor");
 
     if (m_pVariables != nullptr)
     {
@@ -130,6 +164,18 @@ void ShaderVariableManagerVk::DestroyVariables(IMemoryAllocator& Allocator)
     }
 }
 
+void ShaderVariableManagerVk::DestroyVariables()
+{
+    VERIFY(m_pDbgAllocator == nullptr, "Variables were allocated by the manager and must be released through the allocator");
+
+    if (m_pVariables != nullptr)
+    {
+        for (Uint32 v = 0; v < m_NumVariables; ++v)
+            m_pVariables[v].~ShaderVariableVkImpl();
+        m_pVariables = nullptr;
+    }
+}
+
 ShaderVariableVkImpl* ShaderVariableManagerVk::GetVariable(const Char* Name)
 {
     ShaderVariableVkImpl* pVar = nullptr;
@@ -35,6 +35,7 @@
 #include "GLSLUtils.hpp"
 #include "DXCompiler.hpp"
 #include "ShaderToolsCommon.hpp"
+#include "SPIRVUtils.hpp"
 
 #if !DILIGENT_NO_GLSLANG
 #    include "GLSLangUtils.hpp"
@@ -143,9 +144,17 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
     else if (ShaderCI.ByteCode != nullptr)
     {
         DEV_CHECK_ERR(ShaderCI.ByteCodeSize != 0, "ByteCodeSize must not be 0");
-        DEV_CHECK_ERR(ShaderCI.ByteCodeSize % 4 == 0, "Byte code size (", ShaderCI.ByteCodeSize, ") is not multiple of 4");
-        m_SPIRV.resize(ShaderCI.ByteCodeSize / 4);
-        memcpy(m_SPIRV.data(), ShaderCI.ByteCode, ShaderCI.ByteCodeSize);
+        if (IsCompressedSPIRV(ShaderCI.ByteCode, ShaderCI.ByteCodeSize))
+        {
+            if (!DecompressSPIRV(ShaderCI.ByteCode, ShaderCI.ByteCodeSize, m_SPIRV))
+                LOG_ERROR_AND_THROW("Failed to decompress SPIRV byte code of shader '", ShaderCI.Desc.Name, '\'');
+        }
+        else
+        {
+            DEV_CHECK_ERR(ShaderCI.ByteCodeSize % 4 == 0, "Byte code size (", ShaderCI.ByteCodeSize, ") is not multiple of 4");
+            m_SPIRV.resize(ShaderCI.ByteCodeSize / 4);
+            memcpy(m_SPIRV.data(), ShaderCI.ByteCode, ShaderCI.ByteCodeSize);
+        }
     }
     else
     {
@@ -156,19 +165,55 @@ ShaderVkImpl::ShaderVkImpl(IReferenceCounters*     pRefCounters,
     // pipeline state is created
 
     // Load shader resources
-    auto& Allocator        = GetRawAllocator();
-    auto* pRawMem          = ALLOCATE(Allocator, "Allocator for ShaderResources", SPIRVShaderResources, 1);
-    auto  LoadShaderInputs = m_Desc.ShaderType == SHADER_TYPE_VERTEX;
-    auto* pResources       = new (pRawMem) SPIRVShaderResources //
+    auto&       Allocator             = GetRawAllocator();
+    auto*       pRawMem               = ALLOCATE(Allocator, "Allocator for ShaderResources", SPIRVShaderResources, 1);
+    auto        LoadShaderInputs      = m_Desc.ShaderType == SHADER_TYPE_VERTEX;
+    const auto* CombinedSamplerSuffix = ShaderCI.UseCombinedTextureSamplers ? ShaderCI.CombinedSamplerSuffix : nullptr;
+
+    // Shaders created from the same byte code restore the resources from the
+    // serialized data instead of reflecting the byte code again
+    auto&                 ReflectionCache = pRenderDeviceVk->GetShaderReflectionCache();
+    SPIRVShaderResources* pResources      = nullptr;
+    if (auto pSerializedData = ReflectionCache.Find(m_SPIRV, m_Desc.ShaderType, CombinedSamplerSuffix))
+    {
+        try
+        {
+            pResources = new (pRawMem) SPIRVShaderResources //
+                {
+                    Allocator,
+                    pSerializedData->data(),
+                    pSerializedData->size(),
+                    m_SPIRV,
+                    m_Desc,
+                    CombinedSamplerSuffix,
+                    m_EntryPoint //
+                };
+        }
+        catch (const std::runtime_error&)
         {
-            Allocator,
-            pRenderDeviceVk,
-            m_SPIRV,
-            m_Desc,
-            ShaderCI.UseCombinedTextureSamplers ? ShaderCI.CombinedSamplerSuffix : nullptr,
-            LoadShaderInputs,
-            m_EntryPoint //
-        };
+            m_EntryPoint.clear();
+            LOG_WARNING_MESSAGE("Failed to restore resources of shader '", m_Desc.Name, "' from the reflection cache. The byte code will be reflected again.");
+        }
+    }
+
+    if (pResources == nullptr)
+    {
+        pResources = new (pRawMem) SPIRVShaderResources //
+            {
+                Allocator,
+                pRenderDeviceVk,
+                m_SPIRV,
+                m_Desc,
+                CombinedSamplerSuffix,
+                LoadShaderInputs,
+                m_EntryPoint //
+            };
+
+        // Serialize the resources before the vertex shader inputs are remapped in the byte code
+        std::vector<Uint8> SerializedData;
+        pResources->Serialize(m_SPIRV, m_EntryPoint, SerializedData);
+        ReflectionCache.Add(m_SPIRV, m_Desc.ShaderType, CombinedSamplerSuffix, std::move(SerializedData));
+    }
     m_pShaderResources.reset(pResources, STDDeleterRawMem<SPIRVShaderResources>(Allocator));
 
     if (LoadShaderInputs && m_pShaderResources->IsHLSLSource())
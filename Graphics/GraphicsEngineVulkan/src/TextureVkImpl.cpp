@@ -59,6 +59,7 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
 
     const auto& FmtAttribs    = GetTextureFormatAttribs(m_Desc.Format);
     const auto& LogicalDevice = pRenderDeviceVk->GetLogicalDevice();
+    const bool  IsMemoryless  = (m_Desc.MiscFlags & MISC_TEXTURE_FLAG_MEMORYLESS) != 0;
 
     if (m_Desc.Usage == USAGE_STATIC || m_Desc.Usage == USAGE_DEFAULT || m_Desc.Usage == USAGE_DYNAMIC)
     {
@@ -143,6 +144,14 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
         {
             ImageCI.usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
         }
+        if (IsMemoryless)
+        {
+            // If usage includes VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, then bits other than
+            // VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            // and VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT must not be set (11.3)
+            ImageCI.usage &= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+            ImageCI.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        }
 
         if (m_Desc.MiscFlags & MISC_TEXTURE_FLAG_GENERATE_MIPS)
         {
@@ -179,6 +188,8 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
         ImageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
         bool bInitializeTexture = (pInitData != nullptr && pInitData->pSubResources != nullptr && pInitData->NumSubresources > 0);
+        if (bInitializeTexture && IsMemoryless)
+            LOG_ERROR_AND_THROW("Memoryless texture '", m_Desc.Name, "' can't be initialized with data");
 
         m_VulkanImage = LogicalDevice.CreateImage(ImageCI, m_Desc.Name);
 
@@ -190,6 +201,16 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
         else
             ImageMemoryFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
+        if (IsMemoryless)
+        {
+            // Lazily-allocated memory is typically only exposed by tiled GPUs that can keep
+            // transient attachments in the on-chip memory. Use regular device-local memory otherwise.
+            const auto LazyMemoryFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            if (pRenderDeviceVk->GetPhysicalDevice().GetMemoryTypeIndex(MemReqs.memoryTypeBits, LazyMemoryFlags) !=
+                VulkanUtilities::VulkanPhysicalDevice::InvalidMemoryTypeIndex)
+                ImageMemoryFlags = LazyMemoryFlags;
+        }
+
         VERIFY(IsPowerOfTwo(MemReqs.alignment), "Alignment is not power of 2!");
         m_MemoryAllocation = pRenderDeviceVk->AllocateMemory(MemReqs, ImageMemoryFlags);
         auto AlignedOffset = Align(m_MemoryAllocation.UnalignedOffset, MemReqs.alignment);
@@ -199,13 +220,17 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
         CHECK_VK_ERROR_AND_THROW(err, "Failed to bind image memory");
 
 
+        if (IsMemoryless)
+        {
+            // Transient attachments can't be used with transfer commands, so they are not cleared.
+            // Their contents are undefined until they are written within a render pass.
+            SetState(RESOURCE_STATE_UNDEFINED);
+            return;
+        }
+
         // Vulkan validation layers do not like uninitialized memory, so if no initial data
         // is provided, we will clear the memory
 
-        VulkanUtilities::CommandPoolWrapper CmdPool;
-        VkCommandBuffer                     vkCmdBuff;
-        pRenderDeviceVk->AllocateTransientCmdPool(CmdPool, vkCmdBuff, "Transient command pool to copy staging data to a device buffer");
-
         VkImageAspectFlags aspectMask = 0;
         if (FmtAttribs.ComponentType == COMPONENT_TYPE_DEPTH)
             aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -229,7 +254,6 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
         SubresRange.baseMipLevel         = 0;
         SubresRange.levelCount           = VK_REMAINING_MIP_LEVELS;
         auto EnabledGraphicsShaderStages = LogicalDevice.GetEnabledGraphicsShaderStages();
-        VulkanUtilities::VulkanCommandBuffer::TransitionImageLayout(vkCmdBuff, m_VulkanImage, ImageCI.initialLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, SubresRange, EnabledGraphicsShaderStages);
         SetState(RESOURCE_STATE_COPY_DEST);
         const auto CurrentLayout = GetLayout();
         VERIFY_EXPR(CurrentLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
@@ -248,13 +272,11 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
             {
                 for (Uint32 mip = 0; mip < ImageCI.mipLevels; ++mip)
                 {
-                    const auto& SubResData = pInitData->pSubResources[subres];
-                    (void)SubResData;
                     auto& CopyRegion = Regions[subres];
 
                     auto MipInfo = GetMipLevelProperties(m_Desc, mip);
 
-                    CopyRegion.bufferOffset = uploadBufferSize; // offset in bytes from the start of the buffer object
+                    CopyRegion.bufferOffset = uploadBufferSize; // offset in bytes from the start of the upload space
                     // bufferRowLength and bufferImageHeight specify the data in buffer memory as a subregion
                     // of a larger two- or three-dimensional image, and control the addressing calculations of
                     // data in buffer memory. If either of these values is zero, that aspect of the buffer memory
@@ -270,10 +292,6 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
                     CopyRegion.imageSubresource.baseArrayLayer = layer;
                     CopyRegion.imageSubresource.layerCount     = 1;
 
-                    VERIFY(SubResData.Stride == 0 || SubResData.Stride >= MipInfo.RowSize, "Stride is too small");
-                    // For compressed-block formats, MipInfo.RowSize is the size of one row of blocks
-                    VERIFY(SubResData.DepthStride == 0 || SubResData.DepthStride >= (MipInfo.StorageHeight / FmtAttribs.BlockHeight) * MipInfo.RowSize, "Depth stride is too small");
-
                     // bufferOffset must be a multiple of 4 (18.4)
                     // If the calling command's VkImage parameter is a compressed image, bufferOffset
                     // must be a multiple of the compressed texel block size in bytes (18.4). This
@@ -284,121 +302,108 @@ TextureVkImpl::TextureVkImpl(IReferenceCounters*        pRefCounters,
             }
             VERIFY_EXPR(subres == pInitData->NumSubresources);
 
-            VkBufferCreateInfo VkStagingBuffCI    = {};
-            VkStagingBuffCI.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            VkStagingBuffCI.pNext                 = nullptr;
-            VkStagingBuffCI.flags                 = 0;
-            VkStagingBuffCI.size                  = uploadBufferSize;
-            VkStagingBuffCI.usage                 = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-            VkStagingBuffCI.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
-            VkStagingBuffCI.queueFamilyIndexCount = 0;
-            VkStagingBuffCI.pQueueFamilyIndices   = nullptr;
-
-            std::string StagingBufferName = "Upload buffer for '";
-            StagingBufferName += m_Desc.Name;
-            StagingBufferName += '\'';
-            VulkanUtilities::BufferWrapper StagingBuffer = LogicalDevice.CreateBuffer(VkStagingBuffCI, StagingBufferName.c_str());
-
-            VkMemoryRequirements StagingBufferMemReqs = LogicalDevice.GetBufferMemoryRequirements(StagingBuffer);
-            VERIFY(IsPowerOfTwo(StagingBufferMemReqs.alignment), "Alignment is not power of 2!");
-            // VK_MEMORY_PROPERTY_HOST_COHERENT_BIT bit specifies that the host cache management commands vkFlushMappedMemoryRanges
-            // and vkInvalidateMappedMemoryRanges are NOT needed to flush host writes to the device or make device writes visible
-            // to the host (10.2)
-            auto StagingMemoryAllocation = pRenderDeviceVk->AllocateMemory(StagingBufferMemReqs, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-            auto StagingBufferMemory     = StagingMemoryAllocation.Page->GetVkMemory();
-            auto AlignedStagingMemOffset = Align(StagingMemoryAllocation.UnalignedOffset, StagingBufferMemReqs.alignment);
-            VERIFY_EXPR(StagingMemoryAllocation.Size >= StagingBufferMemReqs.size + (AlignedStagingMemOffset - StagingMemoryAllocation.UnalignedOffset));
-
-            auto* StagingData = reinterpret_cast<uint8_t*>(StagingMemoryAllocation.Page->GetCPUMemory());
-            VERIFY_EXPR(StagingData != nullptr);
-            StagingData += AlignedStagingMemOffset;
+            // The start of the upload space must satisfy the same requirements as bufferOffset, i.e. it
+            // must be a multiple of 4 and of the texel block size, which is not necessarily a power of two.
+            VkDeviceSize UploadAlignment = FmtAttribs.GetElementSize();
+            while (UploadAlignment % 4 != 0)
+                UploadAlignment *= 2;
 
-            subres = 0;
-            for (Uint32 layer = 0; layer < ImageCI.arrayLayers; ++layer)
-            {
-                for (Uint32 mip = 0; mip < ImageCI.mipLevels; ++mip)
+            m_UploadBatchId = pRenderDeviceVk->RecordResourceInitCommands(
+                uploadBufferSize, UploadAlignment,
+                [&](const RenderDeviceVkImpl::ResourceUploadSpace& UploadSpace) //
                 {
-                    const auto& SubResData = pInitData->pSubResources[subres];
-                    const auto& CopyRegion = Regions[subres];
-
-                    auto MipInfo = GetMipLevelProperties(m_Desc, mip);
-
-                    VERIFY_EXPR(MipInfo.LogicalWidth == CopyRegion.imageExtent.width);
-                    VERIFY_EXPR(MipInfo.LogicalHeight == CopyRegion.imageExtent.height);
-                    VERIFY_EXPR(MipInfo.Depth == CopyRegion.imageExtent.depth);
-
-                    VERIFY(SubResData.Stride == 0 || SubResData.Stride >= MipInfo.RowSize, "Stride is too small");
-                    // For compressed-block formats, MipInfo.RowSize is the size of one row of blocks
-                    VERIFY(SubResData.DepthStride == 0 || SubResData.DepthStride >= (MipInfo.StorageHeight / FmtAttribs.BlockHeight) * MipInfo.RowSize, "Depth stride is too small");
+                    auto* StagingData = UploadSpace.pCPUAddress;
+                    VERIFY_EXPR(StagingData != nullptr);
 
-                    for (Uint32 z = 0; z < MipInfo.Depth; ++z)
+                    subres = 0;
+                    for (Uint32 layer = 0; layer < ImageCI.arrayLayers; ++layer)
                     {
-                        for (Uint32 y = 0; y < MipInfo.StorageHeight; y += FmtAttribs.BlockHeight)
+                        for (Uint32 mip = 0; mip < ImageCI.mipLevels; ++mip)
                         {
-                            memcpy(StagingData + CopyRegion.bufferOffset + ((y + z * MipInfo.StorageHeight) / FmtAttribs.BlockHeight) * MipInfo.RowSize,
-                                   // SubResData.Stride must be the stride of one row of compressed blocks
-                                   reinterpret_cast<const uint8_t*>(SubResData.pData) + (y / FmtAttribs.BlockHeight) * SubResData.Stride + z * SubResData.DepthStride,
-                                   MipInfo.RowSize);
+                            const auto& SubResData = pInitData->pSubResources[subres];
+                            const auto& CopyRegion = Regions[subres];
+
+                            auto MipInfo = GetMipLevelProperties(m_Desc, mip);
+
+                            VERIFY_EXPR(MipInfo.LogicalWidth == CopyRegion.imageExtent.width);
+                            VERIFY_EXPR(MipInfo.LogicalHeight == CopyRegion.imageExtent.height);
+                            VERIFY_EXPR(MipInfo.Depth == CopyRegion.imageExtent.depth);
+
+                            VERIFY(SubResData.Stride == 0 || SubResData.Stride >= MipInfo.RowSize, "Stride is too small");
+                            // For compressed-block formats, MipInfo.RowSize is the size of one row of blocks
+                            VERIFY(SubResData.DepthStride == 0 || SubResData.DepthStride >= (MipInfo.StorageHeight / FmtAttribs.BlockHeight) * MipInfo.RowSize, "Depth stride is too small");
+
+                            for (Uint32 z = 0; z < MipInfo.Depth; ++z)
+                            {
+                                for (Uint32 y = 0; y < MipInfo.StorageHeight; y += FmtAttribs.BlockHeight)
+                                {
+                                    memcpy(StagingData + CopyRegion.bufferOffset + ((y + z * MipInfo.StorageHeight) / FmtAttribs.BlockHeight) * MipInfo.RowSize,
+                                           // SubResData.Stride must be the stride of one row of compressed blocks
+                                           reinterpret_cast<const uint8_t*>(SubResData.pData) + (y / FmtAttribs.BlockHeight) * SubResData.Stride + z * SubResData.DepthStride,
+                                           MipInfo.RowSize);
+                                }
+                            }
+
+                            ++subres;
                         }
                     }
-
-                    ++subres;
-                }
-            }
-            VERIFY_EXPR(subres == pInitData->NumSubresources);
-
-            err = LogicalDevice.BindBufferMemory(StagingBuffer, StagingBufferMemory, AlignedStagingMemOffset);
-            CHECK_VK_ERROR_AND_THROW(err, "Failed to bind staging bufer memory");
-
-            VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, StagingBuffer, 0, VK_ACCESS_TRANSFER_READ_BIT, EnabledGraphicsShaderStages);
-
-            // Copy commands MUST be recorded outside of a render pass instance. This is OK here
-            // as copy will be the only command in the cmd buffer
-            vkCmdCopyBufferToImage(vkCmdBuff, StagingBuffer, m_VulkanImage,
-                                   CurrentLayout, // dstImageLayout must be VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL or VK_IMAGE_LAYOUT_GENERAL (18.4)
-                                   static_cast<uint32_t>(Regions.size()), Regions.data());
-
-            Uint32 QueueIndex = 0;
-            pRenderDeviceVk->ExecuteAndDisposeTransientCmdBuff(QueueIndex, vkCmdBuff, std::move(CmdPool));
-
-            // After command buffer is submitted, safe-release resources. This strategy
-            // is little overconservative as the resources will be released after the first
-            // command buffer submitted through the immediate context will be completed
-            pRenderDeviceVk->SafeReleaseDeviceObject(std::move(StagingBuffer), Uint64{1} << Uint64{QueueIndex});
-            pRenderDeviceVk->SafeReleaseDeviceObject(std::move(StagingMemoryAllocation), Uint64{1} << Uint64{QueueIndex});
+                    VERIFY_EXPR(subres == pInitData->NumSubresources);
+                },
+                [&](VkCommandBuffer vkCmdBuff, const RenderDeviceVkImpl::ResourceUploadSpace& UploadSpace) //
+                {
+                    // Make the offsets relative to the start of the staging buffer
+                    for (auto& CopyRegion : Regions)
+                        CopyRegion.bufferOffset += UploadSpace.Offset;
+
+                    VulkanUtilities::VulkanCommandBuffer::TransitionImageLayout(vkCmdBuff, m_VulkanImage, ImageCI.initialLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, SubresRange, EnabledGraphicsShaderStages);
+                    VulkanUtilities::VulkanCommandBuffer::BufferMemoryBarrier(vkCmdBuff, UploadSpace.vkBuffer, 0, VK_ACCESS_TRANSFER_READ_BIT, EnabledGraphicsShaderStages);
+
+                    // Copy commands MUST be recorded outside of a render pass instance. This is OK here
+                    // as the command buffer only contains resource initialization commands
+                    vkCmdCopyBufferToImage(vkCmdBuff, UploadSpace.vkBuffer, m_VulkanImage,
+                                           CurrentLayout, // dstImageLayout must be VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL or VK_IMAGE_LAYOUT_GENERAL (18.4)
+                                           static_cast<uint32_t>(Regions.size()), Regions.data());
+                },
+                m_Desc.Name);
         }
         else
         {
-            VkImageSubresourceRange Subresource;
-            Subresource.aspectMask     = aspectMask;
-            Subresource.baseMipLevel   = 0;
-            Subresource.levelCount     = VK_REMAINING_MIP_LEVELS;
-            Subresource.baseArrayLayer = 0;
-            Subresource.layerCount     = VK_REMAINING_ARRAY_LAYERS;
-            if (aspectMask == VK_IMAGE_ASPECT_COLOR_BIT)
-            {
-                if (FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED)
+            m_UploadBatchId = pRenderDeviceVk->RecordResourceInitCommands(
+                0, 1, nullptr,
+                [&](VkCommandBuffer vkCmdBuff, const RenderDeviceVkImpl::ResourceUploadSpace&) //
                 {
-                    VkClearColorValue ClearColor = {};
-                    vkCmdClearColorImage(vkCmdBuff, m_VulkanImage,
-                                         CurrentLayout, // must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-                                         &ClearColor, 1, &Subresource);
-                }
-            }
-            else if (aspectMask == VK_IMAGE_ASPECT_DEPTH_BIT ||
-                     aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
-            {
-                VkClearDepthStencilValue ClearValue = {};
-                vkCmdClearDepthStencilImage(vkCmdBuff, m_VulkanImage,
-                                            CurrentLayout, // must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-                                            &ClearValue, 1, &Subresource);
-            }
-            else
-            {
-                UNEXPECTED("Unexpected aspect mask");
-            }
-            Uint32 QueueIndex = 0;
-            pRenderDeviceVk->ExecuteAndDisposeTransientCmdBuff(QueueIndex, vkCmdBuff, std::move(CmdPool));
+                    VulkanUtilities::VulkanCommandBuffer::TransitionImageLayout(vkCmdBuff, m_VulkanImage, ImageCI.initialLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, SubresRange, EnabledGraphicsShaderStages);
+
+                    VkImageSubresourceRange Subresource;
+                    Subresource.aspectMask     = aspectMask;
+                    Subresource.baseMipLevel   = 0;
+                    Subresource.levelCount     = VK_REMAINING_MIP_LEVELS;
+                    Subresource.baseArrayLayer = 0;
+                    Subresource.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+                    if (aspectMask == VK_IMAGE_ASPECT_COLOR_BIT)
+                    {
+                        if (FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED)
+                        {
+                            VkClearColorValue ClearColor = {};
+                            vkCmdClearColorImage(vkCmdBuff, m_VulkanImage,
+                                                 CurrentLayout, // must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                                 &ClearColor, 1, &Subresource);
+                        }
+                    }
+                    else if (aspectMask == VK_IMAGE_ASPECT_DEPTH_BIT ||
+                             aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+                    {
+                        VkClearDepthStencilValue ClearValue = {};
+                        vkCmdClearDepthStencilImage(vkCmdBuff, m_VulkanImage,
+                                                    CurrentLayout, // must be VK_IMAGE_LAYOUT_GENERAL or VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                                    &ClearValue, 1, &Subresource);
+                    }
+                    else
+                    {
+                        UNEXPECTED("Unexpected aspect mask");
+                    }
+                },
+                m_Desc.Name);
         }
     }
     else if (m_Desc.Usage == USAGE_STAGING)
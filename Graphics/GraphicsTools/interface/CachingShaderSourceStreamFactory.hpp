@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Shader source stream factory that caches file contents in memory
+
+#include "../../GraphicsEngine/interface/Shader.h"
+
+namespace Diligent
+{
+
+/// Caching shader source stream factory create info
+struct CachingShaderSourceStreamFactoryCreateInfo
+{
+    /// Semicolon-separated list of search directories, same as for
+    /// IEngineFactory::CreateDefaultShaderSourceStreamFactory().
+    const Char* SearchDirectories = nullptr;
+
+    /// Whether to check the modification time and size of cached files on every request and
+    /// reload the files that have changed. Disable when the sources are known to be immutable
+    /// to avoid the file system query.
+    bool CheckModificationTime = true;
+};
+
+/// Caching shader source stream factory statistics
+struct CachingShaderSourceStreamFactoryStats
+{
+    /// The total number of CreateInputStream() calls.
+    Uint64 NumRequests = 0;
+
+    /// The number of requests served from the cache.
+    Uint64 NumCacheHits = 0;
+
+    /// The number of times a file was read from disk.
+    Uint64 NumFileLoads = 0;
+
+    /// The number of cached files that were reloaded because their modification time or size changed.
+    Uint64 NumInvalidations = 0;
+
+    /// The number of requests whose path was resolved without probing search directories.
+    Uint64 NumPathResolutionHits = 0;
+
+    /// The number of requests for files that were not found.
+    Uint64 NumFailures = 0;
+
+    /// The total size of the cached file contents, in bytes.
+    size_t CachedBytes = 0;
+};
+
+/// Shader source stream factory that reads every file only once.
+
+/// The factory resolves file names against the search directories like the default
+/// factory, but memoizes the resolved paths and keeps the contents of every file that
+/// has been read in memory. All streams created for the same file share one immutable
+/// data blob, so common headers included by many shaders are only read from disk once.
+/// The factory is thread-safe.
+class ICachingShaderSourceStreamFactory : public IShaderSourceInputStreamFactory
+{
+public:
+    /// Returns the cache statistics
+    virtual CachingShaderSourceStreamFactoryStats GetStatistics() = 0;
+
+    /// Removes all files and resolved paths from the cache
+    virtual void ClearCache() = 0;
+};
+
+void CreateCachingShaderSourceStreamFactory(const CachingShaderSourceStreamFactoryCreateInfo& CreateInfo,
+                                            ICachingShaderSourceStreamFactory**               ppFactory);
+
+} // namespace Diligent
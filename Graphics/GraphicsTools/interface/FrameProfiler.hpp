@@ -0,0 +1,250 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Hierarchical CPU/GPU frame profiler
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <ostream>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/DeviceContext.h"
+#include "../../GraphicsEngine/interface/Query.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "../../../Common/interface/HashUtils.hpp"
+#include "../../../Common/interface/Timer.hpp"
+
+namespace Diligent
+{
+
+/// Frame profiler create info
+struct FrameProfilerCreateInfo
+{
+    /// The number of frames whose GPU timestamps may be in flight at the same time.
+    /// When all frame slots are occupied, BeginFrame() waits for the oldest frame to complete.
+    Uint32 NumFramesInFlight = 4;
+
+    /// The maximum number of markers, including the frame marker itself, that record
+    /// GPU timestamps in one frame. Markers above this limit only record CPU time.
+    Uint32 MaxMarkersPerFrame = 256;
+
+    /// The maximum number of resolved frames kept in the history.
+    /// When the limit is reached, the oldest frames are discarded. 0 means no limit.
+    Uint32 MaxRecordedFrames = 600;
+
+    /// Whether to record GPU timestamps. GPU timestamps are only recorded when
+    /// the device supports timestamp queries.
+    bool EnableGPUTimestamps = true;
+};
+
+
+/// Hierarchical CPU/GPU frame profiler.
+
+/// The profiler records nested named markers. Every marker records CPU begin/end times as well as
+/// GPU begin/end timestamps. GPU timestamp queries are pre-allocated for every frame slot and are
+/// resolved in bulk once all GPU work of the frame has completed.
+/// Resolved frames can be written to a Chrome trace JSON file that can be opened with
+/// chrome://tracing or https://ui.perfetto.dev.
+///
+/// \remarks    The profiler is not thread-safe and must only be used with the immediate context.
+class FrameProfiler
+{
+public:
+    FrameProfiler(IRenderDevice* pDevice, const FrameProfilerCreateInfo& CreateInfo);
+    ~FrameProfiler();
+
+    // clang-format off
+    FrameProfiler           (const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    FrameProfiler           (FrameProfiler&&)      = delete;
+    FrameProfiler& operator=(FrameProfiler&&)      = delete;
+    // clang-format on
+
+    /// Begins a new frame and resolves all previous frames whose GPU data is available.
+
+    /// \param [in] pCtx - Immediate device context. May be null if GPU timestamps are disabled.
+    void BeginFrame(IDeviceContext* pCtx);
+
+    /// Ends the current frame. All markers must be closed at this point.
+    void EndFrame(IDeviceContext* pCtx);
+
+    /// Begins a named marker. Markers may be nested.
+
+    /// \param [in] pCtx - Device context to record the GPU timestamp.
+    /// \param [in] Name - Marker name. The string is copied, so it does not need to outlive the call.
+    void BeginMarker(IDeviceContext* pCtx, const Char* Name);
+
+    /// Ends the innermost open marker.
+    void EndMarker(IDeviceContext* pCtx);
+
+    /// Waits for all frames in flight to complete and resolves them.
+    void Flush(IDeviceContext* pCtx);
+
+    /// RAII helper that begins a marker in the constructor and ends it in the destructor.
+    class ScopedMarker
+    {
+    public:
+        ScopedMarker(FrameProfiler& Profiler, IDeviceContext* pCtx, const Char* Name) :
+            m_Profiler{Profiler},
+            m_pCtx{pCtx}
+        {
+            m_Profiler.BeginMarker(m_pCtx, Name);
+        }
+
+        ~ScopedMarker()
+        {
+            m_Profiler.EndMarker(m_pCtx);
+        }
+
+        // clang-format off
+        ScopedMarker           (const ScopedMarker&) = delete;
+        ScopedMarker& operator=(const ScopedMarker&) = delete;
+        ScopedMarker           (ScopedMarker&&)      = delete;
+        ScopedMarker& operator=(ScopedMarker&&)      = delete;
+        // clang-format on
+
+    private:
+        FrameProfiler&        m_Profiler;
+        IDeviceContext* const m_pCtx;
+    };
+
+    /// Resolved marker data. All times are in seconds relative to the profiler creation.
+    struct MarkerData
+    {
+        const Char* Name   = nullptr;
+        Uint32      Parent = ~Uint32{0}; ///< Index of the parent marker in the frame, or ~0 for the frame marker
+        Uint32      Depth  = 0;
+
+        double CPUBegin = 0;
+        double CPUEnd   = 0;
+
+        /// GPU times are aligned such that the frame's first GPU timestamp
+        /// coincides with the CPU frame begin time.
+        double GPUBegin = 0;
+        double GPUEnd   = 0;
+
+        /// Whether GPUBegin and GPUEnd contain valid data.
+        bool HasGPUData = false;
+    };
+
+    /// Resolved frame data. The first marker is the frame itself.
+    struct FrameData
+    {
+        Uint64                  FrameNumber = 0;
+        std::vector<MarkerData> Markers;
+    };
+
+    struct Statistics
+    {
+        /// The number of frames that have been resolved.
+        Uint64 NumResolvedFrames = 0;
+
+        /// The number of times BeginFrame() had to wait for the GPU.
+        Uint64 NumGPUStalls = 0;
+
+        /// The number of markers that did not record GPU timestamps because
+        /// MaxMarkersPerFrame limit was exceeded.
+        Uint64 NumMarkersWithoutGPUData = 0;
+    };
+
+    const std::deque<FrameData>& GetResolvedFrames() const { return m_ResolvedFrames; }
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+    bool IsGPUTimingEnabled() const { return m_GPUTimingEnabled; }
+
+    /// Discards all resolved frames.
+    void ClearResolvedFrames() { m_ResolvedFrames.clear(); }
+
+    /// Writes resolved frames in Chrome trace event format.
+    void WriteChromeTrace(std::ostream& Stream) const;
+
+    /// Writes resolved frames in Chrome trace event format to the file.
+    bool WriteChromeTrace(const Char* FilePath) const;
+
+private:
+    static constexpr Uint32 InvalidIndex = ~Uint32{0};
+
+    struct MarkerRecord
+    {
+        Uint32 NameId      = 0;
+        Uint32 Parent      = InvalidIndex;
+        Uint32 Depth       = 0;
+        Uint32 GPUQueryIdx = InvalidIndex; // Begin timestamp index, end timestamp index is GPUQueryIdx + 1
+
+        double CPUBegin = 0;
+        double CPUEnd   = 0;
+    };
+
+    struct FrameSlot
+    {
+        Uint64                             FrameNumber = 0;
+        std::vector<MarkerRecord>          Markers;
+        std::vector<RefCntAutoPtr<IQuery>> Timestamps;
+        std::vector<IQuery*>               TimestampPtrs; // Raw pointers to Timestamps for bulk data reads
+        Uint32                             NumUsedTimestamps = 0;
+    };
+
+    Uint32 GetNameId(const Char* Name);
+    Uint32 AllocateTimestampPair();
+    void   EndTimestamp(IDeviceContext* pCtx, Uint32 QueryIdx);
+    bool   ReadTimestamps(IDeviceContext* pCtx, FrameSlot& Slot, QueryDataTimestamp* pTimestamps);
+    bool   TryResolveFrame(IDeviceContext* pCtx, FrameSlot& Slot, bool Wait);
+    void   ResolveCompletedFrames(IDeviceContext* pCtx, bool WaitForAll);
+
+    const FrameProfilerCreateInfo m_CreateInfo;
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    bool m_GPUTimingEnabled = false;
+
+    Timer m_Timer;
+
+    // Frame slots in the order they were submitted; the front slot is the oldest frame in flight
+    std::deque<FrameSlot>  m_FramesInFlight;
+    std::vector<FrameSlot> m_AvailableSlots;
+
+    FrameSlot* m_pCurrentFrame = nullptr;
+    Uint64     m_FrameCounter  = 0;
+
+    // Indices of the currently open markers in m_pCurrentFrame->Markers
+    std::vector<Uint32> m_MarkerStack;
+
+    // Marker names are interned so that repeated markers do not allocate memory
+    std::unordered_map<HashMapStringKey, Uint32, HashMapStringKey::Hasher> m_NameToId;
+    std::vector<const Char*>                                               m_Names;
+
+    std::deque<FrameData> m_ResolvedFrames;
+
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
@@ -0,0 +1,125 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Helper that records commands on a pool of deferred contexts in parallel
+
+#include <vector>
+#include <functional>
+
+#include "../../GraphicsEngine/interface/DeviceContext.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "../../../Common/interface/WorkerThreadPool.hpp"
+
+namespace Diligent
+{
+
+/// Parallel command recorder create info
+struct ParallelCommandRecorderCreateInfo
+{
+    /// Deferred contexts to record commands with. Typically these are
+    /// the contexts created through EngineCreateInfo::NumDeferredContexts.
+    IDeviceContext* const* ppDeferredContexts = nullptr;
+
+    /// The number of contexts in ppDeferredContexts.
+    Uint32 NumDeferredContexts = 0;
+
+    /// The minimum number of items recorded by one context. Ranges smaller than
+    /// NumDeferredContexts * MinItemsPerContext are split between fewer contexts.
+    Uint32 MinItemsPerContext = 1;
+};
+
+
+/// Records a range of items on a pool of deferred contexts using worker threads.
+
+/// The recorder owns a worker thread pool with one thread per deferred context except the first one,
+/// as the calling thread records too. Record() splits the item range into contiguous sub-ranges,
+/// records every sub-range on its own context, and executes the resulting command lists
+/// on the immediate context in the order of the sub-ranges, so the result is equivalent to
+/// recording all items sequentially.
+///
+/// \remarks    The callback is invoked concurrently from multiple threads and must only
+///             use the context it is given. Every sub-range starts with an invalidated context
+///             state, so the callback must set all states it relies on.
+///             The recorder is not thread-safe: Record() and FinishFrame() must be called
+///             from the same thread.
+class ParallelCommandRecorder
+{
+public:
+    /// Callback that records items [FirstItem, FirstItem + NumItems) using the given context.
+    using RecordCallbackType = std::function<void(IDeviceContext* pContext, Uint32 FirstItem, Uint32 NumItems)>;
+
+    ParallelCommandRecorder(const ParallelCommandRecorderCreateInfo& CreateInfo);
+
+    // clang-format off
+    ParallelCommandRecorder           (const ParallelCommandRecorder&) = delete;
+    ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+    ParallelCommandRecorder           (ParallelCommandRecorder&&)      = delete;
+    ParallelCommandRecorder& operator=(ParallelCommandRecorder&&)      = delete;
+    // clang-format on
+
+    /// Records NumItems items in parallel and executes the command lists.
+
+    /// \param [in] pImmediateCtx - Immediate context that executes the command lists.
+    /// \param [in] NumItems      - The number of items to record.
+    /// \param [in] Callback      - Callback that records a sub-range of items.
+    void Record(IDeviceContext* pImmediateCtx, Uint32 NumItems, const RecordCallbackType& Callback);
+
+    /// Calls IDeviceContext::FinishFrame() for all deferred contexts of the pool.
+    /// Must be called at the end of every frame in which Record() was called.
+    void FinishFrame();
+
+    Uint32 GetNumContexts() const { return static_cast<Uint32>(m_Contexts.size()); }
+
+    struct Statistics
+    {
+        /// The number of command lists executed by the last call to Record().
+        Uint32 NumCommandLists = 0;
+
+        /// The total number of command lists executed since the recorder was created.
+        Uint64 TotalCommandLists = 0;
+    };
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+private:
+    void RecordSubRange(Uint32 ContextIndex, Uint32 NumSubRanges, Uint32 NumItems, const RecordCallbackType& Callback);
+
+    const Uint32 m_MinItemsPerContext;
+
+    std::vector<RefCntAutoPtr<IDeviceContext>> m_Contexts;
+    std::vector<RefCntAutoPtr<ICommandList>>   m_CommandLists;
+
+    // Task index is the index of the context that records the sub-range
+    WorkerThreadPool m_RecordingPool;
+
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
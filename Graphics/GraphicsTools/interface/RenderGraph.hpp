@@ -0,0 +1,334 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Render graph that schedules passes, resource transitions and transient resources
+
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/DeviceContext.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "../../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+class WorkerThreadPool;
+
+/// Render graph create info
+struct RenderGraphCreateInfo
+{
+    /// The number of frames a pooled transient resource may stay unused before it is released.
+    Uint32 MaxUnusedFrames = 4;
+};
+
+
+/// Frame-level render graph.
+
+/// Every frame, the application adds passes to the graph. Each pass declares the resources it reads
+/// and writes together with the required resource states and provides a callback that records its commands.
+/// When the graph is executed, it
+///   - culls passes whose results are never used,
+///   - computes the minimal set of state transitions and issues them in one batch before every pass,
+///   - allocates transient textures and buffers from a pool and reuses the same object for resources
+///     whose lifetimes do not overlap,
+///   - optionally records passes on multiple deferred contexts in parallel.
+///
+/// Typical usage:
+///
+///     Graph.Reset();
+///     auto Color = Graph.ImportTexture(pBackBuffer, RESOURCE_STATE_PRESENT);
+///     RenderGraph::ResourceId GBuffer;
+///     Graph.AddPass("GBuffer",
+///         [&](RenderGraph::PassBuilder& Builder) {
+///             GBuffer = Builder.CreateTexture("GBuffer", GBufferDesc);
+///             Builder.Write(GBuffer, RESOURCE_STATE_RENDER_TARGET);
+///         },
+///         [=](const RenderGraph::PassContext& Ctx) { ... });
+///     Graph.AddPass("Lighting",
+///         [&](RenderGraph::PassBuilder& Builder) {
+///             Builder.Read(GBuffer, RESOURCE_STATE_SHADER_RESOURCE);
+///             Builder.Write(Color, RESOURCE_STATE_RENDER_TARGET);
+///         },
+///         [=](const RenderGraph::PassContext& Ctx) { ... });
+///     Graph.Execute(pImmediateCtx);
+///
+/// \remarks    Pass callbacks must not transition graph resources themselves and should use
+///             RESOURCE_STATE_TRANSITION_MODE_NONE for them. When passes are recorded on deferred contexts,
+///             the states of graph resources are only updated after all command lists have been executed.
+///             The graph is not thread-safe: all methods must be called from the same thread.
+class RenderGraph
+{
+public:
+    using ResourceId = Uint32;
+
+    static constexpr ResourceId InvalidResourceId = ~Uint32{0};
+
+    /// Declares resources used by a pass. Passed to the setup callback of AddPass().
+    class PassBuilder
+    {
+    public:
+        /// Creates a transient texture whose lifetime is managed by the graph.
+        /// The contents of the texture are undefined until the texture is first written.
+        ResourceId CreateTexture(const Char* Name, const TextureDesc& Desc);
+
+        /// Creates a transient buffer whose lifetime is managed by the graph.
+        ResourceId CreateBuffer(const Char* Name, const BufferDesc& Desc);
+
+        /// Declares that the pass reads the resource in the given state. Multiple reads of the same
+        /// resource in one pass are combined.
+        void Read(ResourceId Id, RESOURCE_STATE State);
+
+        /// Declares that the pass writes the resource in the given state.
+        void Write(ResourceId Id, RESOURCE_STATE State);
+
+        /// Marks the pass as having side effects that are not expressed through its writes
+        /// (e.g. reading back data). Such passes are never culled.
+        void SetSideEffects();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& Graph, Uint32 PassIndex) :
+            m_Graph{Graph},
+            m_PassIndex{PassIndex}
+        {}
+
+        void AddAccess(ResourceId Id, RESOURCE_STATE State, bool IsWrite);
+
+        RenderGraph& m_Graph;
+        const Uint32 m_PassIndex;
+    };
+
+    /// Provides the pass callback with the device context and the objects that back graph resources.
+    class PassContext
+    {
+    public:
+        IDeviceContext* GetDeviceContext() const { return m_pContext; }
+
+        ITexture* GetTexture(ResourceId Id) const { return m_Graph.GetTexture(Id); }
+        IBuffer*  GetBuffer(ResourceId Id) const { return m_Graph.GetBuffer(Id); }
+
+    private:
+        friend class RenderGraph;
+        PassContext(const RenderGraph& Graph, IDeviceContext* pContext) :
+            m_Graph{Graph},
+            m_pContext{pContext}
+        {}
+
+        const RenderGraph&    m_Graph;
+        IDeviceContext* const m_pContext;
+    };
+
+    using SetupCallbackType   = std::function<void(PassBuilder&)>;
+    using ExecuteCallbackType = std::function<void(const PassContext&)>;
+
+    RenderGraph(IRenderDevice* pDevice, const RenderGraphCreateInfo& CreateInfo = RenderGraphCreateInfo{});
+
+    // clang-format off
+    RenderGraph           (const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+    RenderGraph           (RenderGraph&&)      = delete;
+    RenderGraph& operator=(RenderGraph&&)      = delete;
+    // clang-format on
+
+    ~RenderGraph();
+
+    /// Imports an external texture into the graph.
+
+    /// \param [in] pTexture   - Texture to import. The texture must be in a known state.
+    /// \param [in] FinalState - State the texture must be transitioned to after all passes
+    ///                          are executed, or RESOURCE_STATE_UNKNOWN to leave it in the
+    ///                          state required by the last pass that uses it.
+    ///
+    /// \remarks    Passes that write imported resources are never culled.
+    ResourceId ImportTexture(ITexture* pTexture, RESOURCE_STATE FinalState = RESOURCE_STATE_UNKNOWN);
+
+    /// Imports an external buffer into the graph, see ImportTexture().
+    ResourceId ImportBuffer(IBuffer* pBuffer, RESOURCE_STATE FinalState = RESOURCE_STATE_UNKNOWN);
+
+    /// Adds a pass to the graph. Passes are executed in the order they are added.
+
+    /// \param [in] Name    - Pass name. The string is copied.
+    /// \param [in] Setup   - Callback that declares the resources used by the pass. It is called immediately.
+    /// \param [in] Execute - Callback that records the pass commands. It is called by Execute() and
+    ///                       may be invoked from a worker thread when deferred contexts are used.
+    void AddPass(const Char* Name, const SetupCallbackType& Setup, ExecuteCallbackType Execute);
+
+    /// Culls unused passes, allocates transient resources and computes state transitions.
+    /// Execute() compiles the graph automatically if it has not been compiled.
+    void Compile();
+
+    /// Records all passes that have not been culled.
+
+    /// \param [in] pImmediateCtx   - Immediate device context.
+    /// \param [in] ppDeferredCtxs  - Optional array of deferred contexts. If provided, passes are split into
+    ///                               contiguous groups that are recorded in parallel, one group per context,
+    ///                               and the resulting command lists are executed in order by the immediate context.
+    ///                               The worker threads that record the groups are created by the first call
+    ///                               and are reused by subsequent calls.
+    ///                               The application remains responsible for calling FinishFrame() for deferred contexts.
+    /// \param [in] NumDeferredCtxs - The number of deferred contexts in ppDeferredCtxs.
+    void Execute(IDeviceContext* pImmediateCtx, IDeviceContext* const* ppDeferredCtxs = nullptr, Uint32 NumDeferredCtxs = 0);
+
+    /// Removes all passes and resources. Pooled transient objects are kept for the next frames.
+    /// Must be called at the beginning of every frame.
+    void Reset();
+
+    struct Statistics
+    {
+        /// The number of passes added to the graph in the current frame.
+        Uint32 NumPasses = 0;
+
+        /// The number of passes that were culled in the current frame.
+        Uint32 NumCulledPasses = 0;
+
+        /// The number of transient resources declared in the current frame.
+        Uint32 NumTransientResources = 0;
+
+        /// The number of pooled objects that back transient resources in the current frame.
+        /// The difference from NumTransientResources is the number of aliased resources.
+        Uint32 NumPhysicalResources = 0;
+
+        /// The number of state transitions issued in the current frame.
+        Uint32 NumTransitions = 0;
+
+        /// The total number of objects created by the graph since its creation.
+        Uint64 TotalObjectsCreated = 0;
+    };
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+    /// Returns true if the pass has been culled by Compile().
+    bool IsPassCulled(Uint32 PassIndex) const;
+
+    /// Returns the transitions that are issued before the pass is recorded. Valid after Compile().
+    const std::vector<StateTransitionDesc>& GetPassTransitions(Uint32 PassIndex) const;
+
+    /// Returns the transitions of imported resources to their final states. Valid after Compile().
+    const std::vector<StateTransitionDesc>& GetFinalTransitions() const { return m_FinalTransitions; }
+
+    /// Returns the texture that backs the resource, or null if the resource is not used
+    /// by any pass that has not been culled. Valid after Compile().
+    ITexture* GetTexture(ResourceId Id) const;
+
+    /// Returns the buffer that backs the resource, see GetTexture().
+    IBuffer* GetBuffer(ResourceId Id) const;
+
+private:
+    static constexpr Uint32 InvalidIndex = ~Uint32{0};
+
+    struct ResourceAccess
+    {
+        ResourceId     Id      = InvalidResourceId;
+        RESOURCE_STATE State   = RESOURCE_STATE_UNKNOWN;
+        bool           IsRead  = false;
+        bool           IsWrite = false;
+    };
+
+    struct Pass
+    {
+        String                           Name;
+        ExecuteCallbackType              Execute;
+        std::vector<ResourceAccess>      Accesses;
+        std::vector<StateTransitionDesc> Transitions;
+        bool                             HasSideEffects = false;
+        bool                             IsCulled       = false;
+    };
+
+    struct Resource
+    {
+        String      Name;
+        bool        IsTexture  = true;
+        bool        IsImported = false;
+        TextureDesc TexDesc;
+        BufferDesc  BuffDesc;
+
+        // Index of the physical object that backs the resource
+        Uint32 PhysicalIndex = InvalidIndex;
+
+        // First and last non-culled passes that use the resource
+        Uint32 FirstPass = InvalidIndex;
+        Uint32 LastPass  = InvalidIndex;
+    };
+
+    struct PhysicalResource
+    {
+        RefCntAutoPtr<ITexture> pTexture;
+        RefCntAutoPtr<IBuffer>  pBuffer;
+
+        // State of the object after all transitions computed so far
+        RESOURCE_STATE State = RESOURCE_STATE_UNKNOWN;
+
+        // Whether the object has been accessed in the current frame
+        bool IsAccessed = false;
+
+        // Whether the last access in the current frame was a write
+        bool LastAccessIsWrite = false;
+
+        // State the object is transitioned to after the frame (imported objects only)
+        RESOURCE_STATE FinalState = RESOURCE_STATE_UNKNOWN;
+
+        // Last pass of the current frame that uses the object, or InvalidIndex if it is not used
+        Uint32 BusyUntilPass = InvalidIndex;
+
+        Uint64 LastUsedFrame = 0;
+        bool   IsImported    = false;
+    };
+
+    ResourceId AddResource(Resource&& Res);
+    Uint32     AcquirePhysicalResource(const Resource& Res);
+    void       CullPasses();
+    void       ComputeTransitions();
+    void       RecordPasses(IDeviceContext* pContext, const Uint32* pPassIndices, size_t NumPasses);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    const RenderGraphCreateInfo  m_CreateInfo;
+
+    std::vector<Pass>     m_Passes;
+    std::vector<Resource> m_Resources;
+
+    // Pooled transient objects and the objects imported in the current frame
+    std::vector<PhysicalResource> m_PhysicalResources;
+
+    // Transitions to the final states of imported resources
+    std::vector<StateTransitionDesc> m_FinalTransitions;
+
+    Uint64 m_FrameNumber = 0;
+    bool   m_IsCompiled  = false;
+
+    Statistics m_Stats;
+
+    // Threads that record pass groups on deferred contexts
+    std::unique_ptr<WorkerThreadPool> m_pRecordingPool;
+};
+
+} // namespace Diligent
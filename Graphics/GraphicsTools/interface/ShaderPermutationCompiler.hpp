@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Compiler of shader permutations that creates one shader per unique preprocessed source
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/Shader.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Creates shaders for a set of permutations of the same source that differ only by macros.
+
+/// The source and all files it includes are loaded and expanded once when the compiler is created.
+/// Every permutation is then reduced to the macros that are referenced by the expanded source, so
+/// permutations whose preprocessed text is identical (e.g. differ only by macros that the shader
+/// does not use, or by the order of macros) map to the same unique shader. Compile() creates one
+/// shader per unique permutation, and the permutation lookup table gives the shader for every
+/// permutation index.
+///
+/// Files that contain '#pragma once' are expanded only once. Other files are expanded every time
+/// they are included and are left to their include guards, if any. '#line' directives keep the line
+/// numbers of every file in compiler messages.
+///
+/// \remarks    Includes that are not found are left in the source and are resolved by the shader
+///             compiler through the source stream factory. In this case macros can't be
+///             reduced and every distinct macro set is compiled separately. The same is true
+///             if the source or a macro definition uses the token-pasting operator (##).
+///             A '#pragma once' file is not expanded again even if its first include is in a
+///             conditional block that the preprocessor skips, so such files must not be included
+///             in mutually exclusive branches of '#if'/'#else'.
+///             The compiler is not thread-safe.
+class ShaderPermutationCompiler
+{
+public:
+    /// \param [in] pDevice  - Render device that creates the shaders.
+    /// \param [in] ShaderCI - Base shader create info. The Macros member is ignored: the macros are
+    ///                        given for every permutation. All strings are copied, but the source
+    ///                        stream factory must stay alive until the last Compile() call.
+    ShaderPermutationCompiler(IRenderDevice* pDevice, const ShaderCreateInfo& ShaderCI);
+
+    // clang-format off
+    ShaderPermutationCompiler           (const ShaderPermutationCompiler&) = delete;
+    ShaderPermutationCompiler& operator=(const ShaderPermutationCompiler&) = delete;
+    ShaderPermutationCompiler           (ShaderPermutationCompiler&&)      = delete;
+    ShaderPermutationCompiler& operator=(ShaderPermutationCompiler&&)      = delete;
+    // clang-format on
+
+    /// Adds a permutation defined by a null-terminated array of macros and returns its index.
+    Uint32 AddPermutation(const ShaderMacro* Macros);
+
+    /// Creates shaders for all unique permutations that have not been compiled yet.
+    /// Returns false if any of the shaders failed to compile.
+    bool Compile();
+
+    /// Returns the shader of the permutation, or null if it has not been compiled or failed to compile.
+    IShader* GetShader(Uint32 PermutationIndex) const;
+
+    /// Returns the index of the unique shader that the permutation maps to.
+    Uint32 GetUniqueShaderIndex(Uint32 PermutationIndex) const;
+
+    /// Returns the unique shader, or null if it has not been compiled or failed to compile.
+    IShader* GetUniqueShader(Uint32 UniqueShaderIndex) const;
+
+    Uint32 GetNumPermutations() const { return static_cast<Uint32>(m_PermutationToUniqueShader.size()); }
+    Uint32 GetNumUniqueShaders() const { return static_cast<Uint32>(m_UniqueShaders.size()); }
+
+    /// Returns the source with all includes expanded.
+    const String& GetExpandedSource() const { return m_ExpandedSource; }
+
+    struct Statistics
+    {
+        /// The number of include directives that were expanded.
+        Uint32 NumExpandedIncludes = 0;
+
+        /// The number of include directives that could not be expanded.
+        Uint32 NumUnresolvedIncludes = 0;
+
+        /// The number of include directives that were skipped because the file has '#pragma once'
+        /// and had already been expanded, or because the file includes itself.
+        Uint32 NumRepeatedIncludes = 0;
+
+        /// The number of shaders created by Compile().
+        Uint32 NumCompiledShaders = 0;
+
+        /// The number of shaders that failed to compile.
+        Uint32 NumFailedShaders = 0;
+    };
+
+    const Statistics& GetStatistics() const { return m_Stats; }
+
+private:
+    void ExpandIncludes(const Char* Source, size_t Length, Uint32 Depth);
+
+    struct UniqueShader
+    {
+        // Reduced macros in the order of names
+        std::vector<std::pair<String, String>> Macros;
+
+        RefCntAutoPtr<IShader> pShader;
+
+        bool Compiled = false;
+    };
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    ShaderCreateInfo m_ShaderCI;
+    const String     m_Name;
+    const String     m_EntryPoint;
+    const String     m_CombinedSamplerSuffix;
+
+    String m_ExpandedSource;
+    bool   m_SourceLoaded = false;
+
+    // Files that contain '#pragma once' and have been expanded
+    std::unordered_set<String> m_PragmaOnceFiles;
+
+    // Files that are being expanded, from the outermost one
+    std::vector<String> m_IncludeStack;
+
+    // Identifiers that occur in the expanded source outside of comments and string literals
+    std::unordered_set<String> m_Identifiers;
+
+    // Whether the expanded source uses the token-pasting operator
+    bool m_HasTokenPasting = false;
+
+    // Reduced macro key -> unique shader index
+    std::unordered_map<String, Uint32> m_KeyToUniqueShader;
+
+    std::vector<UniqueShader> m_UniqueShaders;
+    std::vector<Uint32>       m_PermutationToUniqueShader;
+
+    Statistics m_Stats;
+};
+
+} // namespace Diligent
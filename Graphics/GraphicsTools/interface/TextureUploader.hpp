@@ -66,6 +66,28 @@ public:
 /// Texture uploader description.
 struct TextureUploaderDesc
 {
+    /// Size of one staging ring buffer, in bytes.
+
+    /// When non-zero, D3D12 and Vulkan uploaders sub-allocate upload buffers from
+    /// large persistently mapped staging buffers and copy the data to textures with
+    /// buffer-to-texture copies instead of creating a staging texture for every
+    /// unique upload buffer description. Upload buffers that do not fit into
+    /// one ring buffer still use staging textures.
+    ///
+    /// \remarks In ring buffer mode, the uploader must be released by the render thread.
+    Uint32 RingBufferSize = 0;
+
+    /// Maximum total size of the staging memory, in bytes. Zero means no limit.
+
+    /// In ring buffer mode, no new ring buffers are created once the budget is reached.
+    /// Worker threads then block in AllocateUploadBuffer() until the GPU releases enough
+    /// space, while the render thread waits for the GPU to complete pending copies.
+    ///
+    /// In OpenGL, the budget limits the total size of the pooled staging buffers. A staging
+    /// buffer returns to the pool once its copy is scheduled, so worker threads block until
+    /// the render thread schedules enough copies, while the render thread executes pending
+    /// copies first and exceeds the budget only if that does not release enough memory.
+    Uint64 StagingMemoryBudget = 0;
 };
 
 
@@ -73,6 +95,17 @@ struct TextureUploaderDesc
 struct TextureUploaderStats
 {
     Uint32 NumPendingOperations = 0;
+
+    /// Total size of the staging memory allocated by the uploader, in bytes.
+    Uint64 StagingMemorySize = 0;
+
+    /// Size of the staging memory used by upload buffers whose data
+    /// may not yet have been copied by the GPU, in bytes.
+    Uint64 StagingMemoryInUse = 0;
+
+    /// The number of allocations that had to wait for the GPU to
+    /// release staging memory because the budget was exhausted.
+    Uint32 NumStalledAllocations = 0;
 };
 
 /// Asynchronous texture uplader
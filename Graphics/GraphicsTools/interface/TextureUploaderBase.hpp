@@ -97,11 +97,13 @@ class TextureUploaderBase : public ObjectBase<ITextureUploader>
 public:
     TextureUploaderBase(IReferenceCounters* pRefCounters, IRenderDevice* pDevice, const TextureUploaderDesc Desc) :
         ObjectBase<ITextureUploader>{pRefCounters},
-        m_pDevice{pDevice}
+        m_pDevice{pDevice},
+        m_Desc{Desc}
     {}
 
 protected:
     RefCntAutoPtr<IRenderDevice> m_pDevice;
+    const TextureUploaderDesc    m_Desc;
 };
 
 } // namespace Diligent
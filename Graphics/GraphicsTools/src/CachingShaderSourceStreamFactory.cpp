@@ -0,0 +1,311 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "CachingShaderSourceStreamFactory.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "DataBlobImpl.hpp"
+#include "MemoryFileStream.hpp"
+#include "MappedFileDataBlob.hpp"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+class CachingShaderSourceStreamFactory final : public ObjectBase<ICachingShaderSourceStreamFactory>
+{
+public:
+    using TBase = ObjectBase<ICachingShaderSourceStreamFactory>;
+
+    CachingShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const CachingShaderSourceStreamFactoryCreateInfo& CreateInfo);
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_IShaderSourceInputStreamFactory, TBase)
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final;
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
+                                                       CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                       IFileStream**                           ppStream) override final;
+
+    virtual CachingShaderSourceStreamFactoryStats GetStatistics() override final;
+
+    virtual void ClearCache() override final;
+
+private:
+    // Modification time and size of the file, which identify its version
+    struct FileVersion
+    {
+        Uint64 ModificationTime = 0;
+        Uint64 Size             = 0;
+        bool   IsValid          = false;
+
+        bool operator==(const FileVersion& rhs) const
+        {
+            return ModificationTime == rhs.ModificationTime && Size == rhs.Size && IsValid == rhs.IsValid;
+        }
+    };
+
+    // File system queries below are made without holding the mutex
+    bool        ResolvePath(const Char* Name, String& FullPath) const;
+    FileVersion GetFileVersion(const String& FullPath) const;
+
+    RefCntAutoPtr<IDataBlob> LoadFile(const String& FullPath) const;
+
+    struct CachedFile
+    {
+        RefCntAutoPtr<IDataBlob> pData;
+        FileVersion              Version;
+    };
+
+    std::vector<String> m_SearchDirectories;
+    const bool          m_CheckModificationTime;
+
+    std::mutex m_Mtx;
+    // Shader source name -> full path of the file it resolved to
+    std::unordered_map<String, String> m_ResolvedPaths;
+    // Full path -> file contents
+    std::unordered_map<String, CachedFile> m_Files;
+
+    CachingShaderSourceStreamFactoryStats m_Stats;
+};
+
+CachingShaderSourceStreamFactory::CachingShaderSourceStreamFactory(IReferenceCounters* pRefCounters, const CachingShaderSourceStreamFactoryCreateInfo& CreateInfo) :
+    TBase{pRefCounters},
+    m_CheckModificationTime{CreateInfo.CheckModificationTime}
+{
+    const auto* SearchDirectories = CreateInfo.SearchDirectories;
+    while (SearchDirectories)
+    {
+        const char* Semicolon = strchr(SearchDirectories, ';');
+        String      SearchPath;
+        if (Semicolon == nullptr)
+        {
+            SearchPath        = SearchDirectories;
+            SearchDirectories = nullptr;
+        }
+        else
+        {
+            SearchPath        = String(SearchDirectories, Semicolon);
+            SearchDirectories = Semicolon + 1;
+        }
+
+        if (SearchPath.length() > 0)
+        {
+            if (SearchPath.back() != '\\' && SearchPath.back() != '/')
+                SearchPath.push_back(FileSystem::GetSlashSymbol());
+            m_SearchDirectories.push_back(SearchPath);
+        }
+    }
+    m_SearchDirectories.push_back("");
+}
+
+bool CachingShaderSourceStreamFactory::ResolvePath(const Char* Name, String& FullPath) const
+{
+    for (const auto& SearchDir : m_SearchDirectories)
+    {
+        FullPath = SearchDir + ((Name[0] == '\\' || Name[0] == '/') ? Name + 1 : Name);
+        FileSystem::CorrectSlashes(FullPath, FileSystem::GetSlashSymbol());
+        if (FileSystem::FileExists(FullPath.c_str()))
+            return true;
+    }
+    FullPath.clear();
+    return false;
+}
+
+CachingShaderSourceStreamFactory::FileVersion CachingShaderSourceStreamFactory::GetFileVersion(const String& FullPath) const
+{
+    FileVersion Version;
+    if (!m_CheckModificationTime)
+        return Version;
+
+    auto Path = FileSystem::GetFullPath(FullPath.c_str());
+    FileSystem::CorrectSlashes(Path, FileSystem::GetSlashSymbol());
+    Version.IsValid = FileSystem::GetFileModificationTime(Path.c_str(), Version.ModificationTime, Version.Size);
+    return Version;
+}
+
+RefCntAutoPtr<IDataBlob> CachingShaderSourceStreamFactory::LoadFile(const String& FullPath) const
+{
+    if (!m_CheckModificationTime)
+    {
+        // Files are not expected to change, so map them instead of copying the contents.
+        // When modification time is tracked, the file may be rewritten in place, which
+        // would invalidate the mapping, so the contents are always copied in that case.
+        auto pMappedData = MappedFileDataBlob::Create(FullPath.c_str(), EFileAccessPattern::Sequential);
+        return RefCntAutoPtr<IDataBlob>{pMappedData};
+    }
+
+    FileWrapper File{FullPath.c_str(), EFileAccessMode::Read};
+    if (!File)
+        return RefCntAutoPtr<IDataBlob>{};
+
+    RefCntAutoPtr<DataBlobImpl> pData{MakeNewRCObj<DataBlobImpl>()(0)};
+    File->Read(pData);
+    return RefCntAutoPtr<IDataBlob>{pData};
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream(const Char* Name, IFileStream** ppStream)
+{
+    CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+}
+
+void CachingShaderSourceStreamFactory::CreateInputStream2(const Char*                             Name,
+                                                          CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                          IFileStream**                           ppStream)
+{
+    DEV_CHECK_ERR(Name != nullptr, "Name must not be null");
+    DEV_CHECK_ERR(ppStream != nullptr, "ppStream must not be null");
+    *ppStream = nullptr;
+
+    String FullPath;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        ++m_Stats.NumRequests;
+
+        auto PathIt = m_ResolvedPaths.find(Name);
+        if (PathIt != m_ResolvedPaths.end())
+            FullPath = PathIt->second;
+    }
+
+    // The file system is only queried when the mutex is not held, so that requests for
+    // cached files are not serialized behind the file system calls of other threads.
+    FileVersion Version;
+    bool        IsPathResolutionHit = false;
+    if (!FullPath.empty())
+    {
+        Version = GetFileVersion(FullPath);
+        // If the file has been removed, the path must be resolved again
+        IsPathResolutionHit = !m_CheckModificationTime || Version.IsValid;
+    }
+
+    if (!IsPathResolutionHit)
+    {
+        if (!ResolvePath(Name, FullPath))
+        {
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                m_ResolvedPaths.erase(Name);
+                ++m_Stats.NumFailures;
+            }
+            if ((Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT) == 0)
+                LOG_ERROR("Failed to create input stream for source file ", Name);
+            return;
+        }
+        Version = GetFileVersion(FullPath);
+    }
+
+    RefCntAutoPtr<IDataBlob> pData;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (IsPathResolutionHit)
+            ++m_Stats.NumPathResolutionHits;
+        else
+            m_ResolvedPaths[Name] = FullPath;
+
+        auto FileIt = m_Files.find(FullPath);
+        if (FileIt != m_Files.end())
+        {
+            const auto& File = FileIt->second;
+            if (!m_CheckModificationTime || File.Version == Version)
+            {
+                ++m_Stats.NumCacheHits;
+                pData = File.pData;
+            }
+            else
+            {
+                ++m_Stats.NumInvalidations;
+                m_Stats.CachedBytes -= File.pData->GetSize();
+                m_Files.erase(FileIt);
+            }
+        }
+    }
+
+    if (!pData)
+    {
+        pData = LoadFile(FullPath);
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (!pData)
+        {
+            ++m_Stats.NumFailures;
+            if ((Flags & CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT) == 0)
+                LOG_ERROR("Failed to read source file ", FullPath);
+            return;
+        }
+
+        ++m_Stats.NumFileLoads;
+        // Another thread may have loaded the same file in the meantime, in which
+        // case the cached data is replaced with the latest version
+        auto& File = m_Files[FullPath];
+        if (File.pData)
+            m_Stats.CachedBytes -= File.pData->GetSize();
+        File.pData   = pData;
+        File.Version = Version;
+        m_Stats.CachedBytes += pData->GetSize();
+    }
+
+    // All streams share the same blob. Shader source streams are only read, so the blob is never modified.
+    RefCntAutoPtr<MemoryFileStream> pStream{MakeNewRCObj<MemoryFileStream>()(pData)};
+    pStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+}
+
+CachingShaderSourceStreamFactoryStats CachingShaderSourceStreamFactory::GetStatistics()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Stats;
+}
+
+void CachingShaderSourceStreamFactory::ClearCache()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_ResolvedPaths.clear();
+    m_Files.clear();
+    m_Stats.CachedBytes = 0;
+}
+
+} // namespace
+
+void CreateCachingShaderSourceStreamFactory(const CachingShaderSourceStreamFactoryCreateInfo& CreateInfo,
+                                            ICachingShaderSourceStreamFactory**               ppFactory)
+{
+    DEV_CHECK_ERR(ppFactory != nullptr, "ppFactory must not be null");
+    *ppFactory = MakeNewRCObj<CachingShaderSourceStreamFactory>()(CreateInfo);
+    (*ppFactory)->AddRef();
+}
+
+} // namespace Diligent
@@ -0,0 +1,456 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <sstream>
+#include <iomanip>
+
+#include "FileWrapper.hpp"
+
+#if VULKAN_SUPPORTED
+#    include "DeviceContextVk.h"
+#endif
+
+namespace Diligent
+{
+
+FrameProfiler::FrameProfiler(IRenderDevice* pDevice, const FrameProfilerCreateInfo& CreateInfo) :
+    m_CreateInfo{CreateInfo},
+    m_pDevice{pDevice}
+{
+    DEV_CHECK_ERR(m_CreateInfo.NumFramesInFlight > 0, "The number of frames in flight must not be zero");
+    DEV_CHECK_ERR(m_CreateInfo.MaxMarkersPerFrame > 0, "The maximum number of markers per frame must not be zero");
+
+    if (m_CreateInfo.EnableGPUTimestamps && m_pDevice)
+    {
+        m_GPUTimingEnabled = m_pDevice->GetDeviceCaps().Features.TimestampQueries != DEVICE_FEATURE_STATE_DISABLED;
+        if (!m_GPUTimingEnabled)
+            LOG_WARNING_MESSAGE("Timestamp queries are not supported by the device. Frame profiler will only record CPU times.");
+    }
+
+    m_AvailableSlots.resize(std::max(m_CreateInfo.NumFramesInFlight, 1u));
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    if (m_pCurrentFrame != nullptr)
+        LOG_WARNING_MESSAGE("Destroying frame profiler with an unfinished frame");
+}
+
+Uint32 FrameProfiler::GetNameId(const Char* Name)
+{
+    if (Name == nullptr)
+        Name = "<Unnamed>";
+
+    auto it = m_NameToId.find(Name);
+    if (it == m_NameToId.end())
+    {
+        auto Id = static_cast<Uint32>(m_Names.size());
+        it      = m_NameToId.emplace(HashMapStringKey{Name, true}, Id).first;
+        m_Names.push_back(it->first.GetStr());
+    }
+    return it->second;
+}
+
+Uint32 FrameProfiler::AllocateTimestampPair()
+{
+    VERIFY_EXPR(m_pCurrentFrame != nullptr);
+    auto& Slot = *m_pCurrentFrame;
+    if (!m_GPUTimingEnabled)
+        return InvalidIndex;
+
+    if (Slot.NumUsedTimestamps + 2 > m_CreateInfo.MaxMarkersPerFrame * 2)
+    {
+        ++m_Stats.NumMarkersWithoutGPUData;
+        return InvalidIndex;
+    }
+
+    const auto QueryIdx = Slot.NumUsedTimestamps;
+    while (Slot.Timestamps.size() < QueryIdx + 2)
+    {
+        QueryDesc Desc{QUERY_TYPE_TIMESTAMP};
+        Desc.Name = "Frame profiler timestamp query";
+        RefCntAutoPtr<IQuery> pQuery;
+        m_pDevice->CreateQuery(Desc, &pQuery);
+        if (!pQuery)
+        {
+            LOG_ERROR_MESSAGE("Failed to create timestamp query. GPU timing will be disabled.");
+            m_GPUTimingEnabled = false;
+            return InvalidIndex;
+        }
+        Slot.TimestampPtrs.push_back(pQuery);
+        Slot.Timestamps.emplace_back(std::move(pQuery));
+    }
+    Slot.NumUsedTimestamps += 2;
+    return QueryIdx;
+}
+
+void FrameProfiler::EndTimestamp(IDeviceContext* pCtx, Uint32 QueryIdx)
+{
+    if (QueryIdx == InvalidIndex)
+        return;
+
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null when GPU timing is enabled");
+    pCtx->EndQuery(m_pCurrentFrame->Timestamps[QueryIdx]);
+}
+
+void FrameProfiler::BeginFrame(IDeviceContext* pCtx)
+{
+    if (m_pCurrentFrame != nullptr)
+    {
+        LOG_ERROR_MESSAGE("BeginFrame() is called before the previous frame has been ended");
+        return;
+    }
+
+    ResolveCompletedFrames(pCtx, false);
+
+    if (m_AvailableSlots.empty())
+    {
+        // All slots are in flight - wait for the oldest frame
+        VERIFY_EXPR(!m_FramesInFlight.empty());
+        ++m_Stats.NumGPUStalls;
+        TryResolveFrame(pCtx, m_FramesInFlight.front(), true);
+        m_AvailableSlots.emplace_back(std::move(m_FramesInFlight.front()));
+        m_FramesInFlight.pop_front();
+    }
+
+    m_FramesInFlight.emplace_back(std::move(m_AvailableSlots.back()));
+    m_AvailableSlots.pop_back();
+
+    m_pCurrentFrame                    = &m_FramesInFlight.back();
+    m_pCurrentFrame->FrameNumber       = m_FrameCounter++;
+    m_pCurrentFrame->NumUsedTimestamps = 0;
+    m_pCurrentFrame->Markers.clear();
+    m_MarkerStack.clear();
+
+    MarkerRecord FrameMarker;
+    FrameMarker.NameId      = GetNameId("Frame");
+    FrameMarker.GPUQueryIdx = AllocateTimestampPair();
+    FrameMarker.CPUBegin    = m_Timer.GetElapsedTime();
+    m_pCurrentFrame->Markers.emplace_back(FrameMarker);
+    m_MarkerStack.push_back(0);
+
+    EndTimestamp(pCtx, FrameMarker.GPUQueryIdx);
+}
+
+void FrameProfiler::EndFrame(IDeviceContext* pCtx)
+{
+    if (m_pCurrentFrame == nullptr)
+    {
+        LOG_ERROR_MESSAGE("EndFrame() is called without matching BeginFrame()");
+        return;
+    }
+
+    if (m_MarkerStack.size() != 1)
+    {
+        LOG_ERROR_MESSAGE("Ending frame with ", m_MarkerStack.size() - 1, " open marker(s). Every BeginMarker() must be matched by EndMarker().");
+        while (m_MarkerStack.size() > 1)
+            EndMarker(pCtx);
+    }
+
+    auto& FrameMarker = m_pCurrentFrame->Markers[0];
+    if (FrameMarker.GPUQueryIdx != InvalidIndex)
+        EndTimestamp(pCtx, FrameMarker.GPUQueryIdx + 1);
+    FrameMarker.CPUEnd = m_Timer.GetElapsedTime();
+    m_MarkerStack.clear();
+    m_pCurrentFrame = nullptr;
+}
+
+void FrameProfiler::BeginMarker(IDeviceContext* pCtx, const Char* Name)
+{
+    if (m_pCurrentFrame == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Markers can only be recorded between BeginFrame() and EndFrame()");
+        return;
+    }
+
+    VERIFY_EXPR(!m_MarkerStack.empty());
+    auto& Markers = m_pCurrentFrame->Markers;
+
+    MarkerRecord Marker;
+    Marker.NameId      = GetNameId(Name);
+    Marker.Parent      = m_MarkerStack.back();
+    Marker.Depth       = static_cast<Uint32>(m_MarkerStack.size());
+    Marker.GPUQueryIdx = AllocateTimestampPair();
+    m_MarkerStack.push_back(static_cast<Uint32>(Markers.size()));
+
+    EndTimestamp(pCtx, Marker.GPUQueryIdx);
+    // Sample CPU time last to exclude the profiler overhead
+    Marker.CPUBegin = m_Timer.GetElapsedTime();
+    Markers.emplace_back(Marker);
+}
+
+void FrameProfiler::EndMarker(IDeviceContext* pCtx)
+{
+    if (m_pCurrentFrame == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Markers can only be recorded between BeginFrame() and EndFrame()");
+        return;
+    }
+
+    if (m_MarkerStack.size() <= 1)
+    {
+        LOG_ERROR_MESSAGE("There are no open markers, which likely indicates inconsistent BeginMarker()/EndMarker() calls");
+        return;
+    }
+
+    auto& Marker  = m_pCurrentFrame->Markers[m_MarkerStack.back()];
+    Marker.CPUEnd = m_Timer.GetElapsedTime();
+    if (Marker.GPUQueryIdx != InvalidIndex)
+        EndTimestamp(pCtx, Marker.GPUQueryIdx + 1);
+    m_MarkerStack.pop_back();
+}
+
+bool FrameProfiler::ReadTimestamps(IDeviceContext* pCtx, FrameSlot& Slot, QueryDataTimestamp* pTimestamps)
+{
+    VERIFY_EXPR(Slot.NumUsedTimestamps != 0);
+
+#if VULKAN_SUPPORTED
+    if (pCtx != nullptr)
+    {
+        RefCntAutoPtr<IDeviceContextVk> pCtxVk{pCtx, IID_DeviceContextVk};
+        if (pCtxVk)
+        {
+            // Read all timestamps of the frame with a single fence check
+            return pCtxVk->GetQueryData(Slot.NumUsedTimestamps, Slot.TimestampPtrs.data(), pTimestamps, sizeof(QueryDataTimestamp), true);
+        }
+    }
+#endif
+
+    // The frame end timestamp is the last query recorded in the frame.
+    // Once it is available, all other queries of the frame are available too.
+    auto& pFrameEndQuery = Slot.Timestamps[Slot.Markers[0].GPUQueryIdx + 1];
+    if (!pFrameEndQuery->GetData(nullptr, 0, false))
+        return false;
+
+    for (Uint32 i = 0; i < Slot.NumUsedTimestamps; ++i)
+    {
+        if (!Slot.Timestamps[i]->GetData(&pTimestamps[i], sizeof(pTimestamps[i]), true))
+        {
+            UNEXPECTED("Timestamp query data is not available while the frame end timestamp is");
+            pTimestamps[i].Frequency = 0;
+        }
+    }
+    return true;
+}
+
+bool FrameProfiler::TryResolveFrame(IDeviceContext* pCtx, FrameSlot& Slot, bool Wait)
+{
+    std::vector<QueryDataTimestamp> Timestamps(Slot.NumUsedTimestamps);
+    if (Slot.NumUsedTimestamps != 0)
+    {
+        bool Flushed = false;
+        while (!ReadTimestamps(pCtx, Slot, Timestamps.data()))
+        {
+            if (!Wait)
+                return false;
+
+            if (!Flushed)
+            {
+                // The frame's queries may still be pending in the context. Without
+                // the flush, they never reach the GPU and the wait never ends.
+                DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null when waiting for GPU timestamps");
+                if (pCtx != nullptr)
+                    pCtx->Flush();
+                Flushed = true;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    const auto& FrameMarker = Slot.Markers[0];
+
+    auto GetGPUTime = [&](Uint32 Idx, double& Time) //
+    {
+        const auto& Data = Timestamps[Idx];
+        if (Data.Frequency == 0)
+            return false;
+        Time = static_cast<double>(Data.Counter) / static_cast<double>(Data.Frequency);
+        return true;
+    };
+
+    // Align the GPU timeline with the CPU timeline at the beginning of the frame
+    double GPUFrameBegin  = 0;
+    bool   HasGPUBaseTime = FrameMarker.GPUQueryIdx != InvalidIndex && GetGPUTime(FrameMarker.GPUQueryIdx, GPUFrameBegin);
+    double GPUTimeOffset  = FrameMarker.CPUBegin - GPUFrameBegin;
+
+    FrameData Frame;
+    Frame.FrameNumber = Slot.FrameNumber;
+    Frame.Markers.resize(Slot.Markers.size());
+    for (size_t i = 0; i < Slot.Markers.size(); ++i)
+    {
+        const auto& Src = Slot.Markers[i];
+        auto&       Dst = Frame.Markers[i];
+
+        Dst.Name     = m_Names[Src.NameId];
+        Dst.Parent   = Src.Parent;
+        Dst.Depth    = Src.Depth;
+        Dst.CPUBegin = Src.CPUBegin;
+        Dst.CPUEnd   = Src.CPUEnd;
+        if (HasGPUBaseTime && Src.GPUQueryIdx != InvalidIndex &&
+            GetGPUTime(Src.GPUQueryIdx, Dst.GPUBegin) &&
+            GetGPUTime(Src.GPUQueryIdx + 1, Dst.GPUEnd))
+        {
+            Dst.GPUBegin += GPUTimeOffset;
+            Dst.GPUEnd += GPUTimeOffset;
+            Dst.HasGPUData = true;
+        }
+    }
+
+    m_ResolvedFrames.emplace_back(std::move(Frame));
+    if (m_CreateInfo.MaxRecordedFrames != 0)
+    {
+        while (m_ResolvedFrames.size() > m_CreateInfo.MaxRecordedFrames)
+            m_ResolvedFrames.pop_front();
+    }
+    ++m_Stats.NumResolvedFrames;
+
+    Slot.NumUsedTimestamps = 0;
+    return true;
+}
+
+void FrameProfiler::ResolveCompletedFrames(IDeviceContext* pCtx, bool WaitForAll)
+{
+    while (!m_FramesInFlight.empty())
+    {
+        auto& Slot = m_FramesInFlight.front();
+        if (&Slot == m_pCurrentFrame)
+            break;
+
+        // Frames complete in order, so stop at the first frame whose data is not yet available
+        if (!TryResolveFrame(pCtx, Slot, WaitForAll))
+            break;
+
+        m_AvailableSlots.emplace_back(std::move(Slot));
+        m_FramesInFlight.pop_front();
+    }
+}
+
+void FrameProfiler::Flush(IDeviceContext* pCtx)
+{
+    if (m_pCurrentFrame != nullptr)
+        LOG_WARNING_MESSAGE("Flushing frame profiler inside a frame. The current frame will not be resolved.");
+
+    ResolveCompletedFrames(pCtx, true);
+}
+
+namespace
+{
+
+void WriteJSONString(std::ostream& Stream, const Char* Str)
+{
+    Stream << '"';
+    for (const Char* c = Str; *c != 0; ++c)
+    {
+        switch (*c)
+        {
+            case '"': Stream << "\\\""; break;
+            case '\\': Stream << "\\\\"; break;
+            case '\n': Stream << "\\n"; break;
+            case '\r': Stream << "\\r"; break;
+            case '\t': Stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20)
+                    Stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*c) << std::dec << std::setfill(' ');
+                else
+                    Stream << *c;
+        }
+    }
+    Stream << '"';
+}
+
+void WriteCompleteEvent(std::ostream& Stream, bool& IsFirst, const Char* Name, const Char* Category, int ThreadId, double Begin, double End, Uint64 FrameNumber)
+{
+    Stream << (IsFirst ? "\n" : ",\n");
+    IsFirst = false;
+
+    // Chrome trace timestamps are in microseconds
+    Stream << "{\"name\":";
+    WriteJSONString(Stream, Name);
+    Stream << ",\"cat\":\"" << Category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ThreadId
+           << ",\"ts\":" << Begin * 1e+6 << ",\"dur\":" << std::max(End - Begin, 0.0) * 1e+6
+           << ",\"args\":{\"frame\":" << FrameNumber << "}}";
+}
+
+} // namespace
+
+void FrameProfiler::WriteChromeTrace(std::ostream& Stream) const
+{
+    static constexpr int CPUThreadId = 1;
+    static constexpr int GPUThreadId = 2;
+
+    const auto Flags     = Stream.flags();
+    const auto Precision = Stream.precision();
+    Stream << std::fixed << std::setprecision(3);
+
+    Stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    Stream << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << CPUThreadId << ",\"args\":{\"name\":\"CPU\"}}";
+    Stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPUThreadId << ",\"args\":{\"name\":\"GPU\"}}";
+
+    bool IsFirst = false;
+    for (const auto& Frame : m_ResolvedFrames)
+    {
+        for (const auto& Marker : Frame.Markers)
+        {
+            WriteCompleteEvent(Stream, IsFirst, Marker.Name, "CPU", CPUThreadId, Marker.CPUBegin, Marker.CPUEnd, Frame.FrameNumber);
+            if (Marker.HasGPUData)
+                WriteCompleteEvent(Stream, IsFirst, Marker.Name, "GPU", GPUThreadId, Marker.GPUBegin, Marker.GPUEnd, Frame.FrameNumber);
+        }
+    }
+    Stream << "\n]}\n";
+
+    Stream.flags(Flags);
+    Stream.precision(Precision);
+}
+
+bool FrameProfiler::WriteChromeTrace(const Char* FilePath) const
+{
+    std::stringstream ss;
+    WriteChromeTrace(ss);
+    const auto Trace = ss.str();
+
+    FileWrapper File{FilePath, EFileAccessMode::Overwrite};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open file '", FilePath, "' to write the frame profiler trace");
+        return false;
+    }
+
+    if (!File->Write(Trace.data(), Trace.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write the frame profiler trace to file '", FilePath, "'");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
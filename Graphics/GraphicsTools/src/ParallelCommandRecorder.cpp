@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "ParallelCommandRecorder.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+ParallelCommandRecorder::ParallelCommandRecorder(const ParallelCommandRecorderCreateInfo& CreateInfo) :
+    m_MinItemsPerContext{std::max(CreateInfo.MinItemsPerContext, 1u)},
+    // The first context is recorded by the thread that calls Record()
+    m_RecordingPool{CreateInfo.NumDeferredContexts > 1 ? CreateInfo.NumDeferredContexts - 1 : 0}
+{
+    DEV_CHECK_ERR(CreateInfo.NumDeferredContexts > 0, "At least one deferred context is required");
+    DEV_CHECK_ERR(CreateInfo.ppDeferredContexts != nullptr, "Deferred contexts must not be null");
+
+    m_Contexts.reserve(CreateInfo.NumDeferredContexts);
+    for (Uint32 i = 0; i < CreateInfo.NumDeferredContexts; ++i)
+    {
+        auto* pCtx = CreateInfo.ppDeferredContexts[i];
+        DEV_CHECK_ERR(pCtx != nullptr, "Deferred context ", i, " is null");
+        m_Contexts.emplace_back(pCtx);
+    }
+    m_CommandLists.resize(m_Contexts.size());
+}
+
+void ParallelCommandRecorder::RecordSubRange(Uint32 ContextIndex, Uint32 NumSubRanges, Uint32 NumItems, const RecordCallbackType& Callback)
+{
+    const auto FirstItem = static_cast<Uint32>(Uint64{NumItems} * ContextIndex / NumSubRanges);
+    const auto EndItem   = static_cast<Uint32>(Uint64{NumItems} * (ContextIndex + 1) / NumSubRanges);
+
+    auto* pCtx = m_Contexts[ContextIndex].RawPtr();
+    // Do not let the states set by the previous sub-range recorded on this context leak into this one
+    pCtx->InvalidateState();
+    Callback(pCtx, FirstItem, EndItem - FirstItem);
+    pCtx->FinishCommandList(&m_CommandLists[ContextIndex]);
+}
+
+void ParallelCommandRecorder::Record(IDeviceContext* pImmediateCtx, Uint32 NumItems, const RecordCallbackType& Callback)
+{
+    DEV_CHECK_ERR(pImmediateCtx != nullptr, "Immediate context must not be null");
+    DEV_CHECK_ERR(Callback, "Record callback must not be empty");
+    if (NumItems == 0)
+        return;
+
+    const auto NumSubRanges = std::min(static_cast<Uint32>(m_Contexts.size()), (NumItems + m_MinItemsPerContext - 1) / m_MinItemsPerContext);
+
+    // Every task records one sub-range on its own context, so a context is never used by two threads
+    m_RecordingPool.ParallelFor(NumSubRanges, [&](Uint32 ContextIndex) {
+        RecordSubRange(ContextIndex, NumSubRanges, NumItems, Callback);
+    });
+
+    std::vector<ICommandList*> ppCmdLists(NumSubRanges);
+    for (Uint32 i = 0; i < NumSubRanges; ++i)
+        ppCmdLists[i] = m_CommandLists[i];
+    pImmediateCtx->ExecuteCommandLists(NumSubRanges, ppCmdLists.data());
+
+    // Command lists can't be reused once executed
+    for (Uint32 i = 0; i < NumSubRanges; ++i)
+        m_CommandLists[i].Release();
+
+    m_Stats.NumCommandLists = NumSubRanges;
+    m_Stats.TotalCommandLists += NumSubRanges;
+}
+
+void ParallelCommandRecorder::FinishFrame()
+{
+    for (auto& pCtx : m_Contexts)
+        pCtx->FinishFrame();
+}
+
+} // namespace Diligent
@@ -0,0 +1,606 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+#include "WorkerThreadPool.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+bool IsReadOnlyState(RESOURCE_STATE State)
+{
+    return State != RESOURCE_STATE_UNKNOWN && (State & ~RESOURCE_STATE_GENERIC_READ) == 0;
+}
+
+} // namespace
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::CreateTexture(const Char* Name, const TextureDesc& Desc)
+{
+    DEV_CHECK_ERR(Desc.Usage == USAGE_DEFAULT, "Transient texture '", (Name != nullptr ? Name : ""), "' must use USAGE_DEFAULT");
+
+    Resource Res;
+    Res.Name      = Name != nullptr ? Name : "";
+    Res.IsTexture = true;
+    Res.TexDesc   = Desc;
+    return m_Graph.AddResource(std::move(Res));
+}
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::CreateBuffer(const Char* Name, const BufferDesc& Desc)
+{
+    DEV_CHECK_ERR(Desc.Usage == USAGE_DEFAULT, "Transient buffer '", (Name != nullptr ? Name : ""), "' must use USAGE_DEFAULT");
+
+    Resource Res;
+    Res.Name      = Name != nullptr ? Name : "";
+    Res.IsTexture = false;
+    Res.BuffDesc  = Desc;
+    return m_Graph.AddResource(std::move(Res));
+}
+
+void RenderGraph::PassBuilder::Read(ResourceId Id, RESOURCE_STATE State)
+{
+    AddAccess(Id, State, false);
+}
+
+void RenderGraph::PassBuilder::Write(ResourceId Id, RESOURCE_STATE State)
+{
+    AddAccess(Id, State, true);
+}
+
+void RenderGraph::PassBuilder::SetSideEffects()
+{
+    m_Graph.m_Passes[m_PassIndex].HasSideEffects = true;
+}
+
+void RenderGraph::PassBuilder::AddAccess(ResourceId Id, RESOURCE_STATE State, bool IsWrite)
+{
+    if (Id >= m_Graph.m_Resources.size())
+    {
+        UNEXPECTED("Resource id ", Id, " is invalid");
+        return;
+    }
+    DEV_CHECK_ERR(State != RESOURCE_STATE_UNKNOWN && State != RESOURCE_STATE_UNDEFINED,
+                  "Required state of resource '", m_Graph.m_Resources[Id].Name, "' must be known");
+
+    auto& Accesses = m_Graph.m_Passes[m_PassIndex].Accesses;
+    for (auto& Access : Accesses)
+    {
+        if (Access.Id != Id)
+            continue;
+
+        if (!IsWrite && !Access.IsWrite && IsReadOnlyState(Access.State) && IsReadOnlyState(State))
+        {
+            // Multiple read-only accesses are combined into one state
+            Access.State = Access.State | State;
+        }
+        else
+        {
+            DEV_CHECK_ERR(Access.State == State,
+                          "Resource '", m_Graph.m_Resources[Id].Name, "' is accessed by pass '", m_Graph.m_Passes[m_PassIndex].Name,
+                          "' in incompatible states. A pass may only read and write a resource in the same state (e.g. RESOURCE_STATE_UNORDERED_ACCESS).");
+        }
+        Access.IsRead  = Access.IsRead || !IsWrite;
+        Access.IsWrite = Access.IsWrite || IsWrite;
+        return;
+    }
+
+    ResourceAccess Access;
+    Access.Id      = Id;
+    Access.State   = State;
+    Access.IsRead  = !IsWrite;
+    Access.IsWrite = IsWrite;
+    Accesses.emplace_back(Access);
+}
+
+
+RenderGraph::RenderGraph(IRenderDevice* pDevice, const RenderGraphCreateInfo& CreateInfo) :
+    m_pDevice{pDevice},
+    m_CreateInfo{CreateInfo}
+{
+    DEV_CHECK_ERR(m_pDevice, "Render device must not be null");
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+bool RenderGraph::IsPassCulled(Uint32 PassIndex) const
+{
+    DEV_CHECK_ERR(m_IsCompiled, "The graph has not been compiled");
+    VERIFY_EXPR(PassIndex < m_Passes.size());
+    return m_Passes[PassIndex].IsCulled;
+}
+
+const std::vector<StateTransitionDesc>& RenderGraph::GetPassTransitions(Uint32 PassIndex) const
+{
+    DEV_CHECK_ERR(m_IsCompiled, "The graph has not been compiled");
+    VERIFY_EXPR(PassIndex < m_Passes.size());
+    return m_Passes[PassIndex].Transitions;
+}
+
+ITexture* RenderGraph::GetTexture(ResourceId Id) const
+{
+    if (Id >= m_Resources.size())
+    {
+        UNEXPECTED("Resource id ", Id, " is invalid");
+        return nullptr;
+    }
+
+    const auto& Res = m_Resources[Id];
+    DEV_CHECK_ERR(Res.IsTexture, "Resource '", Res.Name, "' is not a texture");
+    return Res.PhysicalIndex != InvalidIndex ? m_PhysicalResources[Res.PhysicalIndex].pTexture.RawPtr<ITexture>() : nullptr;
+}
+
+IBuffer* RenderGraph::GetBuffer(ResourceId Id) const
+{
+    if (Id >= m_Resources.size())
+    {
+        UNEXPECTED("Resource id ", Id, " is invalid");
+        return nullptr;
+    }
+
+    const auto& Res = m_Resources[Id];
+    DEV_CHECK_ERR(!Res.IsTexture, "Resource '", Res.Name, "' is not a buffer");
+    return Res.PhysicalIndex != InvalidIndex ? m_PhysicalResources[Res.PhysicalIndex].pBuffer.RawPtr<IBuffer>() : nullptr;
+}
+
+RenderGraph::ResourceId RenderGraph::AddResource(Resource&& Res)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Resources can't be added after the graph has been compiled. Call Reset() to start a new frame.");
+    m_Resources.emplace_back(std::move(Res));
+    return static_cast<ResourceId>(m_Resources.size() - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::ImportTexture(ITexture* pTexture, RESOURCE_STATE FinalState)
+{
+    if (pTexture == nullptr)
+    {
+        UNEXPECTED("Imported texture must not be null");
+        return InvalidResourceId;
+    }
+
+    for (ResourceId Id = 0; Id < m_Resources.size(); ++Id)
+    {
+        const auto& Res = m_Resources[Id];
+        if (Res.IsImported && Res.IsTexture && m_PhysicalResources[Res.PhysicalIndex].pTexture == pTexture)
+        {
+            DEV_CHECK_ERR(m_PhysicalResources[Res.PhysicalIndex].FinalState == FinalState,
+                          "Texture '", Res.Name, "' is imported multiple times with different final states");
+            return Id;
+        }
+    }
+    DEV_CHECK_ERR(pTexture->GetState() != RESOURCE_STATE_UNKNOWN, "Imported texture '", pTexture->GetDesc().Name, "' must be in a known state");
+
+    PhysicalResource Phys;
+    Phys.pTexture   = pTexture;
+    Phys.FinalState = FinalState;
+    Phys.IsImported = true;
+    m_PhysicalResources.emplace_back(std::move(Phys));
+
+    Resource Res;
+    Res.Name          = pTexture->GetDesc().Name != nullptr ? pTexture->GetDesc().Name : "";
+    Res.IsTexture     = true;
+    Res.IsImported    = true;
+    Res.TexDesc       = pTexture->GetDesc();
+    Res.PhysicalIndex = static_cast<Uint32>(m_PhysicalResources.size() - 1);
+    return AddResource(std::move(Res));
+}
+
+RenderGraph::ResourceId RenderGraph::ImportBuffer(IBuffer* pBuffer, RESOURCE_STATE FinalState)
+{
+    if (pBuffer == nullptr)
+    {
+        UNEXPECTED("Imported buffer must not be null");
+        return InvalidResourceId;
+    }
+
+    for (ResourceId Id = 0; Id < m_Resources.size(); ++Id)
+    {
+        const auto& Res = m_Resources[Id];
+        if (Res.IsImported && !Res.IsTexture && m_PhysicalResources[Res.PhysicalIndex].pBuffer == pBuffer)
+        {
+            DEV_CHECK_ERR(m_PhysicalResources[Res.PhysicalIndex].FinalState == FinalState,
+                          "Buffer '", Res.Name, "' is imported multiple times with different final states");
+            return Id;
+        }
+    }
+    DEV_CHECK_ERR(pBuffer->GetState() != RESOURCE_STATE_UNKNOWN, "Imported buffer '", pBuffer->GetDesc().Name, "' must be in a known state");
+
+    PhysicalResource Phys;
+    Phys.pBuffer    = pBuffer;
+    Phys.FinalState = FinalState;
+    Phys.IsImported = true;
+    m_PhysicalResources.emplace_back(std::move(Phys));
+
+    Resource Res;
+    Res.Name          = pBuffer->GetDesc().Name != nullptr ? pBuffer->GetDesc().Name : "";
+    Res.IsTexture     = false;
+    Res.IsImported    = true;
+    Res.BuffDesc      = pBuffer->GetDesc();
+    Res.PhysicalIndex = static_cast<Uint32>(m_PhysicalResources.size() - 1);
+    return AddResource(std::move(Res));
+}
+
+void RenderGraph::AddPass(const Char* Name, const SetupCallbackType& Setup, ExecuteCallbackType Execute)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Passes can't be added after the graph has been compiled. Call Reset() to start a new frame.");
+
+    Pass NewPass;
+    NewPass.Name    = Name != nullptr ? Name : "";
+    NewPass.Execute = std::move(Execute);
+    m_Passes.emplace_back(std::move(NewPass));
+
+    if (Setup)
+    {
+        PassBuilder Builder{*this, static_cast<Uint32>(m_Passes.size() - 1)};
+        Setup(Builder);
+    }
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walk the passes backwards and only keep the ones whose results are consumed
+    // by other kept passes, written to imported resources or have side effects.
+    std::vector<bool> IsResourceNeeded(m_Resources.size(), false);
+    for (size_t PassIdx = m_Passes.size(); PassIdx-- > 0;)
+    {
+        auto& CurrPass = m_Passes[PassIdx];
+
+        bool IsNeeded = CurrPass.HasSideEffects;
+        for (const auto& Access : CurrPass.Accesses)
+        {
+            if (Access.IsWrite && (m_Resources[Access.Id].IsImported || IsResourceNeeded[Access.Id]))
+                IsNeeded = true;
+        }
+
+        CurrPass.IsCulled = !IsNeeded;
+        if (!IsNeeded)
+        {
+            ++m_Stats.NumCulledPasses;
+            continue;
+        }
+
+        for (const auto& Access : CurrPass.Accesses)
+        {
+            if (Access.IsRead)
+                IsResourceNeeded[Access.Id] = true;
+        }
+    }
+
+    for (Uint32 PassIdx = 0; PassIdx < m_Passes.size(); ++PassIdx)
+    {
+        if (m_Passes[PassIdx].IsCulled)
+            continue;
+
+        for (const auto& Access : m_Passes[PassIdx].Accesses)
+        {
+            auto& Res = m_Resources[Access.Id];
+            if (Res.FirstPass == InvalidIndex)
+                Res.FirstPass = PassIdx;
+            Res.LastPass = PassIdx;
+        }
+    }
+}
+
+Uint32 RenderGraph::AcquirePhysicalResource(const Resource& Res)
+{
+    VERIFY_EXPR(!Res.IsImported && Res.FirstPass != InvalidIndex);
+
+    // Reuse a pooled object with identical description that is no longer used by the time
+    // the resource is first accessed. This aliases resources with disjoint lifetimes.
+    for (Uint32 i = 0; i < m_PhysicalResources.size(); ++i)
+    {
+        auto& Phys = m_PhysicalResources[i];
+        if (Phys.IsImported)
+            continue;
+        if (Phys.BusyUntilPass != InvalidIndex && Phys.BusyUntilPass >= Res.FirstPass)
+            continue;
+
+        const bool IsCompatible = Res.IsTexture ?
+            (Phys.pTexture && Phys.pTexture->GetDesc() == Res.TexDesc) :
+            (Phys.pBuffer && Phys.pBuffer->GetDesc() == Res.BuffDesc);
+        if (!IsCompatible)
+            continue;
+
+        Phys.BusyUntilPass = Res.LastPass;
+        Phys.LastUsedFrame = m_FrameNumber;
+        return i;
+    }
+
+    PhysicalResource Phys;
+    if (Res.IsTexture)
+    {
+        auto Desc = Res.TexDesc;
+        Desc.Name = Res.Name.c_str();
+        m_pDevice->CreateTexture(Desc, nullptr, &Phys.pTexture);
+        if (!Phys.pTexture)
+        {
+            LOG_ERROR_MESSAGE("Failed to create transient texture '", Res.Name, "'");
+            return InvalidIndex;
+        }
+    }
+    else
+    {
+        auto Desc = Res.BuffDesc;
+        Desc.Name = Res.Name.c_str();
+        m_pDevice->CreateBuffer(Desc, nullptr, &Phys.pBuffer);
+        if (!Phys.pBuffer)
+        {
+            LOG_ERROR_MESSAGE("Failed to create transient buffer '", Res.Name, "'");
+            return InvalidIndex;
+        }
+    }
+    ++m_Stats.TotalObjectsCreated;
+
+    Phys.BusyUntilPass = Res.LastPass;
+    Phys.LastUsedFrame = m_FrameNumber;
+    m_PhysicalResources.emplace_back(std::move(Phys));
+    return static_cast<Uint32>(m_PhysicalResources.size() - 1);
+}
+
+void RenderGraph::ComputeTransitions()
+{
+    for (auto& Phys : m_PhysicalResources)
+    {
+        Phys.State             = Phys.pTexture ? Phys.pTexture->GetState() : Phys.pBuffer->GetState();
+        Phys.IsAccessed        = false;
+        Phys.LastAccessIsWrite = false;
+    }
+
+#ifdef DILIGENT_DEVELOPMENT
+    std::vector<bool> IsWritten(m_Resources.size(), false);
+#endif
+
+    for (auto& CurrPass : m_Passes)
+    {
+        if (CurrPass.IsCulled)
+            continue;
+
+        for (const auto& Access : CurrPass.Accesses)
+        {
+            const auto& Res = m_Resources[Access.Id];
+            if (Res.PhysicalIndex == InvalidIndex)
+                continue;
+
+#ifdef DILIGENT_DEVELOPMENT
+            if (Access.IsRead && !Res.IsImported && !IsWritten[Access.Id])
+            {
+                LOG_WARNING_MESSAGE("Pass '", CurrPass.Name, "' reads transient resource '", Res.Name,
+                                    "' before it has been written. The contents of the resource are undefined.");
+            }
+            IsWritten[Access.Id] = IsWritten[Access.Id] || Access.IsWrite;
+#endif
+
+            auto& Phys = m_PhysicalResources[Res.PhysicalIndex];
+
+            bool NeedTransition = false;
+            if (Phys.State != Access.State)
+            {
+                // A resource that is already in a read-only state that includes the required
+                // state does not need to be transitioned for another read.
+                NeedTransition = !(!Access.IsWrite && IsReadOnlyState(Phys.State) && (Phys.State & Access.State) == Access.State);
+            }
+            else if (Access.State == RESOURCE_STATE_UNORDERED_ACCESS)
+            {
+                // UAV barrier is required between dependent accesses
+                NeedTransition = Phys.IsAccessed && (Phys.LastAccessIsWrite || Access.IsWrite);
+            }
+
+            if (NeedTransition)
+            {
+                StateTransitionDesc Barrier;
+                Barrier.pTexture = Phys.pTexture;
+                Barrier.pBuffer  = Phys.pBuffer;
+                Barrier.OldState = Phys.State;
+                Barrier.NewState = Access.State;
+                CurrPass.Transitions.emplace_back(Barrier);
+                Phys.State = Access.State;
+            }
+
+            Phys.IsAccessed        = true;
+            Phys.LastAccessIsWrite = Access.IsWrite;
+        }
+        m_Stats.NumTransitions += static_cast<Uint32>(CurrPass.Transitions.size());
+    }
+
+    for (auto& Phys : m_PhysicalResources)
+    {
+        if (Phys.FinalState == RESOURCE_STATE_UNKNOWN || Phys.State == Phys.FinalState)
+            continue;
+
+        StateTransitionDesc Barrier;
+        Barrier.pTexture = Phys.pTexture;
+        Barrier.pBuffer  = Phys.pBuffer;
+        Barrier.OldState = Phys.State;
+        Barrier.NewState = Phys.FinalState;
+        m_FinalTransitions.emplace_back(Barrier);
+        Phys.State = Phys.FinalState;
+    }
+    m_Stats.NumTransitions += static_cast<Uint32>(m_FinalTransitions.size());
+}
+
+void RenderGraph::Compile()
+{
+    if (m_IsCompiled)
+        return;
+
+    m_Stats.NumPasses = static_cast<Uint32>(m_Passes.size());
+    CullPasses();
+
+    for (auto& Phys : m_PhysicalResources)
+        Phys.BusyUntilPass = InvalidIndex;
+
+    // Allocate transient resources in the order of their first use
+    std::vector<ResourceId> TransientResources;
+    for (ResourceId Id = 0; Id < m_Resources.size(); ++Id)
+    {
+        const auto& Res = m_Resources[Id];
+        if (Res.IsImported)
+            continue;
+        ++m_Stats.NumTransientResources;
+        if (Res.FirstPass != InvalidIndex)
+            TransientResources.push_back(Id);
+    }
+    std::sort(TransientResources.begin(), TransientResources.end(),
+              [this](ResourceId Id0, ResourceId Id1) {
+                  return m_Resources[Id0].FirstPass < m_Resources[Id1].FirstPass;
+              });
+
+    for (auto Id : TransientResources)
+    {
+        auto& Res         = m_Resources[Id];
+        Res.PhysicalIndex = AcquirePhysicalResource(Res);
+    }
+
+    for (const auto& Phys : m_PhysicalResources)
+    {
+        if (!Phys.IsImported && Phys.BusyUntilPass != InvalidIndex)
+            ++m_Stats.NumPhysicalResources;
+    }
+
+    ComputeTransitions();
+
+    m_IsCompiled = true;
+}
+
+void RenderGraph::RecordPasses(IDeviceContext* pContext, const Uint32* pPassIndices, size_t NumPasses)
+{
+    PassContext Ctx{*this, pContext};
+    for (size_t i = 0; i < NumPasses; ++i)
+    {
+        auto& CurrPass = m_Passes[pPassIndices[i]];
+        if (!CurrPass.Transitions.empty())
+            pContext->TransitionResourceStates(static_cast<Uint32>(CurrPass.Transitions.size()), CurrPass.Transitions.data());
+        if (CurrPass.Execute)
+            CurrPass.Execute(Ctx);
+    }
+}
+
+void RenderGraph::Execute(IDeviceContext* pImmediateCtx, IDeviceContext* const* ppDeferredCtxs, Uint32 NumDeferredCtxs)
+{
+    DEV_CHECK_ERR(pImmediateCtx != nullptr, "Immediate context must not be null");
+    DEV_CHECK_ERR(NumDeferredCtxs == 0 || ppDeferredCtxs != nullptr, "Deferred contexts must not be null");
+
+    Compile();
+
+    std::vector<Uint32> ActivePasses;
+    ActivePasses.reserve(m_Passes.size());
+    for (Uint32 PassIdx = 0; PassIdx < m_Passes.size(); ++PassIdx)
+    {
+        if (!m_Passes[PassIdx].IsCulled)
+            ActivePasses.push_back(PassIdx);
+    }
+
+    const auto NumChunks = std::min(static_cast<size_t>(NumDeferredCtxs), ActivePasses.size());
+    if (NumChunks == 0)
+    {
+        // Update the states as we go so that pass callbacks can verify them
+        for (auto PassIdx : ActivePasses)
+        {
+            for (auto& Barrier : m_Passes[PassIdx].Transitions)
+                Barrier.UpdateResourceState = true;
+        }
+        RecordPasses(pImmediateCtx, ActivePasses.data(), ActivePasses.size());
+    }
+    else
+    {
+        // Resource states are not updated while recording as deferred contexts
+        // are executed in an order that is not known to the objects
+        std::vector<RefCntAutoPtr<ICommandList>> CommandLists(NumChunks);
+
+        const auto RecordChunk = [&](Uint32 Chunk) {
+            const auto FirstPass = ActivePasses.size() * Chunk / NumChunks;
+            const auto EndPass   = ActivePasses.size() * (Chunk + 1) / NumChunks;
+            auto*      pCtx      = ppDeferredCtxs[Chunk];
+            RecordPasses(pCtx, ActivePasses.data() + FirstPass, EndPass - FirstPass);
+            pCtx->FinishCommandList(&CommandLists[Chunk]);
+        };
+
+        if (NumChunks > 1)
+        {
+            // The calling thread records one of the chunks, so one worker less is needed.
+            // The pool is only recreated when more contexts are used than ever before.
+            const auto NumWorkers = static_cast<Uint32>(NumChunks - 1);
+            if (!m_pRecordingPool || m_pRecordingPool->GetNumWorkers() < NumWorkers)
+                m_pRecordingPool.reset(new WorkerThreadPool{NumWorkers});
+            m_pRecordingPool->ParallelFor(static_cast<Uint32>(NumChunks), RecordChunk);
+        }
+        else
+        {
+            RecordChunk(0);
+        }
+
+        std::vector<ICommandList*> ppCmdLists(NumChunks);
+        for (size_t i = 0; i < NumChunks; ++i)
+            ppCmdLists[i] = CommandLists[i];
+        pImmediateCtx->ExecuteCommandLists(static_cast<Uint32>(ppCmdLists.size()), ppCmdLists.data());
+    }
+
+    if (!m_FinalTransitions.empty())
+        pImmediateCtx->TransitionResourceStates(static_cast<Uint32>(m_FinalTransitions.size()), m_FinalTransitions.data());
+
+    for (auto& Phys : m_PhysicalResources)
+    {
+        if (!Phys.IsAccessed)
+            continue;
+        if (Phys.pTexture)
+            Phys.pTexture->SetState(Phys.State);
+        else
+            Phys.pBuffer->SetState(Phys.State);
+    }
+}
+
+void RenderGraph::Reset()
+{
+    m_Passes.clear();
+    m_Resources.clear();
+    m_FinalTransitions.clear();
+
+    ++m_FrameNumber;
+    // Release imported objects and the pooled objects that have not been used for a while
+    m_PhysicalResources.erase(
+        std::remove_if(m_PhysicalResources.begin(), m_PhysicalResources.end(),
+                       [this](const PhysicalResource& Phys) {
+                           return Phys.IsImported || m_FrameNumber - Phys.LastUsedFrame > m_CreateInfo.MaxUnusedFrames;
+                       }),
+        m_PhysicalResources.end());
+
+    const auto TotalObjectsCreated = m_Stats.TotalObjectsCreated;
+    m_Stats                        = Statistics{};
+    m_Stats.TotalObjectsCreated    = TotalObjectsCreated;
+
+    m_IsCompiled = false;
+}
+
+} // namespace Diligent
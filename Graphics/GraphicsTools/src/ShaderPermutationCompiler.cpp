@@ -0,0 +1,461 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include "ShaderPermutationCompiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_set>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Include files nested deeper than this are left to the shader compiler
+constexpr Uint32 MaxIncludeDepth = 32;
+
+inline bool IsIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool IsIdentifierChar(char c)
+{
+    return IsIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+// Parses '#include "Name"' or '#include <Name>' directive. Returns false if the line is not an include directive.
+bool ParseIncludeDirective(const Char* Line, const Char* LineEnd, String& Name)
+{
+    const auto* c = Line;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+    if (c == LineEnd || *c != '#')
+        return false;
+    ++c;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+
+    static constexpr char   IncludeStr[] = "include";
+    static constexpr size_t IncludeLen   = sizeof(IncludeStr) - 1;
+    if (static_cast<size_t>(LineEnd - c) < IncludeLen || strncmp(c, IncludeStr, IncludeLen) != 0)
+        return false;
+    c += IncludeLen;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+    if (c == LineEnd || (*c != '"' && *c != '<'))
+        return false;
+
+    const char  ClosingQuote = *c == '"' ? '"' : '>';
+    const auto* NameStart    = ++c;
+    while (c < LineEnd && *c != ClosingQuote)
+        ++c;
+    if (c == LineEnd)
+        return false;
+
+    Name.assign(NameStart, c);
+    return !Name.empty();
+}
+
+// Returns true if the line is a '#pragma once' directive
+bool IsPragmaOnceDirective(const Char* Line, const Char* LineEnd)
+{
+    const auto* c = Line;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+    if (c == LineEnd || *c != '#')
+        return false;
+    ++c;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+
+    static constexpr char   PragmaStr[] = "pragma";
+    static constexpr size_t PragmaLen   = sizeof(PragmaStr) - 1;
+    if (static_cast<size_t>(LineEnd - c) < PragmaLen || strncmp(c, PragmaStr, PragmaLen) != 0)
+        return false;
+    c += PragmaLen;
+    if (c == LineEnd || (*c != ' ' && *c != '\t'))
+        return false;
+    while (c < LineEnd && (*c == ' ' || *c == '\t'))
+        ++c;
+
+    static constexpr char   OnceStr[] = "once";
+    static constexpr size_t OnceLen   = sizeof(OnceStr) - 1;
+    if (static_cast<size_t>(LineEnd - c) < OnceLen || strncmp(c, OnceStr, OnceLen) != 0)
+        return false;
+    c += OnceLen;
+    while (c < LineEnd && (*c == ' ' || *c == '\t' || *c == '\r'))
+        ++c;
+    return c == LineEnd;
+}
+
+// Updates the block comment state for the line
+void ScanComments(const Char* Line, const Char* LineEnd, bool& InBlockComment)
+{
+    for (const auto* c = Line; c < LineEnd; ++c)
+    {
+        if (InBlockComment)
+        {
+            if (c[0] == '*' && c + 1 < LineEnd && c[1] == '/')
+            {
+                InBlockComment = false;
+                ++c;
+            }
+        }
+        else if (c[0] == '/' && c + 1 < LineEnd && c[1] == '/')
+        {
+            break;
+        }
+        else if (c[0] == '/' && c + 1 < LineEnd && c[1] == '*')
+        {
+            InBlockComment = true;
+            ++c;
+        }
+        else if (c[0] == '"')
+        {
+            for (++c; c < LineEnd && *c != '"'; ++c)
+            {
+                if (*c == '\\' && c + 1 < LineEnd)
+                    ++c;
+            }
+        }
+    }
+}
+
+// Collects identifiers that occur outside of comments and string literals.
+// Returns true if the source contains the token-pasting operator.
+bool CollectIdentifiers(const String& Source, std::unordered_set<String>& Identifiers)
+{
+    bool HasTokenPasting = false;
+
+    const auto* c   = Source.c_str();
+    const auto* End = c + Source.length();
+    while (c < End)
+    {
+        if (c[0] == '/' && c + 1 < End && c[1] == '/')
+        {
+            c = std::find(c, End, '\n');
+        }
+        else if (c[0] == '/' && c + 1 < End && c[1] == '*')
+        {
+            const auto* CommentEnd = strstr(c + 2, "*/");
+            c                      = CommentEnd != nullptr ? CommentEnd + 2 : End;
+        }
+        else if (c[0] == '"')
+        {
+            for (++c; c < End && *c != '"' && *c != '\n'; ++c)
+            {
+                if (*c == '\\' && c + 1 < End)
+                    ++c;
+            }
+            if (c < End)
+                ++c;
+        }
+        else if (IsIdentifierStart(*c))
+        {
+            const auto* IdentifierStart = c;
+            while (c < End && IsIdentifierChar(*c))
+                ++c;
+            Identifiers.emplace(IdentifierStart, c);
+        }
+        else if (*c >= '0' && *c <= '9')
+        {
+            // Skip numeric literals together with their suffixes (e.g. 1.0f, 0x1Fu)
+            while (c < End && (IsIdentifierChar(*c) || *c == '.'))
+                ++c;
+        }
+        else if (c[0] == '#' && c + 1 < End && c[1] == '#')
+        {
+            HasTokenPasting = true;
+            c += 2;
+        }
+        else
+        {
+            ++c;
+        }
+    }
+
+    return HasTokenPasting;
+}
+
+void AppendLineDirective(String& Source, Uint32 LineNumber)
+{
+    Source.append("#line ");
+    Source.append(std::to_string(LineNumber));
+    Source.push_back('\n');
+}
+
+} // namespace
+
+ShaderPermutationCompiler::ShaderPermutationCompiler(IRenderDevice* pDevice, const ShaderCreateInfo& ShaderCI) :
+    m_pDevice{pDevice},
+    m_ShaderCI{ShaderCI},
+    m_Name{ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : ""},
+    m_EntryPoint{ShaderCI.EntryPoint != nullptr ? ShaderCI.EntryPoint : ""},
+    m_CombinedSamplerSuffix{ShaderCI.CombinedSamplerSuffix != nullptr ? ShaderCI.CombinedSamplerSuffix : ""}
+{
+    DEV_CHECK_ERR(ShaderCI.ByteCode == nullptr, "Shader permutations can only be created from source");
+
+    m_ShaderCI.Macros                = nullptr;
+    m_ShaderCI.ppCompilerOutput      = nullptr;
+    m_ShaderCI.ppConversionStream    = nullptr;
+    m_ShaderCI.Desc.Name             = ShaderCI.Desc.Name != nullptr ? m_Name.c_str() : nullptr;
+    m_ShaderCI.EntryPoint            = ShaderCI.EntryPoint != nullptr ? m_EntryPoint.c_str() : nullptr;
+    m_ShaderCI.CombinedSamplerSuffix = ShaderCI.CombinedSamplerSuffix != nullptr ? m_CombinedSamplerSuffix.c_str() : nullptr;
+
+    if (ShaderCI.Source != nullptr)
+    {
+        ExpandIncludes(ShaderCI.Source, strlen(ShaderCI.Source), 0);
+        m_SourceLoaded = true;
+    }
+    else if (ShaderCI.FilePath != nullptr && ShaderCI.pShaderSourceStreamFactory != nullptr)
+    {
+        RefCntAutoPtr<IFileStream> pSourceStream;
+        ShaderCI.pShaderSourceStreamFactory->CreateInputStream(ShaderCI.FilePath, &pSourceStream);
+        if (pSourceStream)
+        {
+            std::vector<Char> Source(pSourceStream->GetSize());
+            if (Source.empty() || pSourceStream->Read(Source.data(), Source.size()))
+            {
+                m_IncludeStack.emplace_back(ShaderCI.FilePath);
+                ExpandIncludes(Source.data(), Source.size(), 0);
+                m_IncludeStack.pop_back();
+                m_SourceLoaded = true;
+            }
+        }
+
+        if (!m_SourceLoaded)
+            LOG_ERROR_MESSAGE("Failed to load shader source file '", ShaderCI.FilePath, "'. Permutations of shader '", m_Name, "' will not be deduplicated.");
+    }
+    else
+    {
+        UNEXPECTED("Shader source or file path and source stream factory must be provided");
+    }
+
+    if (m_SourceLoaded)
+    {
+        m_ShaderCI.Source   = m_ExpandedSource.c_str();
+        m_ShaderCI.FilePath = nullptr;
+        m_HasTokenPasting   = CollectIdentifiers(m_ExpandedSource, m_Identifiers);
+    }
+}
+
+void ShaderPermutationCompiler::ExpandIncludes(const Char* Source, size_t Length, Uint32 Depth)
+{
+    const auto* const SourceEnd = Source + Length;
+
+    bool   InBlockComment = false;
+    Uint32 LineNumber     = 1;
+    for (const auto* Line = Source; Line < SourceEnd; ++LineNumber)
+    {
+        const auto* LineEnd  = std::find(Line, SourceEnd, '\n');
+        const auto* NextLine = LineEnd < SourceEnd ? LineEnd + 1 : SourceEnd;
+
+        String IncludeName;
+        if (!InBlockComment && ParseIncludeDirective(Line, LineEnd, IncludeName))
+        {
+            // Files with '#pragma once' are only expanded once. Other files may be meant to be included
+            // several times (e.g. X-macro tables or headers included in both branches of #if/#else)
+            // and are expanded every time, except for a file that is already being expanded, which would
+            // never end. The directive is replaced with an empty line to keep the line numbers.
+            if (m_PragmaOnceFiles.find(IncludeName) != m_PragmaOnceFiles.end() ||
+                std::find(m_IncludeStack.begin(), m_IncludeStack.end(), IncludeName) != m_IncludeStack.end())
+            {
+                m_ExpandedSource.push_back('\n');
+                ++m_Stats.NumRepeatedIncludes;
+                Line = NextLine;
+                continue;
+            }
+
+            RefCntAutoPtr<IFileStream> pIncludeStream;
+            if (Depth < MaxIncludeDepth && m_ShaderCI.pShaderSourceStreamFactory != nullptr)
+                m_ShaderCI.pShaderSourceStreamFactory->CreateInputStream(IncludeName.c_str(), &pIncludeStream);
+
+            std::vector<Char> IncludeSource;
+            if (pIncludeStream)
+            {
+                IncludeSource.resize(pIncludeStream->GetSize());
+                if (!IncludeSource.empty() && !pIncludeStream->Read(IncludeSource.data(), IncludeSource.size()))
+                    pIncludeStream.Release();
+            }
+
+            if (pIncludeStream)
+            {
+                m_IncludeStack.push_back(IncludeName);
+                AppendLineDirective(m_ExpandedSource, 1);
+                ExpandIncludes(IncludeSource.data(), IncludeSource.size(), Depth + 1);
+                m_IncludeStack.pop_back();
+                // The line after the directive
+                AppendLineDirective(m_ExpandedSource, LineNumber + 1);
+                ++m_Stats.NumExpandedIncludes;
+                Line = NextLine;
+                continue;
+            }
+
+            ++m_Stats.NumUnresolvedIncludes;
+        }
+        else if (!InBlockComment && IsPragmaOnceDirective(Line, LineEnd))
+        {
+            if (!m_IncludeStack.empty())
+                m_PragmaOnceFiles.insert(m_IncludeStack.back());
+            // The pasted file is not a separate file for the compiler anymore
+            m_ExpandedSource.push_back('\n');
+            Line = NextLine;
+            continue;
+        }
+
+        ScanComments(Line, LineEnd, InBlockComment);
+        m_ExpandedSource.append(Line, LineEnd);
+        m_ExpandedSource.push_back('\n');
+        Line = NextLine;
+    }
+}
+
+Uint32 ShaderPermutationCompiler::AddPermutation(const ShaderMacro* Macros)
+{
+    // Macros that are not referenced by the source can't affect the preprocessed text.
+    // This is only known when all includes have been expanded.
+    // Token pasting may form references to macros whose names do not occur in the source.
+    bool ReduceMacros = m_SourceLoaded && m_Stats.NumUnresolvedIncludes == 0 && !m_HasTokenPasting;
+
+    // Later definitions of the same macro override earlier ones
+    std::map<String, String> AllMacros;
+    for (const auto* Macro = Macros; Macro != nullptr && Macro->Name != nullptr; ++Macro)
+    {
+        const auto& Definition = AllMacros[Macro->Name] = Macro->Definition != nullptr ? Macro->Definition : "";
+        if (Definition.find("##") != String::npos)
+            ReduceMacros = false;
+    }
+
+    std::map<String, String> ReducedMacros;
+    if (ReduceMacros)
+    {
+        // A macro is also referenced if it is used in the definition of a referenced macro
+        std::unordered_set<String> DefinitionIdentifiers;
+        for (bool MacroAdded = true; MacroAdded;)
+        {
+            MacroAdded = false;
+            for (const auto& Macro : AllMacros)
+            {
+                if (ReducedMacros.find(Macro.first) != ReducedMacros.end())
+                    continue;
+                if (m_Identifiers.find(Macro.first) == m_Identifiers.end() &&
+                    DefinitionIdentifiers.find(Macro.first) == DefinitionIdentifiers.end())
+                    continue;
+
+                ReducedMacros.insert(Macro);
+                CollectIdentifiers(Macro.second, DefinitionIdentifiers);
+                MacroAdded = true;
+            }
+        }
+    }
+    else
+    {
+        ReducedMacros.swap(AllMacros);
+    }
+
+    String Key;
+    for (const auto& Macro : ReducedMacros)
+    {
+        Key.append(Macro.first);
+        Key.push_back('=');
+        Key.append(Macro.second);
+        Key.push_back('\n');
+    }
+
+    auto it = m_KeyToUniqueShader.find(Key);
+    if (it == m_KeyToUniqueShader.end())
+    {
+        it = m_KeyToUniqueShader.emplace(std::move(Key), static_cast<Uint32>(m_UniqueShaders.size())).first;
+
+        m_UniqueShaders.emplace_back();
+        m_UniqueShaders.back().Macros.assign(ReducedMacros.begin(), ReducedMacros.end());
+    }
+
+    m_PermutationToUniqueShader.push_back(it->second);
+    return static_cast<Uint32>(m_PermutationToUniqueShader.size() - 1);
+}
+
+bool ShaderPermutationCompiler::Compile()
+{
+    DEV_CHECK_ERR(m_pDevice, "Render device must not be null");
+
+    bool AllSucceeded = true;
+    for (auto& Shader : m_UniqueShaders)
+    {
+        if (Shader.Compiled)
+        {
+            AllSucceeded = AllSucceeded && Shader.pShader != nullptr;
+            continue;
+        }
+
+        std::vector<ShaderMacro> Macros;
+        Macros.reserve(Shader.Macros.size() + 1);
+        for (const auto& Macro : Shader.Macros)
+            Macros.emplace_back(Macro.first.c_str(), Macro.second.c_str());
+        Macros.emplace_back(nullptr, nullptr);
+
+        auto ShaderCI   = m_ShaderCI;
+        ShaderCI.Macros = Macros.data();
+        m_pDevice->CreateShader(ShaderCI, &Shader.pShader);
+        Shader.Compiled = true;
+
+        ++m_Stats.NumCompiledShaders;
+        if (!Shader.pShader)
+        {
+            ++m_Stats.NumFailedShaders;
+            AllSucceeded = false;
+        }
+    }
+
+    return AllSucceeded;
+}
+
+IShader* ShaderPermutationCompiler::GetShader(Uint32 PermutationIndex) const
+{
+    return GetUniqueShader(GetUniqueShaderIndex(PermutationIndex));
+}
+
+Uint32 ShaderPermutationCompiler::GetUniqueShaderIndex(Uint32 PermutationIndex) const
+{
+    DEV_CHECK_ERR(PermutationIndex < m_PermutationToUniqueShader.size(), "Permutation index (", PermutationIndex, ") is out of range");
+    return m_PermutationToUniqueShader[PermutationIndex];
+}
+
+IShader* ShaderPermutationCompiler::GetUniqueShader(Uint32 UniqueShaderIndex) const
+{
+    DEV_CHECK_ERR(UniqueShaderIndex < m_UniqueShaders.size(), "Unique shader index (", UniqueShaderIndex, ") is out of range");
+    return m_UniqueShaders[UniqueShaderIndex].pShader.RawPtr<IShader>();
+}
+
+} // namespace Diligent
@@ -29,10 +29,13 @@
 #include <unordered_map>
 #include <deque>
 #include <vector>
+#include <algorithm>
 
 #include "TextureUploaderD3D12_Vk.hpp"
 #include "ThreadSignal.hpp"
 #include "GraphicsAccessories.hpp"
+#include "RingBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
 
 namespace Diligent
 {
@@ -40,6 +43,87 @@ namespace Diligent
 namespace
 {
 
+// D3D12 requires texture data in a buffer to be aligned by 512 bytes and row pitch to be
+// aligned by 256 bytes. Vulkan additionally requires both to be multiples of the texel size.
+constexpr Uint32 StagingDataPlacementAlignment = 512;
+constexpr Uint32 StagingDataPitchAlignment     = 256;
+
+// Returns the smallest multiple of BaseAlignment that is also a multiple of ElementSize
+Uint32 GetCompatibleAlignment(Uint32 BaseAlignment, Uint32 ElementSize)
+{
+    auto Alignment = BaseAlignment;
+    while (ElementSize != 0 && Alignment % ElementSize != 0)
+        Alignment += BaseAlignment;
+    return Alignment;
+}
+
+// Unlike Align(), the alignment is not required to be a power of two
+template <typename T>
+T AlignUp(T Value, T Alignment)
+{
+    return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+// Layout of upload buffer subresources in a staging buffer
+struct StagingBufferLayout
+{
+    StagingBufferLayout() = default;
+
+    explicit StagingBufferLayout(const UploadBufferDesc& Desc) :
+        // clang-format off
+        Offsets     (Desc.MipLevels * Desc.ArraySize),
+        Strides     (Desc.MipLevels * Desc.ArraySize),
+        DepthStrides(Desc.MipLevels * Desc.ArraySize),
+        Regions     (Desc.MipLevels * Desc.ArraySize)
+    // clang-format on
+    {
+        TextureDesc TexDesc;
+        TexDesc.Type      = Desc.Depth > 1 ? RESOURCE_DIM_TEX_3D : (Desc.ArraySize == 1 ? RESOURCE_DIM_TEX_2D : RESOURCE_DIM_TEX_2D_ARRAY);
+        TexDesc.Format    = Desc.Format;
+        TexDesc.Width     = Desc.Width;
+        TexDesc.Height    = Desc.Height;
+        TexDesc.Depth     = Desc.Depth;
+        TexDesc.MipLevels = Desc.MipLevels;
+
+        const auto& FmtAttribs  = GetTextureFormatAttribs(Desc.Format);
+        const auto  ElementSize = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ?
+            Uint32{FmtAttribs.ComponentSize} :
+            Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+
+        PlacementAlignment        = GetCompatibleAlignment(StagingDataPlacementAlignment, ElementSize);
+        const auto PitchAlignment = GetCompatibleAlignment(StagingDataPitchAlignment, ElementSize);
+        Uint32     SubRes         = 0;
+        Uint32     CurrOffset     = 0;
+        for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+            {
+                const auto MipProps = GetMipLevelProperties(TexDesc, Mip);
+
+                CurrOffset           = AlignUp(CurrOffset, PlacementAlignment);
+                Offsets[SubRes]      = CurrOffset;
+                Strides[SubRes]      = AlignUp(MipProps.RowSize, PitchAlignment);
+                DepthStrides[SubRes] = Strides[SubRes] * MipProps.StorageHeight;
+                Regions[SubRes]      = Box{0, MipProps.LogicalWidth, 0, MipProps.LogicalHeight, 0, MipProps.Depth};
+                CurrOffset += DepthStrides[SubRes] * MipProps.Depth;
+                ++SubRes;
+            }
+        }
+        TotalSize = CurrOffset;
+    }
+
+    std::vector<Uint32> Offsets;
+    std::vector<Uint32> Strides;
+    std::vector<Uint32> DepthStrides;
+    // Destination region of every subresource, which is defined by the upload buffer
+    // description rather than by the destination texture mip level.
+    std::vector<Box> Regions;
+    Uint32           TotalSize          = 0;
+    Uint32           PlacementAlignment = StagingDataPlacementAlignment;
+};
+
+// Upload buffer that is either backed by its own staging texture, or
+// is sub-allocated from a staging ring buffer.
 class UploadTexture : public UploadBufferBase
 {
 public:
@@ -53,13 +137,23 @@ public:
     {
     }
 
+    UploadTexture(IReferenceCounters*     pRefCounters,
+                  const UploadBufferDesc& Desc,
+                  StagingBufferLayout&&   Layout) :
+        // clang-format off
+        UploadBufferBase{pRefCounters, Desc},
+        m_RingLayout    {std::move(Layout)}
+    // clang-format on
+    {
+    }
+
     ~UploadTexture()
     {
         for (Uint32 Slice = 0; Slice < m_Desc.ArraySize; ++Slice)
         {
             for (Uint32 Mip = 0; Mip < m_Desc.MipLevels; ++Mip)
             {
-                DEV_CHECK_ERR(!IsMapped(Mip, Slice), "Releasing mapped staging texture");
+                DEV_CHECK_ERR(IsRingBufferRegion() || !IsMapped(Mip, Slice), "Releasing mapped staging texture");
             }
         }
     }
@@ -83,12 +177,15 @@ public:
     void Unmap(IDeviceContext* pDeviceContext, Uint32 Mip, Uint32 Slice)
     {
         VERIFY(IsMapped(Mip, Slice), "This subresource is not mapped");
-        pDeviceContext->UnmapTextureSubresource(m_pStagingTexture, Mip, Slice);
+        // Ring buffers are persistently mapped
+        if (!IsRingBufferRegion())
+            pDeviceContext->UnmapTextureSubresource(m_pStagingTexture, Mip, Slice);
         SetMappedData(Mip, Slice, MappedTextureSubresource{});
     }
 
     void Map(IDeviceContext* pDeviceContext, Uint32 Mip, Uint32 Slice)
     {
+        VERIFY(!IsRingBufferRegion(), "Ring buffer regions are mapped when they are allocated");
         VERIFY(!IsMapped(Mip, Slice), "This subresource is already mapped");
         MappedTextureSubresource MappedData;
         pDeviceContext->MapTextureSubresource(m_pStagingTexture, Mip, Slice, MAP_WRITE, MAP_FLAG_NO_OVERWRITE, nullptr, MappedData);
@@ -126,12 +223,76 @@ public:
         return m_CopyScheduledFenceValue;
     }
 
+    bool IsRingBufferRegion() const
+    {
+        return !m_pStagingTexture;
+    }
+
+    const StagingBufferLayout& GetRingLayout() const
+    {
+        VERIFY_EXPR(IsRingBufferRegion());
+        return m_RingLayout;
+    }
+
+    void SetRingAllocation(size_t RingIdx, Uint64 AllocationId, IBuffer* pRingBuffer, Uint8* pRingData, Uint32 Offset)
+    {
+        VERIFY_EXPR(IsRingBufferRegion() && !IsRingAllocated());
+        m_RingIdx          = RingIdx;
+        m_RingAllocationId = AllocationId;
+        m_pRingBuffer      = pRingBuffer;
+        m_RingOffset       = Offset;
+
+        Uint32 SubRes = 0;
+        for (Uint32 Slice = 0; Slice < m_Desc.ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < m_Desc.MipLevels; ++Mip)
+            {
+                MappedTextureSubresource MappedData //
+                    {
+                        pRingData + Offset + m_RingLayout.Offsets[SubRes],
+                        m_RingLayout.Strides[SubRes],
+                        m_RingLayout.DepthStrides[SubRes] //
+                    };
+                SetMappedData(Mip, Slice, MappedData);
+                ++SubRes;
+            }
+        }
+    }
+
+    bool IsRingAllocated() const
+    {
+        return m_pRingBuffer != nullptr;
+    }
+
+    size_t   GetRingIndex() const { return m_RingIdx; }
+    Uint64   GetRingAllocationId() const { return m_RingAllocationId; }
+    IBuffer* GetRingBuffer() const { return m_pRingBuffer.RawPtr<IBuffer>(); }
+
+    Uint32 GetRingOffset(Uint32 Mip, Uint32 Slice) const
+    {
+        VERIFY_EXPR(Mip < m_Desc.MipLevels && Slice < m_Desc.ArraySize);
+        return m_RingOffset + m_RingLayout.Offsets[m_Desc.MipLevels * Slice + Mip];
+    }
+
+    const Box& GetRingRegion(Uint32 Mip, Uint32 Slice) const
+    {
+        VERIFY_EXPR(Mip < m_Desc.MipLevels && Slice < m_Desc.ArraySize);
+        return m_RingLayout.Regions[m_Desc.MipLevels * Slice + Mip];
+    }
+
 private:
     ThreadingTools::Signal m_CopyScheduledSignal;
     ThreadingTools::Signal m_TextureMappedSignal;
 
     RefCntAutoPtr<ITexture> m_pStagingTexture;
     Uint64                  m_CopyScheduledFenceValue = 0;
+
+    // Ring buffer region data
+    const StagingBufferLayout m_RingLayout;
+    RefCntAutoPtr<IBuffer>    m_pRingBuffer;
+    size_t                    m_RingIdx          = 0;
+    Uint64                    m_RingAllocationId = 0;
+    Uint32                    m_RingOffset       = 0;
 };
 
 } // namespace
@@ -166,7 +327,9 @@ struct TextureUploaderD3D12_Vk::InternalData
         // clang-format on
     };
 
-    InternalData(IRenderDevice* pDevice)
+    InternalData(IRenderDevice* pDevice, const TextureUploaderDesc& Desc) :
+        m_pDevice{pDevice},
+        m_Desc{Desc}
     {
         FenceDesc fenceDesc;
         fenceDesc.Name = "Texture uploader sync fence";
@@ -186,6 +349,19 @@ struct TextureUploaderD3D12_Vk::InternalData
                                  " upload buffer(s)", (it.second.size() == 1 ? "" : "s"));
             }
         }
+
+        if (!m_Rings.empty())
+        {
+            VERIFY(m_pRingContext, "Ring buffers are created by the render thread, so the context must not be null");
+            // Ring buffers may still be referenced by the GPU
+            m_pRingContext->WaitForFence(m_pFence, m_NextFenceValue - 1, true);
+            for (auto& Ring : m_Rings)
+            {
+                m_pRingContext->UnmapBuffer(Ring.pBuffer, MAP_WRITE);
+                Ring.Ring.ReleaseCompletedFrames(~Uint64{0});
+            }
+            LOG_INFO_MESSAGE("TextureUploaderD3D12_Vk: releasing ", m_Rings.size(), " staging ring buffer", (m_Rings.size() == 1 ? "" : "s"));
+        }
     }
 
     std::vector<PendingBufferOperation>& SwapMapQueues()
@@ -259,9 +435,37 @@ struct TextureUploaderD3D12_Vk::InternalData
         return static_cast<Uint32>(m_PendingOperations.size());
     }
 
-    void Execute(IDeviceContext* pContext, PendingBufferOperation& OperationInfo);
+    // Returns false if the operation could not be completed and must be retried later
+    bool Execute(IDeviceContext* pContext, PendingBufferOperation& OperationInfo);
+
+    bool TryAllocateFromRings(UploadTexture* pUploadTexture);
+    bool AllocateRingRegion(IDeviceContext* pContext, UploadTexture* pUploadTexture, bool CanStall);
+    void OnRingCopyScheduled(UploadTexture* pUploadTexture, Uint64 FenceValue);
+    void ReleaseCompletedRingSpace();
+
+    void OnAllocationStalled()
+    {
+        std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+        ++m_NumStalledAllocations;
+    }
+
+    void GetRingStats(TextureUploaderStats& Stats)
+    {
+        std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+        for (const auto& Ring : m_Rings)
+        {
+            Stats.StagingMemorySize += Ring.Ring.GetMaxSize();
+            Stats.StagingMemoryInUse += Ring.Ring.GetUsedSize();
+        }
+        Stats.NumStalledAllocations = m_NumStalledAllocations;
+    }
+
+    // Render-thread only
+    std::vector<PendingBufferOperation> m_DeferredOperations;
 
 private:
+    bool CreateRing(IDeviceContext* pContext);
+
     std::mutex                          m_PendingOperationsMtx;
     std::vector<PendingBufferOperation> m_PendingOperations;
     std::vector<PendingBufferOperation> m_InWorkOperations;
@@ -269,14 +473,191 @@ private:
     std::mutex                                                                     m_UploadTexturesCacheMtx;
     std::unordered_map<UploadBufferDesc, std::deque<RefCntAutoPtr<UploadTexture>>> m_UploadTexturesCache;
 
+    IRenderDevice* const      m_pDevice;
+    const TextureUploaderDesc m_Desc;
+
     RefCntAutoPtr<IFence> m_pFence;
     Uint64                m_NextFenceValue      = 1;
     Uint64                m_CompletedFenceValue = 0;
+
+    struct StagingRing
+    {
+        StagingRing(Uint32 Size) :
+            Ring{Size, DefaultRawMemoryAllocator::GetAllocator()}
+        {}
+
+        struct AllocationInfo
+        {
+            const Uint64 Id;
+            // Fence value signaled after the copy is scheduled, or zero if the copy has not been scheduled yet
+            Uint64 FenceValue;
+        };
+
+        RefCntAutoPtr<IBuffer> pBuffer;
+        Uint8*                 pMappedData = nullptr;
+        // Every allocation is a separate ring buffer frame identified by the allocation id.
+        // Allocations are released in order once their copies have been completed by the GPU.
+        RingBuffer                 Ring;
+        std::deque<AllocationInfo> Allocations;
+        Uint64                     NextAllocationId = 1;
+    };
+
+    std::mutex                    m_RingsMtx;
+    std::vector<StagingRing>      m_Rings;
+    Uint32                        m_NumStalledAllocations = 0;
+    RefCntAutoPtr<IDeviceContext> m_pRingContext;
 };
 
+bool TextureUploaderD3D12_Vk::InternalData::TryAllocateFromRings(UploadTexture* pUploadTexture)
+{
+    const auto& Layout = pUploadTexture->GetRingLayout();
+    // Ring buffer only supports power-of-two alignments
+    const auto Alignment = StagingDataPlacementAlignment;
+    const auto Size      = Layout.TotalSize + (Layout.PlacementAlignment - Alignment);
+
+    std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+    for (size_t RingIdx = 0; RingIdx < m_Rings.size(); ++RingIdx)
+    {
+        auto& Ring   = m_Rings[RingIdx];
+        auto  Offset = Ring.Ring.Allocate(Size, Alignment);
+        if (Offset == RingBuffer::InvalidOffset)
+            continue;
+
+        const auto AllocationId = Ring.NextAllocationId++;
+        Ring.Ring.FinishCurrentFrame(AllocationId);
+        Ring.Allocations.push_back({AllocationId, 0});
+
+        Offset = AlignUp(Offset, size_t{Layout.PlacementAlignment});
+        pUploadTexture->SetRingAllocation(RingIdx, AllocationId, Ring.pBuffer, Ring.pMappedData, static_cast<Uint32>(Offset));
+        return true;
+    }
+
+    return false;
+}
+
+bool TextureUploaderD3D12_Vk::InternalData::CreateRing(IDeviceContext* pContext)
+{
+    {
+        std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+        if (m_Desc.StagingMemoryBudget != 0 && Uint64{m_Desc.RingBufferSize} * (m_Rings.size() + 1) > m_Desc.StagingMemoryBudget)
+            return false;
+    }
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = "Texture uploader staging ring buffer";
+    BuffDesc.uiSizeInBytes  = m_Desc.RingBufferSize;
+    BuffDesc.Usage          = USAGE_STAGING;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+
+    StagingRing NewRing{m_Desc.RingBufferSize};
+    m_pDevice->CreateBuffer(BuffDesc, nullptr, &NewRing.pBuffer);
+    if (!NewRing.pBuffer)
+    {
+        LOG_ERROR_MESSAGE("Failed to create staging ring buffer");
+        return false;
+    }
+
+    // Staging buffers in D3D12 and Vulkan can stay mapped while they are used by the GPU
+    PVoid pMappedData = nullptr;
+    pContext->MapBuffer(NewRing.pBuffer, MAP_WRITE, MAP_FLAG_NONE, pMappedData);
+    NewRing.pMappedData = static_cast<Uint8*>(pMappedData);
+    if (NewRing.pMappedData == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to map staging ring buffer");
+        return false;
+    }
+
+    LOG_INFO_MESSAGE("TextureUploaderD3D12_Vk: created ", m_Desc.RingBufferSize, "-byte staging ring buffer");
+
+    m_pRingContext = pContext;
+
+    std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+    m_Rings.emplace_back(std::move(NewRing));
+    return true;
+}
+
+bool TextureUploaderD3D12_Vk::InternalData::AllocateRingRegion(IDeviceContext* pContext, UploadTexture* pUploadTexture, bool CanStall)
+{
+    if (TryAllocateFromRings(pUploadTexture))
+        return true;
+
+    UpdatedCompletedFenceValue();
+    ReleaseCompletedRingSpace();
+    if (TryAllocateFromRings(pUploadTexture))
+        return true;
+
+    if (CreateRing(pContext))
+        return TryAllocateFromRings(pUploadTexture);
+
+    // The budget is exhausted
+    if (!CanStall)
+        return false;
+
+    OnAllocationStalled();
+
+    while (true)
+    {
+        // Find the oldest copy that prevents the space from being released
+        Uint64 FenceToWait = 0;
+        {
+            std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+            for (const auto& Ring : m_Rings)
+            {
+                if (!Ring.Allocations.empty() && Ring.Allocations.front().FenceValue != 0)
+                {
+                    const auto FenceValue = Ring.Allocations.front().FenceValue;
+                    if (FenceToWait == 0 || FenceValue < FenceToWait)
+                        FenceToWait = FenceValue;
+                }
+            }
+        }
+        // If no copy has been scheduled, the space is held by upload buffers
+        // that are still being written, and waiting for the GPU will not help.
+        if (FenceToWait == 0)
+            return false;
+
+        pContext->WaitForFence(m_pFence, FenceToWait, true);
+        UpdatedCompletedFenceValue();
+        ReleaseCompletedRingSpace();
+        if (TryAllocateFromRings(pUploadTexture))
+            return true;
+    }
+}
+
+void TextureUploaderD3D12_Vk::InternalData::OnRingCopyScheduled(UploadTexture* pUploadTexture, Uint64 FenceValue)
+{
+    std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+
+    auto& Ring = m_Rings[pUploadTexture->GetRingIndex()];
+    VERIFY_EXPR(!Ring.Allocations.empty());
+    const auto AllocationIdx = static_cast<size_t>(pUploadTexture->GetRingAllocationId() - Ring.Allocations.front().Id);
+    VERIFY_EXPR(AllocationIdx < Ring.Allocations.size() && Ring.Allocations[AllocationIdx].Id == pUploadTexture->GetRingAllocationId());
+    Ring.Allocations[AllocationIdx].FenceValue = FenceValue;
+}
+
+void TextureUploaderD3D12_Vk::InternalData::ReleaseCompletedRingSpace()
+{
+    std::lock_guard<std::mutex> RingsLock(m_RingsMtx);
+    for (auto& Ring : m_Rings)
+    {
+        Uint64 LastReleasedId = 0;
+        while (!Ring.Allocations.empty())
+        {
+            const auto& Allocation = Ring.Allocations.front();
+            if (Allocation.FenceValue == 0 || Allocation.FenceValue > m_CompletedFenceValue)
+                break;
+            LastReleasedId = Allocation.Id;
+            Ring.Allocations.pop_front();
+        }
+        if (LastReleasedId != 0)
+            Ring.Ring.ReleaseCompletedFrames(LastReleasedId);
+    }
+}
+
+
 TextureUploaderD3D12_Vk::TextureUploaderD3D12_Vk(IReferenceCounters* pRefCounters, IRenderDevice* pDevice, const TextureUploaderDesc Desc) :
     TextureUploaderBase{pRefCounters, pDevice, Desc},
-    m_pInternalData{new InternalData(pDevice)}
+    m_pInternalData{new InternalData(pDevice, Desc)}
 {
 }
 
@@ -294,13 +675,33 @@ TextureUploaderD3D12_Vk::~TextureUploaderD3D12_Vk()
 
 void TextureUploaderD3D12_Vk::RenderThreadUpdate(IDeviceContext* pContext)
 {
+    // Operations that could not be executed last time go first
+    std::vector<InternalData::PendingBufferOperation> DeferredOperations;
+    DeferredOperations.swap(m_pInternalData->m_DeferredOperations);
+    if (!DeferredOperations.empty())
+    {
+        m_pInternalData->UpdatedCompletedFenceValue();
+        m_pInternalData->ReleaseCompletedRingSpace();
+        for (auto& OperationInfo : DeferredOperations)
+        {
+            if (!m_pInternalData->Execute(pContext, OperationInfo))
+                m_pInternalData->m_DeferredOperations.emplace_back(std::move(OperationInfo));
+        }
+    }
+
     auto& InWorkOperations = m_pInternalData->SwapMapQueues();
     if (!InWorkOperations.empty())
     {
         Uint32 NumCopyOperations = 0;
         for (auto& OperationInfo : InWorkOperations)
         {
-            m_pInternalData->Execute(pContext, OperationInfo);
+            if (!m_pInternalData->Execute(pContext, OperationInfo))
+            {
+                // Back-pressure: the worker thread remains blocked until there is enough space in the ring
+                m_pInternalData->OnAllocationStalled();
+                m_pInternalData->m_DeferredOperations.emplace_back(std::move(OperationInfo));
+                continue;
+            }
             if (OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
                 ++NumCopyOperations;
         }
@@ -313,8 +714,12 @@ void TextureUploaderD3D12_Vk::RenderThreadUpdate(IDeviceContext* pContext)
 
             for (auto& OperationInfo : InWorkOperations)
             {
-                if (OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
+                if (OperationInfo.pUploadTexture && OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
+                {
+                    if (OperationInfo.pUploadTexture->IsRingBufferRegion())
+                        m_pInternalData->OnRingCopyScheduled(OperationInfo.pUploadTexture, SignaledFenceValue);
                     OperationInfo.pUploadTexture->SignalCopyScheduled(SignaledFenceValue);
+                }
             }
         }
 
@@ -323,10 +728,11 @@ void TextureUploaderD3D12_Vk::RenderThreadUpdate(IDeviceContext* pContext)
 
     // This must be called by the same thread that signals the fence
     m_pInternalData->UpdatedCompletedFenceValue();
+    m_pInternalData->ReleaseCompletedRingSpace();
 }
 
 
-void TextureUploaderD3D12_Vk::InternalData::Execute(IDeviceContext*         pContext,
+bool TextureUploaderD3D12_Vk::InternalData::Execute(IDeviceContext*         pContext,
                                                     PendingBufferOperation& OperationInfo)
 {
     auto&       pUploadTex     = OperationInfo.pUploadTexture;
@@ -336,11 +742,19 @@ void TextureUploaderD3D12_Vk::InternalData::Execute(IDeviceContext*         pCon
     {
         case InternalData::PendingBufferOperation::Map:
         {
-            for (Uint32 Slice = 0; Slice < StagingTexDesc.ArraySize; ++Slice)
+            if (pUploadTex->IsRingBufferRegion())
             {
-                for (Uint32 Mip = 0; Mip < StagingTexDesc.MipLevels; ++Mip)
+                if (!AllocateRingRegion(pContext, pUploadTex, false))
+                    return false;
+            }
+            else
+            {
+                for (Uint32 Slice = 0; Slice < StagingTexDesc.ArraySize; ++Slice)
                 {
-                    pUploadTex->Map(pContext, Mip, Slice);
+                    for (Uint32 Mip = 0; Mip < StagingTexDesc.MipLevels; ++Mip)
+                    {
+                        pUploadTex->Map(pContext, Mip, Slice);
+                    }
                 }
             }
             pUploadTex->SignalMapped();
@@ -354,32 +768,92 @@ void TextureUploaderD3D12_Vk::InternalData::Execute(IDeviceContext*         pCon
             {
                 for (Uint32 Mip = 0; Mip < StagingTexDesc.MipLevels; ++Mip)
                 {
+                    const auto SrcStride      = pUploadTex->GetMappedData(Mip, Slice).Stride;
+                    const auto SrcDepthStride = pUploadTex->GetMappedData(Mip, Slice).DepthStride;
                     pUploadTex->Unmap(pContext, Mip, Slice);
 
-                    CopyTextureAttribs CopyInfo //
-                        {
-                            pUploadTex->GetStagingTexture(),
-                            RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
-                            OperationInfo.pDstTexture,
-                            RESOURCE_STATE_TRANSITION_MODE_TRANSITION //
-                        };
-                    CopyInfo.SrcMipLevel = Mip;
-                    CopyInfo.SrcSlice    = Slice;
-                    CopyInfo.DstMipLevel = OperationInfo.DstMip + Mip;
-                    CopyInfo.DstSlice    = OperationInfo.DstSlice + Slice;
-                    pContext->CopyTexture(CopyInfo);
+                    if (pUploadTex->IsRingBufferRegion())
+                    {
+                        // Like CopyTexture() in the staging texture path, the copy region is
+                        // the size of the upload buffer mip level, not the destination mip level.
+                        const auto& DstBox = pUploadTex->GetRingRegion(Mip, Slice);
+
+                        TextureSubResData SubResData{pUploadTex->GetRingBuffer(), pUploadTex->GetRingOffset(Mip, Slice), SrcStride, SrcDepthStride};
+                        pContext->UpdateTexture(OperationInfo.pDstTexture, OperationInfo.DstMip + Mip, OperationInfo.DstSlice + Slice, DstBox,
+                                                SubResData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+                    }
+                    else
+                    {
+                        CopyTextureAttribs CopyInfo //
+                            {
+                                pUploadTex->GetStagingTexture(),
+                                RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                OperationInfo.pDstTexture,
+                                RESOURCE_STATE_TRANSITION_MODE_TRANSITION //
+                            };
+                        CopyInfo.SrcMipLevel = Mip;
+                        CopyInfo.SrcSlice    = Slice;
+                        CopyInfo.DstMipLevel = OperationInfo.DstMip + Mip;
+                        CopyInfo.DstSlice    = OperationInfo.DstSlice + Slice;
+                        pContext->CopyTexture(CopyInfo);
+                    }
                 }
             }
         }
         break;
     }
+
+    return true;
 }
 
 void TextureUploaderD3D12_Vk::AllocateUploadBuffer(IDeviceContext*         pContext,
                                                    const UploadBufferDesc& Desc,
                                                    IUploadBuffer**         ppBuffer)
 {
-    RefCntAutoPtr<UploadTexture> pUploadTexture = m_pInternalData->FindCachedUploadTexture(Desc);
+    RefCntAutoPtr<UploadTexture> pUploadTexture;
+
+    if (m_Desc.RingBufferSize != 0)
+    {
+        StagingBufferLayout Layout{Desc};
+        if (Layout.TotalSize + (Layout.PlacementAlignment - StagingDataPlacementAlignment) <= m_Desc.RingBufferSize)
+        {
+            pUploadTexture = MakeNewRCObj<UploadTexture>()(Desc, std::move(Layout));
+            if (m_pInternalData->TryAllocateFromRings(pUploadTexture))
+            {
+                // The region is already mapped, no render-thread operation is required
+                pUploadTexture->SignalMapped();
+            }
+            else if (pContext != nullptr)
+            {
+                // Render thread
+                if (m_pInternalData->AllocateRingRegion(pContext, pUploadTexture, true))
+                {
+                    pUploadTexture->SignalMapped();
+                }
+                else
+                {
+                    LOG_WARNING_MESSAGE("TextureUploaderD3D12_Vk: staging memory budget is exhausted and no space can be released "
+                                        "by waiting for the GPU. Falling back to a staging texture.");
+                    pUploadTexture.Release();
+                }
+            }
+            else
+            {
+                // Worker thread. The allocation may be deferred by the render thread
+                // until the GPU releases enough space in the ring.
+                m_pInternalData->EnqueMap(pUploadTexture);
+                pUploadTexture->WaitForMap();
+            }
+
+            if (pUploadTexture)
+            {
+                *ppBuffer = pUploadTexture.Detach();
+                return;
+            }
+        }
+    }
+
+    pUploadTexture = m_pInternalData->FindCachedUploadTexture(Desc);
 
     // No available buffer found in the cache
     if (!pUploadTexture)
@@ -442,6 +916,8 @@ void TextureUploaderD3D12_Vk::ScheduleGPUCopy(IDeviceContext* pContext,
         // The buffer may be recycled immediately after the copy scheduled is signaled,
         // so we must signal the fence first.
         auto SignaledFenceValue = m_pInternalData->SignalFence(pContext);
+        if (pUploadTexture->IsRingBufferRegion())
+            m_pInternalData->OnRingCopyScheduled(pUploadTexture, SignaledFenceValue);
         pUploadTexture->SignalCopyScheduled(SignaledFenceValue);
         // This must be called by the same thread that signals the fence
         m_pInternalData->UpdatedCompletedFenceValue();
@@ -458,13 +934,17 @@ void TextureUploaderD3D12_Vk::RecycleBuffer(IUploadBuffer* pUploadBuffer)
     auto* pUploadTexture = ValidatedCast<UploadTexture>(pUploadBuffer);
     VERIFY(pUploadTexture->DbgIsCopyScheduled(), "Upload buffer must be recycled only after copy operation has been scheduled on the GPU");
 
-    m_pInternalData->RecycleUploadTexture(pUploadTexture);
+    // Ring buffer space is released when the GPU completes the copy, and
+    // the region object itself is not reused
+    if (!pUploadTexture->IsRingBufferRegion())
+        m_pInternalData->RecycleUploadTexture(pUploadTexture);
 }
 
 TextureUploaderStats TextureUploaderD3D12_Vk::GetStats()
 {
     TextureUploaderStats Stats;
     Stats.NumPendingOperations = static_cast<Uint32>(m_pInternalData->GetNumPendingOperations());
+    m_pInternalData->GetRingStats(Stats);
     return Stats;
 }
 
@@ -195,22 +195,120 @@ struct TextureUploaderGL::InternalData
         // clang-format on
     };
 
-    void Execute(IRenderDevice*          pDevice,
+    // Returns false if the operation could not be completed and must be retried later
+    bool Execute(IRenderDevice*          pDevice,
                  IDeviceContext*         pContext,
                  PendingBufferOperation& OperationInfo);
 
+    bool   m_UsePooledStagingBuffers = false;
+    Uint64 m_StagingMemoryBudget     = 0;
+
+    // Map operations that were deferred because the budget was exhausted. Render-thread only.
+    std::vector<PendingBufferOperation> m_DeferredOperations;
+
     std::mutex                          m_PendingOperationsMtx;
     std::vector<PendingBufferOperation> m_PendingOperations;
     std::vector<PendingBufferOperation> m_InWorkOperations;
 
     std::mutex                                                                      m_UploadBuffCacheMtx;
     std::unordered_map<UploadBufferDesc, std::deque<RefCntAutoPtr<UploadBufferGL>>> m_UploadBufferCache;
+
+    // Returns null if the budget is exhausted, unless IgnoreBudget is true
+    RefCntAutoPtr<IBuffer> AcquireStagingBuffer(IRenderDevice* pDevice, Uint32 Size, bool IgnoreBudget);
+    void                   ReleaseStagingBuffer(RefCntAutoPtr<IBuffer>&& pStagingBuffer);
+
+    void OnAllocationStalled()
+    {
+        std::lock_guard<std::mutex> CacheLock(m_UploadBuffCacheMtx);
+        ++m_NumStalledAllocations;
+    }
+
+    // Staging buffers pooled by power-of-two size. Unlike D3D12 and Vulkan, OpenGL
+    // buffers can't stay mapped while they are used as the copy source, so instead
+    // of sub-allocating from a ring, buffers are shared by uploads of similar size.
+    // Buffers are acquired and released by the render thread only.
+    // Protected by m_UploadBuffCacheMtx.
+    std::unordered_map<Uint32, std::vector<RefCntAutoPtr<IBuffer>>> m_StagingBufferPool;
+    Uint64                                                          m_PooledStagingMemorySize = 0;
+    Uint64                                                          m_StagingMemoryInUse      = 0;
+    Uint32                                                          m_NumStalledAllocations   = 0;
 };
 
+RefCntAutoPtr<IBuffer> TextureUploaderGL::InternalData::AcquireStagingBuffer(IRenderDevice* pDevice, Uint32 Size, bool IgnoreBudget)
+{
+    Uint32 PooledSize = 256;
+    while (PooledSize < Size)
+        PooledSize *= 2;
+
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    {
+        std::lock_guard<std::mutex> CacheLock(m_UploadBuffCacheMtx);
+
+        auto& Pool = m_StagingBufferPool[PooledSize];
+        if (!Pool.empty())
+        {
+            pStagingBuffer = std::move(Pool.back());
+            Pool.pop_back();
+            m_PooledStagingMemorySize -= PooledSize;
+        }
+        else if (m_StagingMemoryBudget != 0 && m_StagingMemoryInUse + m_PooledStagingMemorySize + PooledSize > m_StagingMemoryBudget)
+        {
+            // Release pooled buffers of other sizes to make room for the new one
+            for (auto& SizeAndPool : m_StagingBufferPool)
+            {
+                auto& OtherPool = SizeAndPool.second;
+                while (!OtherPool.empty() && m_StagingMemoryInUse + m_PooledStagingMemorySize + PooledSize > m_StagingMemoryBudget)
+                {
+                    OtherPool.pop_back();
+                    m_PooledStagingMemorySize -= SizeAndPool.first;
+                }
+            }
+
+            // Buffers in use return to the pool when their copies are scheduled. If no buffer
+            // is in use, this upload alone exceeds the budget and there is nothing to wait for.
+            if (!IgnoreBudget && m_StagingMemoryInUse != 0 && m_StagingMemoryInUse + PooledSize > m_StagingMemoryBudget)
+                return RefCntAutoPtr<IBuffer>{};
+        }
+        m_StagingMemoryInUse += PooledSize;
+    }
+
+    if (!pStagingBuffer)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name           = "Pooled staging buffer for UploadBufferGL";
+        BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+        BuffDesc.Usage          = USAGE_STAGING;
+        BuffDesc.uiSizeInBytes  = PooledSize;
+        pDevice->CreateBuffer(BuffDesc, nullptr, &pStagingBuffer);
+    }
+
+    return pStagingBuffer;
+}
+
+void TextureUploaderGL::InternalData::ReleaseStagingBuffer(RefCntAutoPtr<IBuffer>&& pStagingBuffer)
+{
+    const auto Size = pStagingBuffer->GetDesc().uiSizeInBytes;
+
+    std::lock_guard<std::mutex> CacheLock(m_UploadBuffCacheMtx);
+    VERIFY_EXPR(m_StagingMemoryInUse >= Size);
+    m_StagingMemoryInUse -= Size;
+    if (m_StagingMemoryBudget != 0 && m_StagingMemoryInUse + m_PooledStagingMemorySize + Size > m_StagingMemoryBudget)
+    {
+        // Release the buffer to stay within the budget
+        pStagingBuffer.Release();
+        return;
+    }
+
+    m_StagingBufferPool[Size].emplace_back(std::move(pStagingBuffer));
+    m_PooledStagingMemorySize += Size;
+}
+
 TextureUploaderGL::TextureUploaderGL(IReferenceCounters* pRefCounters, IRenderDevice* pDevice, const TextureUploaderDesc Desc) :
     TextureUploaderBase{pRefCounters, pDevice, Desc},
     m_pInternalData{new InternalData{}}
 {
+    m_pInternalData->m_UsePooledStagingBuffers = Desc.RingBufferSize != 0;
+    m_pInternalData->m_StagingMemoryBudget     = Desc.StagingMemoryBudget;
 }
 
 TextureUploaderGL::~TextureUploaderGL()
@@ -239,17 +337,41 @@ TextureUploaderGL::~TextureUploaderGL()
 void TextureUploaderGL::RenderThreadUpdate(IDeviceContext* pContext)
 {
     m_pInternalData->SwapMapQueues();
-    if (!m_pInternalData->m_InWorkOperations.empty())
+    auto& InWorkOperations = m_pInternalData->m_InWorkOperations;
+
+    // Copy operations return pooled staging buffers, so they go first. A map operation
+    // for the same upload buffer can't be in the queue as the buffer must be mapped
+    // before the copy is scheduled.
+    for (auto& OperationInfo : InWorkOperations)
     {
-        for (auto& OperationInfo : m_pInternalData->m_InWorkOperations)
-        {
+        if (OperationInfo.operation == InternalData::PendingBufferOperation::Copy)
             m_pInternalData->Execute(m_pDevice, pContext, OperationInfo);
+    }
+
+    // Map operations that could not be executed last time go next
+    std::vector<InternalData::PendingBufferOperation> DeferredOperations;
+    DeferredOperations.swap(m_pInternalData->m_DeferredOperations);
+    for (auto& OperationInfo : DeferredOperations)
+    {
+        if (!m_pInternalData->Execute(m_pDevice, pContext, OperationInfo))
+            m_pInternalData->m_DeferredOperations.emplace_back(std::move(OperationInfo));
+    }
+
+    for (auto& OperationInfo : InWorkOperations)
+    {
+        if (OperationInfo.operation == InternalData::PendingBufferOperation::Map &&
+            !m_pInternalData->Execute(m_pDevice, pContext, OperationInfo))
+        {
+            // Back-pressure: the worker thread remains blocked until staging memory is released
+            m_pInternalData->OnAllocationStalled();
+            m_pInternalData->m_DeferredOperations.emplace_back(std::move(OperationInfo));
         }
-        m_pInternalData->m_InWorkOperations.clear();
     }
+
+    InWorkOperations.clear();
 }
 
-void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
+bool TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
                                               IDeviceContext*         pContext,
                                               PendingBufferOperation& OperationInfo)
 {
@@ -260,7 +382,13 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
     {
         case InternalData::PendingBufferOperation::Map:
         {
-            if (pBuffer->m_pStagingBuffer == nullptr)
+            if (pBuffer->m_pStagingBuffer == nullptr && m_UsePooledStagingBuffers)
+            {
+                pBuffer->m_pStagingBuffer = AcquireStagingBuffer(pDevice, pBuffer->GetTotalSize(), false);
+                if (pBuffer->m_pStagingBuffer == nullptr)
+                    return false;
+            }
+            else if (pBuffer->m_pStagingBuffer == nullptr)
             {
                 BufferDesc BuffDesc;
                 BuffDesc.Name           = "Staging buffer for UploadBufferGL";
@@ -281,7 +409,6 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
 
         case InternalData::PendingBufferOperation::Copy:
         {
-            const auto& TexDesc = OperationInfo.pDstTexture->GetDesc();
             pContext->UnmapBuffer(pBuffer->m_pStagingBuffer, MAP_WRITE);
             for (Uint32 Slice = 0; Slice < UploadBuffDesc.ArraySize; ++Slice)
             {
@@ -292,18 +419,27 @@ void TextureUploaderGL::InternalData::Execute(IRenderDevice*          pDevice,
 
                     TextureSubResData SubResData(pBuffer->m_pStagingBuffer, SrcOffset, SrcStride);
 
-                    auto MipLevelProps = GetMipLevelProperties(TexDesc, OperationInfo.DstMip + Mip);
-                    Box  DstBox;
-                    DstBox.MaxX = MipLevelProps.LogicalWidth;
-                    DstBox.MaxY = MipLevelProps.LogicalHeight;
+                    // The copy region is the size of the upload buffer mip level, which
+                    // may be smaller than the destination mip level
+                    Box DstBox;
+                    DstBox.MaxX = std::max(UploadBuffDesc.Width >> Mip, 1u);
+                    DstBox.MaxY = std::max(UploadBuffDesc.Height >> Mip, 1u);
                     pContext->UpdateTexture(OperationInfo.pDstTexture, OperationInfo.DstMip + Mip, OperationInfo.DstSlice + Slice, DstBox,
                                             SubResData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
                 }
             }
+            if (m_UsePooledStagingBuffers)
+            {
+                // The copy has been recorded into the GL command stream, and the next MapBuffer()
+                // with MAP_FLAG_DISCARD orphans the storage, so the buffer can be reused right away
+                ReleaseStagingBuffer(std::move(pBuffer->m_pStagingBuffer));
+            }
             pBuffer->SignalCopyScheduled();
         }
         break;
     }
+
+    return true;
 }
 
 void TextureUploaderGL::AllocateUploadBuffer(IDeviceContext*         pContext,
@@ -331,7 +467,12 @@ void TextureUploaderGL::AllocateUploadBuffer(IDeviceContext*         pContext,
         }
     }
 
-    if (!pUploadBuffer)
+    if (!pUploadBuffer && m_pInternalData->m_UsePooledStagingBuffers)
+    {
+        // The staging buffer is taken from the pool when the upload buffer is mapped
+        pUploadBuffer = MakeNewRCObj<UploadBufferGL>()(Desc);
+    }
+    else if (!pUploadBuffer)
     {
         pUploadBuffer = MakeNewRCObj<UploadBufferGL>()(Desc);
         LOG_INFO_MESSAGE("TextureUploaderGL: created upload buffer for ", Desc.Width, 'x', Desc.Height, 'x',
@@ -342,6 +483,24 @@ void TextureUploaderGL::AllocateUploadBuffer(IDeviceContext*         pContext,
     if (pContext != nullptr)
     {
         // Render thread
+        if (m_pInternalData->m_UsePooledStagingBuffers)
+        {
+            auto& pStagingBuffer = pUploadBuffer->m_pStagingBuffer;
+            pStagingBuffer       = m_pInternalData->AcquireStagingBuffer(m_pDevice, pUploadBuffer->GetTotalSize(), false);
+            if (!pStagingBuffer)
+            {
+                // Copies scheduled by worker threads return their staging buffers to the pool
+                m_pInternalData->OnAllocationStalled();
+                RenderThreadUpdate(pContext);
+                pStagingBuffer = m_pInternalData->AcquireStagingBuffer(m_pDevice, pUploadBuffer->GetTotalSize(), false);
+            }
+            if (!pStagingBuffer)
+            {
+                LOG_WARNING_MESSAGE("TextureUploaderGL: staging memory budget is exhausted by upload buffers that have not been "
+                                    "copied yet. The render thread can't wait for them, so the budget will be exceeded.");
+                pStagingBuffer = m_pInternalData->AcquireStagingBuffer(m_pDevice, pUploadBuffer->GetTotalSize(), true);
+            }
+        }
         InternalData::PendingBufferOperation MapOp{InternalData::PendingBufferOperation::Operation::Map, pUploadBuffer};
         m_pInternalData->Execute(m_pDevice, pContext, MapOp);
     }
@@ -385,6 +544,14 @@ void TextureUploaderGL::RecycleBuffer(IUploadBuffer* pUploadBuffer)
 {
     auto* pUploadBufferGL = ValidatedCast<UploadBufferGL>(pUploadBuffer);
     VERIFY(pUploadBufferGL->DbgIsCopyScheduled(), "Upload buffer must be recycled only after copy operation has been scheduled on the GPU");
+    if (m_pInternalData->m_UsePooledStagingBuffers)
+    {
+        // The staging buffer has been returned to the pool when the copy was scheduled,
+        // and the upload buffer object itself is not reused
+        VERIFY_EXPR(pUploadBufferGL->m_pStagingBuffer == nullptr);
+        return;
+    }
+
     pUploadBufferGL->Reset();
 
     std::lock_guard<std::mutex> CacheLock(m_pInternalData->m_UploadBuffCacheMtx);
@@ -399,6 +566,12 @@ TextureUploaderStats TextureUploaderGL::GetStats()
     TextureUploaderStats        Stats;
     std::lock_guard<std::mutex> QueueLock(m_pInternalData->m_PendingOperationsMtx);
     Stats.NumPendingOperations = static_cast<Uint32>(m_pInternalData->m_PendingOperations.size());
+    {
+        std::lock_guard<std::mutex> CacheLock(m_pInternalData->m_UploadBuffCacheMtx);
+        Stats.StagingMemorySize     = m_pInternalData->m_PooledStagingMemorySize + m_pInternalData->m_StagingMemoryInUse;
+        Stats.StagingMemoryInUse    = m_pInternalData->m_StagingMemoryInUse;
+        Stats.NumStalledAllocations = m_pInternalData->m_NumStalledAllocations;
+    }
     return Stats;
 }
 
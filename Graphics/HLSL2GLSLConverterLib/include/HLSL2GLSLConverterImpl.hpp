@@ -32,9 +32,11 @@
 #include <unordered_map>
 #include <vector>
 #include <array>
+#include <mutex>
 
 #include "HLSL2GLSLConverter.h"
 #include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
 #include "HLSLKeywords.h"
 #include "Shader.h"
 #include "HashUtils.hpp"
@@ -90,11 +92,31 @@ struct FunctionStubHashKey
 };
 
 /// HLSL to GLSL shader source code converter implementation
+
+/// The converter is a singleton whose keyword, semantic and GLSL definition tables
+/// are immutable after construction. Conversion streams never modify their tokenized
+/// source and can be used by multiple threads simultaneously.
 class HLSL2GLSLConverterImpl
 {
 public:
     static const HLSL2GLSLConverterImpl& GetInstance();
 
+    /// Dead code elimination statistics
+    struct DeadCodeEliminationStats
+    {
+        /// Number of removed functions, including GLSL definition functions
+        Uint32 NumRemovedFunctions = 0;
+
+        /// Number of removed structures
+        Uint32 NumRemovedStructs = 0;
+
+        /// Number of removed resources (uniform blocks, storage blocks, samplers and images)
+        Uint32 NumRemovedResources = 0;
+
+        /// Number of removed global variables
+        Uint32 NumRemovedVariables = 0;
+    };
+
     // clang-format off
 
     /// Conversion attributes
@@ -104,7 +126,12 @@ public:
         /// well as to load shader includes.
         IShaderSourceInputStreamFactory*    pSourceStreamFactory       = nullptr;
 
-        /// Optional pointer to a conversion stream.
+        /// Optional pointer to a conversion stream. If the stream is null or was created
+        /// for another input file, a new stream is created and written to this address.
+        /// Multiple threads may convert using the same address simultaneously: creation
+        /// and replacement of the stream are atomic, and the replaced stream remains valid
+        /// until all threads that use it are done. While conversions are in progress, the
+        /// address must not be accessed other than through the converter.
         IHLSL2GLSLConversionStream**        ppConversionStream         = nullptr;
 
         /// HLSL source code. Can be null, in which case the source code will be loaded from the
@@ -135,6 +162,18 @@ public:
         /// This requires separate shader objects extension:
         /// https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_separate_shader_objects.txt
         bool                                UseInOutLocationQualifiers = true;
+
+        /// Shader macros that will be defined when the converted source is compiled.
+        /// Identifiers used in the macro definitions are treated as referenced by the shader.
+        const ShaderMacro*                  Macros                     = nullptr;
+
+        /// Whether to remove functions, structures, global variables and resources
+        /// (including those from GLSL definitions) that are not reachable from the
+        /// shader entry point.
+        bool                                EliminateDeadCode          = true;
+
+        /// Optional pointer to the structure that receives dead code elimination statistics.
+        DeadCodeEliminationStats*           pDCEStats                  = nullptr;
     };
 
     // clang-format on
@@ -145,6 +184,40 @@ public:
     /// \return     Converted GLSL source code.
     String Convert(ConversionAttribs& Attribs) const;
 
+    /// Entry point converted by ConvertBatch()
+    struct BatchEntryPoint
+    {
+        /// Shader entry point.
+        const Char* EntryPoint = nullptr;
+
+        /// Shader type. See Diligent::SHADER_TYPE.
+        SHADER_TYPE ShaderType = SHADER_TYPE_UNKNOWN;
+
+        /// Converted GLSL source code. Empty if the conversion failed.
+        String GLSLSource;
+
+        /// Dead code elimination statistics.
+        DeadCodeEliminationStats DCEStats;
+    };
+
+    /// Converts multiple entry points of the same HLSL source to GLSL
+
+    /// \param [in] Attribs             - Conversion attributes. EntryPoint, ShaderType and pDCEStats
+    ///                                   members are ignored. The conversion stream is reused or created
+    ///                                   the same way as by Convert().
+    /// \param [in, out] pEntryPoints    - Entry points to convert. Converted source code and statistics
+    ///                                   are written to every element of the array.
+    /// \param [in] NumEntryPoints      - Number of elements in pEntryPoints array.
+    /// \param [in] NumThreads          - Number of threads to use, including the calling thread.
+    /// \return     The number of entry points that were successfully converted.
+    ///
+    /// \remarks    The source is loaded and tokenized only once. Every thread converts its entry points
+    ///             using its own scratch copy of the tokens that is reused between the entry points.
+    Uint32 ConvertBatch(ConversionAttribs& Attribs,
+                        BatchEntryPoint*   pEntryPoints,
+                        Uint32             NumEntryPoints,
+                        Uint32             NumThreads = 1) const;
+
     /// Creates a conversion stream
 
     /// \param [in] InputFileName - Input file name. If HLSLSource is null, this name will be
@@ -166,6 +239,11 @@ public:
 private:
     HLSL2GLSLConverterImpl();
 
+    class ConversionStream;
+
+    // Returns the stream referenced by Attribs.ppConversionStream, creating a new one if necessary
+    RefCntAutoPtr<ConversionStream> GetConversionStream(ConversionAttribs& Attribs) const;
+
     struct HLSLObjectInfo
     {
         String GLSLType;      // sampler2D, sampler2DShadow, image2D, etc.
@@ -271,6 +349,39 @@ private:
     };
     typedef std::list<TokenInfo> TokenListType;
 
+    void Tokenize(const String& Source, TokenListType& Tokens) const;
+
+    // Global-scope declaration used by the dead code elimination pass
+    struct GlobalDeclaration
+    {
+        enum class DeclarationType : Uint8
+        {
+            Directive, // Preprocessor directive or text block; always kept
+            Macro,     // Macro definition; always kept, references are followed only when the macro is used
+            Pinned,    // Declaration that is never removed (shader interface, built-in redeclaration, etc.)
+            Function,
+            Struct,
+            Resource, // Uniform block, storage block, sampler or image
+            Variable
+        };
+        DeclarationType Type = DeclarationType::Pinned;
+
+        // [Start, End) token range of the declaration
+        TokenListType::iterator Start;
+        TokenListType::iterator End;
+
+        // Symbols defined by the declaration
+        std::vector<String> Names;
+
+        // Unique identifiers referenced by the declaration
+        std::vector<String> Refs;
+    };
+    typedef std::unordered_map<String, std::vector<size_t>> SymbolMapType;
+
+    // Splits the token list into global-scope declarations.
+    // Returns false if the scopes are not balanced.
+    static bool ParseGlobalDeclarations(TokenListType& Tokens, std::vector<GlobalDeclaration>& Decls);
+
 
     class ConversionStream : public ObjectBase<IHLSL2GLSLConversionStream>
     {
@@ -300,11 +411,23 @@ private:
                          size_t                           NumSymbols,
                          bool                             bPreserveTokens);
 
-        String Convert(const Char* EntryPoint,
-                       SHADER_TYPE ShaderType,
-                       bool        IncludeDefintions,
-                       const char* SamplerSuffix,
-                       bool        UseInOutLocationQualifiers);
+        /// Creates a scratch stream that holds a copy of the source stream tokens.
+        explicit ConversionStream(const ConversionStream& SrcStream);
+
+        /// Replaces the tokens of a scratch stream with the source stream tokens,
+        /// reusing the allocated list nodes and strings.
+        void ResetTokens(const ConversionStream& SrcStream);
+
+        /// Converts the stream. If the stream preserves its tokens, the conversion is
+        /// performed on a scratch copy and the stream itself is not modified.
+        String Convert(const Char*               EntryPoint,
+                       SHADER_TYPE               ShaderType,
+                       bool                      IncludeDefintions,
+                       const char*               SamplerSuffix,
+                       bool                      UseInOutLocationQualifiers,
+                       bool                      bEliminateDeadCode,
+                       const ShaderMacro*        Macros,
+                       DeadCodeEliminationStats* pDCEStats);
 
         virtual void DILIGENT_CALL_TYPE Convert(const Char* EntryPoint,
                                                 SHADER_TYPE ShaderType,
@@ -313,13 +436,23 @@ private:
                                                 bool        UseInOutLocationQualifiers,
                                                 IDataBlob** ppGLSLSource) override final;
 
+        /// Converts the stream tokens in place. The stream can't be used for other conversions
+        /// until its tokens are reset.
+        String ConvertTokens(const Char*               EntryPoint,
+                             SHADER_TYPE               ShaderType,
+                             bool                      IncludeDefintions,
+                             const char*               SamplerSuffix,
+                             bool                      UseInOutLocationQualifiers,
+                             bool                      bEliminateDeadCode,
+                             const ShaderMacro*        Macros,
+                             DeadCodeEliminationStats* pDCEStats);
+
         IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_HLSL2GLSLConversionStream, TBase)
 
         const String& GetInputFileName() const { return m_InputFileName; }
 
     private:
         void InsertIncludes(String& GLSLSource, IShaderSourceInputStreamFactory* pSourceStreamFactory);
-        void Tokenize(const String& Source);
 
         typedef std::unordered_map<String, bool> SamplerHashType;
 
@@ -501,6 +634,14 @@ private:
                                           const String&            OutStreamName,
                                           const char*              EntryPoint);
 
+        // Removes global declarations that are not reachable from the shader entry point.
+        // If IncludeDefinitions is true, writes the GLSL definitions referenced by the shader
+        // to Definitions. Returns false if the source could not be analyzed.
+        bool EliminateDeadCode(const ShaderMacro*        Macros,
+                               bool                      IncludeDefinitions,
+                               String&                   Definitions,
+                               DeadCodeEliminationStats* pDCEStats);
+
         String BuildGLSLSource();
 
         // Tokenized source code
@@ -545,6 +686,16 @@ private:
     static constexpr int MaxShaderStages = 6; // Maximum supported shader stages: VS, GS, PS, DS, HS, CS
 
     std::array<std::array<std::unordered_map<HashMapStringKey, String, HashMapStringKey::Hasher>, 2>, MaxShaderStages> m_HLSLSemanticToGLSLVar;
+
+    // Tokenized GLSL definitions split into global declarations, and the map from
+    // symbol name to the indices of declarations that define it. Used to only include
+    // the definitions that are referenced by the converted shader.
+    TokenListType                  m_GLSLDefinitionTokens;
+    std::vector<GlobalDeclaration> m_GLSLDefinitionDecls;
+    SymbolMapType                  m_GLSLDefinitionSymbols;
+
+    // Protects the stream pointers passed in ConversionAttribs::ppConversionStream
+    mutable std::mutex m_ConversionStreamMtx;
 };
 
 } // namespace Diligent
@@ -355,6 +355,8 @@
 
 #include "pch.h"
 #include <unordered_set>
+#include <algorithm>
+#include <atomic>
 #include <string>
 
 #include "HLSL2GLSLConverterImpl.hpp"
@@ -363,6 +365,7 @@
 #include "StringDataBlobImpl.hpp"
 #include "StringTools.hpp"
 #include "EngineMemory.h"
+#include "WorkerThreadPool.hpp"
 
 using namespace std;
 
@@ -766,6 +769,23 @@ HLSL2GLSLConverterImpl::HLSL2GLSLConverterImpl()
     DEFINE_VARIABLE(CSInd, InVar, "sv_groupthreadid", "_GET_GL_LOCAL_INVOCATION_ID");
     DEFINE_VARIABLE(CSInd, InVar, "sv_groupindex", "_GET_GL_LOCAL_INVOCATION_INDEX");
 #undef DEFINE_VARIABLE
+
+    // Split GLSL definitions into global declarations so that only the definitions
+    // that are referenced by the converted shader are included into the output
+    Tokenize(g_GLSLDefinitions, m_GLSLDefinitionTokens);
+    if (ParseGlobalDeclarations(m_GLSLDefinitionTokens, m_GLSLDefinitionDecls))
+    {
+        for (size_t i = 0; i < m_GLSLDefinitionDecls.size(); ++i)
+        {
+            for (const auto& Name : m_GLSLDefinitionDecls[i].Names)
+                m_GLSLDefinitionSymbols[Name].push_back(i);
+        }
+    }
+    else
+    {
+        UNEXPECTED("Failed to parse GLSL definitions");
+        m_GLSLDefinitionDecls.clear();
+    }
 }
 
 String CompressNewLines(const String& Str)
@@ -1115,7 +1135,7 @@ void ReadNumericConstant(const String& Source, String::const_iterator& Pos, Stri
 
 
 // The function convertes source code into a token list
-void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
+void HLSL2GLSLConverterImpl::Tokenize(const String& Source, TokenListType& Tokens) const
 {
 #define CHECK_END(...)                      \
     do                                      \
@@ -1133,7 +1153,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 
     // Push empty node in the beginning of the list to facilitate
     // backwards searching
-    m_Tokens.push_back(TokenInfo());
+    Tokens.push_back(TokenInfo());
 
     // https://msdn.microsoft.com/en-us/library/windows/desktop/bb509638(v=vs.85).aspx
 
@@ -1178,9 +1198,9 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                 break;
 
             case '=':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "")
+                if (Tokens.size() > 0 && NewToken.Delimiter == "")
                 {
-                    auto& LastToken = m_Tokens.back();
+                    auto& LastToken = Tokens.back();
                     // +=, -=, *=, /=, %=, <<=, >>=, &=, |=, ^=
                     if (LastToken.Literal == "+" ||
                         LastToken.Literal == "-" ||
@@ -1214,11 +1234,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 
             case '|':
             case '&':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
-                    m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
+                if (Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                    Tokens.back().Literal.length() == 1 && Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::BooleanOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    Tokens.back().Type = TokenType::BooleanOp;
+                    Tokens.back().Literal.push_back(*(SrcPos++));
                     continue;
                 }
                 else
@@ -1230,11 +1250,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 
             case '<':
             case '>':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
-                    m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
+                if (Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                    Tokens.back().Literal.length() == 1 && Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::BitwiseOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    Tokens.back().Type = TokenType::BitwiseOp;
+                    Tokens.back().Literal.push_back(*(SrcPos++));
                     continue;
                 }
                 else
@@ -1249,11 +1269,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 
             case '+':
             case '-':
-                if (m_Tokens.size() > 0 && NewToken.Delimiter == "" &&
-                    m_Tokens.back().Literal.length() == 1 && m_Tokens.back().Literal[0] == *SrcPos)
+                if (Tokens.size() > 0 && NewToken.Delimiter == "" &&
+                    Tokens.back().Literal.length() == 1 && Tokens.back().Literal[0] == *SrcPos)
                 {
-                    m_Tokens.back().Type = TokenType::IncDecOp;
-                    m_Tokens.back().Literal.push_back(*(SrcPos++));
+                    Tokens.back().Type = TokenType::IncDecOp;
+                    Tokens.back().Literal.push_back(*(SrcPos++));
                     continue;
                 }
                 else
@@ -1330,8 +1350,8 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
                     auto IDSize = SrcPos - IdentifierStartPos;
                     NewToken.Literal.reserve(IDSize);
                     NewToken.Literal.append(IdentifierStartPos, SrcPos);
-                    auto KeywordIt = m_Converter.m_HLSLKeywords.find(NewToken.Literal.c_str());
-                    if (KeywordIt != m_Converter.m_HLSLKeywords.end())
+                    auto KeywordIt = m_HLSLKeywords.find(NewToken.Literal.c_str());
+                    if (KeywordIt != m_HLSLKeywords.end())
                     {
                         NewToken.Type = KeywordIt->second.Type;
                         VERIFY(NewToken.Literal == KeywordIt->second.Literal, "Inconsistent literal");
@@ -1366,7 +1386,7 @@ void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
             }
         }
 
-        m_Tokens.push_back(NewToken);
+        Tokens.push_back(NewToken);
     }
 #undef CHECK_END
 }
@@ -4557,6 +4577,448 @@ void HLSL2GLSLConverterImpl::ConversionStream::RemoveSpecialShaderAttributes()
     );
 }
 
+// Appends all identifiers found in the string to the list
+static void ExtractIdentifiers(const String& Str, std::vector<String>& Identifiers)
+{
+    auto Pos = Str.begin();
+    while (Pos != Str.end())
+    {
+        if (isalpha(*Pos) || *Pos == '_')
+        {
+            auto IdStart = Pos;
+            while (Pos != Str.end() && (isalnum(*Pos) || *Pos == '_'))
+                ++Pos;
+            Identifiers.emplace_back(IdStart, Pos);
+        }
+        else if (isdigit(*Pos))
+        {
+            // Skip numeric constants such as 0x1F or 1e-5f
+            while (Pos != Str.end() && (isalnum(*Pos) || *Pos == '_' || *Pos == '.'))
+                ++Pos;
+        }
+        else
+            ++Pos;
+    }
+}
+
+static bool IsMacroDefinition(const String& Text)
+{
+    auto Pos = Text.begin();
+    SkipDelimeters(Text, Pos);
+    if (Pos == Text.end() || *Pos != '#')
+        return false;
+    ++Pos;
+    SkipDelimeters(Text, Pos);
+    return SkipPrefix("define", Pos, Text.end());
+}
+
+bool HLSL2GLSLConverterImpl::ParseGlobalDeclarations(TokenListType& Tokens, std::vector<GlobalDeclaration>& Decls)
+{
+    using DeclarationType = GlobalDeclaration::DeclarationType;
+
+    // Returns the first token after the preprocessor directive
+    auto SkipDirective = [&](TokenListType::iterator Token) {
+        /*
+         * #define MACRO(x) \
+         *     x * 2
+         * int a;
+         */
+        VERIFY_EXPR(Token->Type == TokenType::PreprocessorDirective);
+        auto Prev = Token;
+        ++Token;
+        while (Token != Tokens.end())
+        {
+            if (Token->Delimiter.find('\n') != String::npos && Prev->Literal != "\\")
+                break;
+            Prev = Token;
+            ++Token;
+        }
+        return Token;
+    };
+
+    std::vector<String> Identifiers;
+
+    auto Token = Tokens.begin();
+    while (Token != Tokens.end())
+    {
+        Decls.emplace_back();
+        auto& Decl = Decls.back();
+        Decl.Start = Token;
+
+        if (Token->Type == TokenType::PreprocessorDirective)
+        {
+            Token     = SkipDirective(Token);
+            Decl.Type = DeclarationType::Directive;
+
+            auto NameToken = std::next(Decl.Start);
+            if (IsMacroDefinition(Decl.Start->Literal) && NameToken != Token && NameToken->Type == TokenType::Identifier)
+            {
+                // #define MACRO(x) Func(x)
+                //         ^
+                Decl.Type = DeclarationType::Macro;
+                Decl.Names.push_back(NameToken->Literal);
+                ++NameToken;
+            }
+            for (auto It = NameToken; It != Token; ++It)
+                ExtractIdentifiers(It->Literal, Decl.Refs);
+        }
+        else if (Token->Type == TokenType::TextBlock)
+        {
+            // Text blocks are generated by the converter. Some of them define
+            // a single macro, e.g.
+            // #define g_Data g_Data_data
+            ExtractIdentifiers(Token->Literal, Decl.Refs);
+            if (IsMacroDefinition(Token->Literal) && Decl.Refs.size() > 1 &&
+                std::count(Token->Literal.begin(), Token->Literal.end(), '#') == 1)
+            {
+                Decl.Type = DeclarationType::Macro;
+                Decl.Names.push_back(Decl.Refs[1]);
+            }
+            else
+            {
+                Decl.Type = DeclarationType::Directive;
+            }
+            ++Token;
+        }
+        else if (Token->Literal.empty())
+        {
+            // Empty node in the beginning of the list
+            Decl.Type = DeclarationType::Directive;
+            ++Token;
+        }
+        else
+        {
+            int  BraceDepth    = 0;
+            int  BracketDepth  = 0;
+            bool InInitializer = false;
+            bool HasBody       = false;
+            bool IsFunction    = false;
+            bool IsStruct      = Token->Type == TokenType::kw_struct;
+            bool IsResource    = false;
+            bool IsPinned      = false;
+
+            String FunctionName;
+            while (Token != Tokens.end())
+            {
+                if (Token->Type == TokenType::PreprocessorDirective)
+                {
+                    // Directives inside function or struct bodies are fine, but directives
+                    // between declaration tokens make the declaration structure ambiguous:
+                    // float4 Func(
+                    // #if FLAG
+                    //     float4 Arg
+                    // #endif
+                    // ) {...}
+                    if (BraceDepth == 0)
+                        IsPinned = true;
+                    auto DirectiveEnd = SkipDirective(Token);
+                    for (; Token != DirectiveEnd; ++Token)
+                        ExtractIdentifiers(Token->Literal, Decl.Refs);
+                    continue;
+                }
+
+                Identifiers.clear();
+                ExtractIdentifiers(Token->Literal, Identifiers);
+                if (BraceDepth == 0 && BracketDepth == 0)
+                {
+                    for (const auto& Id : Identifiers)
+                    {
+                        if (Id == "uniform" || Id == "buffer")
+                            IsResource = true;
+                        else if (Id == "in" || Id == "out" || Id == "inout" || Id == "attribute" || Id == "varying")
+                            IsPinned = true; // Shader interface variable
+                    }
+                }
+                Decl.Refs.insert(Decl.Refs.end(), Identifiers.begin(), Identifiers.end());
+
+                auto NextToken = std::next(Token);
+
+                bool Finished = false;
+                switch (Token->Type)
+                {
+                    case TokenType::OpenBracket:
+                        ++BracketDepth;
+                        break;
+
+                    case TokenType::ClosingBracket:
+                        --BracketDepth;
+                        if (BracketDepth < 0)
+                            return false;
+                        break;
+
+                    case TokenType::OpenBrace:
+                        if (BraceDepth == 0 && BracketDepth == 0 && !InInitializer)
+                        {
+                            // float4 Func(float4 Arg) {
+                            //                         ^
+                            // struct S {
+                            //          ^
+                            HasBody    = true;
+                            IsFunction = !FunctionName.empty();
+                        }
+                        ++BraceDepth;
+                        break;
+
+                    case TokenType::ClosingBrace:
+                        --BraceDepth;
+                        if (BraceDepth < 0)
+                            return false;
+                        // Function body is not followed by a semicolon
+                        Finished = BraceDepth == 0 && IsFunction;
+                        break;
+
+                    case TokenType::Semicolon:
+                        if (BracketDepth == 0)
+                        {
+                            Finished      = BraceDepth == 0;
+                            InInitializer = false;
+                        }
+                        break;
+
+                    case TokenType::Assignment:
+                        if (BracketDepth == 0 && Token->Literal == "=")
+                            InInitializer = true;
+                        break;
+
+                    case TokenType::Comma:
+                        if (BracketDepth == 0)
+                            InInitializer = false;
+                        break;
+
+                    case TokenType::Identifier:
+                        if (BracketDepth == 0 && !InInitializer && !IsFunction)
+                        {
+                            const auto NextType = NextToken != Tokens.end() ? NextToken->Type : TokenType::Semicolon;
+                            if (BraceDepth == 0 && !HasBody && FunctionName.empty() && Token != Decl.Start &&
+                                NextType == TokenType::OpenBracket && Token->Literal != "layout")
+                            {
+                                // float4 Func(
+                                //        ^
+                                FunctionName = Token->Literal;
+                            }
+                            else if (BraceDepth == 0 && !HasBody && NextType == TokenType::OpenBrace)
+                            {
+                                // struct StructName {
+                                // uniform BlockName {
+                                //         ^
+                                Decl.Names.push_back(Token->Literal);
+                            }
+                            else if ((BraceDepth == 0 || (BraceDepth == 1 && HasBody && !IsStruct)) &&
+                                     (NextType == TokenType::Semicolon || NextType == TokenType::Comma || NextType == TokenType::OpenStaple ||
+                                      NextType == TokenType::Assignment || (NextToken != Tokens.end() && NextToken->Literal == ":")))
+                            {
+                                // float4 g_Var;
+                                // float4 g_Arr[4];
+                                // uniform Block { float4 g_Member; };
+                                //                        ^
+                                Decl.Names.push_back(Token->Literal);
+                            }
+                        }
+                        break;
+
+                    default:
+                        break;
+                }
+
+                ++Token;
+                if (Finished)
+                    break;
+            }
+
+            if (BraceDepth != 0 || BracketDepth != 0)
+                return false;
+
+            if (!FunctionName.empty() && (IsFunction || !HasBody))
+            {
+                // Function definition or prototype
+                Decl.Type = DeclarationType::Function;
+                Decl.Names.clear();
+                Decl.Names.push_back(FunctionName);
+            }
+            else if (IsStruct)
+                Decl.Type = DeclarationType::Struct;
+            else if (IsResource || HasBody)
+                Decl.Type = DeclarationType::Resource;
+            else
+                Decl.Type = DeclarationType::Variable;
+
+            for (const auto& Name : Decl.Names)
+            {
+                // Built-in variable redeclarations such as out gl_PerVertex {...};
+                if (Name.compare(0, 3, "gl_") == 0)
+                    IsPinned = true;
+            }
+            if (IsPinned || Decl.Names.empty())
+                Decl.Type = DeclarationType::Pinned;
+        }
+
+        Decl.End = Token;
+
+        std::sort(Decl.Refs.begin(), Decl.Refs.end());
+        Decl.Refs.erase(std::unique(Decl.Refs.begin(), Decl.Refs.end()), Decl.Refs.end());
+    }
+
+    return true;
+}
+
+bool HLSL2GLSLConverterImpl::ConversionStream::EliminateDeadCode(const ShaderMacro*        Macros,
+                                                                 bool                      IncludeDefinitions,
+                                                                 String&                   Definitions,
+                                                                 DeadCodeEliminationStats* pDCEStats)
+{
+    using DeclarationType = GlobalDeclaration::DeclarationType;
+
+    std::vector<GlobalDeclaration> Decls;
+    if (!ParseGlobalDeclarations(m_Tokens, Decls))
+    {
+        LOG_WARNING_MESSAGE("Failed to parse global declarations in shader '", m_InputFileName, "'. Dead code will not be eliminated.");
+        return false;
+    }
+
+    SymbolMapType Symbols;
+    for (size_t i = 0; i < Decls.size(); ++i)
+    {
+        for (const auto& Name : Decls[i].Names)
+            Symbols[Name].push_back(i);
+    }
+
+    // Declarations from GLSL definitions go first, followed by the declarations from the shader source
+    const auto& DefinitionDecls = m_Converter.m_GLSLDefinitionDecls;
+    const auto  NumDefDecls     = IncludeDefinitions ? DefinitionDecls.size() : 0;
+
+    std::vector<bool>   IsReachable(NumDefDecls + Decls.size());
+    std::vector<size_t> Worklist;
+
+    auto MarkDecl = [&](size_t DeclIdx) {
+        if (!IsReachable[DeclIdx])
+        {
+            IsReachable[DeclIdx] = true;
+            Worklist.push_back(DeclIdx);
+        }
+    };
+    auto MarkSymbol = [&](const String& Name) {
+        if (NumDefDecls != 0)
+        {
+            auto it = m_Converter.m_GLSLDefinitionSymbols.find(Name);
+            if (it != m_Converter.m_GLSLDefinitionSymbols.end())
+            {
+                for (auto DeclIdx : it->second)
+                    MarkDecl(DeclIdx);
+            }
+        }
+        auto it = Symbols.find(Name);
+        if (it != Symbols.end())
+        {
+            for (auto DeclIdx : it->second)
+                MarkDecl(NumDefDecls + DeclIdx);
+        }
+    };
+    auto GetDecl = [&](size_t DeclIdx) -> const GlobalDeclaration& {
+        return DeclIdx < NumDefDecls ? DefinitionDecls[DeclIdx] : Decls[DeclIdx - NumDefDecls];
+    };
+
+    // Directives and pinned declarations are always kept, and the entry point has been renamed to main
+    for (size_t i = 0; i < IsReachable.size(); ++i)
+    {
+        const auto Type = GetDecl(i).Type;
+        if (Type == DeclarationType::Directive || Type == DeclarationType::Pinned)
+            MarkDecl(i);
+    }
+    MarkSymbol("main");
+    if (Macros != nullptr)
+    {
+        std::vector<String> MacroRefs;
+        for (; Macros->Name != nullptr && Macros->Definition != nullptr; ++Macros)
+        {
+            MacroRefs.emplace_back(Macros->Name);
+            ExtractIdentifiers(Macros->Definition, MacroRefs);
+        }
+        for (const auto& Ref : MacroRefs)
+            MarkSymbol(Ref);
+    }
+
+    while (!Worklist.empty())
+    {
+        auto DeclIdx = Worklist.back();
+        Worklist.pop_back();
+        for (const auto& Ref : GetDecl(DeclIdx).Refs)
+            MarkSymbol(Ref);
+    }
+
+    DeadCodeEliminationStats Stats;
+
+    auto IsRemoved = [&](size_t DeclIdx) {
+        if (IsReachable[DeclIdx])
+            return false;
+
+        switch (GetDecl(DeclIdx).Type)
+        {
+            // clang-format off
+            case DeclarationType::Function: ++Stats.NumRemovedFunctions; return true;
+            case DeclarationType::Struct:   ++Stats.NumRemovedStructs;   return true;
+            case DeclarationType::Resource: ++Stats.NumRemovedResources; return true;
+            case DeclarationType::Variable: ++Stats.NumRemovedVariables; return true;
+            // clang-format on
+            default:
+                return false;
+        }
+    };
+
+    if (IncludeDefinitions)
+    {
+        if (NumDefDecls != 0)
+        {
+            bool NewLineRequired = false;
+            for (size_t i = 0; i < NumDefDecls; ++i)
+            {
+                const auto& Decl = DefinitionDecls[i];
+                if (IsRemoved(i))
+                {
+                    NewLineRequired = NewLineRequired || Decl.Start->Delimiter.find('\n') != String::npos;
+                    continue;
+                }
+
+                for (auto Token = Decl.Start; Token != Decl.End; ++Token)
+                {
+                    if (NewLineRequired && Token->Delimiter.find('\n') == String::npos)
+                        Definitions.push_back('\n');
+                    NewLineRequired = false;
+                    Definitions.append(Token->Delimiter);
+                    Definitions.append(Token->Literal);
+                }
+            }
+            Definitions.push_back('\n');
+        }
+        else
+        {
+            Definitions = g_GLSLDefinitions;
+        }
+    }
+
+    for (size_t i = 0; i < Decls.size(); ++i)
+    {
+        const auto& Decl = Decls[i];
+        if (!IsRemoved(NumDefDecls + i))
+            continue;
+
+        // Preserve the line break that separates the removed declaration from the previous one:
+        // #define MACRO 1
+        // void UnusedFunc(){} void Func(){}
+        if (Decl.End != m_Tokens.end() &&
+            Decl.Start->Delimiter.find('\n') != String::npos &&
+            Decl.End->Delimiter.find('\n') == String::npos)
+        {
+            Decl.End->Delimiter.insert(0, "\n");
+        }
+        m_Tokens.erase(Decl.Start, Decl.End);
+    }
+
+    if (pDCEStats != nullptr)
+        *pDCEStats = Stats;
+
+    return true;
+}
+
 String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource()
 {
     String Output;
@@ -4568,6 +5030,27 @@ String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource()
     return Output;
 }
 
+HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(const ConversionStream& SrcStream) :
+    // clang-format off
+    TBase            {nullptr                  },
+    m_Tokens         {SrcStream.m_Tokens       },
+    m_bPreserveTokens{false                    },
+    m_Converter      {SrcStream.m_Converter    },
+    m_InputFileName  {SrcStream.m_InputFileName}
+// clang-format on
+{
+}
+
+void HLSL2GLSLConverterImpl::ConversionStream::ResetTokens(const ConversionStream& SrcStream)
+{
+    VERIFY(!m_bPreserveTokens, "Only scratch streams can be reset");
+    // std::list::assign reuses the existing nodes and String assignment reuses the
+    // allocated storage, so converting multiple entry points does not reallocate the tokens
+    m_Tokens.assign(SrcStream.m_Tokens.begin(), SrcStream.m_Tokens.end());
+    m_StructDefinitions.clear();
+    m_Objects.clear();
+}
+
 HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*              pRefCounters,
                                                            const HLSL2GLSLConverterImpl&    Converter,
                                                            const char*                      InputFileName,
@@ -4606,7 +5089,7 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
 
     InsertIncludes(Source, pInputStreamFactory);
 
-    Tokenize(Source);
+    m_Converter.Tokenize(Source, m_Tokens);
 }
 
 
@@ -4617,7 +5100,8 @@ String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
         try
         {
             ConversionStream Stream(nullptr, *this, Attribs.InputFileName, Attribs.pSourceStreamFactory, Attribs.HLSLSource, Attribs.NumSymbols, false);
-            return Stream.Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers);
+            return Stream.Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers,
+                                  Attribs.EliminateDeadCode, Attribs.Macros, Attribs.pDCEStats);
         }
         catch (std::runtime_error&)
         {
@@ -4626,28 +5110,125 @@ String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
     }
     else
     {
-        ConversionStream* pStream = nullptr;
+        auto pStream = GetConversionStream(Attribs);
+        if (!pStream)
+            return "";
+
+        return pStream->Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers,
+                                Attribs.EliminateDeadCode, Attribs.Macros, Attribs.pDCEStats);
+    }
+}
+
+RefCntAutoPtr<HLSL2GLSLConverterImpl::ConversionStream> HLSL2GLSLConverterImpl::GetConversionStream(ConversionAttribs& Attribs) const
+{
+    VERIFY_EXPR(Attribs.ppConversionStream != nullptr);
+
+    {
+        std::lock_guard<std::mutex> Lock{m_ConversionStreamMtx};
         if (*Attribs.ppConversionStream != nullptr)
         {
-            pStream = ValidatedCast<ConversionStream>(*Attribs.ppConversionStream);
+            auto* pStream = ValidatedCast<ConversionStream>(*Attribs.ppConversionStream);
 
             const auto& FileNameFromStream = pStream->GetInputFileName();
-            if (FileNameFromStream != Attribs.InputFileName)
-            {
-                LOG_WARNING_MESSAGE("Input stream was initialized for input file \"", FileNameFromStream, "\" that does not match the name of the file to be converted \"", Attribs.InputFileName, "\". New stream will be created");
-                (*Attribs.ppConversionStream)->Release();
-                *Attribs.ppConversionStream = nullptr;
-            }
+            if (FileNameFromStream == Attribs.InputFileName)
+                return RefCntAutoPtr<ConversionStream>{pStream};
+
+            LOG_WARNING_MESSAGE("Input stream was initialized for input file \"", FileNameFromStream, "\" that does not match the name of the file to be converted \"", Attribs.InputFileName, "\". New stream will be created");
         }
+    }
 
-        if (*Attribs.ppConversionStream == nullptr)
+    // Loading and tokenizing the source may take a long time, so the stream is created without holding the lock
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pNewStream;
+    CreateStream(Attribs.InputFileName, Attribs.pSourceStreamFactory, Attribs.HLSLSource, Attribs.NumSymbols, &pNewStream);
+    if (!pNewStream)
+        return {};
+
+    std::lock_guard<std::mutex> Lock{m_ConversionStreamMtx};
+    if (*Attribs.ppConversionStream != nullptr)
+    {
+        auto* pStream = ValidatedCast<ConversionStream>(*Attribs.ppConversionStream);
+        // Another thread may have created the stream first
+        if (pStream->GetInputFileName() == Attribs.InputFileName)
+            return RefCntAutoPtr<ConversionStream>{pStream};
+
+        // Threads that are using the old stream hold their own references to it
+        (*Attribs.ppConversionStream)->Release();
+    }
+    *Attribs.ppConversionStream = pNewStream;
+    (*Attribs.ppConversionStream)->AddRef();
+
+    return RefCntAutoPtr<ConversionStream>{ValidatedCast<ConversionStream>(pNewStream.RawPtr())};
+}
+
+Uint32 HLSL2GLSLConverterImpl::ConvertBatch(ConversionAttribs& Attribs,
+                                            BatchEntryPoint*   pEntryPoints,
+                                            Uint32             NumEntryPoints,
+                                            Uint32             NumThreads) const
+{
+    if (NumEntryPoints == 0)
+        return 0;
+
+    DEV_CHECK_ERR(pEntryPoints != nullptr, "pEntryPoints must not be null when NumEntryPoints is not zero");
+
+    // Use a temporary stream if the caller did not provide one
+    RefCntAutoPtr<ConversionStream> pStream;
+    if (Attribs.ppConversionStream != nullptr)
+    {
+        pStream = GetConversionStream(Attribs);
+    }
+    else
+    {
+        RefCntAutoPtr<IHLSL2GLSLConversionStream> pTmpStream;
+        CreateStream(Attribs.InputFileName, Attribs.pSourceStreamFactory, Attribs.HLSLSource, Attribs.NumSymbols, &pTmpStream);
+        if (pTmpStream)
+            pStream = ValidatedCast<ConversionStream>(pTmpStream.RawPtr());
+    }
+    if (pStream == nullptr)
+    {
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+            pEntryPoints[i].GLSLSource.clear();
+        return 0;
+    }
+
+    std::atomic<Uint32> NextEntryPoint{0};
+    std::atomic<Uint32> NumConverted{0};
+
+    // Every task converts entry points until none are left, so that the
+    // scratch tokens are reused by all entry points converted by the task
+    auto ConvertEntryPoints = [&](Uint32 /*TaskIndex*/) {
+        ConversionStream Scratch{*pStream};
+
+        bool ResetRequired = false;
+        for (Uint32 i = NextEntryPoint.fetch_add(1); i < NumEntryPoints; i = NextEntryPoint.fetch_add(1))
         {
-            CreateStream(Attribs.InputFileName, Attribs.pSourceStreamFactory, Attribs.HLSLSource, Attribs.NumSymbols, Attribs.ppConversionStream);
-            pStream = ValidatedCast<ConversionStream>(*Attribs.ppConversionStream);
+            auto& EntryPoint = pEntryPoints[i];
+            EntryPoint.GLSLSource.clear();
+            EntryPoint.DCEStats = DeadCodeEliminationStats{};
+
+            if (ResetRequired)
+                Scratch.ResetTokens(*pStream);
+            ResetRequired = true;
+
+            try
+            {
+                EntryPoint.GLSLSource = Scratch.ConvertTokens(EntryPoint.EntryPoint, EntryPoint.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix,
+                                                              Attribs.UseInOutLocationQualifiers, Attribs.EliminateDeadCode, Attribs.Macros, &EntryPoint.DCEStats);
+                NumConverted.fetch_add(1);
+            }
+            catch (std::runtime_error&)
+            {
+                EntryPoint.GLSLSource.clear();
+            }
         }
+    };
 
-        return pStream->Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers);
-    }
+    NumThreads = std::max(std::min(NumThreads, NumEntryPoints), Uint32{1});
+
+    // The pool runs the tasks on the calling thread and NumThreads - 1 workers
+    WorkerThreadPool ThreadPool{NumThreads - 1};
+    ThreadPool.ParallelFor(NumThreads, ConvertEntryPoints);
+
+    return NumConverted.load();
 }
 
 void HLSL2GLSLConverterImpl::CreateStream(const Char*                      InputFileName,
@@ -4676,7 +5257,9 @@ void HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
 {
     try
     {
-        auto                GLSLSource = Convert(EntryPoint, ShaderType, IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers);
+        // The converted source may be compiled with macros unknown to the stream,
+        // so dead code elimination is not performed
+        auto                GLSLSource = Convert(EntryPoint, ShaderType, IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers, false, nullptr, nullptr);
         StringDataBlobImpl* pDataBlob  = MakeNewRCObj<StringDataBlobImpl>()(std::move(GLSLSource));
         pDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(ppGLSLSource));
     }
@@ -4686,14 +5269,39 @@ void HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
     }
 }
 
-String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
-                                                         SHADER_TYPE ShaderType,
-                                                         bool        IncludeDefintions,
-                                                         const char* SamplerSuffix,
-                                                         bool        UseInOutLocationQualifiers)
+String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char*               EntryPoint,
+                                                         SHADER_TYPE               ShaderType,
+                                                         bool                      IncludeDefintions,
+                                                         const char*               SamplerSuffix,
+                                                         bool                      UseInOutLocationQualifiers,
+                                                         bool                      bEliminateDeadCode,
+                                                         const ShaderMacro*        Macros,
+                                                         DeadCodeEliminationStats* pDCEStats)
+{
+    if (m_bPreserveTokens)
+    {
+        // Tokens of a reusable stream are never modified, which allows multiple
+        // threads to use the same stream simultaneously.
+        ConversionStream Scratch{*this};
+        return Scratch.ConvertTokens(EntryPoint, ShaderType, IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers, bEliminateDeadCode, Macros, pDCEStats);
+    }
+    else
+    {
+        return ConvertTokens(EntryPoint, ShaderType, IncludeDefintions, SamplerSuffix, UseInOutLocationQualifiers, bEliminateDeadCode, Macros, pDCEStats);
+    }
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::ConvertTokens(const Char*               EntryPoint,
+                                                               SHADER_TYPE               ShaderType,
+                                                               bool                      IncludeDefintions,
+                                                               const char*               SamplerSuffix,
+                                                               bool                      UseInOutLocationQualifiers,
+                                                               bool                      bEliminateDeadCode,
+                                                               const ShaderMacro*        Macros,
+                                                               DeadCodeEliminationStats* pDCEStats)
 {
+    VERIFY(!m_bPreserveTokens, "Tokens of a reusable stream must not be modified");
     m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
-    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
 
     Uint32 ShaderStorageBlockBinding = 0;
     Uint32 ImageBinding              = 0;
@@ -4917,17 +5525,21 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
 
     RemoveSpecialShaderAttributes();
 
-    auto GLSLSource = BuildGLSLSource();
-
-    if (m_bPreserveTokens)
+    String Definitions;
+    if (bEliminateDeadCode)
     {
-        m_Tokens.swap(TokensCopy);
-        m_StructDefinitions.clear();
-        m_Objects.clear();
+        if (!EliminateDeadCode(Macros, IncludeDefintions, Definitions, pDCEStats))
+            Definitions = IncludeDefintions ? g_GLSLDefinitions : "";
     }
+    else if (IncludeDefintions)
+    {
+        Definitions = g_GLSLDefinitions;
+    }
+
+    auto GLSLSource = BuildGLSLSource();
 
     if (IncludeDefintions)
-        GLSLSource.insert(0, g_GLSLDefinitions);
+        GLSLSource.insert(0, Definitions);
 
     return GLSLSource;
 }
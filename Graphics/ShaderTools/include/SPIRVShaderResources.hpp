@@ -100,6 +100,14 @@ public:
                                ResourceType                          _Type,
                                Uint32                                _SamplerOrSepImgInd = InvalidSepSmplrOrImgInd) noexcept;
 
+    // Initializes the attributes from previously serialized values
+    SPIRVShaderResourceAttribs(const char*  _Name,
+                               Uint16       _ArraySize,
+                               ResourceType _Type,
+                               Uint32       _SepSmplrOrImgInd,
+                               uint32_t     _BindingDecorationOffset,
+                               uint32_t     _DescriptorSetDecorationOffset) noexcept;
+
     bool IsValidSepSamplerAssigned() const
     {
         VERIFY_EXPR(Type == SeparateImage);
@@ -189,6 +197,18 @@ public:
                          bool                  LoadShaderStageInputs,
                          std::string&          EntryPoint);
 
+    /// Restores the resources from the data produced by Serialize() without parsing the SPIR-V binary.
+    /// Throws an exception if the data is malformed, was produced by a different version of the
+    /// serializer, or does not match the SPIR-V binary, shader type or combined sampler suffix.
+    /// The shader name is not serialized and is always taken from shaderDesc.
+    SPIRVShaderResources(IMemoryAllocator&            Allocator,
+                         const void*                  pSerializedData,
+                         size_t                       SerializedDataSize,
+                         const std::vector<uint32_t>& spirv_binary,
+                         const ShaderDesc&            shaderDesc,
+                         const char*                  CombinedSamplerSuffix,
+                         std::string&                 EntryPoint) noexcept(false);
+
     // clang-format off
     SPIRVShaderResources             (const SPIRVShaderResources&)  = delete;
     SPIRVShaderResources             (      SPIRVShaderResources&&) = delete;
@@ -332,6 +352,15 @@ public:
 
     std::string DumpResources();
 
+    /// Serializes the resources. spirv_binary must be the binary the resources were
+    /// created from: its hash is stored in the data and is verified when the data is loaded.
+    void Serialize(const std::vector<uint32_t>& spirv_binary,
+                   const std::string&           EntryPoint,
+                   std::vector<Uint8>&          Data) const;
+
+    /// Version of the serialized data format. Data of other versions is rejected.
+    static constexpr Uint32 SerializationVersion = 1;
+
     bool IsCompatibleWith(const SPIRVShaderResources& Resources) const;
 
     // clang-format off
@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// SPIR-V post-processing utilities: stripping, ID remapping and compression
+
+#include <vector>
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Removes instructions that do not affect the semantics of the module:
+/// OpSource*, OpString, OpLine, OpNoLine, OpModuleProcessed, and the instructions
+/// of non-semantic and debug-info extended instruction sets.
+/// Names and decorations are preserved as they are required for reflection.
+std::vector<uint32_t> StripSPIRVNonSemanticInfo(const std::vector<uint32_t>& SPIRV);
+
+/// Renumbers IDs of the module to make them contiguous, which makes the byte code
+/// more compressible. Returns the original byte code if remapping is not available
+/// (glslang is not built) or fails.
+std::vector<uint32_t> RemapSPIRVIds(const std::vector<uint32_t>& SPIRV);
+
+/// Compresses SPIR-V byte code by encoding every instruction word as a variable-length integer.
+/// Returns an empty vector if the byte code is not a valid SPIR-V module.
+std::vector<Uint8> CompressSPIRV(const std::vector<uint32_t>& SPIRV);
+
+/// Returns true if the data was produced by CompressSPIRV().
+bool IsCompressedSPIRV(const void* pData, size_t Size);
+
+/// Decompresses SPIR-V byte code produced by CompressSPIRV(). Returns false if the data is not valid.
+bool DecompressSPIRV(const void* pData, size_t Size, std::vector<uint32_t>& SPIRV);
+
+/// SPIR-V post-processing attributes
+struct SPIRVPostProcessAttribs
+{
+    /// Strip instructions that do not affect the semantics, see StripSPIRVNonSemanticInfo().
+    bool StripNonSemanticInfo = true;
+
+    /// Make IDs contiguous, see RemapSPIRVIds().
+    bool RemapIds = true;
+
+    /// Compress the byte code, see CompressSPIRV().
+    bool Compress = true;
+};
+
+/// Runs the post-processing pipeline on the SPIR-V byte code produced by the compiler.
+/// The result can be used as ShaderCreateInfo::ByteCode when creating a Vulkan shader.
+std::vector<Uint8> PostProcessSPIRV(const std::vector<uint32_t>& SPIRV, const SPIRVPostProcessAttribs& Attribs);
+
+} // namespace Diligent
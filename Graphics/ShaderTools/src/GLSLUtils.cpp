@@ -293,6 +293,8 @@ String BuildGLSLSourceString(const ShaderCreateInfo& ShaderCI,
         Attribs.IncludeDefinitions   = true;
         Attribs.InputFileName        = ShaderCI.FilePath;
         Attribs.SamplerSuffix        = ShaderCI.CombinedSamplerSuffix;
+        // Functions and resources referenced only through shader macros must not be eliminated
+        Attribs.Macros = ShaderCI.Macros;
         // Separate shader objects extension also allows input/output layout qualifiers for
         // all shader stages.
         // https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_separate_shader_objects.txt
@@ -26,6 +26,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "SPIRVShaderResources.hpp"
 #include "spirv_parser.hpp"
 #include "spirv_cross.hpp"
@@ -33,6 +34,7 @@
 #include "GraphicsAccessories.hpp"
 #include "StringTools.hpp"
 #include "Align.hpp"
+#include "HashUtils.hpp"
 
 namespace Diligent
 {
@@ -84,6 +86,23 @@ SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const diligent_spirv_cros
            "Only separate images or separate samplers can be assinged valid SepSmplrOrImgInd value");
 }
 
+SPIRVShaderResourceAttribs::SPIRVShaderResourceAttribs(const char*  _Name,
+                                                       Uint16       _ArraySize,
+                                                       ResourceType _Type,
+                                                       Uint32       _SepSmplrOrImgInd,
+                                                       uint32_t     _BindingDecorationOffset,
+                                                       uint32_t     _DescriptorSetDecorationOffset) noexcept :
+    // clang-format off
+    Name                          {_Name},
+    ArraySize                     {_ArraySize},
+    Type                          {_Type},
+    SepSmplrOrImgInd              {_SepSmplrOrImgInd},
+    BindingDecorationOffset       {_BindingDecorationOffset},
+    DescriptorSetDecorationOffset {_DescriptorSetDecorationOffset}
+// clang-format on
+{
+}
+
 
 ShaderResourceDesc SPIRVShaderResourceAttribs::GetResourceDesc() const
 {
@@ -627,6 +646,305 @@ SPIRVShaderResources::~SPIRVShaderResources()
 }
 
 
+namespace
+{
+
+// Serialized data layout:
+//
+//   | Header | Resources | Stage Inputs | Resource Names | Entry Point |
+//
+// Pointers to names are stored as offsets from the start of the names pool.
+// The shader name is not stored.
+
+constexpr Uint32 SerializedDataMagic = 0x52525053; // 'SPRR'
+constexpr Uint32 InvalidNameOffset   = ~0u;
+
+struct SerializedHeader
+{
+    Uint32 Magic;
+    Uint32 Version;
+    Uint64 SPIRVHash;
+    Uint32 SPIRVSize;
+    Uint32 ShaderType;
+    Uint32 IsHLSLSource;
+
+    Uint32 StorageBufferOffset;
+    Uint32 StorageImageOffset;
+    Uint32 SampledImageOffset;
+    Uint32 AtomicCounterOffset;
+    Uint32 SeparateSamplerOffset;
+    Uint32 SeparateImageOffset;
+    Uint32 InputAttachmentOffset;
+    Uint32 TotalResources;
+    Uint32 NumShaderStageInputs;
+
+    Uint32 NamesPoolSize;
+    Uint32 CombinedSamplerSuffixOffset;
+    Uint32 EntryPointLength;
+};
+
+struct SerializedResourceAttribs
+{
+    Uint32 NameOffset;
+    Uint16 ArraySize;
+    Uint8  Type;
+    Uint8  Padding;
+    Uint32 SepSmplrOrImgInd;
+    Uint32 BindingDecorationOffset;
+    Uint32 DescriptorSetDecorationOffset;
+};
+
+struct SerializedStageInputAttribs
+{
+    Uint32 SemanticOffset;
+    Uint32 LocationDecorationOffset;
+};
+
+Uint64 ComputeSPIRVHash(const std::vector<uint32_t>& spirv_binary)
+{
+    // FNV-1a
+    Uint64 Hash = 14695981039346656037ull;
+    for (auto Word : spirv_binary)
+    {
+        Hash ^= Word;
+        Hash *= 1099511628211ull;
+    }
+    return Hash;
+}
+
+} // namespace
+
+void SPIRVShaderResources::Serialize(const std::vector<uint32_t>& spirv_binary,
+                                     const std::string&           EntryPoint,
+                                     std::vector<Uint8>&          Data) const
+{
+    // The shader name is not serialized: it belongs to the shader object
+    // and is taken from the shader description when the data is loaded.
+    std::vector<char> NamesPool;
+
+    auto AddName = [&NamesPool](const char* Name) {
+        if (Name == nullptr)
+            return InvalidNameOffset;
+        const auto Offset = static_cast<Uint32>(NamesPool.size());
+        NamesPool.insert(NamesPool.end(), Name, Name + strlen(Name) + 1);
+        return Offset;
+    };
+
+    std::vector<SerializedResourceAttribs> Resources(m_TotalResources);
+    for (Uint32 n = 0; n < m_TotalResources; ++n)
+    {
+        const auto& Res           = GetResource(n);
+        auto&       SerializedRes = Resources[n];
+
+        SerializedRes.NameOffset       = AddName(Res.Name);
+        SerializedRes.ArraySize        = Res.ArraySize;
+        SerializedRes.Type             = static_cast<Uint8>(Res.Type);
+        SerializedRes.SepSmplrOrImgInd = SPIRVShaderResourceAttribs::InvalidSepSmplrOrImgInd;
+        if (Res.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateImage)
+            SerializedRes.SepSmplrOrImgInd = Res.GetAssignedSepSamplerInd();
+        else if (Res.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
+            SerializedRes.SepSmplrOrImgInd = Res.GetAssignedSepImageInd();
+        SerializedRes.BindingDecorationOffset       = Res.BindingDecorationOffset;
+        SerializedRes.DescriptorSetDecorationOffset = Res.DescriptorSetDecorationOffset;
+    }
+
+    std::vector<SerializedStageInputAttribs> StageInputs(m_NumShaderStageInputs);
+    for (Uint32 n = 0; n < m_NumShaderStageInputs; ++n)
+    {
+        const auto& Input = GetShaderStageInputAttribs(n);
+
+        StageInputs[n].SemanticOffset           = AddName(Input.Semantic);
+        StageInputs[n].LocationDecorationOffset = Input.LocationDecorationOffset;
+    }
+
+    SerializedHeader Header = {};
+
+    Header.Magic        = SerializedDataMagic;
+    Header.Version      = SerializationVersion;
+    Header.SPIRVHash    = ComputeSPIRVHash(spirv_binary);
+    Header.SPIRVSize    = static_cast<Uint32>(spirv_binary.size());
+    Header.ShaderType   = static_cast<Uint32>(m_ShaderType);
+    Header.IsHLSLSource = m_IsHLSLSource ? 1 : 0;
+
+    Header.StorageBufferOffset   = m_StorageBufferOffset;
+    Header.StorageImageOffset    = m_StorageImageOffset;
+    Header.SampledImageOffset    = m_SampledImageOffset;
+    Header.AtomicCounterOffset   = m_AtomicCounterOffset;
+    Header.SeparateSamplerOffset = m_SeparateSamplerOffset;
+    Header.SeparateImageOffset   = m_SeparateImageOffset;
+    Header.InputAttachmentOffset = m_InputAttachmentOffset;
+    Header.TotalResources        = m_TotalResources;
+    Header.NumShaderStageInputs  = m_NumShaderStageInputs;
+    static_assert(SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes == 11, "Please serialize the new resource type offset");
+
+    Header.CombinedSamplerSuffixOffset = AddName(m_CombinedSamplerSuffix);
+    Header.NamesPoolSize               = static_cast<Uint32>(NamesPool.size());
+    Header.EntryPointLength            = static_cast<Uint32>(EntryPoint.length());
+
+    Data.resize(sizeof(Header) +
+                Resources.size() * sizeof(SerializedResourceAttribs) +
+                StageInputs.size() * sizeof(SerializedStageInputAttribs) +
+                NamesPool.size() +
+                EntryPoint.length());
+
+    auto* pDst      = Data.data();
+    auto  WriteData = [&pDst](const void* pSrc, size_t Size) {
+        if (Size > 0)
+            memcpy(pDst, pSrc, Size);
+        pDst += Size;
+    };
+    WriteData(&Header, sizeof(Header));
+    WriteData(Resources.data(), Resources.size() * sizeof(SerializedResourceAttribs));
+    WriteData(StageInputs.data(), StageInputs.size() * sizeof(SerializedStageInputAttribs));
+    WriteData(NamesPool.data(), NamesPool.size());
+    WriteData(EntryPoint.data(), EntryPoint.length());
+
+    VERIFY_EXPR(pDst == Data.data() + Data.size());
+}
+
+SPIRVShaderResources::SPIRVShaderResources(IMemoryAllocator&            Allocator,
+                                           const void*                  pSerializedData,
+                                           size_t                       SerializedDataSize,
+                                           const std::vector<uint32_t>& spirv_binary,
+                                           const ShaderDesc&            shaderDesc,
+                                           const char*                  CombinedSamplerSuffix,
+                                           std::string&                 EntryPoint) noexcept(false) :
+    m_ShaderType{shaderDesc.ShaderType}
+{
+    const auto* pSrc    = static_cast<const Uint8*>(pSerializedData);
+    const auto* pSrcEnd = pSrc + SerializedDataSize;
+
+    auto ReadData = [&](void* pDst, size_t Size) {
+        if (static_cast<size_t>(pSrcEnd - pSrc) < Size)
+            LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' are truncated");
+        if (Size > 0)
+            memcpy(pDst, pSrc, Size);
+        pSrc += Size;
+    };
+
+    SerializedHeader Header;
+    if (pSerializedData == nullptr)
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' are null");
+    ReadData(&Header, sizeof(Header));
+
+    if (Header.Magic != SerializedDataMagic)
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' are not valid");
+    if (Header.Version != SerializationVersion)
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have version ", Header.Version, " while version ", Uint32{SerializationVersion}, " is expected");
+    if (Header.SPIRVSize != spirv_binary.size() || Header.SPIRVHash != ComputeSPIRVHash(spirv_binary))
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' were created from a different SPIRV binary");
+    if (Header.ShaderType != static_cast<Uint32>(shaderDesc.ShaderType))
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' were created for a different shader type");
+
+    // clang-format off
+    if (!(Header.StorageBufferOffset   <= Header.StorageImageOffset    &&
+          Header.StorageImageOffset    <= Header.SampledImageOffset    &&
+          Header.SampledImageOffset    <= Header.AtomicCounterOffset   &&
+          Header.AtomicCounterOffset   <= Header.SeparateSamplerOffset &&
+          Header.SeparateSamplerOffset <= Header.SeparateImageOffset   &&
+          Header.SeparateImageOffset   <= Header.InputAttachmentOffset &&
+          Header.InputAttachmentOffset <= Header.TotalResources        &&
+          Header.TotalResources        <= std::numeric_limits<OffsetType>::max() &&
+          Header.NumShaderStageInputs  <= std::numeric_limits<OffsetType>::max()))
+    {
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have invalid resource offsets");
+    }
+    // clang-format on
+
+    std::vector<SerializedResourceAttribs>   Resources(Header.TotalResources);
+    std::vector<SerializedStageInputAttribs> StageInputs(Header.NumShaderStageInputs);
+    std::vector<char>                        NamesPool(Header.NamesPoolSize);
+    ReadData(Resources.data(), Resources.size() * sizeof(SerializedResourceAttribs));
+    ReadData(StageInputs.data(), StageInputs.size() * sizeof(SerializedStageInputAttribs));
+    ReadData(NamesPool.data(), NamesPool.size());
+
+    std::string SerializedEntryPoint(Header.EntryPointLength, '\0');
+    ReadData(&SerializedEntryPoint[0], SerializedEntryPoint.length());
+
+    auto IsValidNameOffset = [&NamesPool](Uint32 Offset) {
+        return Offset < NamesPool.size();
+    };
+    if (!NamesPool.empty() && NamesPool.back() != '\0')
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have invalid names pool");
+    for (const auto& Res : Resources)
+    {
+        bool IsValid = IsValidNameOffset(Res.NameOffset) && Res.Type < SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes;
+        if (Res.SepSmplrOrImgInd != SPIRVShaderResourceAttribs::InvalidSepSmplrOrImgInd)
+        {
+            if (Res.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateImage)
+                IsValid = IsValid && Res.SepSmplrOrImgInd < Header.SeparateImageOffset - Header.SeparateSamplerOffset;
+            else if (Res.Type == SPIRVShaderResourceAttribs::ResourceType::SeparateSampler)
+                IsValid = IsValid && Res.SepSmplrOrImgInd < Header.InputAttachmentOffset - Header.SeparateImageOffset;
+            else
+                IsValid = false;
+        }
+        if (!IsValid)
+            LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have invalid resource attributes");
+    }
+    for (const auto& Input : StageInputs)
+    {
+        if (!IsValidNameOffset(Input.SemanticOffset))
+            LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have invalid stage input attributes");
+    }
+
+    const bool HasCombinedSamplerSuffix = Header.CombinedSamplerSuffixOffset != InvalidNameOffset;
+    if (HasCombinedSamplerSuffix && !IsValidNameOffset(Header.CombinedSamplerSuffixOffset))
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' have invalid combined sampler suffix");
+    if (HasCombinedSamplerSuffix != (CombinedSamplerSuffix != nullptr) ||
+        (CombinedSamplerSuffix != nullptr && strcmp(CombinedSamplerSuffix, &NamesPool[Header.CombinedSamplerSuffixOffset]) != 0))
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' were created with a different combined sampler suffix");
+
+    if (!EntryPoint.empty() && EntryPoint != SerializedEntryPoint)
+        LOG_ERROR_AND_THROW("Serialized resources of shader '", shaderDesc.Name, "' were created for entry point '", SerializedEntryPoint, "'");
+    EntryPoint = std::move(SerializedEntryPoint);
+
+    m_IsHLSLSource = Header.IsHLSLSource != 0;
+
+    ResourceCounters ResCounters;
+    ResCounters.NumUBs       = Header.StorageBufferOffset;
+    ResCounters.NumSBs       = Header.StorageImageOffset - Header.StorageBufferOffset;
+    ResCounters.NumImgs      = Header.SampledImageOffset - Header.StorageImageOffset;
+    ResCounters.NumSmpldImgs = Header.AtomicCounterOffset - Header.SampledImageOffset;
+    ResCounters.NumACs       = Header.SeparateSamplerOffset - Header.AtomicCounterOffset;
+    ResCounters.NumSepSmplrs = Header.SeparateImageOffset - Header.SeparateSamplerOffset;
+    ResCounters.NumSepImgs   = Header.InputAttachmentOffset - Header.SeparateImageOffset;
+    ResCounters.NumInptAtts  = Header.TotalResources - Header.InputAttachmentOffset;
+    static_assert(SPIRVShaderResourceAttribs::ResourceType::NumResourceTypes == 11, "Please restore the new resource type counter");
+
+    VERIFY_EXPR(shaderDesc.Name != nullptr);
+    StringPool ResourceNamesPool;
+    Initialize(Allocator, ResCounters, Header.NumShaderStageInputs, NamesPool.size() + strlen(shaderDesc.Name) + 1, ResourceNamesPool);
+
+    auto* NamesPoolData = ResourceNamesPool.Allocate(NamesPool.size());
+    if (!NamesPool.empty())
+        memcpy(NamesPoolData, NamesPool.data(), NamesPool.size());
+
+    for (Uint32 n = 0; n < Header.TotalResources; ++n)
+    {
+        const auto& Res = Resources[n];
+        new (&GetResource(n)) SPIRVShaderResourceAttribs //
+            {
+                NamesPoolData + Res.NameOffset,
+                Res.ArraySize,
+                static_cast<SPIRVShaderResourceAttribs::ResourceType>(Res.Type),
+                Res.SepSmplrOrImgInd,
+                Res.BindingDecorationOffset,
+                Res.DescriptorSetDecorationOffset //
+            };
+    }
+
+    for (Uint32 n = 0; n < Header.NumShaderStageInputs; ++n)
+    {
+        const auto& Input = StageInputs[n];
+        new (&GetShaderStageInputAttribs(n)) SPIRVShaderStageInputAttribs{NamesPoolData + Input.SemanticOffset, Input.LocationDecorationOffset};
+    }
+
+    if (HasCombinedSamplerSuffix)
+        m_CombinedSamplerSuffix = NamesPoolData + Header.CombinedSamplerSuffixOffset;
+    m_ShaderName = ResourceNamesPool.CopyString(shaderDesc.Name);
+
+    VERIFY(ResourceNamesPool.GetRemainingSize() == 0, "Names pool must be empty");
+}
 
 std::string SPIRVShaderResources::DumpResources()
 {
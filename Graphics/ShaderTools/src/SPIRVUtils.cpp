@@ -0,0 +1,300 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <unordered_set>
+
+#include "SPIRVUtils.hpp"
+#include "DebugUtilities.hpp"
+#include "spirv.hpp"
+
+#if !DILIGENT_NO_GLSLANG
+#    include "spirv-tools/optimizer.hpp"
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr uint32_t SPIRVHeaderSize = 5;
+
+// 'DSPZ'
+constexpr Uint32 CompressedSPIRVMagic   = 0x5A505344;
+constexpr Uint32 CompressedSPIRVVersion = 1;
+
+struct CompressedSPIRVHeader
+{
+    Uint32 Magic;
+    Uint32 Version;
+    Uint32 NumWords;
+};
+
+bool IsValidSPIRVModule(const std::vector<uint32_t>& SPIRV)
+{
+    return SPIRV.size() >= SPIRVHeaderSize && SPIRV[0] == spv::MagicNumber;
+}
+
+// Calls Handler(Offset, Opcode, WordCount) for every instruction of the module.
+// Returns false if the module is malformed.
+template <typename HandlerType>
+bool ProcessInstructions(const std::vector<uint32_t>& SPIRV, HandlerType Handler)
+{
+    for (size_t Offset = SPIRVHeaderSize; Offset < SPIRV.size();)
+    {
+        const auto Opcode    = static_cast<spv::Op>(SPIRV[Offset] & spv::OpCodeMask);
+        const auto WordCount = SPIRV[Offset] >> spv::WordCountShift;
+        if (WordCount == 0 || Offset + WordCount > SPIRV.size())
+            return false;
+
+        Handler(Offset, Opcode, WordCount);
+        Offset += WordCount;
+    }
+    return true;
+}
+
+void WriteVarUint(std::vector<Uint8>& Data, Uint32 Value)
+{
+    while (Value >= 0x80)
+    {
+        Data.push_back(static_cast<Uint8>(Value | 0x80));
+        Value >>= 7;
+    }
+    Data.push_back(static_cast<Uint8>(Value));
+}
+
+bool ReadVarUint(const Uint8*& pSrc, const Uint8* pEnd, Uint32& Value)
+{
+    Value = 0;
+    for (Uint32 Shift = 0; Shift < 35; Shift += 7)
+    {
+        if (pSrc == pEnd)
+            return false;
+
+        const auto Byte = *(pSrc++);
+        Value |= static_cast<Uint32>(Byte & 0x7F) << Shift;
+        if ((Byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<uint32_t> StripSPIRVNonSemanticInfo(const std::vector<uint32_t>& SPIRV)
+{
+    if (!IsValidSPIRVModule(SPIRV))
+    {
+        LOG_ERROR_MESSAGE("Unable to strip SPIRV: the byte code is not a valid SPIRV module");
+        return SPIRV;
+    }
+
+    auto GetString = [&SPIRV](size_t Offset, uint32_t WordCount, uint32_t FirstWord) -> const char* {
+        return FirstWord < WordCount ? reinterpret_cast<const char*>(&SPIRV[Offset + FirstWord]) : "";
+    };
+
+    // Extended instruction sets whose instructions can be removed
+    std::unordered_set<uint32_t> RemovableSets;
+
+    bool IsValid = ProcessInstructions(SPIRV, [&](size_t Offset, spv::Op Opcode, uint32_t WordCount) {
+        if (Opcode == spv::OpExtInstImport && WordCount > 2)
+        {
+            const auto* Name = GetString(Offset, WordCount, 2);
+            if (strncmp(Name, "NonSemantic.", 12) == 0 || strstr(Name, "DebugInfo") != nullptr)
+                RemovableSets.insert(SPIRV[Offset + 1]);
+        }
+    });
+    if (!IsValid)
+    {
+        LOG_ERROR_MESSAGE("Unable to strip SPIRV: the module is malformed");
+        return SPIRV;
+    }
+
+    std::vector<uint32_t> StrippedSPIRV;
+    StrippedSPIRV.reserve(SPIRV.size());
+    StrippedSPIRV.insert(StrippedSPIRV.end(), SPIRV.begin(), SPIRV.begin() + SPIRVHeaderSize);
+    ProcessInstructions(SPIRV, [&](size_t Offset, spv::Op Opcode, uint32_t WordCount) {
+        switch (Opcode)
+        {
+            case spv::OpSourceContinued:
+            case spv::OpSource:
+            case spv::OpSourceExtension:
+            case spv::OpString:
+            case spv::OpLine:
+            case spv::OpNoLine:
+            case spv::OpModuleProcessed:
+                return;
+
+            case spv::OpExtension:
+                if (strcmp(GetString(Offset, WordCount, 1), "SPV_KHR_non_semantic_info") == 0)
+                    return;
+                break;
+
+            case spv::OpExtInstImport:
+                if (RemovableSets.find(SPIRV[Offset + 1]) != RemovableSets.end())
+                    return;
+                break;
+
+            case spv::OpExtInst:
+                // Results of non-semantic instructions can only be used by other non-semantic instructions
+                if (WordCount > 3 && RemovableSets.find(SPIRV[Offset + 3]) != RemovableSets.end())
+                    return;
+                break;
+
+            default:
+                break;
+        }
+        StrippedSPIRV.insert(StrippedSPIRV.end(), SPIRV.begin() + Offset, SPIRV.begin() + Offset + WordCount);
+    });
+
+    return StrippedSPIRV;
+}
+
+std::vector<uint32_t> RemapSPIRVIds(const std::vector<uint32_t>& SPIRV)
+{
+#if !DILIGENT_NO_GLSLANG
+    spvtools::Optimizer SpirvOptimizer(SPV_ENV_VULKAN_1_0);
+    SpirvOptimizer.RegisterPass(spvtools::CreateCompactIdsPass());
+    std::vector<uint32_t> RemappedSPIRV;
+    if (SpirvOptimizer.Run(SPIRV.data(), SPIRV.size(), &RemappedSPIRV))
+        return RemappedSPIRV;
+
+    LOG_ERROR_MESSAGE("Failed to remap SPIRV ids");
+#endif
+    return SPIRV;
+}
+
+std::vector<Uint8> CompressSPIRV(const std::vector<uint32_t>& SPIRV)
+{
+    std::vector<Uint8> Data;
+    if (!IsValidSPIRVModule(SPIRV))
+    {
+        LOG_ERROR_MESSAGE("Unable to compress SPIRV: the byte code is not a valid SPIRV module");
+        return Data;
+    }
+
+    // Most instruction words are small IDs, literals and opcodes, so they take 1-2 bytes
+    Data.reserve(sizeof(CompressedSPIRVHeader) + SPIRV.size() * 2);
+
+    CompressedSPIRVHeader Header;
+    Header.Magic    = CompressedSPIRVMagic;
+    Header.Version  = CompressedSPIRVVersion;
+    Header.NumWords = static_cast<Uint32>(SPIRV.size());
+    Data.resize(sizeof(Header));
+    memcpy(Data.data(), &Header, sizeof(Header));
+
+    for (uint32_t i = 0; i < SPIRVHeaderSize; ++i)
+        WriteVarUint(Data, SPIRV[i]);
+
+    bool IsValid = ProcessInstructions(SPIRV, [&](size_t Offset, spv::Op Opcode, uint32_t WordCount) {
+        // Opcode and word count are encoded separately as the combined word always takes 3+ bytes
+        WriteVarUint(Data, static_cast<Uint32>(Opcode));
+        WriteVarUint(Data, WordCount);
+        for (uint32_t i = 1; i < WordCount; ++i)
+            WriteVarUint(Data, SPIRV[Offset + i]);
+    });
+    if (!IsValid)
+    {
+        LOG_ERROR_MESSAGE("Unable to compress SPIRV: the module is malformed");
+        Data.clear();
+    }
+
+    return Data;
+}
+
+bool IsCompressedSPIRV(const void* pData, size_t Size)
+{
+    if (pData == nullptr || Size < sizeof(CompressedSPIRVHeader))
+        return false;
+
+    Uint32 Magic = 0;
+    memcpy(&Magic, pData, sizeof(Magic));
+    return Magic == CompressedSPIRVMagic;
+}
+
+bool DecompressSPIRV(const void* pData, size_t Size, std::vector<uint32_t>& SPIRV)
+{
+    SPIRV.clear();
+    if (!IsCompressedSPIRV(pData, Size))
+        return false;
+
+    CompressedSPIRVHeader Header;
+    memcpy(&Header, pData, sizeof(Header));
+    if (Header.Version != CompressedSPIRVVersion || Header.NumWords < SPIRVHeaderSize)
+        return false;
+
+    const auto* pSrc = static_cast<const Uint8*>(pData) + sizeof(Header);
+    const auto* pEnd = static_cast<const Uint8*>(pData) + Size;
+    // Every word takes at least one byte
+    if (Header.NumWords > static_cast<size_t>(pEnd - pSrc))
+        return false;
+
+    SPIRV.resize(Header.NumWords);
+    for (uint32_t i = 0; i < SPIRVHeaderSize; ++i)
+    {
+        if (!ReadVarUint(pSrc, pEnd, SPIRV[i]))
+            return false;
+    }
+
+    for (size_t Offset = SPIRVHeaderSize; Offset < SPIRV.size();)
+    {
+        Uint32 Opcode    = 0;
+        Uint32 WordCount = 0;
+        if (!ReadVarUint(pSrc, pEnd, Opcode) || !ReadVarUint(pSrc, pEnd, WordCount))
+            return false;
+        if (Opcode > spv::OpCodeMask || WordCount == 0 || WordCount > 0xFFFF || Offset + WordCount > SPIRV.size())
+            return false;
+
+        SPIRV[Offset] = (WordCount << spv::WordCountShift) | Opcode;
+        for (uint32_t i = 1; i < WordCount; ++i)
+        {
+            if (!ReadVarUint(pSrc, pEnd, SPIRV[Offset + i]))
+                return false;
+        }
+        Offset += WordCount;
+    }
+
+    return pSrc == pEnd && SPIRV[0] == spv::MagicNumber;
+}
+
+std::vector<Uint8> PostProcessSPIRV(const std::vector<uint32_t>& SPIRV, const SPIRVPostProcessAttribs& Attribs)
+{
+    auto ProcessedSPIRV = Attribs.StripNonSemanticInfo ? StripSPIRVNonSemanticInfo(SPIRV) : SPIRV;
+    if (Attribs.RemapIds)
+        ProcessedSPIRV = RemapSPIRVIds(ProcessedSPIRV);
+
+    if (Attribs.Compress)
+        return CompressSPIRV(ProcessedSPIRV);
+
+    std::vector<Uint8> Data(ProcessedSPIRV.size() * sizeof(uint32_t));
+    if (!Data.empty())
+        memcpy(Data.data(), ProcessedSPIRV.data(), Data.size());
+    return Data;
+}
+
+} // namespace Diligent
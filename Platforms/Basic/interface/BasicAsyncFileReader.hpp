@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Asynchronous file reader interface and the thread-pool based implementation
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include "../../../Primitives/interface/BasicTypes.h"
+
+/// File opened for asynchronous reading
+class BasicAsyncFile
+{
+public:
+    virtual ~BasicAsyncFile() {}
+
+    /// Returns the size of the file at the time it was opened
+    Diligent::Uint64 GetSize() const { return m_Size; }
+
+protected:
+    Diligent::Uint64 m_Size = 0;
+};
+
+/// Asynchronous read request
+struct AsyncReadRequest
+{
+    /// File to read from. The file must not be closed until the read completes.
+    BasicAsyncFile* pFile = nullptr;
+
+    /// Offset in the file to start reading from
+    Diligent::Uint64 Offset = 0;
+
+    /// Caller-provided destination buffer that must stay valid until the read completes
+    void* pBuffer = nullptr;
+
+    /// Number of bytes to read
+    size_t Size = 0;
+};
+
+/// Result of an asynchronous read request
+struct AsyncReadResult
+{
+    /// Number of bytes read. May be less than the requested size if the end of file was reached.
+    size_t BytesRead = 0;
+
+    /// Indicates if the read succeeded
+    bool Succeeded = false;
+};
+
+/// Callback that is invoked from a reader thread once all reads of a batch have completed.
+/// Results are given in the same order as the requests.
+using AsyncReadBatchCallback = std::function<void(const AsyncReadResult* pResults, Diligent::Uint32 NumResults)>;
+
+/// Asynchronous file reader create info
+struct AsyncFileReaderCreateInfo
+{
+    /// The number of worker threads used by the thread-pool implementation
+    Diligent::Uint32 NumWorkerThreads = 2;
+
+    /// The maximum number of reads submitted to the native backend at the same time.
+    /// Reads beyond this limit are queued until earlier reads complete.
+    Diligent::Uint32 QueueDepth = 64;
+};
+
+/// Base class of asynchronous file readers
+class BasicAsyncFileReader
+{
+public:
+    /// \param [in] SlashSymbol - Slash symbol of the platform that OpenFile() converts all slashes in the path to.
+    explicit BasicAsyncFileReader(Diligent::Char SlashSymbol) :
+        m_SlashSymbol{SlashSymbol}
+    {}
+
+    virtual ~BasicAsyncFileReader() {}
+
+    /// Opens the file for asynchronous reading. Returns null if the file can't be opened.
+    /// Both forward and back slashes may be used in the path.
+    std::unique_ptr<BasicAsyncFile> OpenFile(const Diligent::Char* strFilePath);
+
+    /// Submits a batch of reads. The callback is invoked once when all reads of the batch have completed.
+    /// Reads within the batch are issued in the order they are given.
+    virtual void SubmitReads(const AsyncReadRequest* pRequests, Diligent::Uint32 NumRequests, AsyncReadBatchCallback Callback) = 0;
+
+    /// Returns the name of the backend used by the reader
+    virtual const Diligent::Char* GetBackendName() const = 0;
+
+    /// Waits until all submitted batches have completed and their callbacks have returned
+    void WaitIdle();
+
+protected:
+    /// Opens the file; all slashes in the path have been converted to the platform slash symbol.
+    virtual std::unique_ptr<BasicAsyncFile> OpenFileImpl(const Diligent::Char* strFilePath) = 0;
+
+    struct ReadBatch
+    {
+        ReadBatch(Diligent::Uint32 NumRequests, AsyncReadBatchCallback&& _Callback) :
+            Results(NumRequests),
+            NumPendingReads{NumRequests},
+            Callback{std::move(_Callback)}
+        {}
+
+        std::vector<AsyncReadResult> Results;
+        Diligent::Uint32             NumPendingReads;
+        AsyncReadBatchCallback       Callback;
+    };
+
+    /// Creates a new batch. Returns null and invokes the callback immediately if the batch is empty.
+    ReadBatch* BeginBatch(Diligent::Uint32 NumRequests, AsyncReadBatchCallback&& Callback);
+
+    /// Records the result of the read. When the last read of the batch completes,
+    /// invokes the callback and destroys the batch.
+    void CompleteRead(ReadBatch* pBatch, Diligent::Uint32 RequestIdx, const AsyncReadResult& Result);
+
+private:
+    const Diligent::Char m_SlashSymbol;
+
+    std::mutex              m_BatchMtx;
+    std::condition_variable m_IdleCondVar;
+    Diligent::Uint32        m_NumPendingBatches = 0;
+};
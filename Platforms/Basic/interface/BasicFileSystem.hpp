@@ -28,7 +28,9 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include "../../../Primitives/interface/BasicTypes.h"
+#include "BasicAsyncFileReader.hpp"
 
 enum class EFileAccessMode
 {
@@ -71,6 +73,28 @@ protected:
     Diligent::String m_Path;
 };
 
+/// Expected access pattern to the contents of a mapped file
+enum class EFileAccessPattern
+{
+    Default,
+    Sequential,
+    Random
+};
+
+/// Read-only view of the contents of a file
+class BasicMappedFile
+{
+public:
+    virtual ~BasicMappedFile() {}
+
+    const void* GetData() const { return m_pData; }
+    size_t      GetSize() const { return m_Size; }
+
+protected:
+    const void* m_pData = nullptr;
+    size_t      m_Size  = 0;
+};
+
 struct FindFileData
 {
     virtual const Diligent::Char* Name() const        = 0;
@@ -89,6 +113,22 @@ public:
 
     static bool FileExists(const Diligent::Char* strFilePath);
 
+    /// Retrieves the time of the last modification of the file, in nanoseconds since the epoch,
+    /// and the file size, in bytes. The time resolution depends on the platform and the file system,
+    /// so the size should also be compared to detect files rewritten within one time tick.
+    /// Returns false if the file does not exist or the information is not available (e.g. for packaged assets).
+    static bool GetFileModificationTime(const Diligent::Char* strFilePath, Diligent::Uint64& Time, Diligent::Uint64& Size);
+
+    /// Makes the contents of the file available in memory. Returns null if the file can't be read.
+    /// Platforms that support memory-mapped files map the file without reading it; the generic
+    /// implementation reads the entire file into memory.
+    static std::unique_ptr<BasicMappedFile> MapFile(const Diligent::Char* strFilePath, EFileAccessPattern AccessPattern = EFileAccessPattern::Default);
+
+    /// Creates an asynchronous file reader. Platforms with native asynchronous I/O use it;
+    /// the generic implementation performs blocking reads on a pool of worker threads.
+    /// SlashSymbol is the slash symbol of the platform that file paths are converted to.
+    static std::unique_ptr<BasicAsyncFileReader> CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo, Diligent::Char SlashSymbol = '/');
+
     static void SetWorkingDirectory(const Diligent::Char* strWorkingDir) { m_strWorkingDirectory = strWorkingDir; }
 
     static const Diligent::String& GetWorkingDirectory() { return m_strWorkingDirectory; }
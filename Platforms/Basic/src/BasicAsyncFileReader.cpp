@@ -0,0 +1,251 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BasicAsyncFileReader.hpp"
+#include "BasicFileSystem.hpp"
+#include "DebugUtilities.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <thread>
+
+std::unique_ptr<BasicAsyncFile> BasicAsyncFileReader::OpenFile(const Diligent::Char* strFilePath)
+{
+    VERIFY(strFilePath != nullptr, "File path must not be null");
+    Diligent::String Path{strFilePath};
+    BasicFileSystem::CorrectSlashes(Path, m_SlashSymbol);
+    return OpenFileImpl(Path.c_str());
+}
+
+void BasicAsyncFileReader::WaitIdle()
+{
+    std::unique_lock<std::mutex> Lock{m_BatchMtx};
+    m_IdleCondVar.wait(Lock, [this] { return m_NumPendingBatches == 0; });
+}
+
+BasicAsyncFileReader::ReadBatch* BasicAsyncFileReader::BeginBatch(Diligent::Uint32 NumRequests, AsyncReadBatchCallback&& Callback)
+{
+    if (NumRequests == 0)
+    {
+        if (Callback)
+            Callback(nullptr, 0);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> Lock{m_BatchMtx};
+    ++m_NumPendingBatches;
+    return new ReadBatch{NumRequests, std::move(Callback)};
+}
+
+void BasicAsyncFileReader::CompleteRead(ReadBatch* pBatch, Diligent::Uint32 RequestIdx, const AsyncReadResult& Result)
+{
+    VERIFY_EXPR(pBatch != nullptr && RequestIdx < pBatch->Results.size());
+    {
+        std::lock_guard<std::mutex> Lock{m_BatchMtx};
+        pBatch->Results[RequestIdx] = Result;
+        VERIFY_EXPR(pBatch->NumPendingReads > 0);
+        if (--pBatch->NumPendingReads > 0)
+            return;
+    }
+
+    // This is the last read of the batch: no other thread references it anymore
+    if (pBatch->Callback)
+        pBatch->Callback(pBatch->Results.data(), static_cast<Diligent::Uint32>(pBatch->Results.size()));
+    delete pBatch;
+
+    std::lock_guard<std::mutex> Lock{m_BatchMtx};
+    VERIFY_EXPR(m_NumPendingBatches > 0);
+    if (--m_NumPendingBatches == 0)
+        m_IdleCondVar.notify_all();
+}
+
+
+namespace
+{
+
+class ThreadPoolAsyncFile final : public BasicAsyncFile
+{
+public:
+    ThreadPoolAsyncFile(FILE* pFile, Diligent::Uint64 Size) :
+        m_pFile{pFile}
+    {
+        m_Size = Size;
+    }
+
+    ~ThreadPoolAsyncFile()
+    {
+        fclose(m_pFile);
+    }
+
+    AsyncReadResult Read(Diligent::Uint64 Offset, void* pBuffer, size_t Size)
+    {
+        AsyncReadResult Result;
+        // Standard file streams have no positional reads, so reads from the same file are serialized
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (Seek(m_pFile, Offset) != 0)
+            return Result;
+
+        Result.BytesRead = Size > 0 ? fread(pBuffer, 1, Size, m_pFile) : 0;
+        Result.Succeeded = Result.BytesRead == Size || feof(m_pFile) != 0;
+        clearerr(m_pFile);
+        return Result;
+    }
+
+    static int Seek(FILE* pFile, Diligent::Uint64 Offset)
+    {
+#ifdef _WIN32
+        return _fseeki64(pFile, static_cast<__int64>(Offset), SEEK_SET);
+#else
+        return fseeko(pFile, static_cast<off_t>(Offset), SEEK_SET);
+#endif
+    }
+
+    static Diligent::Int64 Tell(FILE* pFile)
+    {
+#ifdef _WIN32
+        return _ftelli64(pFile);
+#else
+        return ftello(pFile);
+#endif
+    }
+
+private:
+    FILE* const m_pFile;
+    std::mutex  m_Mtx;
+};
+
+class ThreadPoolAsyncFileReader final : public BasicAsyncFileReader
+{
+public:
+    ThreadPoolAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo, Diligent::Char SlashSymbol) :
+        BasicAsyncFileReader{SlashSymbol}
+    {
+        const auto NumThreads = std::max(CreateInfo.NumWorkerThreads, Diligent::Uint32{1});
+        m_Workers.reserve(NumThreads);
+        for (Diligent::Uint32 i = 0; i < NumThreads; ++i)
+            m_Workers.emplace_back(&ThreadPoolAsyncFileReader::WorkerThreadFunc, this);
+    }
+
+    ~ThreadPoolAsyncFileReader()
+    {
+        WaitIdle();
+        {
+            std::lock_guard<std::mutex> Lock{m_QueueMtx};
+            m_Stop = true;
+        }
+        m_QueueCondVar.notify_all();
+        for (auto& Worker : m_Workers)
+            Worker.join();
+    }
+
+    virtual std::unique_ptr<BasicAsyncFile> OpenFileImpl(const Diligent::Char* strFilePath) override final
+    {
+        FILE* pFile = fopen(strFilePath, "rb");
+        if (pFile == nullptr)
+            return nullptr;
+
+        Diligent::Int64 Size = -1;
+        if (fseek(pFile, 0, SEEK_END) == 0)
+            Size = ThreadPoolAsyncFile::Tell(pFile);
+        if (Size < 0)
+        {
+            fclose(pFile);
+            return nullptr;
+        }
+
+        return std::unique_ptr<BasicAsyncFile>{new ThreadPoolAsyncFile{pFile, static_cast<Diligent::Uint64>(Size)}};
+    }
+
+    virtual void SubmitReads(const AsyncReadRequest* pRequests, Diligent::Uint32 NumRequests, AsyncReadBatchCallback Callback) override final
+    {
+        auto* pBatch = BeginBatch(NumRequests, std::move(Callback));
+        if (pBatch == nullptr)
+            return;
+
+        {
+            std::lock_guard<std::mutex> Lock{m_QueueMtx};
+            for (Diligent::Uint32 i = 0; i < NumRequests; ++i)
+            {
+                VERIFY(pRequests[i].pFile != nullptr, "File must not be null");
+                m_Queue.emplace_back(pRequests[i], pBatch, i);
+            }
+        }
+        m_QueueCondVar.notify_all();
+    }
+
+    virtual const Diligent::Char* GetBackendName() const override final
+    {
+        return "thread pool";
+    }
+
+private:
+    struct QueuedRead
+    {
+        QueuedRead(const AsyncReadRequest& _Request, ReadBatch* _pBatch, Diligent::Uint32 _RequestIdx) :
+            Request{_Request},
+            pBatch{_pBatch},
+            RequestIdx{_RequestIdx}
+        {}
+
+        AsyncReadRequest Request;
+        ReadBatch*       pBatch;
+        Diligent::Uint32 RequestIdx;
+    };
+
+    void WorkerThreadFunc()
+    {
+        for (;;)
+        {
+            std::unique_lock<std::mutex> Lock{m_QueueMtx};
+            m_QueueCondVar.wait(Lock, [this] { return m_Stop || !m_Queue.empty(); });
+            if (m_Queue.empty())
+                return;
+
+            auto Read = m_Queue.front();
+            m_Queue.pop_front();
+            Lock.unlock();
+
+            auto* pFile  = static_cast<ThreadPoolAsyncFile*>(Read.Request.pFile);
+            auto  Result = pFile->Read(Read.Request.Offset, Read.Request.pBuffer, Read.Request.Size);
+            CompleteRead(Read.pBatch, Read.RequestIdx, Result);
+        }
+    }
+
+    std::vector<std::thread> m_Workers;
+
+    std::mutex              m_QueueMtx;
+    std::condition_variable m_QueueCondVar;
+    std::deque<QueuedRead>  m_Queue;
+    bool                    m_Stop = false;
+};
+
+} // namespace
+
+std::unique_ptr<BasicAsyncFileReader> BasicFileSystem::CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo, Diligent::Char SlashSymbol)
+{
+    return std::unique_ptr<BasicAsyncFileReader>{new ThreadPoolAsyncFileReader{CreateInfo, SlashSymbol}};
+}
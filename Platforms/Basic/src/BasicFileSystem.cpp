@@ -28,6 +28,9 @@
 #include "BasicFileSystem.hpp"
 #include "DebugUtilities.hpp"
 #include <algorithm>
+#include <cstdio>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 Diligent::String BasicFileSystem::m_strWorkingDirectory;
 
@@ -92,6 +95,67 @@ bool BasicFileSystem::FileExists(const Diligent::Char* strFilePath)
     return false;
 }
 
+bool BasicFileSystem::GetFileModificationTime(const Diligent::Char* strFilePath, Diligent::Uint64& Time, Diligent::Uint64& Size)
+{
+    struct stat FileStat;
+    if (stat(strFilePath, &FileStat) != 0)
+        return false;
+
+    constexpr Diligent::Uint64 NanosecondsPerSecond = 1000000000;
+#if PLATFORM_MACOS || PLATFORM_IOS
+    Time = static_cast<Diligent::Uint64>(FileStat.st_mtimespec.tv_sec) * NanosecondsPerSecond + static_cast<Diligent::Uint64>(FileStat.st_mtimespec.tv_nsec);
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+    Time = static_cast<Diligent::Uint64>(FileStat.st_mtim.tv_sec) * NanosecondsPerSecond + static_cast<Diligent::Uint64>(FileStat.st_mtim.tv_nsec);
+#else
+    // Only whole seconds are available
+    Time = static_cast<Diligent::Uint64>(FileStat.st_mtime) * NanosecondsPerSecond;
+#endif
+    Size = static_cast<Diligent::Uint64>(FileStat.st_size);
+    return true;
+}
+
+namespace
+{
+
+class BufferedMappedFile final : public BasicMappedFile
+{
+public:
+    bool Load(const Diligent::Char* strFilePath)
+    {
+        FILE* pFile = fopen(strFilePath, "rb");
+        if (pFile == nullptr)
+            return false;
+
+        bool Succeeded = fseek(pFile, 0, SEEK_END) == 0;
+        long Size      = Succeeded ? ftell(pFile) : -1;
+        Succeeded      = Size >= 0 && fseek(pFile, 0, SEEK_SET) == 0;
+        if (Succeeded)
+        {
+            m_Buffer.resize(static_cast<size_t>(Size));
+            Succeeded = m_Buffer.empty() || fread(m_Buffer.data(), 1, m_Buffer.size(), pFile) == m_Buffer.size();
+        }
+        fclose(pFile);
+
+        m_pData = m_Buffer.data();
+        m_Size  = m_Buffer.size();
+        return Succeeded;
+    }
+
+private:
+    std::vector<Diligent::Uint8> m_Buffer;
+};
+
+} // namespace
+
+std::unique_ptr<BasicMappedFile> BasicFileSystem::MapFile(const Diligent::Char* strFilePath, EFileAccessPattern AccessPattern)
+{
+    std::unique_ptr<BufferedMappedFile> pFile{new BufferedMappedFile};
+    if (!pFile->Load(strFilePath))
+        return nullptr;
+
+    return std::unique_ptr<BasicMappedFile>{pFile.release()};
+}
+
 Diligent::Char BasicFileSystem::GetSlashSymbol()
 {
     UNSUPPORTED("Unsupported");
@@ -46,4 +46,8 @@ public:
     static void DeleteFile(const Diligent::Char* strPath);
 
     static std::vector<std::unique_ptr<FindFileData>> Search(const Diligent::Char* SearchPattern);
+
+    static std::unique_ptr<BasicMappedFile> MapFile(const Diligent::Char* strFilePath, EFileAccessPattern AccessPattern = EFileAccessPattern::Default);
+
+    static std::unique_ptr<BasicAsyncFileReader> CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo);
 };
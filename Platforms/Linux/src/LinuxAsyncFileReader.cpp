@@ -0,0 +1,436 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "LinuxFileSystem.hpp"
+#include "Errors.hpp"
+#include "DebugUtilities.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        include <linux/io_uring.h>
+#        include <sys/syscall.h>
+#        if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#            define HAS_IO_URING 1
+#        endif
+#    endif
+#endif
+
+#ifndef HAS_IO_URING
+#    define HAS_IO_URING 0
+#endif
+
+#if HAS_IO_URING
+
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/uio.h>
+
+namespace
+{
+
+class IOUringAsyncFile final : public BasicAsyncFile
+{
+public:
+    IOUringAsyncFile(int fd, Diligent::Uint64 Size) :
+        m_fd{fd}
+    {
+        m_Size = Size;
+    }
+
+    ~IOUringAsyncFile()
+    {
+        close(m_fd);
+    }
+
+    int GetFd() const { return m_fd; }
+
+private:
+    const int m_fd;
+};
+
+/// Asynchronous file reader that submits reads to an io_uring instance.
+/// Reads are submitted by the thread that calls SubmitReads() and completed
+/// by a single thread that waits on the completion queue.
+class IOUringAsyncFileReader final : public BasicAsyncFileReader
+{
+public:
+    static std::unique_ptr<BasicAsyncFileReader> Create(const AsyncFileReaderCreateInfo& CreateInfo)
+    {
+        std::unique_ptr<IOUringAsyncFileReader> pReader{new IOUringAsyncFileReader};
+        if (!pReader->Initialize(CreateInfo))
+            return nullptr;
+
+        pReader->m_CompletionThread = std::thread{&IOUringAsyncFileReader::CompletionThreadFunc, pReader.get()};
+        return std::unique_ptr<BasicAsyncFileReader>{pReader.release()};
+    }
+
+    ~IOUringAsyncFileReader()
+    {
+        if (m_CompletionThread.joinable())
+        {
+            WaitIdle();
+            {
+                // A no-op with null user data stops the completion thread
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                auto&                       SQE = GetNextSQE();
+                SQE.opcode                      = IORING_OP_NOP;
+                SQE.user_data                   = 0;
+                PublishSQE();
+                Submit(1);
+            }
+            m_CompletionThread.join();
+        }
+
+        if (m_pSQEs != nullptr)
+            munmap(m_pSQEs, m_SQEsSize);
+        if (m_pCQRing != nullptr && m_pCQRing != m_pSQRing)
+            munmap(m_pCQRing, m_CQRingSize);
+        if (m_pSQRing != nullptr)
+            munmap(m_pSQRing, m_SQRingSize);
+        if (m_RingFd >= 0)
+            close(m_RingFd);
+    }
+
+    virtual std::unique_ptr<BasicAsyncFile> OpenFileImpl(const Diligent::Char* strFilePath) override final
+    {
+        int fd = open(strFilePath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return nullptr;
+
+        struct stat FileStat;
+        if (fstat(fd, &FileStat) != 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        return std::unique_ptr<BasicAsyncFile>{new IOUringAsyncFile{fd, static_cast<Diligent::Uint64>(FileStat.st_size)}};
+    }
+
+    virtual void SubmitReads(const AsyncReadRequest* pRequests, Diligent::Uint32 NumRequests, AsyncReadBatchCallback Callback) override final
+    {
+        auto* pBatch = BeginBatch(NumRequests, std::move(Callback));
+        if (pBatch == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        for (Diligent::Uint32 i = 0; i < NumRequests; ++i)
+        {
+            VERIFY(pRequests[i].pFile != nullptr, "File must not be null");
+            m_PendingReads.emplace_back(pRequests[i], pBatch, i);
+        }
+        SubmitPendingReads();
+    }
+
+    virtual const Diligent::Char* GetBackendName() const override final
+    {
+        return "io_uring";
+    }
+
+private:
+    IOUringAsyncFileReader() :
+        BasicAsyncFileReader{LinuxFileSystem::GetSlashSymbol()}
+    {}
+
+    struct PendingRead
+    {
+        PendingRead(const AsyncReadRequest& _Request, ReadBatch* _pBatch, Diligent::Uint32 _RequestIdx) :
+            Request{_Request},
+            pBatch{_pBatch},
+            RequestIdx{_RequestIdx}
+        {}
+
+        AsyncReadRequest Request;
+        ReadBatch*       pBatch;
+        Diligent::Uint32 RequestIdx;
+    };
+
+    struct InFlightRead
+    {
+        AsyncReadRequest Request;
+        ReadBatch*       pBatch     = nullptr;
+        Diligent::Uint32 RequestIdx = 0;
+        size_t           BytesRead  = 0;
+        iovec            IOVec      = {};
+    };
+
+    struct CompletedRead
+    {
+        ReadBatch*       pBatch;
+        Diligent::Uint32 RequestIdx;
+        AsyncReadResult  Result;
+    };
+
+    bool Initialize(const AsyncFileReaderCreateInfo& CreateInfo)
+    {
+        // One extra entry is reserved for the no-op that stops the completion thread
+        const auto QueueDepth = std::max(CreateInfo.QueueDepth, Diligent::Uint32{1});
+
+        io_uring_params Params;
+        memset(&Params, 0, sizeof(Params));
+        m_RingFd = static_cast<int>(syscall(__NR_io_uring_setup, QueueDepth + 1, &Params));
+        if (m_RingFd < 0)
+            return false;
+
+        m_SQRingSize = Params.sq_off.array + Params.sq_entries * sizeof(Diligent::Uint32);
+        m_CQRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+        m_SQEsSize   = Params.sq_entries * sizeof(io_uring_sqe);
+
+        const bool SingleMMap = (Params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (SingleMMap)
+            m_SQRingSize = m_CQRingSize = std::max(m_SQRingSize, m_CQRingSize);
+
+        m_pSQRing = MapRing(m_SQRingSize, IORING_OFF_SQ_RING);
+        if (m_pSQRing == nullptr)
+            return false;
+
+        m_pCQRing = SingleMMap ? m_pSQRing : MapRing(m_CQRingSize, IORING_OFF_CQ_RING);
+        if (m_pCQRing == nullptr)
+            return false;
+
+        m_pSQEs = static_cast<io_uring_sqe*>(MapRing(m_SQEsSize, IORING_OFF_SQES));
+        if (m_pSQEs == nullptr)
+            return false;
+
+        auto* pSQRing = static_cast<Diligent::Uint8*>(m_pSQRing);
+        m_pSQTail     = reinterpret_cast<unsigned*>(pSQRing + Params.sq_off.tail);
+        m_SQMask      = *reinterpret_cast<unsigned*>(pSQRing + Params.sq_off.ring_mask);
+        m_pSQArray    = reinterpret_cast<unsigned*>(pSQRing + Params.sq_off.array);
+
+        auto* pCQRing = static_cast<Diligent::Uint8*>(m_pCQRing);
+        m_pCQHead     = reinterpret_cast<unsigned*>(pCQRing + Params.cq_off.head);
+        m_pCQTail     = reinterpret_cast<unsigned*>(pCQRing + Params.cq_off.tail);
+        m_CQMask      = *reinterpret_cast<unsigned*>(pCQRing + Params.cq_off.ring_mask);
+        m_pCQEs       = reinterpret_cast<io_uring_cqe*>(pCQRing + Params.cq_off.cqes);
+
+        // Keeping the number of reads in flight below the ring size guarantees that
+        // neither the submission nor the completion queue can overflow.
+        const auto MaxInFlightReads = std::min(QueueDepth, Params.sq_entries - 1);
+        m_InFlightReads.resize(MaxInFlightReads);
+        m_FreeSlots.reserve(MaxInFlightReads);
+        for (Diligent::Uint32 i = 0; i < MaxInFlightReads; ++i)
+            m_FreeSlots.push_back(MaxInFlightReads - 1 - i);
+
+        return true;
+    }
+
+    void* MapRing(size_t Size, off_t Offset)
+    {
+        void* pMapping = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, Offset);
+        return pMapping != MAP_FAILED ? pMapping : nullptr;
+    }
+
+    // All methods below must be called with m_Mtx locked
+
+    io_uring_sqe& GetNextSQE()
+    {
+        auto& SQE = m_pSQEs[*m_pSQTail & m_SQMask];
+        memset(&SQE, 0, sizeof(SQE));
+        return SQE;
+    }
+
+    void PublishSQE()
+    {
+        const auto Tail  = *m_pSQTail;
+        const auto Index = Tail & m_SQMask;
+
+        m_pSQArray[Index] = Index;
+        // Make the entry visible to the kernel before the tail is updated
+        __atomic_store_n(m_pSQTail, Tail + 1, __ATOMIC_RELEASE);
+    }
+
+    void Submit(Diligent::Uint32 NumEntries)
+    {
+        while (NumEntries > 0)
+        {
+            const auto Res = syscall(__NR_io_uring_enter, m_RingFd, NumEntries, 0, 0, nullptr, 0);
+            if (Res < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                LOG_ERROR_MESSAGE("io_uring_enter failed: ", strerror(errno));
+                break;
+            }
+            NumEntries -= static_cast<Diligent::Uint32>(Res);
+        }
+    }
+
+    void QueueRead(Diligent::Uint32 Slot)
+    {
+        auto&      Read   = m_InFlightReads[Slot];
+        const auto Offset = Read.BytesRead;
+
+        Read.IOVec.iov_base = static_cast<Diligent::Uint8*>(Read.Request.pBuffer) + Offset;
+        Read.IOVec.iov_len  = Read.Request.Size - Offset;
+
+        auto& SQE     = GetNextSQE();
+        SQE.opcode    = IORING_OP_READV;
+        SQE.fd        = static_cast<IOUringAsyncFile*>(Read.Request.pFile)->GetFd();
+        SQE.off       = Read.Request.Offset + Offset;
+        SQE.addr      = reinterpret_cast<Diligent::Uint64>(&Read.IOVec);
+        SQE.len       = 1;
+        SQE.user_data = Diligent::Uint64{Slot} + 1;
+        PublishSQE();
+    }
+
+    void SubmitPendingReads()
+    {
+        Diligent::Uint32 NumQueued = 0;
+        while (!m_PendingReads.empty() && !m_FreeSlots.empty())
+        {
+            const auto Slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+
+            const auto& Pending = m_PendingReads.front();
+
+            auto& Read      = m_InFlightReads[Slot];
+            Read.Request    = Pending.Request;
+            Read.pBatch     = Pending.pBatch;
+            Read.RequestIdx = Pending.RequestIdx;
+            Read.BytesRead  = 0;
+            m_PendingReads.pop_front();
+
+            QueueRead(Slot);
+            ++NumQueued;
+        }
+        Submit(NumQueued);
+    }
+
+    void CompletionThreadFunc()
+    {
+        std::vector<CompletedRead> CompletedReads;
+        for (;;)
+        {
+            if (syscall(__NR_io_uring_enter, m_RingFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+            {
+                LOG_ERROR_MESSAGE("io_uring_enter failed: ", strerror(errno));
+                return;
+            }
+
+            bool Stop = false;
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+
+                Diligent::Uint32 NumResubmitted = 0;
+
+                auto       Head = *m_pCQHead;
+                const auto Tail = __atomic_load_n(m_pCQTail, __ATOMIC_ACQUIRE);
+                for (; Head != Tail; ++Head)
+                {
+                    const auto& CQE = m_pCQEs[Head & m_CQMask];
+                    if (CQE.user_data == 0)
+                    {
+                        Stop = true;
+                        continue;
+                    }
+
+                    const auto Slot = static_cast<Diligent::Uint32>(CQE.user_data - 1);
+                    auto&      Read = m_InFlightReads[Slot];
+                    if (CQE.res > 0)
+                    {
+                        Read.BytesRead += static_cast<size_t>(CQE.res);
+                        if (Read.BytesRead < Read.Request.Size)
+                        {
+                            // Short read: request the remaining part
+                            QueueRead(Slot);
+                            ++NumResubmitted;
+                            continue;
+                        }
+                    }
+
+                    CompletedRead Completed;
+                    Completed.pBatch           = Read.pBatch;
+                    Completed.RequestIdx       = Read.RequestIdx;
+                    Completed.Result.BytesRead = Read.BytesRead;
+                    Completed.Result.Succeeded = CQE.res >= 0;
+                    CompletedReads.push_back(Completed);
+                    m_FreeSlots.push_back(Slot);
+                }
+                __atomic_store_n(m_pCQHead, Head, __ATOMIC_RELEASE);
+
+                Submit(NumResubmitted);
+                SubmitPendingReads();
+            }
+
+            for (const auto& Completed : CompletedReads)
+                CompleteRead(Completed.pBatch, Completed.RequestIdx, Completed.Result);
+            CompletedReads.clear();
+
+            if (Stop)
+                return;
+        }
+    }
+
+    int    m_RingFd     = -1;
+    void*  m_pSQRing    = nullptr;
+    void*  m_pCQRing    = nullptr;
+    size_t m_SQRingSize = 0;
+    size_t m_CQRingSize = 0;
+    size_t m_SQEsSize   = 0;
+
+    io_uring_sqe* m_pSQEs    = nullptr;
+    unsigned*     m_pSQTail  = nullptr;
+    unsigned*     m_pSQArray = nullptr;
+    unsigned      m_SQMask   = 0;
+
+    io_uring_cqe* m_pCQEs   = nullptr;
+    unsigned*     m_pCQHead = nullptr;
+    unsigned*     m_pCQTail = nullptr;
+    unsigned      m_CQMask  = 0;
+
+    std::mutex                    m_Mtx;
+    std::deque<PendingRead>       m_PendingReads;
+    std::vector<InFlightRead>     m_InFlightReads;
+    std::vector<Diligent::Uint32> m_FreeSlots;
+
+    std::thread m_CompletionThread;
+};
+
+} // namespace
+
+#endif
+
+std::unique_ptr<BasicAsyncFileReader> LinuxFileSystem::CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo)
+{
+#if HAS_IO_URING
+    if (auto pReader = IOUringAsyncFileReader::Create(CreateInfo))
+        return pReader;
+
+    LOG_INFO_MESSAGE("io_uring is not available. Falling back to the thread-pool asynchronous file reader.");
+#endif
+
+    return BasicFileSystem::CreateAsyncFileReader(CreateInfo, GetSlashSymbol());
+}
@@ -24,6 +24,9 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "LinuxFileSystem.hpp"
 #include "Errors.hpp"
@@ -56,6 +59,76 @@ bool LinuxFileSystem::FileExists(const Diligent::Char* strFilePath)
     return Exists;
 }
 
+namespace
+{
+
+class LinuxMappedFile final : public BasicMappedFile
+{
+public:
+    LinuxMappedFile(void* pMapping, size_t Size) :
+        m_pMapping{pMapping}
+    {
+        m_pData = pMapping;
+        m_Size  = Size;
+    }
+
+    ~LinuxMappedFile()
+    {
+        if (m_pMapping != nullptr)
+            munmap(m_pMapping, m_Size);
+    }
+
+private:
+    void* const m_pMapping;
+};
+
+} // namespace
+
+std::unique_ptr<BasicMappedFile> LinuxFileSystem::MapFile(const Diligent::Char* strFilePath, EFileAccessPattern AccessPattern)
+{
+    FileOpenAttribs OpenAttribs;
+    OpenAttribs.strFilePath = strFilePath;
+    BasicFile   DummyFile(OpenAttribs, LinuxFileSystem::GetSlashSymbol());
+    const auto& Path = DummyFile.GetPath(); // This is necessary to correct slashes
+
+    int fd = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat FileStat;
+    if (fstat(fd, &FileStat) != 0 || !S_ISREG(FileStat.st_mode))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    const auto Size = static_cast<size_t>(FileStat.st_size);
+    if (Size == 0)
+    {
+        // Zero-length mappings are not allowed
+        close(fd);
+        return std::unique_ptr<BasicMappedFile>{new LinuxMappedFile{nullptr, 0}};
+    }
+
+    void* pMapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping remains valid after the descriptor is closed
+    close(fd);
+    if (pMapping == MAP_FAILED)
+    {
+        LOG_WARNING_MESSAGE("Failed to map file '", Path, "'. Falling back to reading the file into memory.");
+        return BasicFileSystem::MapFile(Path.c_str(), AccessPattern);
+    }
+
+    switch (AccessPattern)
+    {
+        case EFileAccessPattern::Sequential: madvise(pMapping, Size, MADV_SEQUENTIAL); break;
+        case EFileAccessPattern::Random: madvise(pMapping, Size, MADV_RANDOM); break;
+        default: break;
+    }
+
+    return std::unique_ptr<BasicMappedFile>{new LinuxMappedFile{pMapping, Size}};
+}
+
 bool LinuxFileSystem::PathExists(const Diligent::Char* strPath)
 {
     UNSUPPORTED("Not implemented");
@@ -73,4 +73,9 @@ public:
     static void DeleteFile(const Diligent::Char* strPath);
 
     static std::vector<std::unique_ptr<FindFileData>> Search(const Diligent::Char* SearchPattern);
+
+    static std::unique_ptr<BasicAsyncFileReader> CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo)
+    {
+        return BasicFileSystem::CreateAsyncFileReader(CreateInfo, GetSlashSymbol());
+    }
 };
@@ -108,6 +108,11 @@ public:
 
     static std::vector<std::unique_ptr<FindFileData>> Search(const Diligent::Char* SearchPattern);
 
+    static std::unique_ptr<BasicAsyncFileReader> CreateAsyncFileReader(const AsyncFileReaderCreateInfo& CreateInfo)
+    {
+        return BasicFileSystem::CreateAsyncFileReader(CreateInfo, GetSlashSymbol());
+    }
+
     static std::string FileDialog(const FileDialogAttribs& DialogAttribs);
 
     static std::string GetCurrentDirectory();
@@ -90,6 +90,8 @@ public:
 
     IRenderDevice*  GetDevice() { return m_pDevice; }
     IDeviceContext* GetDeviceContext() { return m_pDeviceContext; }
+    Uint32          GetNumDeferredContexts() const { return static_cast<Uint32>(m_pDeferredContexts.size()); }
+    IDeviceContext* GetDeferredContext(Uint32 ctx) { return m_pDeferredContexts[ctx]; }
     ISwapChain*     GetSwapChain() { return m_pSwapChain; }
 
     static TestingEnvironment* GetInstance() { return m_pTheEnvironment; }
@@ -126,10 +128,11 @@ protected:
 
     static TestingEnvironment* m_pTheEnvironment;
 
-    RefCntAutoPtr<IRenderDevice>  m_pDevice;
-    RefCntAutoPtr<IDeviceContext> m_pDeviceContext;
-    RefCntAutoPtr<ISwapChain>     m_pSwapChain;
-    SHADER_COMPILER               m_ShaderCompiler = SHADER_COMPILER_DEFAULT;
+    RefCntAutoPtr<IRenderDevice>               m_pDevice;
+    RefCntAutoPtr<IDeviceContext>              m_pDeviceContext;
+    std::vector<RefCntAutoPtr<IDeviceContext>> m_pDeferredContexts;
+    RefCntAutoPtr<ISwapChain>                  m_pSwapChain;
+    SHADER_COMPILER                            m_ShaderCompiler = SHADER_COMPILER_DEFAULT;
 
     static std::atomic_int m_NumAllowedErrors;
 };
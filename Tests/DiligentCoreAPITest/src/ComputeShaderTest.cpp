@@ -32,6 +32,11 @@
 
 #include "InlineShaders/ComputeShaderTestHLSL.h"
 
+#if VULKAN_SUPPORTED && !DILIGENT_NO_GLSLANG
+#    include "GLSLangUtils.hpp"
+#    include "SPIRVUtils.hpp"
+#endif
+
 namespace Diligent
 {
 
@@ -68,15 +73,12 @@ using namespace Diligent::Testing;
 namespace
 {
 
-TEST(ComputeShaderTest, FillTexture)
+// Renders the reference image and fills the back buffer with the compute shader
+// created from ShaderCI, so that the testing swap chain can compare the results.
+void TestFillTexture(const ShaderCreateInfo& ShaderCI)
 {
-    auto* pEnv    = TestingEnvironment::GetInstance();
-    auto* pDevice = pEnv->GetDevice();
-    if (!pDevice->GetDeviceCaps().Features.ComputeShaders)
-    {
-        GTEST_SKIP() << "Compute shaders are not supported by this device";
-    }
-
+    auto* pEnv       = TestingEnvironment::GetInstance();
+    auto* pDevice    = pEnv->GetDevice();
     auto* pSwapChain = pEnv->GetSwapChain();
     auto* pContext   = pEnv->GetDeviceContext();
 
@@ -132,14 +134,6 @@ TEST(ComputeShaderTest, FillTexture)
 
     TestingEnvironment::ScopedReleaseResources EnvironmentAutoReset;
 
-    ShaderCreateInfo ShaderCI;
-    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
-    ShaderCI.ShaderCompiler             = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
-    ShaderCI.UseCombinedTextureSamplers = true;
-    ShaderCI.Desc.ShaderType            = SHADER_TYPE_COMPUTE;
-    ShaderCI.EntryPoint                 = "main";
-    ShaderCI.Desc.Name                  = "Compute shader test";
-    ShaderCI.Source                     = HLSL::FillTextureCS.c_str();
     RefCntAutoPtr<IShader> pCS;
     pDevice->CreateShader(ShaderCI, &pCS);
     ASSERT_NE(pCS, nullptr);
@@ -173,4 +167,56 @@ TEST(ComputeShaderTest, FillTexture)
     pSwapChain->Present();
 }
 
+TEST(ComputeShaderTest, FillTexture)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (!pDevice->GetDeviceCaps().Features.ComputeShaders)
+    {
+        GTEST_SKIP() << "Compute shaders are not supported by this device";
+    }
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.ShaderCompiler             = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+    ShaderCI.UseCombinedTextureSamplers = true;
+    ShaderCI.Desc.ShaderType            = SHADER_TYPE_COMPUTE;
+    ShaderCI.EntryPoint                 = "main";
+    ShaderCI.Desc.Name                  = "Compute shader test";
+    ShaderCI.Source                     = HLSL::FillTextureCS.c_str();
+    TestFillTexture(ShaderCI);
+}
+
+#if VULKAN_SUPPORTED && !DILIGENT_NO_GLSLANG
+// Vulkan shaders must accept the stripped, remapped and compressed byte code directly
+TEST(ComputeShaderTest, FillTexture_PostProcessedSPIRV)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+    if (pDevice->GetDeviceCaps().DevType != RENDER_DEVICE_TYPE_VULKAN)
+    {
+        GTEST_SKIP() << "Post-processed SPIRV is only supported by Vulkan";
+    }
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.UseCombinedTextureSamplers = true;
+    ShaderCI.Desc.ShaderType            = SHADER_TYPE_COMPUTE;
+    ShaderCI.EntryPoint                 = "main";
+    ShaderCI.Desc.Name                  = "Post-processed SPIRV compute shader test";
+    ShaderCI.Source                     = HLSL::FillTextureCS.c_str();
+
+    const auto SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+    ASSERT_FALSE(SPIRV.empty());
+
+    const auto ByteCode = PostProcessSPIRV(std::vector<uint32_t>{SPIRV.begin(), SPIRV.end()}, SPIRVPostProcessAttribs{});
+    ASSERT_TRUE(IsCompressedSPIRV(ByteCode.data(), ByteCode.size()));
+
+    ShaderCI.Source       = nullptr;
+    ShaderCI.ByteCode     = ByteCode.data();
+    ShaderCI.ByteCodeSize = ByteCode.size();
+    TestFillTexture(ShaderCI);
+}
+#endif
+
 } // namespace
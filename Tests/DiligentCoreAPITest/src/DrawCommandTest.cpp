@@ -25,6 +25,9 @@
  *  of the possibility of such damages.
  */
 
+#include <thread>
+#include <vector>
+
 #include "TestingEnvironment.hpp"
 #include "TestingSwapChainBase.hpp"
 #include "BasicMath.hpp"
@@ -1470,4 +1473,96 @@ TEST_F(DrawCommandTest, DrawIndexedInstancedIndirect_FirstInstance_BaseVertex_Fi
     Present();
 }
 
+
+// Deferred contexts
+
+TEST_F(DrawCommandTest, DeferredContexts_ExecuteCommandLists)
+{
+    auto* pEnv = TestingEnvironment::GetInstance();
+    if (pEnv->GetNumDeferredContexts() < 2)
+    {
+        GTEST_SKIP() << "At least two deferred contexts are required for this test";
+    }
+
+    auto* pDevice    = pEnv->GetDevice();
+    auto* pContext   = pEnv->GetDeviceContext();
+    auto* pSwapChain = pEnv->GetSwapChain();
+
+    // clang-format off
+    const Vertex Triangles[] =
+    {
+        Vert[0], Vert[1], Vert[2],
+        Vert[3], Vert[4], Vert[5]
+    };
+    // clang-format on
+
+    auto pVB = CreateVertexBuffer(Triangles, sizeof(Triangles));
+
+    FenceDesc FenceCI;
+    FenceCI.Name = "Execute command lists test fence";
+    RefCntAutoPtr<IFence> pFence;
+    pDevice->CreateFence(FenceCI, &pFence);
+    ASSERT_NE(pFence, nullptr);
+
+    // The clear and all state transitions are recorded in the immediate context. They must be
+    // executed before the command lists, which only verify the states.
+    SetRenderTargets(sm_pDrawPSO);
+    StateTransitionDesc Barrier{pVB, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, true};
+    pContext->TransitionResourceStates(1, &Barrier);
+    // The fence is signaled by the same submission that executes the command lists
+    pContext->SignalFence(pFence, 1);
+
+    // Every command list draws one of the two triangles
+    constexpr Uint32 NumCmdLists = 2;
+
+    ITextureView*                            pRTVs[] = {pSwapChain->GetCurrentBackBufferRTV()};
+    IBuffer*                                 pVBs[]  = {pVB};
+    std::vector<RefCntAutoPtr<ICommandList>> CmdLists(NumCmdLists);
+    std::vector<std::thread>                 Threads(NumCmdLists);
+    for (Uint32 i = 0; i < NumCmdLists; ++i)
+    {
+        Threads[i] = std::thread(
+            [&](Uint32 CtxId) //
+            {
+                auto* pDeferredCtx = pEnv->GetDeferredContext(CtxId);
+
+                pDeferredCtx->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+                pDeferredCtx->SetPipelineState(sm_pDrawPSO);
+
+                Uint32 Offsets[] = {0};
+                pDeferredCtx->SetVertexBuffers(0, 1, pVBs, Offsets, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
+
+                DrawAttribs drawAttrs{3, DRAW_FLAG_VERIFY_ALL};
+                drawAttrs.StartVertexLocation = CtxId * 3;
+                pDeferredCtx->Draw(drawAttrs);
+
+                pDeferredCtx->FinishCommandList(&CmdLists[CtxId]);
+            },
+            i);
+    }
+
+    for (auto& t : Threads)
+        t.join();
+
+    std::vector<ICommandList*> pCmdLists(NumCmdLists);
+    for (Uint32 i = 0; i < NumCmdLists; ++i)
+    {
+        ASSERT_NE(CmdLists[i], nullptr);
+        pCmdLists[i] = CmdLists[i];
+    }
+
+    pContext->ExecuteCommandLists(NumCmdLists, pCmdLists.data());
+    CmdLists.clear();
+    for (Uint32 i = 0; i < NumCmdLists; ++i)
+        pEnv->GetDeferredContext(i)->FinishFrame();
+
+    // Signaling the fence after the command lists must cover all of their work
+    pContext->SignalFence(pFence, 2);
+    pContext->WaitForFence(pFence, 2, true);
+    EXPECT_EQ(pFence->GetCompletedValue(), 2u);
+
+    // Compares the back buffer with the reference image
+    Present();
+}
+
 } // namespace
@@ -31,6 +31,11 @@
 
 #include "TestingEnvironment.hpp"
 
+#if VULKAN_SUPPORTED
+#    include "Vulkan/TestingEnvironmentVk.hpp"
+#    include "DeviceContextVk.h"
+#endif
+
 #include "gtest/gtest.h"
 
 using namespace Diligent;
@@ -449,4 +454,149 @@ TEST_F(QueryTest, Duration)
     }
 }
 
+#if VULKAN_SUPPORTED
+// Ends more queries than fit into one allocation range and reads their results back
+// with a single IDeviceContextVk::GetQueryData() call
+TEST_F(QueryTest, Vk_BulkQueryData)
+{
+    auto* pEnv    = TestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    const auto& deviceCaps = pDevice->GetDeviceCaps();
+    if (deviceCaps.DevType != RENDER_DEVICE_TYPE_VULKAN)
+    {
+        GTEST_SKIP() << "Bulk query data reads are only available in Vulkan";
+    }
+    if (!deviceCaps.Features.TimestampQueries || !deviceCaps.Features.OcclusionQueries)
+    {
+        GTEST_SKIP() << "Timestamp and occlusion queries are not supported by this device";
+    }
+
+    auto* pContext = pEnv->GetDeviceContext();
+
+    RefCntAutoPtr<IDeviceContextVk> pContextVk{pContext, IID_DeviceContextVk};
+    ASSERT_NE(pContextVk, nullptr);
+
+    TestingEnvironment::ScopedReset EnvironmentAutoReset;
+
+    // Default pool sizes give 64 timestamps and 16 occlusion queries per range
+    constexpr Uint32 NumTimestamps        = 100;
+    constexpr Uint32 NumOcclusionQueries  = 40;
+    constexpr Uint32 NumPendingTimestamps = 8;
+
+    auto CreateQueries = [pDevice](QUERY_TYPE Type, Uint32 Count, std::vector<RefCntAutoPtr<IQuery>>& Queries, std::vector<IQuery*>& pQueries) //
+    {
+        QueryDesc queryDesc;
+        queryDesc.Name = "Bulk query data test query";
+        queryDesc.Type = Type;
+
+        Queries.resize(Count);
+        pQueries.resize(Count);
+        for (Uint32 i = 0; i < Count; ++i)
+        {
+            pDevice->CreateQuery(queryDesc, &Queries[i]);
+            ASSERT_NE(Queries[i], nullptr);
+            pQueries[i] = Queries[i];
+        }
+    };
+
+    std::vector<RefCntAutoPtr<IQuery>> Timestamps, OcclusionQueries, PendingTimestamps;
+    std::vector<IQuery*>               pTimestamps, pOcclusionQueries, pPendingTimestamps;
+    CreateQueries(QUERY_TYPE_TIMESTAMP, NumTimestamps, Timestamps, pTimestamps);
+    CreateQueries(QUERY_TYPE_OCCLUSION, NumOcclusionQueries, OcclusionQueries, pOcclusionQueries);
+    CreateQueries(QUERY_TYPE_TIMESTAMP, NumPendingTimestamps, PendingTimestamps, pPendingTimestamps);
+
+    // Query data structures that are not tightly packed
+    struct PaddedOcclusionData
+    {
+        QueryDataOcclusion Data;
+        Uint8              Padding[24];
+    };
+
+    for (Uint32 frame = 0; frame < sm_NumFrames; ++frame)
+    {
+        for (Uint32 i = 0; i < NumTimestamps; ++i)
+        {
+            pContext->EndQuery(pTimestamps[i]);
+            if (i % 16 == 0)
+                DrawQuad();
+        }
+
+        for (Uint32 i = 0; i < NumOcclusionQueries; ++i)
+        {
+            pContext->BeginQuery(pOcclusionQueries[i]);
+            for (Uint32 j = 0; j < 1 + i % 3; ++j)
+                DrawQuad();
+            pContext->EndQuery(pOcclusionQueries[i]);
+        }
+
+        pContext->WaitForIdle();
+
+        // These queries are ended, but not submitted
+        for (Uint32 i = 0; i < NumPendingTimestamps; ++i)
+            pContext->EndQuery(pPendingTimestamps[i]);
+
+        // Partially available results: the call fails for the whole array and leaves the queries valid
+        {
+            std::vector<IQuery*> pAllTimestamps{pTimestamps};
+            pAllTimestamps.insert(pAllTimestamps.end(), pPendingTimestamps.begin(), pPendingTimestamps.end());
+
+            std::vector<QueryDataTimestamp> Data(pAllTimestamps.size());
+            EXPECT_FALSE(pContextVk->GetQueryData(static_cast<Uint32>(pAllTimestamps.size()), pAllTimestamps.data(), Data.data(), sizeof(QueryDataTimestamp)));
+        }
+
+        {
+            std::vector<QueryDataTimestamp> Data(NumTimestamps);
+            ASSERT_TRUE(pContextVk->GetQueryData(NumTimestamps, pTimestamps.data(), Data.data(), sizeof(QueryDataTimestamp), false))
+                << "Data of all submitted queries must be available after idling the context";
+
+            for (Uint32 i = 0; i < NumTimestamps; ++i)
+            {
+                EXPECT_GT(Data[i].Frequency, Uint64{0});
+                if (i > 0)
+                {
+                    EXPECT_GE(Data[i].Counter, Data[i - 1].Counter);
+                }
+
+                // Bulk results must match the results of individual queries
+                QueryDataTimestamp QueryData;
+                ASSERT_TRUE(pTimestamps[i]->GetData(&QueryData, sizeof(QueryData), false));
+                EXPECT_EQ(QueryData.Counter, Data[i].Counter);
+                EXPECT_EQ(QueryData.Frequency, Data[i].Frequency);
+            }
+
+            // Read again and invalidate the queries
+            std::vector<QueryDataTimestamp> Data2(NumTimestamps);
+            ASSERT_TRUE(pContextVk->GetQueryData(NumTimestamps, pTimestamps.data(), Data2.data(), sizeof(QueryDataTimestamp)));
+            EXPECT_EQ(Data2.back().Counter, Data.back().Counter);
+        }
+
+        {
+            std::vector<PaddedOcclusionData> Data(NumOcclusionQueries);
+            ASSERT_TRUE(pContextVk->GetQueryData(NumOcclusionQueries, pOcclusionQueries.data(), &Data[0].Data, sizeof(PaddedOcclusionData)))
+                << "Data of all submitted queries must be available after idling the context";
+
+            const auto NumPixels = sm_TextureSize * sm_TextureSize / 16;
+            for (Uint32 i = 0; i < NumOcclusionQueries; ++i)
+            {
+                const Uint32 DrawCounter = 1 + i % 3;
+                EXPECT_GE(Data[i].Data.NumSamples, NumPixels * DrawCounter);
+            }
+        }
+
+        pContext->Flush();
+        pContext->FinishFrame();
+        pContext->WaitForIdle();
+
+        {
+            std::vector<QueryDataTimestamp> Data(NumPendingTimestamps);
+            ASSERT_TRUE(pContextVk->GetQueryData(NumPendingTimestamps, pPendingTimestamps.data(), Data.data(), sizeof(QueryDataTimestamp)))
+                << "Data of all queries must be available once they are submitted and the context is idle";
+            for (const auto& TimestampData : Data)
+                EXPECT_GT(TimestampData.Frequency, Uint64{0});
+        }
+    }
+}
+#endif
+
 } // namespace
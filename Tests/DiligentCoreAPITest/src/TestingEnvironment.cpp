@@ -127,7 +127,7 @@ TestingEnvironment::TestingEnvironment(RENDER_DEVICE_TYPE   deviceType,
     VERIFY(m_pTheEnvironment == nullptr, "Testing environment object has already been initialized!");
     m_pTheEnvironment = this;
 
-    Uint32 NumDeferredCtx = 0;
+    Uint32 NumDeferredCtx = 4;
 
     std::vector<IDeviceContext*>     ppContexts;
     std::vector<GraphicsAdapterInfo> Adapters;
@@ -288,11 +288,8 @@ TestingEnvironment::TestingEnvironment(RENDER_DEVICE_TYPE   deviceType,
             CreateInfo.CreateDebugContext   = true;
             CreateInfo.Features             = DeviceFeatures{DEVICE_FEATURE_STATE_OPTIONAL};
 
-            if (NumDeferredCtx != 0)
-            {
-                LOG_ERROR_MESSAGE("Deferred contexts are not supported in OpenGL mode");
-                NumDeferredCtx = 0;
-            }
+            // Deferred contexts are not supported in OpenGL mode
+            NumDeferredCtx = 0;
             ppContexts.resize(1 + NumDeferredCtx);
             RefCntAutoPtr<ISwapChain> pSwapChain; // We will use testing swap chain instead
             pFactoryOpenGL->CreateDeviceAndSwapChainGL(
@@ -351,6 +348,9 @@ TestingEnvironment::TestingEnvironment(RENDER_DEVICE_TYPE   deviceType,
             break;
     }
     m_pDeviceContext.Attach(ppContexts[0]);
+    m_pDeferredContexts.resize(NumDeferredCtx);
+    for (Uint32 ctx = 0; ctx < NumDeferredCtx; ++ctx)
+        m_pDeferredContexts[ctx].Attach(ppContexts[1 + ctx]);
 
     const auto& AdapterInfo = m_pDevice->GetDeviceCaps().AdapterInfo;
     std::string AdapterInfoStr;
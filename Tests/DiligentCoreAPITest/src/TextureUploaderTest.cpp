@@ -89,13 +89,12 @@ Uint32 WriteOrVerifyRGBAData(MappedTextureSubresource& MappedData,
     return NumInvalidPixels;
 }
 
-void TextureUploaderTest(bool IsRenderThread)
+void TextureUploaderTest(bool IsRenderThread, const TextureUploaderDesc& UploaderDesc = TextureUploaderDesc{}, bool UploadPartialMip = false)
 {
     auto* pEnv     = TestingEnvironment::GetInstance();
     auto* pDevice  = pEnv->GetDevice();
     auto* pContext = pEnv->GetDeviceContext();
 
-    TextureUploaderDesc             UploaderDesc;
     RefCntAutoPtr<ITextureUploader> pTexUploader;
     CreateTextureUploader(pDevice, UploaderDesc, &pTexUploader);
     ASSERT_TRUE(pTexUploader);
@@ -129,6 +128,12 @@ void TextureUploaderTest(bool IsRenderThread)
     UploadBuffDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
     UploadBuffDesc.MipLevels = 2;
     UploadBuffDesc.ArraySize = 4;
+    if (UploadPartialMip)
+    {
+        // Only the top-left quarter of every destination mip level is updated
+        UploadBuffDesc.Width /= 2;
+        UploadBuffDesc.Height /= 2;
+    }
 
     Uint32 cnt = 0;
     for (Uint32 i = 0; i < 3; ++i)
@@ -201,6 +206,22 @@ void TextureUploaderTest(bool IsRenderThread)
             }
         }
     }
+
+    if (UploaderDesc.StagingMemoryBudget != 0)
+    {
+        auto Stats = pTexUploader->GetStats();
+        EXPECT_LE(Stats.StagingMemorySize, UploaderDesc.StagingMemoryBudget);
+    }
+}
+
+// The ring only fits one 64x32 2-mip 4-slice upload buffer, and the budget does not
+// allow a second ring, so every allocation reuses the space of the previous copy
+TextureUploaderDesc GetRingBufferUploaderDesc()
+{
+    TextureUploaderDesc UploaderDesc;
+    UploaderDesc.RingBufferSize      = 64 << 10;
+    UploaderDesc.StagingMemoryBudget = UploaderDesc.RingBufferSize;
+    return UploaderDesc;
 }
 
 TEST(TextureUploaderTest, RenderThread)
@@ -213,4 +234,14 @@ TEST(TextureUploaderTest, WorkerThread)
     TextureUploaderTest(false);
 }
 
+TEST(TextureUploaderTest, RenderThread_RingBuffer)
+{
+    TextureUploaderTest(true, GetRingBufferUploaderDesc(), true);
+}
+
+TEST(TextureUploaderTest, WorkerThread_RingBuffer)
+{
+    TextureUploaderTest(false, GetRingBufferUploaderDesc(), true);
+}
+
 } // namespace
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Minimal benchmark registration and timing utilities
+
+#include <chrono>
+#include <algorithm>
+
+#include "../../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+using BenchmarkFuncType = void (*)();
+
+/// Registers the benchmark. Benchmarks are run in the order of registration.
+void RegisterBenchmark(const char* Name, BenchmarkFuncType Func);
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* Name, BenchmarkFuncType Func)
+    {
+        RegisterBenchmark(Name, Func);
+    }
+};
+
+/// Runs Func NumRuns times and returns the minimum run time, in seconds.
+template <typename FuncType>
+double MeasureMinTime(Uint32 NumRuns, FuncType&& Func)
+{
+    auto MinTime = std::chrono::duration<double>::max();
+    for (Uint32 Run = 0; Run < NumRuns; ++Run)
+    {
+        const auto StartTime = std::chrono::high_resolution_clock::now();
+        Func();
+        const auto EndTime = std::chrono::high_resolution_clock::now();
+        MinTime            = std::min(MinTime, std::chrono::duration<double>{EndTime - StartTime});
+    }
+    return MinTime.count();
+}
+
+/// Prints the result of a measurement: the time and the number of Units processed per second.
+void ReportResult(const char* Case, double Seconds, double NumUnits, const char* UnitsName);
+
+} // namespace Benchmark
+
+} // namespace Diligent
+
+/// Defines and registers a benchmark function.
+#define DILIGENT_BENCHMARK(Name)                                                                  \
+    static void                                          Name##Benchmark();                       \
+    static const Diligent::Benchmark::BenchmarkRegistrar Name##Registrar{#Name, Name##Benchmark}; \
+    static void                                          Name##Benchmark()
@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <cstdio>
+
+#include "Benchmark.hpp"
+#include "MappedFileDataBlob.hpp"
+#include "FileWrapper.hpp"
+#include "FastRand.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Adds up one byte per cache line so that the result depends on every page of the data
+Uint64 TouchData(const Uint8* pData, size_t Size)
+{
+    Uint64 Sum = 0;
+    for (size_t i = 0; i < Size; i += 64)
+        Sum += pData[i];
+    return Sum;
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(MappedFileRead)
+{
+    constexpr size_t FileSize   = size_t{256} << 20;
+    constexpr size_t PageSize   = 4096;
+    constexpr size_t NumPages   = 16384;
+    const char*      FileName   = "DiligentCoreBenchmark_MappedFileRead.tmp";
+    const double     FileSizeMB = static_cast<double>(FileSize) / double{1 << 20};
+
+    {
+        FileWrapper File{FileName, EFileAccessMode::Overwrite};
+        if (!File)
+        {
+            LOG_ERROR_MESSAGE("Failed to create ", FileName);
+            return;
+        }
+        std::vector<Uint8> Chunk(size_t{1} << 20);
+        FastRandInt        Rnd{0, 0, 255};
+        for (auto& Val : Chunk)
+            Val = static_cast<Uint8>(Rnd());
+        for (size_t Offset = 0; Offset < FileSize; Offset += Chunk.size())
+            File->Write(Chunk.data(), Chunk.size());
+    }
+
+    // Page offsets for random access
+    std::vector<size_t> PageOffsets(NumPages);
+    {
+        // The file has more pages than FastRandInt can address, so two 15-bit values are combined
+        constexpr size_t NumFilePages = FileSize / PageSize;
+        FastRand         Rnd{0};
+        for (auto& Offset : PageOffsets)
+        {
+            const size_t RndVal = (size_t{Rnd()} << 15) | size_t{Rnd()};
+            Offset              = RndVal % NumFilePages * PageSize;
+        }
+    }
+
+    // The file was just written, so all measurements are done with a warm page cache
+    volatile Uint64 Sum = 0;
+
+    const auto ReadTime = MeasureMinTime(3, [&]() {
+        FileWrapper        File{FileName};
+        std::vector<Uint8> Data(File->GetSize());
+        File->Read(Data.data(), Data.size());
+        Sum = Sum + TouchData(Data.data(), Data.size());
+    });
+    ReportResult("Sequential, read into memory", ReadTime, FileSizeMB, "MB");
+
+    const auto MapSeqTime = MeasureMinTime(3, [&]() {
+        auto pBlob = MappedFileDataBlob::Create(FileName, EFileAccessPattern::Sequential);
+        Sum        = Sum + TouchData(static_cast<const Uint8*>(pBlob->GetConstDataPtr()), pBlob->GetSize());
+    });
+    ReportResult("Sequential, memory-mapped", MapSeqTime, FileSizeMB, "MB");
+
+    const auto SeekTime = MeasureMinTime(3, [&]() {
+        FileWrapper        File{FileName};
+        std::vector<Uint8> Page(PageSize);
+        for (auto Offset : PageOffsets)
+        {
+            File->SetPos(Offset, FilePosOrigin::Start);
+            File->Read(Page.data(), PageSize);
+            Sum = Sum + TouchData(Page.data(), PageSize);
+        }
+    });
+    ReportResult("Random 4 KB pages, seek and read", SeekTime, static_cast<double>(NumPages), "pages");
+
+    const auto MapRandTime = MeasureMinTime(3, [&]() {
+        auto        pBlob = MappedFileDataBlob::Create(FileName, EFileAccessPattern::Random);
+        const auto* pData = static_cast<const Uint8*>(pBlob->GetConstDataPtr());
+        for (auto Offset : PageOffsets)
+            Sum = Sum + TouchData(pData + Offset, PageSize);
+    });
+    ReportResult("Random 4 KB pages, memory-mapped", MapRandTime, static_cast<double>(NumPages), "pages");
+
+    std::remove(FileName);
+}
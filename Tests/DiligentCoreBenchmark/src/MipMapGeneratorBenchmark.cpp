@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <string>
+
+#include "Benchmark.hpp"
+#include "MipMapGenerator.hpp"
+#include "FastRand.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+DILIGENT_BENCHMARK(MipMapGenerator)
+{
+    constexpr Uint32 Width     = 2048;
+    constexpr Uint32 Height    = 2048;
+    constexpr Uint32 MipLevels = 12;
+
+    std::vector<std::vector<Uint8>> MipData(MipLevels);
+    std::vector<MipLevelData>       Levels(MipLevels);
+    for (Uint32 Mip = 0; Mip < MipLevels; ++Mip)
+    {
+        const auto MipWidth  = std::max(Width >> Mip, 1u);
+        const auto MipHeight = std::max(Height >> Mip, 1u);
+        MipData[Mip].resize(size_t{MipWidth} * MipHeight * 4);
+        Levels[Mip].pData  = MipData[Mip].data();
+        Levels[Mip].Stride = MipWidth * 4;
+    }
+
+    FastRandInt Rnd{0, 0, 255};
+    for (auto& Val : MipData[0])
+        Val = static_cast<Uint8>(Rnd());
+
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        for (Uint32 NumThreads : {1u, 0u})
+        {
+            const std::string Case = std::string{FilterType == MIP_FILTER_TYPE_BOX ? "Box" : "Kaiser"} +
+                ", RGBA8_UNORM_SRGB 2048x2048, " + (NumThreads == 0 ? "all threads" : "1 thread");
+
+            ComputeMipLevelAttribs LevelAttribs;
+            LevelAttribs.Format          = TEX_FORMAT_RGBA8_UNORM_SRGB;
+            LevelAttribs.FineMipWidth    = Width;
+            LevelAttribs.FineMipHeight   = Height;
+            LevelAttribs.pFineMipData    = MipData[0].data();
+            LevelAttribs.FineMipStride   = Levels[0].Stride;
+            LevelAttribs.pCoarseMipData  = MipData[1].data();
+            LevelAttribs.CoarseMipStride = Levels[1].Stride;
+            LevelAttribs.FilterType      = FilterType;
+            LevelAttribs.NumThreads      = NumThreads;
+
+            const auto LevelTime = MeasureMinTime(5, [&]() { ComputeMipLevel(LevelAttribs); });
+            ReportResult((Case + ", mip 1").c_str(), LevelTime, double{Width} * Height / 1e6, "MPix");
+
+            GenerateMipChainAttribs ChainAttribs;
+            ChainAttribs.Format     = TEX_FORMAT_RGBA8_UNORM_SRGB;
+            ChainAttribs.Width      = Width;
+            ChainAttribs.Height     = Height;
+            ChainAttribs.MipLevels  = MipLevels;
+            ChainAttribs.pMipLevels = Levels.data();
+            ChainAttribs.FilterType = FilterType;
+            ChainAttribs.NumThreads = NumThreads;
+
+            const auto ChainTime = MeasureMinTime(5, [&]() { GenerateMipChain(ChainAttribs); });
+            ReportResult((Case + ", full chain").c_str(), ChainTime, double{Width} * Height / 1e6, "MPix");
+        }
+    }
+}
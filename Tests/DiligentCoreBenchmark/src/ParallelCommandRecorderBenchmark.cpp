@@ -0,0 +1,263 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+#include "Benchmark.hpp"
+#include "EngineFactoryVk.h"
+#include "ParallelCommandRecorder.hpp"
+#include "MapHelper.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "DebugUtilities.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Every draw moves a small triangle by the offset from the dynamic constant buffer
+const char* const VSSource = R"(
+cbuffer Constants
+{
+    float4 g_Offset;
+};
+
+float4 main(uint VertId : SV_VertexID) : SV_Position
+{
+    float2 Pos[3];
+    Pos[0] = float2(-1.0, -1.0);
+    Pos[1] = float2( 0.0, +1.0);
+    Pos[2] = float2(+1.0, -1.0);
+    return float4(Pos[VertId] * 0.01 + g_Offset.xy, 0.0, 1.0);
+}
+)";
+
+const char* const PSSource = R"(
+float4 main() : SV_Target
+{
+    return float4(1.0, 0.0, 0.0, 1.0);
+}
+)";
+
+} // namespace
+
+// Runs on any Vulkan implementation, including lavapipe (VK_ICD_FILENAMES=<path>/lvp_icd.x86_64.json).
+// Only the recording time is measured: the GPU is idled between the runs.
+DILIGENT_BENCHMARK(ParallelCommandRecorder)
+{
+#if EXPLICITLY_LOAD_ENGINE_VK_DLL
+    auto GetEngineFactoryVk = LoadGraphicsEngineVk();
+    if (GetEngineFactoryVk == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to load the Vulkan engine");
+        return;
+    }
+#endif
+
+    const Uint32 MaxDeferredContexts = std::max(std::min(std::thread::hardware_concurrency(), 8u), 1u);
+
+    EngineVkCreateInfo EngineCI;
+    EngineCI.NumDeferredContexts = MaxDeferredContexts;
+
+    RefCntAutoPtr<IRenderDevice> pDevice;
+    std::vector<IDeviceContext*> ppContexts(1 + MaxDeferredContexts);
+    GetEngineFactoryVk()->CreateDeviceAndContextsVk(EngineCI, &pDevice, ppContexts.data());
+    if (!pDevice)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the Vulkan device");
+        return;
+    }
+
+    RefCntAutoPtr<IDeviceContext>              pImmediateCtx;
+    std::vector<RefCntAutoPtr<IDeviceContext>> DeferredContexts(MaxDeferredContexts);
+    pImmediateCtx.Attach(ppContexts[0]);
+    for (Uint32 i = 0; i < MaxDeferredContexts; ++i)
+        DeferredContexts[i].Attach(ppContexts[1 + i]);
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Parallel recording benchmark render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = 256;
+    TexDesc.Height    = 256;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+    RefCntAutoPtr<ITexture> pRenderTarget;
+    pDevice->CreateTexture(TexDesc, nullptr, &pRenderTarget);
+
+    BufferDesc CBDesc;
+    CBDesc.Name           = "Parallel recording benchmark constants";
+    CBDesc.uiSizeInBytes  = sizeof(float) * 4;
+    CBDesc.BindFlags      = BIND_UNIFORM_BUFFER;
+    CBDesc.Usage          = USAGE_DYNAMIC;
+    CBDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+    RefCntAutoPtr<IBuffer> pConstants;
+    pDevice->CreateBuffer(CBDesc, nullptr, &pConstants);
+
+    if (!pRenderTarget || !pConstants)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the benchmark resources");
+        return;
+    }
+    auto* pRTV = pRenderTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.EntryPoint     = "main";
+
+    RefCntAutoPtr<IShader> pVS;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_VERTEX;
+    ShaderCI.Desc.Name       = "Parallel recording benchmark VS";
+    ShaderCI.Source          = VSSource;
+    pDevice->CreateShader(ShaderCI, &pVS);
+
+    RefCntAutoPtr<IShader> pPS;
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+    ShaderCI.Desc.Name       = "Parallel recording benchmark PS";
+    ShaderCI.Source          = PSSource;
+    pDevice->CreateShader(ShaderCI, &pPS);
+
+    if (!pVS || !pPS)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the benchmark shaders");
+        return;
+    }
+
+    PipelineStateCreateInfo PSOCreateInfo;
+    PipelineStateDesc&      PSODesc = PSOCreateInfo.PSODesc;
+
+    PSODesc.Name                                          = "Parallel recording benchmark PSO";
+    PSODesc.PipelineType                                  = PIPELINE_TYPE_GRAPHICS;
+    PSODesc.GraphicsPipeline.NumRenderTargets             = 1;
+    PSODesc.GraphicsPipeline.RTVFormats[0]                = TexDesc.Format;
+    PSODesc.GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    PSODesc.GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+    PSODesc.GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+    PSODesc.GraphicsPipeline.pVS                          = pVS;
+    PSODesc.GraphicsPipeline.pPS                          = pPS;
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    pDevice->CreatePipelineState(PSOCreateInfo, &pPSO);
+    if (!pPSO)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the benchmark pipeline state");
+        return;
+    }
+
+    auto* pConstantsVar = pPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "Constants");
+    if (pConstantsVar == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Static variable 'Constants' is not found in the benchmark pipeline state");
+        return;
+    }
+    pConstantsVar->Set(pConstants);
+
+    RefCntAutoPtr<IShaderResourceBinding> pSRB;
+    pPSO->CreateShaderResourceBinding(&pSRB, true);
+    if (!pSRB)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the benchmark shader resource binding");
+        return;
+    }
+
+    // Put the render target into the required state once, so that the
+    // contexts can only verify it while recording in parallel
+    ITextureView* pRTVs[] = {pRTV};
+    pImmediateCtx->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pImmediateCtx->Flush();
+
+    constexpr Uint32 NumDraws = 20000;
+
+    auto RecordDraws = [&](IDeviceContext* pCtx, Uint32 FirstItem, Uint32 NumItems) {
+        pCtx->SetRenderTargets(1, pRTVs, nullptr, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        pCtx->SetPipelineState(pPSO);
+        pCtx->CommitShaderResources(pSRB, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        for (Uint32 i = FirstItem; i < FirstItem + NumItems; ++i)
+        {
+            {
+                MapHelper<float> Offset{pCtx, pConstants, MAP_WRITE, MAP_FLAG_DISCARD};
+                Offset[0] = static_cast<float>(i % 100) * 0.02f - 1.f;
+                Offset[1] = static_cast<float>(i / 100 % 100) * 0.02f - 1.f;
+                Offset[2] = 0;
+                Offset[3] = 0;
+            }
+            pCtx->Draw(DrawAttribs{3, DRAW_FLAG_NONE});
+        }
+    };
+
+    // Measures the minimum recording time and waits for the GPU after every run
+    auto MeasureRecording = [&](const std::function<void()>& Record, const std::function<void()>& FinishFrame) {
+        double MinTime = 0;
+        for (Uint32 Run = 0; Run < 5; ++Run)
+        {
+            const auto Time = MeasureMinTime(1, Record);
+            MinTime         = Run == 0 ? Time : std::min(MinTime, Time);
+
+            pImmediateCtx->Flush();
+            FinishFrame();
+            pImmediateCtx->FinishFrame();
+            pDevice->IdleGPU();
+        }
+        return MinTime;
+    };
+
+    {
+        const auto Time = MeasureRecording(
+            [&]() { RecordDraws(pImmediateCtx, 0, NumDraws); },
+            []() {});
+        ReportResult("Immediate context, 20000 draws", Time, NumDraws, "draws");
+    }
+
+    std::vector<Uint32> NumContextsToTest;
+    for (Uint32 NumContexts = 1; NumContexts < MaxDeferredContexts; NumContexts *= 2)
+        NumContextsToTest.push_back(NumContexts);
+    NumContextsToTest.push_back(MaxDeferredContexts);
+
+    for (auto NumContexts : NumContextsToTest)
+    {
+        std::vector<IDeviceContext*> ppDeferredContexts(NumContexts);
+        for (Uint32 i = 0; i < NumContexts; ++i)
+            ppDeferredContexts[i] = DeferredContexts[i];
+
+        ParallelCommandRecorderCreateInfo RecorderCI;
+        RecorderCI.ppDeferredContexts  = ppDeferredContexts.data();
+        RecorderCI.NumDeferredContexts = NumContexts;
+        RecorderCI.MinItemsPerContext  = 256;
+        ParallelCommandRecorder Recorder{RecorderCI};
+
+        const auto Time = MeasureRecording(
+            [&]() { Recorder.Record(pImmediateCtx, NumDraws, RecordDraws); },
+            [&]() { Recorder.FinishFrame(); });
+
+        const auto Case = std::to_string(NumContexts) + (NumContexts == 1 ? " deferred context" : " deferred contexts") + ", 20000 draws";
+        ReportResult(Case.c_str(), Time, NumDraws, "draws");
+    }
+}
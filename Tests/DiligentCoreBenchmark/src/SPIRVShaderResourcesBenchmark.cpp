@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "Benchmark.hpp"
+#include "SPIRVShaderResources.hpp"
+#include "GLSLangUtils.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "DebugUtilities.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+DILIGENT_BENCHMARK(SPIRVShaderResources)
+{
+    // Pixel shader with a typical number of resources
+    constexpr Uint32 NumTextures = 16;
+
+    std::stringstream ss;
+    ss << "cbuffer Constants { float4 g_Scale[" << NumTextures << "]; };\n";
+    for (Uint32 t = 0; t < NumTextures; ++t)
+        ss << "Texture2D g_Tex" << t << "; SamplerState g_Tex" << t << "_sampler;\n";
+    ss << "StructuredBuffer<float4> g_Data;\n"
+          "RWTexture2D<float4> g_RWTex;\n"
+          "float4 main(float4 Pos : SV_Position, float2 UV : TEX_COORD) : SV_Target\n"
+          "{\n"
+          "    float4 Color = g_Data[0] + g_RWTex[uint2(0, 0)];\n";
+    for (Uint32 t = 0; t < NumTextures; ++t)
+        ss << "    Color += g_Tex" << t << ".Sample(g_Tex" << t << "_sampler, UV) * g_Scale[" << t << "];\n";
+    ss << "    return Color;\n"
+          "}\n";
+    const auto Source = ss.str();
+
+    GLSLangUtils::InitializeGlslang();
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Source          = Source.c_str();
+    ShaderCI.EntryPoint      = "main";
+    ShaderCI.Desc.Name       = "SPIRVShaderResources benchmark";
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_PIXEL;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+
+    const auto SPIRVData = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+    GLSLangUtils::FinalizeGlslang();
+    if (SPIRVData.empty())
+    {
+        LOG_ERROR_MESSAGE("Failed to compile the SPIRV reflection benchmark shader");
+        return;
+    }
+    const std::vector<uint32_t> SPIRV{SPIRVData.begin(), SPIRVData.end()};
+
+    constexpr Uint32 NumShaders = 100;
+    const char*      Suffix     = "_sampler";
+    auto&            Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+
+    std::vector<Uint8> SerializedData;
+    {
+        std::string          EntryPoint;
+        SPIRVShaderResources Resources{Allocator, nullptr, SPIRV, ShaderCI.Desc, Suffix, false, EntryPoint};
+        Resources.Serialize(SPIRV, EntryPoint, SerializedData);
+    }
+
+    const auto ReflectionTime = MeasureMinTime(5, [&]() {
+        for (Uint32 i = 0; i < NumShaders; ++i)
+        {
+            std::string          EntryPoint;
+            SPIRVShaderResources Resources{Allocator, nullptr, SPIRV, ShaderCI.Desc, Suffix, false, EntryPoint};
+        }
+    });
+    ReportResult("Reflection, 16 combined samplers", ReflectionTime, NumShaders, "shaders");
+
+    const auto RestoreTime = MeasureMinTime(5, [&]() {
+        for (Uint32 i = 0; i < NumShaders; ++i)
+        {
+            std::string          EntryPoint;
+            SPIRVShaderResources Resources{Allocator, SerializedData.data(), SerializedData.size(), SPIRV, ShaderCI.Desc, Suffix, EntryPoint};
+        }
+    });
+    ReportResult("Deserialization, 16 combined samplers", RestoreTime, NumShaders, "shaders");
+}
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include "Benchmark.hpp"
+#include "PlatformDefinitions.h"
+#include "TrackingMemoryAllocator.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "WorkerThreadPool.hpp"
+#include "FastRand.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Allocation sites used by the benchmark threads
+const Char* const SiteDescriptions[] = {
+    "Benchmark site 0",
+    "Benchmark site 1",
+    "Benchmark site 2",
+    "Benchmark site 3",
+    "Benchmark site 4",
+    "Benchmark site 5",
+    "Benchmark site 6",
+    "Benchmark site 7",
+};
+
+// Every thread keeps a window of live allocations of random sizes, and replaces
+// a random allocation from the window with a new one on every iteration.
+void AllocateAndFree(IMemoryAllocator& Allocator, Uint32 Seed, Uint32 NumIterations)
+{
+    constexpr size_t NumLiveAllocations = 64;
+    constexpr Uint32 NumSites           = _countof(SiteDescriptions);
+
+    FastRandInt RndSize{Seed, 16, 512};
+    FastRandInt RndIdx{Seed + 1, 0, static_cast<int>(NumLiveAllocations - 1)};
+
+    std::vector<void*> Allocations(NumLiveAllocations);
+    for (size_t i = 0; i < NumLiveAllocations; ++i)
+        Allocations[i] = Allocator.Allocate(static_cast<size_t>(RndSize()), SiteDescriptions[i % NumSites], __FILE__, __LINE__);
+
+    for (Uint32 i = 0; i < NumIterations; ++i)
+    {
+        auto& pMem = Allocations[RndIdx()];
+        Allocator.Free(pMem);
+        pMem = Allocator.Allocate(static_cast<size_t>(RndSize()), SiteDescriptions[i % NumSites], __FILE__, __LINE__);
+    }
+
+    for (auto* pMem : Allocations)
+        Allocator.Free(pMem);
+}
+
+} // namespace
+
+DILIGENT_BENCHMARK(TrackingMemoryAllocator)
+{
+    constexpr Uint32 NumIterationsPerThread = 1 << 20;
+
+    const Uint32 MaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // The pool threads are reused by all measurements
+    WorkerThreadPool ThreadPool{MaxThreads - 1};
+
+    auto& DefaultAllocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    for (Uint32 NumThreads = 1;; NumThreads = std::min(NumThreads * 2, MaxThreads))
+    {
+        const auto NumOps = static_cast<double>(NumThreads) * NumIterationsPerThread;
+
+        const auto MeasureAllocator = [&](IMemoryAllocator& Allocator) {
+            return MeasureMinTime(3, [&]() {
+                ThreadPool.ParallelFor(
+                    NumThreads,
+                    [&](Uint32 Thread) {
+                        AllocateAndFree(Allocator, Thread * 2 + 1, NumIterationsPerThread);
+                    },
+                    NumThreads);
+            });
+        };
+
+        const auto DefaultTime = MeasureAllocator(DefaultAllocator);
+        ReportResult((std::to_string(NumThreads) + " thread(s), default allocator").c_str(), DefaultTime, NumOps, "alloc/free");
+
+        TrackingMemoryAllocator TrackingAllocator;
+
+        const auto TrackingTime = MeasureAllocator(TrackingAllocator);
+        ReportResult((std::to_string(NumThreads) + " thread(s), tracking allocator").c_str(), TrackingTime, NumOps, "alloc/free");
+
+        if (NumThreads == MaxThreads)
+            break;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+namespace
+{
+
+struct BenchmarkInfo
+{
+    const char*       Name;
+    BenchmarkFuncType Func;
+};
+
+std::vector<BenchmarkInfo>& GetBenchmarks()
+{
+    static std::vector<BenchmarkInfo> Benchmarks;
+    return Benchmarks;
+}
+
+} // namespace
+
+void RegisterBenchmark(const char* Name, BenchmarkFuncType Func)
+{
+    GetBenchmarks().push_back({Name, Func});
+}
+
+void ReportResult(const char* Case, double Seconds, double NumUnits, const char* UnitsName)
+{
+    std::cout << "    " << std::left << std::setw(60) << Case << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << Seconds * 1000.0 << " ms"
+              << std::setprecision(1) << std::setw(12) << NumUnits / std::max(Seconds, 1e-12) << ' ' << UnitsName << "/s\n";
+}
+
+} // namespace Benchmark
+
+} // namespace Diligent
+
+// Usage: DiligentCoreBenchmark [filter]
+// Runs all benchmarks whose names contain the filter string.
+int main(int argc, char** argv)
+{
+    const char* Filter = argc > 1 ? argv[1] : "";
+
+    for (const auto& Benchmark : Diligent::Benchmark::GetBenchmarks())
+    {
+        if (std::strstr(Benchmark.Name, Filter) == nullptr)
+            continue;
+
+        std::cout << Benchmark.Name << '\n';
+        Benchmark.Func();
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "DeferredDestructionDomain.hpp"
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "RefCntAutoPtr.hpp"
+#include "RefCountedObjectImpl.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+class Object : public RefCountedObject<IObject>
+{
+public:
+    Object(IReferenceCounters* pRefCounters, std::atomic_int& NumAliveObjects) :
+        RefCountedObject<IObject>{pRefCounters},
+        m_NumAliveObjects{NumAliveObjects}
+    {
+        ++m_NumAliveObjects;
+    }
+
+    ~Object()
+    {
+        --m_NumAliveObjects;
+    }
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final
+    {
+        *ppInterface = nullptr;
+        if (IID == IID_Unknown)
+        {
+            *ppInterface = this;
+            (*ppInterface)->AddRef();
+        }
+    }
+
+    RefCntAutoPtr<Object> pChild;
+
+private:
+    std::atomic_int& m_NumAliveObjects;
+};
+
+TEST(Common_DeferredDestructionDomain, DestroyPendingObjects)
+{
+    std::atomic_int           NumAliveObjects{0};
+    DeferredDestructionDomain Domain;
+
+    constexpr size_t NumObjects = 8;
+
+    std::vector<RefCntAutoPtr<Object>> Objects;
+    std::vector<RefCntWeakPtr<Object>> WeakPtrs;
+    for (size_t i = 0; i < NumObjects; ++i)
+    {
+        Objects.emplace_back(MakeNewRCObj<Object>{}(NumAliveObjects));
+        Domain.Attach(Objects.back());
+        WeakPtrs.emplace_back(Objects.back());
+    }
+    EXPECT_EQ(NumAliveObjects, static_cast<int>(NumObjects));
+    EXPECT_EQ(Domain.GetNumAttachedObjects(), NumObjects);
+
+    Objects.clear();
+    // Objects are not destroyed until the domain destroys them, but can't be accessed through weak pointers
+    EXPECT_EQ(NumAliveObjects, static_cast<int>(NumObjects));
+    EXPECT_EQ(Domain.GetNumPendingObjects(), NumObjects);
+    for (auto& WeakPtr : WeakPtrs)
+        EXPECT_FALSE(WeakPtr.Lock());
+
+    EXPECT_EQ(Domain.DestroyPendingObjects(3), size_t{3});
+    EXPECT_EQ(NumAliveObjects, static_cast<int>(NumObjects - 3));
+    EXPECT_EQ(Domain.GetNumPendingObjects(), NumObjects - 3);
+
+    WeakPtrs.clear();
+
+    EXPECT_EQ(Domain.DestroyPendingObjects(), NumObjects - 3);
+    EXPECT_EQ(NumAliveObjects, 0);
+    EXPECT_EQ(Domain.GetNumPendingObjects(), size_t{0});
+    EXPECT_EQ(Domain.GetNumAttachedObjects(), size_t{0});
+}
+
+TEST(Common_DeferredDestructionDomain, NestedObjects)
+{
+    std::atomic_int           NumAliveObjects{0};
+    DeferredDestructionDomain Domain;
+
+    RefCntAutoPtr<Object> pParent{MakeNewRCObj<Object>{}(NumAliveObjects)};
+    pParent->pChild = MakeNewRCObj<Object>{}(NumAliveObjects);
+    Domain.Attach(pParent);
+    Domain.Attach(pParent->pChild);
+
+    pParent.Release();
+    EXPECT_EQ(NumAliveObjects, 2);
+
+    // Destroying the parent releases the child, which is added to the queue
+    EXPECT_EQ(Domain.DestroyPendingObjects(), size_t{1});
+    EXPECT_EQ(NumAliveObjects, 1);
+    EXPECT_EQ(Domain.GetNumPendingObjects(), size_t{1});
+
+    EXPECT_EQ(Domain.DestroyPendingObjects(), size_t{1});
+    EXPECT_EQ(NumAliveObjects, 0);
+}
+
+TEST(Common_DeferredDestructionDomain, NotAttached)
+{
+    std::atomic_int           NumAliveObjects{0};
+    DeferredDestructionDomain Domain;
+
+    RefCntAutoPtr<Object> pObject{MakeNewRCObj<Object>{}(NumAliveObjects)};
+    pObject.Release();
+    EXPECT_EQ(NumAliveObjects, 0);
+    EXPECT_EQ(Domain.GetNumPendingObjects(), size_t{0});
+}
+
+TEST(Common_DeferredDestructionDomain, Threading)
+{
+    std::atomic_int           NumAliveObjects{0};
+    DeferredDestructionDomain Domain;
+
+    constexpr int NumObjectsPerThread = 1000;
+    constexpr int NumThreads          = 4;
+
+    std::atomic_int          NumDestroyedObjects{0};
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back(
+            [&]() //
+            {
+                for (int i = 0; i < NumObjectsPerThread; ++i)
+                {
+                    RefCntAutoPtr<Object> pObject{MakeNewRCObj<Object>{}(NumAliveObjects)};
+                    Domain.Attach(pObject);
+                    RefCntWeakPtr<Object> pWeak{pObject};
+                    pObject.Release();
+                    NumDestroyedObjects += static_cast<int>(Domain.DestroyPendingObjects(2));
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    NumDestroyedObjects += static_cast<int>(Domain.DestroyPendingObjects());
+    EXPECT_EQ(NumDestroyedObjects, NumObjectsPerThread * NumThreads);
+    EXPECT_EQ(NumAliveObjects, 0);
+}
+
+} // namespace
@@ -0,0 +1,191 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "LockHelper.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "RefCountedObjectImpl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ThreadingTools;
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_LockHelper, LockUnlock)
+{
+    LockFlag Flag;
+    {
+        LockHelper Lock{Flag};
+        EXPECT_EQ(Flag, LockFlag::LOCK_FLAG_LOCKED);
+
+        LockHelper Lock2;
+        EXPECT_FALSE(Lock2.TryLock(Flag));
+
+        Lock.Unlock();
+        EXPECT_EQ(Flag, LockFlag::LOCK_FLAG_UNLOCKED);
+        EXPECT_TRUE(Lock2.TryLock(Flag));
+    }
+    EXPECT_EQ(Flag, LockFlag::LOCK_FLAG_UNLOCKED);
+}
+
+TEST(Common_LockHelper, Contention)
+{
+    LockHelper::ResetContentionStats();
+
+    LockFlag Flag;
+
+    constexpr int NumIterations = 10000;
+    auto          NumThreads    = std::max(std::thread::hardware_concurrency(), 4u);
+
+    int                      Counter = 0;
+    std::vector<std::thread> Threads(NumThreads);
+    for (auto& t : Threads)
+    {
+        t = std::thread(
+            [&]() //
+            {
+                for (int i = 0; i < NumIterations; ++i)
+                {
+                    LockHelper Lock{Flag};
+                    ++Counter;
+                }
+            });
+    }
+
+    for (auto& t : Threads)
+        t.join();
+
+    EXPECT_EQ(Counter, NumIterations * static_cast<int>(NumThreads));
+    EXPECT_EQ(Flag, LockFlag::LOCK_FLAG_UNLOCKED);
+
+    const auto Stats = LockHelper::GetContentionStats();
+    EXPECT_GE(Stats.NumContendedLocks, 0);
+    EXPECT_LE(Stats.NumContendedLocks, Counter);
+    EXPECT_GE(Stats.NumSpins, Stats.NumContendedLocks);
+
+    LockHelper::ResetContentionStats();
+    EXPECT_EQ(LockHelper::GetContentionStats().NumContendedLocks, 0);
+}
+
+class TrackedObject : public RefCountedObject<IObject>
+{
+public:
+    TrackedObject(IReferenceCounters* pRefCounters, std::atomic_bool& Alive) :
+        RefCountedObject<IObject>{pRefCounters},
+        m_Alive{Alive}
+    {
+        m_Alive.store(true);
+    }
+
+    ~TrackedObject()
+    {
+        m_Alive.store(false);
+    }
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override final
+    {
+        *ppInterface = nullptr;
+        if (IID == IID_Unknown)
+        {
+            *ppInterface = this;
+            (*ppInterface)->AddRef();
+        }
+    }
+
+private:
+    std::atomic_bool& m_Alive;
+};
+
+// Many threads upgrade weak pointers while another thread releases the last strong
+// reference. A locked pointer must never refer to an object that has been destroyed.
+TEST(Common_LockHelper, WeakPtrLockRace)
+{
+    constexpr int NumIterations = 500;
+    constexpr int NumLocks      = 200;
+    const auto    NumThreads    = std::max(std::thread::hardware_concurrency(), 4u);
+
+    std::atomic_int NumDestroyedWhileLocked{0};
+    std::atomic_int NumSuccessfulLocks{0};
+    for (int i = 0; i < NumIterations; ++i)
+    {
+        std::atomic_bool Alive{false};
+
+        RefCntAutoPtr<TrackedObject> pObj{MakeNewRCObj<TrackedObject>()(Alive)};
+        RefCntWeakPtr<TrackedObject> pWeakObj{pObj};
+
+        std::atomic_uint         NumThreadsReady{0};
+        std::vector<std::thread> Threads(NumThreads);
+        for (auto& t : Threads)
+        {
+            t = std::thread(
+                [&]() //
+                {
+                    ++NumThreadsReady;
+                    for (int l = 0; l < NumLocks; ++l)
+                    {
+                        auto pLocked = pWeakObj.Lock();
+                        if (!pLocked)
+                            break;
+
+                        ++NumSuccessfulLocks;
+                        if (!Alive.load())
+                            ++NumDestroyedWhileLocked;
+                        std::this_thread::yield();
+                        if (!Alive.load())
+                            ++NumDestroyedWhileLocked;
+                    }
+                });
+        }
+
+        std::thread Releaser{
+            [&]() //
+            {
+                while (NumThreadsReady.load() < NumThreads)
+                    std::this_thread::yield();
+                pObj.Release();
+            }};
+
+        Releaser.join();
+        for (auto& t : Threads)
+            t.join();
+
+        EXPECT_FALSE(Alive.load());
+        EXPECT_FALSE(pWeakObj.Lock());
+    }
+
+    EXPECT_EQ(NumDestroyedWhileLocked.load(), 0);
+    EXPECT_GT(NumSuccessfulLocks.load(), 0);
+}
+
+} // namespace
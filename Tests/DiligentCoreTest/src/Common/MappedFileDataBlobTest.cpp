@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "MappedFileDataBlob.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "RefCountedObjectImpl.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+void WriteTestFile(const char* FileName, const std::vector<Uint8>& Data)
+{
+    FileWrapper File{FileName, EFileAccessMode::Overwrite};
+    ASSERT_NE(static_cast<CFile*>(File), nullptr);
+    if (!Data.empty())
+        EXPECT_TRUE(File->Write(Data.data(), Data.size()));
+}
+
+std::vector<Uint8> MakeTestData(size_t Size)
+{
+    std::vector<Uint8> Data(Size);
+    for (size_t i = 0; i < Size; ++i)
+        Data[i] = static_cast<Uint8>((i * 31u + 7u) & 0xFFu);
+    return Data;
+}
+
+TEST(Common_MappedFileDataBlob, Contents)
+{
+    const char* FileName = "MappedFileDataBlobTest_Contents.tmp";
+    const auto  Data     = MakeTestData(100003);
+    WriteTestFile(FileName, Data);
+
+    for (auto AccessPattern : {EFileAccessPattern::Default, EFileAccessPattern::Sequential, EFileAccessPattern::Random})
+    {
+        auto pBlob = MappedFileDataBlob::Create(FileName, AccessPattern);
+        ASSERT_TRUE(pBlob);
+        ASSERT_EQ(pBlob->GetSize(), Data.size());
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+    }
+
+    std::remove(FileName);
+}
+
+TEST(Common_MappedFileDataBlob, Stream)
+{
+    const char* FileName = "MappedFileDataBlobTest_Stream.tmp";
+    const auto  Data     = MakeTestData(4096);
+    WriteTestFile(FileName, Data);
+
+    RefCntAutoPtr<IFileStream> pStream;
+    CreateMappedFileStream(FileName, EFileAccessPattern::Sequential, &pStream);
+    // The stream keeps the mapping alive after the file is removed
+    std::remove(FileName);
+    ASSERT_TRUE(pStream);
+    EXPECT_TRUE(pStream->IsValid());
+    EXPECT_EQ(pStream->GetSize(), Data.size());
+
+    std::vector<Uint8> Head(16);
+    EXPECT_TRUE(pStream->Read(Head.data(), Head.size()));
+    EXPECT_EQ(memcmp(Head.data(), Data.data(), Head.size()), 0);
+
+    auto pRest = MakeNewRCObj<DataBlobImpl>()(0);
+    pStream->ReadBlob(pRest);
+    ASSERT_EQ(pRest->GetSize(), Data.size() - Head.size());
+    EXPECT_EQ(memcmp(pRest->GetConstDataPtr(), Data.data() + Head.size(), pRest->GetSize()), 0);
+}
+
+TEST(Common_MappedFileDataBlob, EmptyFile)
+{
+    const char* FileName = "MappedFileDataBlobTest_Empty.tmp";
+    WriteTestFile(FileName, {});
+
+    auto pBlob = MappedFileDataBlob::Create(FileName);
+    ASSERT_TRUE(pBlob);
+    EXPECT_EQ(pBlob->GetSize(), size_t{0});
+
+    std::remove(FileName);
+}
+
+TEST(Common_MappedFileDataBlob, MissingFile)
+{
+    EXPECT_FALSE(MappedFileDataBlob::Create("MappedFileDataBlobTest_Missing.tmp"));
+
+    RefCntAutoPtr<IFileStream> pStream;
+    CreateMappedFileStream("MappedFileDataBlobTest_Missing.tmp", EFileAccessPattern::Default, &pStream);
+    EXPECT_FALSE(pStream);
+}
+
+} // namespace
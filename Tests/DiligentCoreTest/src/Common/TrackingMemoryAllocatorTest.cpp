@@ -0,0 +1,233 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "TrackingMemoryAllocator.hpp"
+
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_TrackingMemoryAllocator, AllocFree)
+{
+    TrackingMemoryAllocator Allocator;
+
+    void* pMem0 = Allocator.Allocate(100, "Tag A", "Root/Module0/src/File0.cpp", 10);
+    void* pMem1 = Allocator.Allocate(200, "Tag A", "Root/Module0/src/File0.cpp", 20);
+    void* pMem2 = Allocator.Allocate(300, "Tag B", "Root\\Module1\\include\\File1.hpp", 30);
+    ASSERT_NE(pMem0, nullptr);
+    ASSERT_NE(pMem1, nullptr);
+    ASSERT_NE(pMem2, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pMem0) % alignof(std::max_align_t), uintptr_t{0});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pMem2) % alignof(std::max_align_t), uintptr_t{0});
+
+    {
+        const auto Total = Allocator.GetTotalStats();
+        EXPECT_EQ(Total.LiveBytes, size_t{600});
+        EXPECT_EQ(Total.PeakLiveBytes, size_t{600});
+        EXPECT_EQ(Total.NumLiveAllocations, size_t{3});
+        EXPECT_EQ(Total.NumAllocations, Uint64{3});
+    }
+
+    Allocator.Free(pMem2);
+    Allocator.Free(pMem0);
+
+    const auto Snap = Allocator.GetSnapshot();
+    EXPECT_EQ(Snap.Total.LiveBytes, size_t{200});
+    EXPECT_EQ(Snap.Total.PeakLiveBytes, size_t{600});
+    EXPECT_EQ(Snap.Total.NumLiveAllocations, size_t{1});
+    EXPECT_EQ(Snap.Total.TotalAllocatedBytes, Uint64{600});
+
+    ASSERT_EQ(Snap.Tags.size(), size_t{2});
+    EXPECT_EQ(Snap.Tags[0].Name, "Tag A");
+    EXPECT_EQ(Snap.Tags[0].Stats.LiveBytes, size_t{200});
+    EXPECT_EQ(Snap.Tags[0].Stats.PeakLiveBytes, size_t{300});
+    EXPECT_EQ(Snap.Tags[0].Stats.NumAllocations, Uint64{2});
+    EXPECT_EQ(Snap.Tags[1].Name, "Tag B");
+    EXPECT_EQ(Snap.Tags[1].Stats.LiveBytes, size_t{0});
+    EXPECT_EQ(Snap.Tags[1].Stats.PeakLiveBytes, size_t{300});
+
+    ASSERT_EQ(Snap.Subsystems.size(), size_t{2});
+    EXPECT_EQ(Snap.Subsystems[0].Name, "Module0");
+    EXPECT_EQ(Snap.Subsystems[1].Name, "Module1");
+
+    EXPECT_EQ(Snap.HotSites.size(), size_t{3});
+
+    Allocator.ResetPeaks();
+    EXPECT_EQ(Allocator.GetTotalStats().PeakLiveBytes, size_t{200});
+
+    Allocator.Free(pMem1);
+    EXPECT_EQ(Allocator.GetTotalStats().LiveBytes, size_t{0});
+}
+
+TEST(Common_TrackingMemoryAllocator, HotSites)
+{
+    TrackingMemoryAllocator Allocator;
+
+    std::vector<void*> Allocations;
+    for (int i = 0; i < 10; ++i)
+        Allocations.push_back(Allocator.Allocate(16, "Frequent", __FILE__, __LINE__));
+    for (int i = 0; i < 2; ++i)
+        Allocations.push_back(Allocator.Allocate(1024, "Rare", __FILE__, __LINE__));
+
+    const auto Snap = Allocator.GetSnapshot(1);
+    ASSERT_EQ(Snap.HotSites.size(), size_t{1});
+    EXPECT_EQ(Snap.HotSites[0].Description, "Frequent");
+    EXPECT_EQ(Snap.HotSites[0].Stats.NumAllocations, Uint64{10});
+    EXPECT_EQ(Snap.Subsystems.size(), size_t{1});
+
+    // Tags are sorted by live bytes
+    ASSERT_EQ(Snap.Tags.size(), size_t{2});
+    EXPECT_EQ(Snap.Tags[0].Name, "Rare");
+
+    EXPECT_EQ(Snap.Tags[0].Stats.LiveBytes, size_t{2048});
+    EXPECT_EQ(Snap.Tags[1].Name, "Frequent");
+    EXPECT_EQ(Snap.Tags[1].Stats.LiveBytes, size_t{160});
+
+    const auto FullSnap = Allocator.GetSnapshot();
+    ASSERT_EQ(FullSnap.HotSites.size(), size_t{2});
+    EXPECT_EQ(FullSnap.HotSites[0].Description, "Frequent");
+    EXPECT_EQ(FullSnap.HotSites[1].Description, "Rare");
+    EXPECT_EQ(FullSnap.HotSites[1].Stats.NumAllocations, Uint64{2});
+    EXPECT_EQ(FullSnap.HotSites[1].Stats.LiveBytes, size_t{2048});
+    EXPECT_EQ(FullSnap.HotSites[1].FileName, __FILE__);
+    EXPECT_NE(FullSnap.HotSites[0].LineNumber, FullSnap.HotSites[1].LineNumber);
+
+    for (auto* pMem : Allocations)
+        Allocator.Free(pMem);
+}
+
+TEST(Common_TrackingMemoryAllocator, Multithreading)
+{
+    TrackingMemoryAllocator Allocator;
+
+    constexpr int NumThreads        = 4;
+    constexpr int NumAllocsInThread = 1000;
+
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&Allocator]() {
+            std::vector<void*> Allocations;
+            for (int i = 0; i < NumAllocsInThread; ++i)
+            {
+                Allocations.push_back(Allocator.Allocate(8, "Thread allocation", __FILE__, __LINE__));
+                if (i % 2 == 1)
+                {
+                    Allocator.Free(Allocations.back());
+                    Allocations.pop_back();
+                }
+            }
+            for (auto* pMem : Allocations)
+                Allocator.Free(pMem);
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const auto Total = Allocator.GetTotalStats();
+    EXPECT_EQ(Total.LiveBytes, size_t{0});
+    EXPECT_EQ(Total.NumLiveAllocations, size_t{0});
+    EXPECT_EQ(Total.NumAllocations, Uint64{NumThreads * NumAllocsInThread});
+}
+
+TEST(Common_TrackingMemoryAllocator, DynamicStrings)
+{
+    TrackingMemoryAllocator Allocator;
+
+    // Descriptions built at run time have different pointers, but equal strings
+    // must be counted as one site, also when the number of pointers is large.
+    constexpr int NumAllocations = 10000;
+
+    std::vector<std::string> Descriptions;
+    Descriptions.reserve(NumAllocations);
+    std::vector<void*> Allocations;
+    for (int i = 0; i < NumAllocations; ++i)
+    {
+        Descriptions.emplace_back(std::string{"Dynamic "} + (i % 2 == 0 ? "A" : "B"));
+        Allocations.push_back(Allocator.Allocate(8, Descriptions.back().c_str(), "Root/Module/src/File.cpp", 10));
+    }
+
+    const auto Snap = Allocator.GetSnapshot();
+    ASSERT_EQ(Snap.HotSites.size(), size_t{2});
+    EXPECT_EQ(Snap.HotSites[0].Stats.NumAllocations, Uint64{NumAllocations / 2});
+    EXPECT_EQ(Snap.HotSites[1].Stats.NumAllocations, Uint64{NumAllocations / 2});
+    ASSERT_EQ(Snap.Tags.size(), size_t{2});
+    EXPECT_EQ(Snap.Tags[0].Stats.LiveBytes, size_t{NumAllocations / 2 * 8});
+    EXPECT_EQ(Snap.Total.NumLiveAllocations, size_t{NumAllocations});
+
+    for (auto* pMem : Allocations)
+        Allocator.Free(pMem);
+    EXPECT_EQ(Allocator.GetTotalStats().LiveBytes, size_t{0});
+}
+
+TEST(Common_TrackingMemoryAllocator, FreeFromOtherThread)
+{
+    TrackingMemoryAllocator Allocator;
+
+    constexpr int NumThreads        = 4;
+    constexpr int NumAllocsInThread = 1000;
+
+    // Every thread releases the allocations made by the previous one
+    std::vector<std::vector<void*>> Allocations(NumThreads);
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        std::thread{[&Allocator, &Allocations, t]() {
+            for (int i = 0; i < NumAllocsInThread; ++i)
+                Allocations[t].push_back(Allocator.Allocate(16, "Cross-thread allocation", __FILE__, __LINE__));
+        }}.join();
+    }
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&Allocator, &Allocations, t]() {
+            for (auto* pMem : Allocations[(t + 1) % NumThreads])
+                Allocator.Free(pMem);
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const auto Snap = Allocator.GetSnapshot();
+    EXPECT_EQ(Snap.Total.LiveBytes, size_t{0});
+    EXPECT_EQ(Snap.Total.NumLiveAllocations, size_t{0});
+    EXPECT_EQ(Snap.Total.NumAllocations, Uint64{NumThreads * NumAllocsInThread});
+    // Allocations were made sequentially, so the peak can not be less than the sum of all of them
+    EXPECT_GE(Snap.Total.PeakLiveBytes, size_t{NumThreads * NumAllocsInThread * 16});
+    ASSERT_EQ(Snap.HotSites.size(), size_t{1});
+    EXPECT_EQ(Snap.HotSites[0].Stats.LiveBytes, size_t{0});
+}
+
+} // namespace
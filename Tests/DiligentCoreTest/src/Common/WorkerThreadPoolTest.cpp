@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "WorkerThreadPool.hpp"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_WorkerThreadPool, ParallelFor)
+{
+    WorkerThreadPool Pool{3};
+    EXPECT_EQ(Pool.GetNumWorkers(), 3u);
+
+    // The pool is reused by consecutive loops of different sizes
+    for (Uint32 NumTasks : {0u, 1u, 2u, 7u, 100u, 1000u})
+    {
+        std::vector<std::atomic_int> Counters(NumTasks);
+        for (auto& Counter : Counters)
+            Counter.store(0);
+
+        Pool.ParallelFor(NumTasks, [&Counters](Uint32 Task) {
+            ++Counters[Task];
+        });
+
+        for (Uint32 Task = 0; Task < NumTasks; ++Task)
+            EXPECT_EQ(Counters[Task].load(), 1) << "Task " << Task << " of " << NumTasks;
+    }
+}
+
+TEST(Common_WorkerThreadPool, MaxThreads)
+{
+    WorkerThreadPool Pool{3};
+
+    const auto CallerId = std::this_thread::get_id();
+
+    std::atomic_int NumTasksOnWorkers{0};
+    Pool.ParallelFor(
+        64,
+        [&](Uint32) {
+            if (std::this_thread::get_id() != CallerId)
+                ++NumTasksOnWorkers;
+        },
+        1);
+    EXPECT_EQ(NumTasksOnWorkers.load(), 0);
+
+    std::atomic_int NumTasks{0};
+    Pool.ParallelFor(
+        64, [&](Uint32) { ++NumTasks; }, 2);
+    EXPECT_EQ(NumTasks.load(), 64);
+}
+
+TEST(Common_WorkerThreadPool, NoWorkers)
+{
+    WorkerThreadPool Pool{0};
+
+    Uint32 Sum = 0;
+    Pool.ParallelFor(10, [&Sum](Uint32 Task) {
+        Sum += Task;
+    });
+    EXPECT_EQ(Sum, 45u);
+}
+
+} // namespace
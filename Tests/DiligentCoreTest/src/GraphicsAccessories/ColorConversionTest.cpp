@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include "PlatformDefinitions.h"
+#include "ColorConversion.h"
+#include "Float16.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(GraphicsAccessories_ColorConversion, SRGBToLinearBulk)
+{
+    std::vector<Uint8> SRGB(256 + 3);
+    for (size_t i = 0; i < SRGB.size(); ++i)
+        SRGB[i] = static_cast<Uint8>(i);
+
+    std::vector<float> Linear(SRGB.size());
+    SRGBToLinear(SRGB.data(), Linear.data(), SRGB.size());
+    for (size_t i = 0; i < SRGB.size(); ++i)
+        EXPECT_EQ(Linear[i], SRGBToLinear(SRGB[i])) << "i = " << i;
+}
+
+TEST(GraphicsAccessories_ColorConversion, LinearToSRGBBulk)
+{
+    // Use odd count to test the remainder processing
+    constexpr size_t   NumValues = 1000001;
+    std::vector<float> Linear(NumValues);
+    for (size_t i = 0; i < NumValues; ++i)
+        Linear[i] = static_cast<float>(i) / static_cast<float>(NumValues - 1);
+
+    std::vector<Uint8> SRGB(NumValues);
+    LinearToSRGB(Linear.data(), SRGB.data(), NumValues);
+
+    double MaxError = 0;
+    for (size_t i = 0; i < NumValues; ++i)
+    {
+        const double Ref   = 255.0 * LinearToSRGB(Linear[i]);
+        const double Error = std::abs(static_cast<double>(SRGB[i]) - Ref);
+        MaxError           = std::max(MaxError, Error);
+        ASSERT_LE(Error, 0.6) << "x = " << Linear[i];
+    }
+    EXPECT_GE(MaxError, 0.5);
+}
+
+TEST(GraphicsAccessories_ColorConversion, LinearToSRGBBulkSpecialValues)
+{
+    const float Linear[] = {
+        -1.f,
+        -0.f,
+        0.f,
+        1.f,
+        2.f,
+        std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::denorm_min(),
+    };
+    const Uint8 Ref[] = {0, 0, 0, 255, 255, 0, 255, 0, 0};
+    static_assert(_countof(Linear) == _countof(Ref), "Array size mismatch");
+
+    Uint8 SRGB[_countof(Linear)] = {};
+    LinearToSRGB(Linear, SRGB, _countof(Linear));
+    for (size_t i = 0; i < _countof(Linear); ++i)
+        EXPECT_EQ(SRGB[i], Ref[i]) << "x = " << Linear[i];
+}
+
+TEST(GraphicsAccessories_ColorConversion, SRGBRoundTrip)
+{
+    Uint8 SRGB[256];
+    for (Uint32 i = 0; i < 256; ++i)
+        SRGB[i] = static_cast<Uint8>(i);
+
+    float Linear[256];
+    SRGBToLinear(SRGB, Linear, 256);
+
+    Uint8 SRGB2[256];
+    LinearToSRGB(Linear, SRGB2, 256);
+    for (Uint32 i = 0; i < 256; ++i)
+        EXPECT_EQ(SRGB2[i], SRGB[i]);
+}
+
+TEST(GraphicsAccessories_ColorConversion, RGBA8ToRGBA16F)
+{
+    std::vector<Uint8> RGBA8(256 * 4);
+    for (size_t i = 0; i < RGBA8.size(); ++i)
+        RGBA8[i] = static_cast<Uint8>(i * 7 + i / 256);
+
+    const size_t        NumTexels = RGBA8.size() / 4;
+    std::vector<Uint16> RGBA16F(RGBA8.size());
+    for (auto IsSRGB : {false, true})
+    {
+        RGBA8ToRGBA16F(RGBA8.data(), RGBA16F.data(), NumTexels, IsSRGB);
+        for (size_t i = 0; i < RGBA8.size(); ++i)
+        {
+            const float Unorm = static_cast<float>(RGBA8[i]) / 255.f;
+            const float Ref   = (IsSRGB && (i % 4) != 3) ? SRGBToLinear(Unorm) : Unorm;
+            // Half-precision float has 11 bits of precision
+            EXPECT_NEAR(Float16::HalfBitsToFloat(RGBA16F[i]), Ref, Ref / 1024.f + 1e-7f) << "i = " << i;
+        }
+    }
+}
+
+} // namespace
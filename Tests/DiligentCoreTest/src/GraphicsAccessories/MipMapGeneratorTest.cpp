@@ -0,0 +1,331 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "MipMapGenerator.hpp"
+#include "ColorConversion.h"
+#include "Float16.hpp"
+#include "FastRand.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(GraphicsAccessories_MipMapGenerator, IsMipGenerationSupported)
+{
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_RGBA8_UNORM));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_RGBA8_UNORM_SRGB));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_RGBA16_FLOAT));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_R32_FLOAT));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_RG16_SNORM));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_R8_UINT));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_RGB10A2_UNORM));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_R11G11B10_FLOAT));
+    EXPECT_TRUE(IsMipGenerationSupported(TEX_FORMAT_D32_FLOAT));
+
+    EXPECT_FALSE(IsMipGenerationSupported(TEX_FORMAT_UNKNOWN));
+    EXPECT_FALSE(IsMipGenerationSupported(TEX_FORMAT_RGBA8_TYPELESS));
+    EXPECT_FALSE(IsMipGenerationSupported(TEX_FORMAT_D24_UNORM_S8_UINT));
+    EXPECT_FALSE(IsMipGenerationSupported(TEX_FORMAT_BC1_UNORM));
+    EXPECT_FALSE(IsMipGenerationSupported(TEX_FORMAT_R1_UNORM));
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, BoxFilterRGBA8)
+{
+    // clang-format off
+    const Uint8 FineData[] =
+    {
+        0,   0,   0,   0,      2,   4,   6,   8,     10,  20,  30,  40,    255, 255, 255, 255,
+        4,   8,  12,  16,      6,  12,  18,  24,     30,  40,  50,  60,    255, 255, 255, 255
+    };
+    // clang-format on
+    Uint8 CoarseData[8] = {};
+
+    ComputeMipLevelAttribs Attribs;
+    Attribs.Format          = TEX_FORMAT_RGBA8_UNORM;
+    Attribs.FineMipWidth    = 4;
+    Attribs.FineMipHeight   = 2;
+    Attribs.pFineMipData    = FineData;
+    Attribs.FineMipStride   = 16;
+    Attribs.pCoarseMipData  = CoarseData;
+    Attribs.CoarseMipStride = 8;
+    ComputeMipLevel(Attribs);
+
+    const Uint8 RefData[] = {3, 6, 9, 12, 138, 143, 148, 153};
+    for (size_t i = 0; i < _countof(RefData); ++i)
+        EXPECT_EQ(CoarseData[i], RefData[i]) << "i = " << i;
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, BoxFilterOddSize)
+{
+    // 3x3 -> 1x1: all texels have equal weight
+    const float FineData[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    float       CoarseData = 0;
+
+    ComputeMipLevelAttribs Attribs;
+    Attribs.Format          = TEX_FORMAT_R32_FLOAT;
+    Attribs.FineMipWidth    = 3;
+    Attribs.FineMipHeight   = 3;
+    Attribs.pFineMipData    = FineData;
+    Attribs.FineMipStride   = sizeof(float) * 3;
+    Attribs.pCoarseMipData  = &CoarseData;
+    Attribs.CoarseMipStride = sizeof(float);
+    ComputeMipLevel(Attribs);
+
+    EXPECT_FLOAT_EQ(CoarseData, 5.f);
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, SRGB)
+{
+    // Black and white texels must average in linear space
+    const Uint8 FineData[]    = {0, 0, 0, 255, 255, 255, 255, 255};
+    Uint8       CoarseData[4] = {};
+
+    ComputeMipLevelAttribs Attribs;
+    Attribs.Format          = TEX_FORMAT_RGBA8_UNORM_SRGB;
+    Attribs.FineMipWidth    = 2;
+    Attribs.FineMipHeight   = 1;
+    Attribs.pFineMipData    = FineData;
+    Attribs.FineMipStride   = sizeof(FineData);
+    Attribs.pCoarseMipData  = CoarseData;
+    Attribs.CoarseMipStride = sizeof(CoarseData);
+    ComputeMipLevel(Attribs);
+
+    const auto RefSRGB = static_cast<Uint8>(LinearToSRGB(0.5f) * 255.f + 0.5f);
+    EXPECT_NEAR(CoarseData[0], RefSRGB, 1);
+    EXPECT_NEAR(CoarseData[1], RefSRGB, 1);
+    EXPECT_NEAR(CoarseData[2], RefSRGB, 1);
+    // Alpha is linear
+    EXPECT_EQ(CoarseData[3], 255);
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, KaiserPreservesConstant)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 21;
+
+    std::vector<Uint16> FineData(Width * Height * 2);
+    for (size_t i = 0; i < FineData.size(); i += 2)
+    {
+        FineData[i + 0] = Float16::FloatToHalfBits(0.25f);
+        FineData[i + 1] = Float16::FloatToHalfBits(-8.f);
+    }
+
+    constexpr Uint32    CoarseWidth  = Width / 2;
+    constexpr Uint32    CoarseHeight = Height / 2;
+    std::vector<Uint16> CoarseData(CoarseWidth * CoarseHeight * 2);
+
+    ComputeMipLevelAttribs Attribs;
+    Attribs.Format          = TEX_FORMAT_RG16_FLOAT;
+    Attribs.FineMipWidth    = Width;
+    Attribs.FineMipHeight   = Height;
+    Attribs.pFineMipData    = FineData.data();
+    Attribs.FineMipStride   = Width * 4;
+    Attribs.pCoarseMipData  = CoarseData.data();
+    Attribs.CoarseMipStride = CoarseWidth * 4;
+    Attribs.FilterType      = MIP_FILTER_TYPE_KAISER;
+    ComputeMipLevel(Attribs);
+
+    for (size_t i = 0; i < CoarseData.size(); i += 2)
+    {
+        EXPECT_NEAR(Float16::HalfBitsToFloat(CoarseData[i + 0]), 0.25f, 1e-3f);
+        EXPECT_NEAR(Float16::HalfBitsToFloat(CoarseData[i + 1]), -8.f, 1e-2f);
+    }
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, PackedFormats)
+{
+    {
+        // R=1023, G=0, B=512, A=3 and R=1, G=1023, B=512, A=1
+        const Uint32 FineData[] = {1023u | (512u << 20u) | (3u << 30u), 1u | (1023u << 10u) | (512u << 20u) | (1u << 30u)};
+        Uint32       CoarseData = 0;
+
+        ComputeMipLevelAttribs Attribs;
+        Attribs.Format          = TEX_FORMAT_RGB10A2_UINT;
+        Attribs.FineMipWidth    = 2;
+        Attribs.FineMipHeight   = 1;
+        Attribs.pFineMipData    = FineData;
+        Attribs.FineMipStride   = sizeof(FineData);
+        Attribs.pCoarseMipData  = &CoarseData;
+        Attribs.CoarseMipStride = sizeof(CoarseData);
+        ComputeMipLevel(Attribs);
+
+        EXPECT_EQ((CoarseData >> 0u) & 0x3FFu, 512u);
+        EXPECT_EQ((CoarseData >> 10u) & 0x3FFu, 512u);
+        EXPECT_EQ((CoarseData >> 20u) & 0x3FFu, 512u);
+        EXPECT_EQ((CoarseData >> 30u) & 0x3u, 2u);
+    }
+
+    {
+        // R11G11B10: 1.0 is exponent 15 with zero mantissa
+        const Uint32 One        = (15u << 6u) | ((15u << 6u) << 11u) | ((15u << 5u) << 22u);
+        const Uint32 FineData[] = {One, One, One, One};
+        Uint32       CoarseData = 0;
+
+        ComputeMipLevelAttribs Attribs;
+        Attribs.Format          = TEX_FORMAT_R11G11B10_FLOAT;
+        Attribs.FineMipWidth    = 2;
+        Attribs.FineMipHeight   = 2;
+        Attribs.pFineMipData    = FineData;
+        Attribs.FineMipStride   = sizeof(Uint32) * 2;
+        Attribs.pCoarseMipData  = &CoarseData;
+        Attribs.CoarseMipStride = sizeof(CoarseData);
+        ComputeMipLevel(Attribs);
+
+        EXPECT_EQ(CoarseData, One);
+    }
+}
+
+void FillRandom(std::vector<Uint8>& Data)
+{
+    FastRandInt Rnd{0, 0, 255};
+    for (auto& Val : Data)
+        Val = static_cast<Uint8>(Rnd());
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, MultithreadedMatchesSingleThreaded)
+{
+    constexpr Uint32 Width  = 301;
+    constexpr Uint32 Height = 517;
+
+    std::vector<Uint8> FineData(Width * Height * 4);
+    FillRandom(FineData);
+
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        constexpr Uint32 CoarseWidth  = Width / 2;
+        constexpr Uint32 CoarseHeight = Height / 2;
+
+        std::vector<Uint8> RefData(CoarseWidth * CoarseHeight * 4);
+        std::vector<Uint8> MTData(RefData.size());
+
+        ComputeMipLevelAttribs Attribs;
+        Attribs.Format          = TEX_FORMAT_RGBA8_UNORM_SRGB;
+        Attribs.FineMipWidth    = Width;
+        Attribs.FineMipHeight   = Height;
+        Attribs.pFineMipData    = FineData.data();
+        Attribs.FineMipStride   = Width * 4;
+        Attribs.CoarseMipStride = CoarseWidth * 4;
+        Attribs.FilterType      = FilterType;
+
+        Attribs.pCoarseMipData = RefData.data();
+        Attribs.NumThreads     = 1;
+        ComputeMipLevel(Attribs);
+
+        Attribs.pCoarseMipData = MTData.data();
+        Attribs.NumThreads     = 7;
+        ComputeMipLevel(Attribs);
+
+        EXPECT_EQ(RefData, MTData);
+    }
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, GenerateMipChain)
+{
+    constexpr Uint32 Width     = 64;
+    constexpr Uint32 Height    = 16;
+    constexpr Uint32 MipLevels = 7;
+
+    std::vector<std::vector<Uint8>> MipData(MipLevels);
+    std::vector<MipLevelData>       Levels(MipLevels);
+    for (Uint32 Mip = 0; Mip < MipLevels; ++Mip)
+    {
+        const auto MipWidth  = std::max(Width >> Mip, 1u);
+        const auto MipHeight = std::max(Height >> Mip, 1u);
+        MipData[Mip].resize(MipWidth * MipHeight, Mip == 0 ? 200 : 0);
+        Levels[Mip].pData  = MipData[Mip].data();
+        Levels[Mip].Stride = MipWidth;
+    }
+
+    GenerateMipChainAttribs Attribs;
+    Attribs.Format     = TEX_FORMAT_R8_UNORM;
+    Attribs.Width      = Width;
+    Attribs.Height     = Height;
+    Attribs.MipLevels  = MipLevels;
+    Attribs.pMipLevels = Levels.data();
+    Attribs.FilterType = MIP_FILTER_TYPE_KAISER;
+    Attribs.NumThreads = 0;
+    GenerateMipChain(Attribs);
+
+    for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+    {
+        for (auto Val : MipData[Mip])
+            EXPECT_EQ(Val, 200) << "Mip " << Mip;
+    }
+}
+
+TEST(GraphicsAccessories_MipMapGenerator, MultithreadedMipChainMatchesSingleThreaded)
+{
+    constexpr Uint32 Width     = 300;
+    constexpr Uint32 Height    = 517;
+    constexpr Uint32 MipLevels = 10;
+
+    for (auto FilterType : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        std::vector<std::vector<Uint8>> RefData(MipLevels), MTData(MipLevels);
+        std::vector<MipLevelData>       RefLevels(MipLevels), MTLevels(MipLevels);
+        for (Uint32 Mip = 0; Mip < MipLevels; ++Mip)
+        {
+            const auto MipWidth  = std::max(Width >> Mip, 1u);
+            const auto MipHeight = std::max(Height >> Mip, 1u);
+            RefData[Mip].resize(MipWidth * MipHeight * 4);
+            if (Mip == 0)
+                FillRandom(RefData[Mip]);
+            MTData[Mip] = RefData[Mip];
+
+            RefLevels[Mip].pData  = RefData[Mip].data();
+            RefLevels[Mip].Stride = MipWidth * 4;
+            MTLevels[Mip].pData   = MTData[Mip].data();
+            MTLevels[Mip].Stride  = MipWidth * 4;
+        }
+
+        GenerateMipChainAttribs Attribs;
+        Attribs.Format     = TEX_FORMAT_RGBA8_UNORM_SRGB;
+        Attribs.Width      = Width;
+        Attribs.Height     = Height;
+        Attribs.MipLevels  = MipLevels;
+        Attribs.FilterType = FilterType;
+
+        Attribs.pMipLevels = RefLevels.data();
+        Attribs.NumThreads = 1;
+        GenerateMipChain(Attribs);
+
+        // Large levels are split between the threads, small ones are computed by one thread
+        Attribs.pMipLevels = MTLevels.data();
+        Attribs.NumThreads = 5;
+        GenerateMipChain(Attribs);
+
+        for (Uint32 Mip = 1; Mip < MipLevels; ++Mip)
+            EXPECT_EQ(RefData[Mip], MTData[Mip]) << "Mip " << Mip;
+    }
+}
+
+} // namespace
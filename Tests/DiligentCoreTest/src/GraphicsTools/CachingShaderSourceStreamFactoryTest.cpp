@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "CachingShaderSourceStreamFactory.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include "RefCntAutoPtr.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+void WriteTestFile(const Char* Path, const Char* Content)
+{
+    FileWrapper File{Path, EFileAccessMode::Overwrite};
+    ASSERT_NE(static_cast<CFile*>(File), nullptr);
+    EXPECT_TRUE(File->Write(Content, strlen(Content)));
+}
+
+// Returns the contents of the stream, or "<null>" if the stream could not be created
+String ReadSource(ICachingShaderSourceStreamFactory* pFactory, const Char* Name)
+{
+    RefCntAutoPtr<IFileStream> pStream;
+    pFactory->CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT, &pStream);
+    if (!pStream)
+        return "<null>";
+
+    String Source(pStream->GetSize(), '\0');
+    if (!Source.empty())
+        EXPECT_TRUE(pStream->Read(&Source[0], Source.size()));
+    return Source;
+}
+
+RefCntAutoPtr<ICachingShaderSourceStreamFactory> CreateFactory(const Char* SearchDirectories, bool CheckModificationTime)
+{
+    CachingShaderSourceStreamFactoryCreateInfo CreateInfo;
+    CreateInfo.SearchDirectories     = SearchDirectories;
+    CreateInfo.CheckModificationTime = CheckModificationTime;
+
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pFactory;
+    CreateCachingShaderSourceStreamFactory(CreateInfo, &pFactory);
+    return pFactory;
+}
+
+TEST(GraphicsTools_CachingShaderSourceStreamFactory, CacheHits)
+{
+    const Char* FileName = "CachingShaderSourceStreamFactoryTest_Hits.fxh";
+    WriteTestFile(FileName, "float4 Color;");
+
+    for (bool CheckModificationTime : {true, false})
+    {
+        auto pFactory = CreateFactory(nullptr, CheckModificationTime);
+        ASSERT_TRUE(pFactory);
+
+        EXPECT_EQ(ReadSource(pFactory, FileName), "float4 Color;");
+        EXPECT_EQ(ReadSource(pFactory, FileName), "float4 Color;");
+        EXPECT_EQ(ReadSource(pFactory, FileName), "float4 Color;");
+
+        const auto Stats = pFactory->GetStatistics();
+        EXPECT_EQ(Stats.NumRequests, 3u);
+        EXPECT_EQ(Stats.NumFileLoads, 1u);
+        EXPECT_EQ(Stats.NumCacheHits, 2u);
+        EXPECT_EQ(Stats.NumPathResolutionHits, 2u);
+        EXPECT_EQ(Stats.NumInvalidations, 0u);
+        EXPECT_EQ(Stats.NumFailures, 0u);
+        EXPECT_EQ(Stats.CachedBytes, strlen("float4 Color;"));
+
+        pFactory->ClearCache();
+        EXPECT_EQ(pFactory->GetStatistics().CachedBytes, 0u);
+        EXPECT_EQ(ReadSource(pFactory, FileName), "float4 Color;");
+        EXPECT_EQ(pFactory->GetStatistics().NumFileLoads, 2u);
+    }
+
+    std::remove(FileName);
+}
+
+TEST(GraphicsTools_CachingShaderSourceStreamFactory, Invalidation)
+{
+    const Char* FileName = "CachingShaderSourceStreamFactoryTest_Invalidation.fxh";
+    WriteTestFile(FileName, "float A;");
+
+    auto pFactory = CreateFactory(nullptr, true);
+    ASSERT_TRUE(pFactory);
+    EXPECT_EQ(ReadSource(pFactory, FileName), "float A;");
+
+    // The file may be rewritten within the modification time resolution,
+    // but the size change must still invalidate the cached data.
+    WriteTestFile(FileName, "float A, B;");
+    EXPECT_EQ(ReadSource(pFactory, FileName), "float A, B;");
+    EXPECT_EQ(ReadSource(pFactory, FileName), "float A, B;");
+
+    auto Stats = pFactory->GetStatistics();
+    EXPECT_EQ(Stats.NumRequests, 3u);
+    EXPECT_EQ(Stats.NumFileLoads, 2u);
+    EXPECT_EQ(Stats.NumInvalidations, 1u);
+    EXPECT_EQ(Stats.NumCacheHits, 1u);
+    EXPECT_EQ(Stats.CachedBytes, strlen("float A, B;"));
+
+    // Removed file must not be served from the cache
+    std::remove(FileName);
+    EXPECT_EQ(ReadSource(pFactory, FileName), "<null>");
+    Stats = pFactory->GetStatistics();
+    EXPECT_EQ(Stats.NumFailures, 1u);
+    EXPECT_EQ(Stats.NumPathResolutionHits, 2u);
+
+    // The path is resolved again when the file is restored
+    WriteTestFile(FileName, "float C;");
+    EXPECT_EQ(ReadSource(pFactory, FileName), "float C;");
+    Stats = pFactory->GetStatistics();
+    EXPECT_EQ(Stats.NumPathResolutionHits, 2u);
+    EXPECT_EQ(Stats.NumFileLoads, 3u);
+    EXPECT_EQ(Stats.CachedBytes, strlen("float C;"));
+
+    std::remove(FileName);
+}
+
+TEST(GraphicsTools_CachingShaderSourceStreamFactory, SearchDirectories)
+{
+    const Char* FileName = "CachingShaderSourceStreamFactoryTest_Include.fxh";
+    WriteTestFile(FileName, "#define INCLUDED 1");
+
+    // The first directory does not exist, so the file is only found in the second one
+    auto pFactory = CreateFactory("CachingShaderSourceStreamFactoryTest_Missing;.", true);
+    ASSERT_TRUE(pFactory);
+
+    EXPECT_EQ(ReadSource(pFactory, FileName), "#define INCLUDED 1");
+    EXPECT_EQ(ReadSource(pFactory, FileName), "#define INCLUDED 1");
+    // A different name that resolves to the same file shares the cached data
+    EXPECT_EQ(ReadSource(pFactory, "/CachingShaderSourceStreamFactoryTest_Include.fxh"), "#define INCLUDED 1");
+
+    auto Stats = pFactory->GetStatistics();
+    EXPECT_EQ(Stats.NumRequests, 3u);
+    EXPECT_EQ(Stats.NumPathResolutionHits, 1u);
+    EXPECT_EQ(Stats.NumFileLoads, 1u);
+    EXPECT_EQ(Stats.NumCacheHits, 2u);
+
+    EXPECT_EQ(ReadSource(pFactory, "CachingShaderSourceStreamFactoryTest_Missing.fxh"), "<null>");
+    Stats = pFactory->GetStatistics();
+    EXPECT_EQ(Stats.NumFailures, 1u);
+    EXPECT_EQ(Stats.NumFileLoads, 1u);
+
+    std::remove(FileName);
+}
+
+} // namespace
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "FrameProfiler.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "FileWrapper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+size_t CountOccurrences(const std::string& Str, const std::string& Substr)
+{
+    size_t Count = 0;
+    for (auto pos = Str.find(Substr); pos != std::string::npos; pos = Str.find(Substr, pos + Substr.length()))
+        ++Count;
+    return Count;
+}
+
+// Without a device, the profiler only records CPU times, which allows testing it without a GPU
+TEST(GraphicsTools_FrameProfiler, CPUOnlyMarkers)
+{
+    FrameProfiler Profiler{nullptr, FrameProfilerCreateInfo{}};
+    EXPECT_FALSE(Profiler.IsGPUTimingEnabled());
+
+    Profiler.BeginFrame(nullptr);
+    {
+        FrameProfiler::ScopedMarker Shadows{Profiler, nullptr, "Shadows"};
+        {
+            // The name must be copied by the profiler
+            std::string Name = "Cascade";
+            Profiler.BeginMarker(nullptr, Name.c_str());
+            Name = "Overwritten";
+            Profiler.EndMarker(nullptr);
+        }
+        Profiler.BeginMarker(nullptr, "Blur");
+        Profiler.EndMarker(nullptr);
+    }
+    Profiler.BeginMarker(nullptr, "Post");
+    Profiler.EndMarker(nullptr);
+    Profiler.EndFrame(nullptr);
+
+    // The frame is only resolved once it is no longer in flight
+    EXPECT_TRUE(Profiler.GetResolvedFrames().empty());
+    Profiler.Flush(nullptr);
+
+    const auto& Frames = Profiler.GetResolvedFrames();
+    ASSERT_EQ(Frames.size(), size_t{1});
+    EXPECT_EQ(Frames[0].FrameNumber, Uint64{0});
+
+    const auto& Markers = Frames[0].Markers;
+    ASSERT_EQ(Markers.size(), size_t{5});
+
+    const char*  ExpectedNames[]   = {"Frame", "Shadows", "Cascade", "Blur", "Post"};
+    const Uint32 ExpectedParents[] = {~Uint32{0}, 0, 1, 1, 0};
+    const Uint32 ExpectedDepths[]  = {0, 1, 2, 2, 1};
+    for (size_t i = 0; i < Markers.size(); ++i)
+    {
+        const auto& Marker = Markers[i];
+        EXPECT_STREQ(Marker.Name, ExpectedNames[i]);
+        EXPECT_EQ(Marker.Parent, ExpectedParents[i]);
+        EXPECT_EQ(Marker.Depth, ExpectedDepths[i]);
+        EXPECT_FALSE(Marker.HasGPUData);
+        EXPECT_LE(Marker.CPUBegin, Marker.CPUEnd);
+        if (Marker.Parent != ~Uint32{0})
+        {
+            // Child markers are nested within their parents
+            const auto& Parent = Markers[Marker.Parent];
+            EXPECT_GE(Marker.CPUBegin, Parent.CPUBegin);
+            EXPECT_LE(Marker.CPUEnd, Parent.CPUEnd);
+        }
+    }
+    EXPECT_LE(Markers[2].CPUEnd, Markers[3].CPUBegin);
+    EXPECT_LE(Markers[1].CPUEnd, Markers[4].CPUBegin);
+
+    const auto& Stats = Profiler.GetStatistics();
+    EXPECT_EQ(Stats.NumResolvedFrames, Uint64{1});
+    EXPECT_EQ(Stats.NumGPUStalls, Uint64{0});
+    EXPECT_EQ(Stats.NumMarkersWithoutGPUData, Uint64{0});
+}
+
+TEST(GraphicsTools_FrameProfiler, FrameHistory)
+{
+    FrameProfilerCreateInfo CI;
+    CI.NumFramesInFlight = 2;
+    CI.MaxRecordedFrames = 3;
+    FrameProfiler Profiler{nullptr, CI};
+
+    constexpr Uint32 NumFrames = 10;
+    for (Uint32 i = 0; i < NumFrames; ++i)
+    {
+        Profiler.BeginFrame(nullptr);
+        // The previous frame has no GPU work and is resolved when the next one begins
+        EXPECT_EQ(Profiler.GetStatistics().NumResolvedFrames, Uint64{i});
+        Profiler.BeginMarker(nullptr, "Scene");
+        Profiler.EndMarker(nullptr);
+        Profiler.EndFrame(nullptr);
+    }
+    Profiler.Flush(nullptr);
+
+    const auto& Stats = Profiler.GetStatistics();
+    EXPECT_EQ(Stats.NumResolvedFrames, Uint64{NumFrames});
+    EXPECT_EQ(Stats.NumGPUStalls, Uint64{0});
+
+    // Only the most recent frames are kept
+    const auto& Frames = Profiler.GetResolvedFrames();
+    ASSERT_EQ(Frames.size(), size_t{CI.MaxRecordedFrames});
+    for (size_t i = 0; i < Frames.size(); ++i)
+    {
+        EXPECT_EQ(Frames[i].FrameNumber, Uint64{NumFrames - CI.MaxRecordedFrames + i});
+        EXPECT_EQ(Frames[i].Markers.size(), size_t{2});
+    }
+    EXPECT_LE(Frames[0].Markers[0].CPUEnd, Frames[1].Markers[0].CPUBegin);
+
+    Profiler.ClearResolvedFrames();
+    EXPECT_TRUE(Profiler.GetResolvedFrames().empty());
+}
+
+TEST(GraphicsTools_FrameProfiler, ChromeTrace)
+{
+    FrameProfiler Profiler{nullptr, FrameProfilerCreateInfo{}};
+
+    constexpr Uint32 NumFrames = 3;
+    for (Uint32 i = 0; i < NumFrames; ++i)
+    {
+        Profiler.BeginFrame(nullptr);
+        Profiler.BeginMarker(nullptr, "Draw \"opaque\"");
+        Profiler.BeginMarker(nullptr, "Path\\Tab\t");
+        Profiler.EndMarker(nullptr);
+        Profiler.EndMarker(nullptr);
+        Profiler.EndFrame(nullptr);
+    }
+    Profiler.Flush(nullptr);
+
+    std::stringstream ss;
+    Profiler.WriteChromeTrace(ss);
+    const auto Trace = ss.str();
+
+    EXPECT_EQ(Trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), size_t{0});
+    EXPECT_EQ(Trace.substr(Trace.length() - 4), "\n]}\n");
+
+    // One complete event per marker, all on the CPU thread
+    EXPECT_EQ(CountOccurrences(Trace, "\"ph\":\"X\""), size_t{NumFrames * 3});
+    EXPECT_EQ(CountOccurrences(Trace, "\"cat\":\"CPU\""), size_t{NumFrames * 3});
+    EXPECT_EQ(CountOccurrences(Trace, "\"cat\":\"GPU\""), size_t{0});
+    EXPECT_EQ(CountOccurrences(Trace, "\"name\":\"thread_name\""), size_t{2});
+    EXPECT_EQ(CountOccurrences(Trace, "\"args\":{\"frame\":2}"), size_t{3});
+
+    // Names are escaped
+    EXPECT_EQ(CountOccurrences(Trace, "\"name\":\"Draw \\\"opaque\\\"\""), size_t{NumFrames});
+    EXPECT_EQ(CountOccurrences(Trace, "\"name\":\"Path\\\\Tab\\t\""), size_t{NumFrames});
+
+    // Events are separated by commas, with no trailing comma
+    EXPECT_EQ(CountOccurrences(Trace, ",\n{"), size_t{NumFrames * 3 + 1});
+    EXPECT_EQ(CountOccurrences(Trace, ",\n]"), size_t{0});
+
+    const char* FileName = "FrameProfilerTest_Trace.json";
+    ASSERT_TRUE(Profiler.WriteChromeTrace(FileName));
+    {
+        FileWrapper File{FileName, EFileAccessMode::Read};
+        ASSERT_NE(static_cast<CFile*>(File), nullptr);
+        std::string FileTrace(File->GetSize(), '\0');
+        ASSERT_TRUE(File->Read(&FileTrace[0], FileTrace.size()));
+        EXPECT_EQ(FileTrace, Trace);
+    }
+    std::remove(FileName);
+}
+
+} // namespace
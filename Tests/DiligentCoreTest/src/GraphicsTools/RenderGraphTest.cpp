@@ -0,0 +1,679 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "RenderGraph.hpp"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Texture and buffer stubs that only keep the description and the state,
+// so that the graph can be compiled without a device.
+class TestTexture final : public ObjectBase<ITexture>
+{
+public:
+    using TBase = ObjectBase<ITexture>;
+
+    TestTexture(IReferenceCounters* pRefCounters, const TextureDesc& Desc, RESOURCE_STATE State) :
+        TBase{pRefCounters},
+        m_Name{Desc.Name != nullptr ? Desc.Name : ""},
+        m_Desc{Desc},
+        m_State{State}
+    {
+        m_Desc.Name = m_Name.c_str();
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_Texture, TBase)
+
+    virtual const TextureDesc& DILIGENT_CALL_TYPE GetDesc() const override final { return m_Desc; }
+    virtual Int32 DILIGENT_CALL_TYPE              GetUniqueID() const override final { return 0; }
+
+    virtual void DILIGENT_CALL_TYPE CreateView(const TextureViewDesc& ViewDesc, ITextureView** ppView) override final { *ppView = nullptr; }
+
+    virtual ITextureView* DILIGENT_CALL_TYPE GetDefaultView(TEXTURE_VIEW_TYPE ViewType) override final { return nullptr; }
+    virtual void* DILIGENT_CALL_TYPE         GetNativeHandle() override final { return nullptr; }
+
+    virtual void DILIGENT_CALL_TYPE           SetState(RESOURCE_STATE State) override final { m_State = State; }
+    virtual RESOURCE_STATE DILIGENT_CALL_TYPE GetState() const override final { return m_State; }
+
+private:
+    const String   m_Name;
+    TextureDesc    m_Desc;
+    RESOURCE_STATE m_State;
+};
+
+class TestBuffer final : public ObjectBase<IBuffer>
+{
+public:
+    using TBase = ObjectBase<IBuffer>;
+
+    TestBuffer(IReferenceCounters* pRefCounters, const BufferDesc& Desc, RESOURCE_STATE State) :
+        TBase{pRefCounters},
+        m_Name{Desc.Name != nullptr ? Desc.Name : ""},
+        m_Desc{Desc},
+        m_State{State}
+    {
+        m_Desc.Name = m_Name.c_str();
+    }
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_Buffer, TBase)
+
+    virtual const BufferDesc& DILIGENT_CALL_TYPE GetDesc() const override final { return m_Desc; }
+    virtual Int32 DILIGENT_CALL_TYPE             GetUniqueID() const override final { return 0; }
+
+    virtual void DILIGENT_CALL_TYPE CreateView(const BufferViewDesc& ViewDesc, IBufferView** ppView) override final { *ppView = nullptr; }
+
+    virtual IBufferView* DILIGENT_CALL_TYPE GetDefaultView(BUFFER_VIEW_TYPE ViewType) override final { return nullptr; }
+    virtual void* DILIGENT_CALL_TYPE        GetNativeHandle() override final { return nullptr; }
+
+    virtual void DILIGENT_CALL_TYPE           SetState(RESOURCE_STATE State) override final { m_State = State; }
+    virtual RESOURCE_STATE DILIGENT_CALL_TYPE GetState() const override final { return m_State; }
+
+private:
+    const String   m_Name;
+    BufferDesc     m_Desc;
+    RESOURCE_STATE m_State;
+};
+
+// Device stub that only creates textures and buffers
+class TestRenderDevice final : public ObjectBase<IRenderDevice>
+{
+public:
+    using TBase = ObjectBase<IRenderDevice>;
+
+    explicit TestRenderDevice(IReferenceCounters* pRefCounters) :
+        TBase{pRefCounters}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_RenderDevice, TBase)
+
+    virtual void DILIGENT_CALL_TYPE CreateBuffer(const BufferDesc& BuffDesc, const BufferData* pBuffData, IBuffer** ppBuffer) override final
+    {
+        RefCntAutoPtr<TestBuffer> pBuffer{MakeNewRCObj<TestBuffer>()(BuffDesc, RESOURCE_STATE_UNDEFINED)};
+        pBuffer->QueryInterface(IID_Buffer, reinterpret_cast<IObject**>(ppBuffer));
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateTexture(const TextureDesc& TexDesc, const TextureData* pData, ITexture** ppTexture) override final
+    {
+        RefCntAutoPtr<TestTexture> pTexture{MakeNewRCObj<TestTexture>()(TexDesc, RESOURCE_STATE_UNDEFINED)};
+        pTexture->QueryInterface(IID_Texture, reinterpret_cast<IObject**>(ppTexture));
+    }
+
+    // clang-format off
+    virtual void DILIGENT_CALL_TYPE CreateShader         (const ShaderCreateInfo&        ShaderCI,      IShader**          ppShader)        override final { *ppShader        = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateSampler        (const SamplerDesc&             SamDesc,       ISampler**         ppSampler)       override final { *ppSampler       = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateResourceMapping(const ResourceMappingDesc&     MappingDesc,   IResourceMapping** ppMapping)       override final { *ppMapping       = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreatePipelineState  (const PipelineStateCreateInfo& PSOCreateInfo, IPipelineState**   ppPipelineState) override final { *ppPipelineState = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateFence          (const FenceDesc&               Desc,          IFence**           ppFence)         override final { *ppFence         = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateQuery          (const QueryDesc&               Desc,          IQuery**           ppQuery)         override final { *ppQuery         = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateRenderPass     (const RenderPassDesc&          Desc,          IRenderPass**      ppRenderPass)    override final { *ppRenderPass    = nullptr; }
+    virtual void DILIGENT_CALL_TYPE CreateFramebuffer    (const FramebufferDesc&         Desc,          IFramebuffer**     ppFramebuffer)   override final { *ppFramebuffer   = nullptr; }
+
+    virtual const DeviceCaps&           DILIGENT_CALL_TYPE GetDeviceCaps          () const                   override final { return m_Caps; }
+    virtual const TextureFormatInfo&    DILIGENT_CALL_TYPE GetTextureFormatInfo   (TEXTURE_FORMAT TexFormat) override final { return m_FormatInfo; }
+    virtual const TextureFormatInfoExt& DILIGENT_CALL_TYPE GetTextureFormatInfoExt(TEXTURE_FORMAT TexFormat) override final { return m_FormatInfo; }
+
+    virtual void            DILIGENT_CALL_TYPE ReleaseStaleResources(bool ForceRelease) override final {}
+    virtual void            DILIGENT_CALL_TYPE IdleGPU              ()                  override final {}
+    virtual IEngineFactory* DILIGENT_CALL_TYPE GetEngineFactory     () const            override final { return nullptr; }
+    // clang-format on
+
+private:
+    DeviceCaps           m_Caps;
+    TextureFormatInfoExt m_FormatInfo;
+};
+
+// Command list stub that keeps the passes recorded by the deferred context
+class TestCommandList final : public ObjectBase<ICommandList>
+{
+public:
+    using TBase = ObjectBase<ICommandList>;
+
+    TestCommandList(IReferenceCounters* pRefCounters, Uint32 ContextId, std::vector<Uint32>&& Passes) :
+        TBase{pRefCounters},
+        m_ContextId{ContextId},
+        m_Passes{std::move(Passes)}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_CommandList, TBase)
+
+    virtual const DeviceObjectAttribs& DILIGENT_CALL_TYPE GetDesc() const override final { return m_Desc; }
+    virtual Int32 DILIGENT_CALL_TYPE                      GetUniqueID() const override final { return 0; }
+
+    const Uint32              m_ContextId;
+    const std::vector<Uint32> m_Passes;
+
+private:
+    DeviceObjectAttribs m_Desc;
+};
+
+// Device context stub that records the passes, the transitions and the executed command lists
+class TestDeviceContext final : public ObjectBase<IDeviceContext>
+{
+public:
+    using TBase = ObjectBase<IDeviceContext>;
+
+    TestDeviceContext(IReferenceCounters* pRefCounters, Uint32 Id) :
+        TBase{pRefCounters},
+        m_Id{Id}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DeviceContext, TBase)
+
+    // Called by pass callbacks
+    void RecordPass(Uint32 PassIdx)
+    {
+        m_RecordedPasses.push_back(PassIdx);
+        m_RecordingThreads.push_back(std::this_thread::get_id());
+    }
+
+    virtual void DILIGENT_CALL_TYPE TransitionResourceStates(Uint32 BarrierCount, StateTransitionDesc* pResourceBarriers) override final
+    {
+        m_Transitions.insert(m_Transitions.end(), pResourceBarriers, pResourceBarriers + BarrierCount);
+    }
+
+    virtual void DILIGENT_CALL_TYPE FinishCommandList(ICommandList** ppCommandList) override final
+    {
+        RefCntAutoPtr<TestCommandList> pCmdList{MakeNewRCObj<TestCommandList>()(m_Id, std::move(m_RecordedPasses))};
+        m_RecordedPasses.clear();
+        pCmdList->QueryInterface(IID_CommandList, reinterpret_cast<IObject**>(ppCommandList));
+    }
+
+    virtual void DILIGENT_CALL_TYPE ExecuteCommandList(ICommandList* pCommandList) override final
+    {
+        ExecuteCommandLists(1, &pCommandList);
+    }
+
+    virtual void DILIGENT_CALL_TYPE ExecuteCommandLists(Uint32 NumCommandLists, ICommandList* const* ppCommandLists) override final
+    {
+        ++m_NumExecuteCalls;
+        for (Uint32 i = 0; i < NumCommandLists; ++i)
+        {
+            const auto* pCmdList = ValidatedCast<TestCommandList>(ppCommandLists[i]);
+            m_ExecutedLists.emplace_back(pCmdList->m_ContextId, pCmdList->m_Passes);
+        }
+    }
+
+    // clang-format off
+    virtual void DILIGENT_CALL_TYPE SetPipelineState         (IPipelineState* pPipelineState) override final {}
+    virtual void DILIGENT_CALL_TYPE TransitionShaderResources(IPipelineState* pPipelineState, IShaderResourceBinding* pShaderResourceBinding) override final {}
+    virtual void DILIGENT_CALL_TYPE CommitShaderResources    (IShaderResourceBinding* pShaderResourceBinding, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE SetStencilRef            (Uint32 StencilRef) override final {}
+    virtual void DILIGENT_CALL_TYPE SetBlendFactors          (const float* pBlendFactors) override final {}
+    virtual void DILIGENT_CALL_TYPE SetVertexBuffers         (Uint32 StartSlot, Uint32 NumBuffersSet, IBuffer** ppBuffers, Uint32* pOffsets, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode, SET_VERTEX_BUFFERS_FLAGS Flags) override final {}
+    virtual void DILIGENT_CALL_TYPE InvalidateState          () override final {}
+    virtual void DILIGENT_CALL_TYPE SetIndexBuffer           (IBuffer* pIndexBuffer, Uint32 ByteOffset, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE SetViewports             (Uint32 NumViewports, const Viewport* pViewports, Uint32 RTWidth, Uint32 RTHeight) override final {}
+    virtual void DILIGENT_CALL_TYPE SetScissorRects          (Uint32 NumRects, const Rect* pRects, Uint32 RTWidth, Uint32 RTHeight) override final {}
+    virtual void DILIGENT_CALL_TYPE SetRenderTargets         (Uint32 NumRenderTargets, ITextureView* ppRenderTargets[], ITextureView* pDepthStencil, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE BeginRenderPass          (const BeginRenderPassAttribs& Attribs) override final {}
+    virtual void DILIGENT_CALL_TYPE NextSubpass              () override final {}
+    virtual void DILIGENT_CALL_TYPE EndRenderPass            () override final {}
+    virtual void DILIGENT_CALL_TYPE Draw                     (const DrawAttribs& Attribs) override final {}
+    virtual void DILIGENT_CALL_TYPE DrawIndexed              (const DrawIndexedAttribs& Attribs) override final {}
+    virtual void DILIGENT_CALL_TYPE DrawIndirect             (const DrawIndirectAttribs& Attribs, IBuffer* pAttribsBuffer) override final {}
+    virtual void DILIGENT_CALL_TYPE DrawIndexedIndirect      (const DrawIndexedIndirectAttribs& Attribs, IBuffer* pAttribsBuffer) override final {}
+    virtual void DILIGENT_CALL_TYPE DrawMesh                 (const DrawMeshAttribs& Attribs) override final {}
+    virtual void DILIGENT_CALL_TYPE DrawMeshIndirect         (const DrawMeshIndirectAttribs& Attribs, IBuffer* pAttribsBuffer) override final {}
+    virtual void DILIGENT_CALL_TYPE DispatchCompute          (const DispatchComputeAttribs& Attribs) override final {}
+    virtual void DILIGENT_CALL_TYPE DispatchComputeIndirect  (const DispatchComputeIndirectAttribs& Attribs, IBuffer* pAttribsBuffer) override final {}
+    virtual void DILIGENT_CALL_TYPE ClearDepthStencil        (ITextureView* pView, CLEAR_DEPTH_STENCIL_FLAGS ClearFlags, float fDepth, Uint8 Stencil, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE ClearRenderTarget        (ITextureView* pView, const float* RGBA, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE SignalFence              (IFence* pFence, Uint64 Value) override final {}
+    virtual void DILIGENT_CALL_TYPE WaitForFence             (IFence* pFence, Uint64 Value, bool FlushContext) override final {}
+    virtual void DILIGENT_CALL_TYPE WaitForIdle              () override final {}
+    virtual void DILIGENT_CALL_TYPE BeginQuery               (IQuery* pQuery) override final {}
+    virtual void DILIGENT_CALL_TYPE EndQuery                 (IQuery* pQuery) override final {}
+    virtual void DILIGENT_CALL_TYPE Flush                    () override final {}
+    virtual void DILIGENT_CALL_TYPE UpdateBuffer             (IBuffer* pBuffer, Uint32 Offset, Uint32 Size, const void* pData, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE CopyBuffer               (IBuffer* pSrcBuffer, Uint32 SrcOffset, RESOURCE_STATE_TRANSITION_MODE SrcBufferTransitionMode, IBuffer* pDstBuffer, Uint32 DstOffset, Uint32 Size, RESOURCE_STATE_TRANSITION_MODE DstBufferTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE MapBuffer                (IBuffer* pBuffer, MAP_TYPE MapType, MAP_FLAGS MapFlags, PVoid& pMappedData) override final { pMappedData = nullptr; }
+    virtual void DILIGENT_CALL_TYPE UnmapBuffer              (IBuffer* pBuffer, MAP_TYPE MapType) override final {}
+    virtual void DILIGENT_CALL_TYPE UpdateTexture            (ITexture* pTexture, Uint32 MipLevel, Uint32 Slice, const Box& DstBox, const TextureSubResData& SubresData, RESOURCE_STATE_TRANSITION_MODE SrcBufferTransitionMode, RESOURCE_STATE_TRANSITION_MODE TextureTransitionMode) override final {}
+    virtual void DILIGENT_CALL_TYPE CopyTexture              (const CopyTextureAttribs& CopyAttribs) override final {}
+    virtual void DILIGENT_CALL_TYPE MapTextureSubresource    (ITexture* pTexture, Uint32 MipLevel, Uint32 ArraySlice, MAP_TYPE MapType, MAP_FLAGS MapFlags, const Box* pMapRegion, MappedTextureSubresource& MappedData) override final {}
+    virtual void DILIGENT_CALL_TYPE UnmapTextureSubresource  (ITexture* pTexture, Uint32 MipLevel, Uint32 ArraySlice) override final {}
+    virtual void DILIGENT_CALL_TYPE GenerateMips             (ITextureView* pTextureView) override final {}
+    virtual void DILIGENT_CALL_TYPE FinishFrame              () override final {}
+    virtual void DILIGENT_CALL_TYPE ResolveTextureSubresource(ITexture* pSrcTexture, ITexture* pDstTexture, const ResolveTextureSubresourceAttribs& ResolveAttribs) override final {}
+    // clang-format on
+
+    const Uint32 m_Id;
+
+    std::vector<Uint32>                                 m_RecordedPasses;
+    std::vector<std::thread::id>                        m_RecordingThreads;
+    std::vector<StateTransitionDesc>                    m_Transitions;
+    std::vector<std::pair<Uint32, std::vector<Uint32>>> m_ExecutedLists;
+    Uint32                                              m_NumExecuteCalls = 0;
+};
+
+TextureDesc GetTexDesc(Uint32 Width)
+{
+    TextureDesc Desc;
+    Desc.Name      = "Render graph test texture";
+    Desc.Type      = RESOURCE_DIM_TEX_2D;
+    Desc.Width     = Width;
+    Desc.Height    = 64;
+    Desc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    Desc.BindFlags = BIND_RENDER_TARGET | BIND_SHADER_RESOURCE;
+    Desc.Usage     = USAGE_DEFAULT;
+    return Desc;
+}
+
+RefCntAutoPtr<ITexture> CreateImportedTexture(RESOURCE_STATE State)
+{
+    RefCntAutoPtr<ITexture> pTexture{MakeNewRCObj<TestTexture>()(GetTexDesc(256), State)};
+    return pTexture;
+}
+
+RefCntAutoPtr<IBuffer> CreateImportedBuffer(RESOURCE_STATE State)
+{
+    BufferDesc Desc;
+    Desc.Name          = "Render graph test buffer";
+    Desc.uiSizeInBytes = 1024;
+    Desc.BindFlags     = BIND_UNORDERED_ACCESS;
+    Desc.Usage         = USAGE_DEFAULT;
+
+    RefCntAutoPtr<IBuffer> pBuffer{MakeNewRCObj<TestBuffer>()(Desc, State)};
+    return pBuffer;
+}
+
+TEST(GraphicsTools_RenderGraph, Culling)
+{
+    RefCntAutoPtr<IRenderDevice> pDevice{MakeNewRCObj<TestRenderDevice>()()};
+    RenderGraph                  Graph{pDevice};
+
+    auto pBackBuffer = CreateImportedTexture(RESOURCE_STATE_RENDER_TARGET);
+    auto BackBuffer  = Graph.ImportTexture(pBackBuffer);
+
+    RenderGraph::ResourceId Unused   = RenderGraph::InvalidResourceId;
+    RenderGraph::ResourceId GBuffer  = RenderGraph::InvalidResourceId;
+    RenderGraph::ResourceId Readback = RenderGraph::InvalidResourceId;
+    // 0: writes a texture nobody reads - culled
+    Graph.AddPass(
+        "Unused",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Unused = Builder.CreateTexture("Unused", GetTexDesc(64));
+            Builder.Write(Unused, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 1: writes a texture read by pass 2 - kept
+    Graph.AddPass(
+        "GBuffer",
+        [&](RenderGraph::PassBuilder& Builder) {
+            GBuffer = Builder.CreateTexture("GBuffer", GetTexDesc(64));
+            Builder.Write(GBuffer, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 2: writes the imported texture - kept
+    Graph.AddPass(
+        "Lighting",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Read(GBuffer, RESOURCE_STATE_SHADER_RESOURCE);
+            Builder.Write(BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 3: only reads - culled
+    Graph.AddPass(
+        "Debug",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Read(BackBuffer, RESOURCE_STATE_SHADER_RESOURCE);
+        },
+        nullptr);
+    // 4: has side effects - kept
+    Graph.AddPass(
+        "Readback",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Readback = Builder.CreateTexture("Readback", GetTexDesc(128));
+            Builder.Write(Readback, RESOURCE_STATE_RENDER_TARGET);
+            Builder.SetSideEffects();
+        },
+        nullptr);
+
+    Graph.Compile();
+
+    EXPECT_TRUE(Graph.IsPassCulled(0));
+    EXPECT_FALSE(Graph.IsPassCulled(1));
+    EXPECT_FALSE(Graph.IsPassCulled(2));
+    EXPECT_TRUE(Graph.IsPassCulled(3));
+    EXPECT_FALSE(Graph.IsPassCulled(4));
+
+    const auto& Stats = Graph.GetStatistics();
+    EXPECT_EQ(Stats.NumPasses, 5u);
+    EXPECT_EQ(Stats.NumCulledPasses, 2u);
+    EXPECT_EQ(Stats.NumTransientResources, 3u);
+    EXPECT_EQ(Stats.NumPhysicalResources, 2u);
+    EXPECT_EQ(Stats.TotalObjectsCreated, 2u);
+
+    // Resources that are only used by culled passes are not allocated
+    EXPECT_EQ(Graph.GetTexture(Unused), nullptr);
+    EXPECT_NE(Graph.GetTexture(GBuffer), nullptr);
+    EXPECT_NE(Graph.GetTexture(Readback), nullptr);
+    EXPECT_EQ(Graph.GetTexture(BackBuffer), pBackBuffer);
+}
+
+TEST(GraphicsTools_RenderGraph, Aliasing)
+{
+    RefCntAutoPtr<IRenderDevice> pDevice{MakeNewRCObj<TestRenderDevice>()()};
+    RenderGraph                  Graph{pDevice};
+
+    auto pBackBuffer = CreateImportedTexture(RESOURCE_STATE_RENDER_TARGET);
+
+    for (Uint32 Frame = 0; Frame < 3; ++Frame)
+    {
+        Graph.Reset();
+        auto BackBuffer = Graph.ImportTexture(pBackBuffer);
+
+        // Chain of passes: A is used by passes 0-1, B by 1-2, C by 2-3 and D by 2-3.
+        // C can reuse the object of A as A is no longer used when C is first written,
+        // while B overlaps both. D has a different description and can't alias anything.
+        RenderGraph::ResourceId A, B, C, D;
+        Graph.AddPass(
+            "Pass0",
+            [&](RenderGraph::PassBuilder& Builder) {
+                A = Builder.CreateTexture("A", GetTexDesc(64));
+                Builder.Write(A, RESOURCE_STATE_RENDER_TARGET);
+            },
+            nullptr);
+        Graph.AddPass(
+            "Pass1",
+            [&](RenderGraph::PassBuilder& Builder) {
+                B = Builder.CreateTexture("B", GetTexDesc(64));
+                Builder.Read(A, RESOURCE_STATE_SHADER_RESOURCE);
+                Builder.Write(B, RESOURCE_STATE_RENDER_TARGET);
+            },
+            nullptr);
+        Graph.AddPass(
+            "Pass2",
+            [&](RenderGraph::PassBuilder& Builder) {
+                C = Builder.CreateTexture("C", GetTexDesc(64));
+                D = Builder.CreateTexture("D", GetTexDesc(32));
+                Builder.Read(B, RESOURCE_STATE_SHADER_RESOURCE);
+                Builder.Write(C, RESOURCE_STATE_RENDER_TARGET);
+                Builder.Write(D, RESOURCE_STATE_RENDER_TARGET);
+            },
+            nullptr);
+        Graph.AddPass(
+            "Pass3",
+            [&](RenderGraph::PassBuilder& Builder) {
+                Builder.Read(C, RESOURCE_STATE_SHADER_RESOURCE);
+                Builder.Read(D, RESOURCE_STATE_SHADER_RESOURCE);
+                Builder.Write(BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+            },
+            nullptr);
+
+        Graph.Compile();
+
+        auto* pA = Graph.GetTexture(A);
+        auto* pB = Graph.GetTexture(B);
+        auto* pC = Graph.GetTexture(C);
+        auto* pD = Graph.GetTexture(D);
+        ASSERT_NE(pA, nullptr);
+        ASSERT_NE(pB, nullptr);
+        ASSERT_NE(pD, nullptr);
+        EXPECT_EQ(pC, pA);
+        EXPECT_NE(pB, pA);
+        EXPECT_NE(pD, pA);
+        EXPECT_NE(pD, pB);
+
+        const auto& Stats = Graph.GetStatistics();
+        EXPECT_EQ(Stats.NumTransientResources, 4u);
+        EXPECT_EQ(Stats.NumPhysicalResources, 3u);
+        // Pooled objects are reused by the following frames
+        EXPECT_EQ(Stats.TotalObjectsCreated, 3u);
+    }
+}
+
+TEST(GraphicsTools_RenderGraph, Transitions)
+{
+    RefCntAutoPtr<IRenderDevice> pDevice{MakeNewRCObj<TestRenderDevice>()()};
+    RenderGraph                  Graph{pDevice};
+
+    auto pBackBuffer = CreateImportedTexture(RESOURCE_STATE_SHADER_RESOURCE);
+    auto pUAVBuffer  = CreateImportedBuffer(RESOURCE_STATE_UNORDERED_ACCESS);
+    auto BackBuffer  = Graph.ImportTexture(pBackBuffer, RESOURCE_STATE_PRESENT);
+    auto UAVBuffer   = Graph.ImportBuffer(pUAVBuffer);
+
+    RenderGraph::ResourceId Color = RenderGraph::InvalidResourceId;
+    // 0: UNDEFINED -> RENDER_TARGET for the new texture
+    Graph.AddPass(
+        "Pass0",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Color = Builder.CreateTexture("Color", GetTexDesc(64));
+            Builder.Write(Color, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 1: two reads are combined into one state; the imported texture goes from SHADER_RESOURCE to RENDER_TARGET
+    Graph.AddPass(
+        "Pass1",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Read(Color, RESOURCE_STATE_SHADER_RESOURCE);
+            Builder.Read(Color, RESOURCE_STATE_COPY_SOURCE);
+            Builder.Write(BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 2: the texture already is in a state that includes SHADER_RESOURCE, no transitions
+    Graph.AddPass(
+        "Pass2",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Read(Color, RESOURCE_STATE_SHADER_RESOURCE);
+            Builder.Write(BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+        },
+        nullptr);
+    // 3: the buffer is already in UAV state and has not been accessed, no barrier
+    Graph.AddPass(
+        "Pass3",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Write(UAVBuffer, RESOURCE_STATE_UNORDERED_ACCESS);
+        },
+        nullptr);
+    // 4: UAV barrier between the dependent writes
+    Graph.AddPass(
+        "Pass4",
+        [&](RenderGraph::PassBuilder& Builder) {
+            Builder.Read(UAVBuffer, RESOURCE_STATE_UNORDERED_ACCESS);
+            Builder.Write(UAVBuffer, RESOURCE_STATE_UNORDERED_ACCESS);
+        },
+        nullptr);
+
+    Graph.Compile();
+
+    auto* pColor = Graph.GetTexture(Color);
+    ASSERT_NE(pColor, nullptr);
+
+    {
+        const auto& Transitions = Graph.GetPassTransitions(0);
+        ASSERT_EQ(Transitions.size(), 1u);
+        EXPECT_EQ(Transitions[0].pTexture, pColor);
+        EXPECT_EQ(Transitions[0].OldState, RESOURCE_STATE_UNDEFINED);
+        EXPECT_EQ(Transitions[0].NewState, RESOURCE_STATE_RENDER_TARGET);
+    }
+    {
+        const auto& Transitions = Graph.GetPassTransitions(1);
+        ASSERT_EQ(Transitions.size(), 2u);
+        EXPECT_EQ(Transitions[0].pTexture, pColor);
+        EXPECT_EQ(Transitions[0].OldState, RESOURCE_STATE_RENDER_TARGET);
+        EXPECT_EQ(Transitions[0].NewState, RESOURCE_STATE_SHADER_RESOURCE | RESOURCE_STATE_COPY_SOURCE);
+        EXPECT_EQ(Transitions[1].pTexture, pBackBuffer);
+        EXPECT_EQ(Transitions[1].OldState, RESOURCE_STATE_SHADER_RESOURCE);
+        EXPECT_EQ(Transitions[1].NewState, RESOURCE_STATE_RENDER_TARGET);
+    }
+    EXPECT_TRUE(Graph.GetPassTransitions(2).empty());
+    EXPECT_TRUE(Graph.GetPassTransitions(3).empty());
+    {
+        const auto& Transitions = Graph.GetPassTransitions(4);
+        ASSERT_EQ(Transitions.size(), 1u);
+        EXPECT_EQ(Transitions[0].pBuffer, pUAVBuffer);
+        EXPECT_EQ(Transitions[0].OldState, RESOURCE_STATE_UNORDERED_ACCESS);
+        EXPECT_EQ(Transitions[0].NewState, RESOURCE_STATE_UNORDERED_ACCESS);
+    }
+
+    // Only the resource with a final state is transitioned after the last pass
+    {
+        const auto& Transitions = Graph.GetFinalTransitions();
+        ASSERT_EQ(Transitions.size(), 1u);
+        EXPECT_EQ(Transitions[0].pTexture, pBackBuffer);
+        EXPECT_EQ(Transitions[0].OldState, RESOURCE_STATE_RENDER_TARGET);
+        EXPECT_EQ(Transitions[0].NewState, RESOURCE_STATE_PRESENT);
+    }
+
+    EXPECT_EQ(Graph.GetStatistics().NumTransitions, 5u);
+
+    // Compiling does not change the states of the objects
+    EXPECT_EQ(pBackBuffer->GetState(), RESOURCE_STATE_SHADER_RESOURCE);
+    EXPECT_EQ(pColor->GetState(), RESOURCE_STATE_UNDEFINED);
+}
+
+TEST(GraphicsTools_RenderGraph, DeferredContexts)
+{
+    RefCntAutoPtr<IRenderDevice> pDevice{MakeNewRCObj<TestRenderDevice>()()};
+    RenderGraph                  Graph{pDevice};
+
+    auto pBackBuffer = CreateImportedTexture(RESOURCE_STATE_SHADER_RESOURCE);
+
+    constexpr Uint32 NumChainPasses = 9;
+    constexpr Uint32 CulledPass     = 3;
+
+    // The pool is created for two contexts, grown for four, and not used for one
+    for (Uint32 NumCtxs : {2u, 4u, 1u})
+    {
+        Graph.Reset();
+
+        auto BackBuffer = Graph.ImportTexture(pBackBuffer, RESOURCE_STATE_PRESENT);
+
+        // A chain of passes, each reading the texture written by the previous one.
+        // The pass inserted at CulledPass writes a texture nobody reads.
+        std::vector<Uint32>     ActivePasses;
+        RenderGraph::ResourceId Prev = RenderGraph::InvalidResourceId;
+        for (Uint32 i = 0; i < NumChainPasses + 1; ++i)
+        {
+            const auto PassIdx = i;
+            if (i == CulledPass)
+            {
+                Graph.AddPass(
+                    "Culled",
+                    [&](RenderGraph::PassBuilder& Builder) {
+                        Builder.Write(Builder.CreateTexture("Unused", GetTexDesc(64)), RESOURCE_STATE_RENDER_TARGET);
+                    },
+                    [PassIdx](const RenderGraph::PassContext& Ctx) {
+                        ValidatedCast<TestDeviceContext>(Ctx.GetDeviceContext())->RecordPass(PassIdx);
+                    });
+                continue;
+            }
+
+            const bool IsLast = i == NumChainPasses;
+            Graph.AddPass(
+                "Chain",
+                [&](RenderGraph::PassBuilder& Builder) {
+                    if (Prev != RenderGraph::InvalidResourceId)
+                        Builder.Read(Prev, RESOURCE_STATE_SHADER_RESOURCE);
+                    if (IsLast)
+                    {
+                        Builder.Write(BackBuffer, RESOURCE_STATE_RENDER_TARGET);
+                    }
+                    else
+                    {
+                        Prev = Builder.CreateTexture("Chain", GetTexDesc(64));
+                        Builder.Write(Prev, RESOURCE_STATE_RENDER_TARGET);
+                    }
+                },
+                [PassIdx](const RenderGraph::PassContext& Ctx) {
+                    ValidatedCast<TestDeviceContext>(Ctx.GetDeviceContext())->RecordPass(PassIdx);
+                });
+            ActivePasses.push_back(PassIdx);
+        }
+
+        RefCntAutoPtr<TestDeviceContext> pImmediateCtx{MakeNewRCObj<TestDeviceContext>()(~Uint32{0})};
+
+        std::vector<RefCntAutoPtr<TestDeviceContext>> DeferredCtxs;
+        std::vector<IDeviceContext*>                  ppDeferredCtxs;
+        for (Uint32 i = 0; i < NumCtxs; ++i)
+        {
+            DeferredCtxs.emplace_back(MakeNewRCObj<TestDeviceContext>()(i));
+            ppDeferredCtxs.push_back(DeferredCtxs.back());
+        }
+
+        Graph.Execute(pImmediateCtx, ppDeferredCtxs.data(), NumCtxs);
+
+        EXPECT_TRUE(Graph.IsPassCulled(CulledPass));
+        EXPECT_EQ(Graph.GetStatistics().NumCulledPasses, 1u);
+
+        // No passes are recorded by the immediate context, and all command lists
+        // are executed by a single call in the order of the contexts
+        EXPECT_TRUE(pImmediateCtx->m_RecordingThreads.empty());
+        EXPECT_EQ(pImmediateCtx->m_NumExecuteCalls, 1u);
+        ASSERT_EQ(pImmediateCtx->m_ExecutedLists.size(), size_t{NumCtxs});
+
+        std::vector<Uint32> ExecutedPasses;
+        for (Uint32 i = 0; i < NumCtxs; ++i)
+        {
+            const auto& CmdList = pImmediateCtx->m_ExecutedLists[i];
+            EXPECT_EQ(CmdList.first, i);
+            EXPECT_FALSE(CmdList.second.empty());
+            ExecutedPasses.insert(ExecutedPasses.end(), CmdList.second.begin(), CmdList.second.end());
+        }
+        // Every active pass is recorded once, and the contexts hold contiguous groups of passes
+        EXPECT_EQ(ExecutedPasses, ActivePasses);
+
+        for (Uint32 i = 0; i < NumCtxs; ++i)
+        {
+            const auto& Ctx = *DeferredCtxs[i];
+
+            // All passes of one context are recorded by the same thread
+            ASSERT_FALSE(Ctx.m_RecordingThreads.empty());
+            for (const auto& ThreadId : Ctx.m_RecordingThreads)
+                EXPECT_EQ(ThreadId, Ctx.m_RecordingThreads[0]);
+
+            size_t NumExpectedTransitions = 0;
+            for (auto PassIdx : pImmediateCtx->m_ExecutedLists[i].second)
+                NumExpectedTransitions += Graph.GetPassTransitions(PassIdx).size();
+            EXPECT_EQ(Ctx.m_Transitions.size(), NumExpectedTransitions);
+
+            // Deferred contexts must not update the states
+            for (const auto& Barrier : Ctx.m_Transitions)
+                EXPECT_FALSE(Barrier.UpdateResourceState);
+        }
+
+        // The final transitions are recorded by the immediate context after the command lists
+        ASSERT_EQ(pImmediateCtx->m_Transitions.size(), 1u);
+        EXPECT_EQ(pImmediateCtx->m_Transitions[0].pTexture, pBackBuffer);
+        EXPECT_EQ(pImmediateCtx->m_Transitions[0].NewState, RESOURCE_STATE_PRESENT);
+        EXPECT_EQ(pBackBuffer->GetState(), RESOURCE_STATE_PRESENT);
+    }
+}
+
+} // namespace
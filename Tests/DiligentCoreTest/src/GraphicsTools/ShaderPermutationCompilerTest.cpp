@@ -0,0 +1,358 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderPermutationCompiler.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "ObjectBase.hpp"
+#include "DataBlobImpl.hpp"
+#include "MemoryFileStream.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+class TestShaderSourceFactory final : public ObjectBase<IShaderSourceInputStreamFactory>
+{
+public:
+    using TBase = ObjectBase<IShaderSourceInputStreamFactory>;
+
+    TestShaderSourceFactory(IReferenceCounters* pRefCounters, std::unordered_map<String, String> Files) :
+        TBase{pRefCounters},
+        m_Files{std::move(Files)}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_IShaderSourceInputStreamFactory, TBase)
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final
+    {
+        CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
+                                                       CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                       IFileStream**                           ppStream) override final
+    {
+        *ppStream = nullptr;
+
+        auto it = m_Files.find(Name);
+        if (it == m_Files.end())
+            return;
+
+        RefCntAutoPtr<DataBlobImpl> pData{MakeNewRCObj<DataBlobImpl>()(it->second.length())};
+        memcpy(pData->GetDataPtr(), it->second.data(), it->second.length());
+        RefCntAutoPtr<MemoryFileStream> pStream{MakeNewRCObj<MemoryFileStream>()(pData)};
+        pStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+    }
+
+private:
+    const std::unordered_map<String, String> m_Files;
+};
+
+ShaderCreateInfo GetShaderCI(const Char* Source, IShaderSourceInputStreamFactory* pFactory = nullptr)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name                  = "Permutation test shader";
+    ShaderCI.Desc.ShaderType            = SHADER_TYPE_PIXEL;
+    ShaderCI.SourceLanguage             = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.EntryPoint                 = "main";
+    ShaderCI.Source                     = Source;
+    ShaderCI.pShaderSourceStreamFactory = pFactory;
+    return ShaderCI;
+}
+
+// Shaders are only created by Compile(), so no device is needed to test the permutation mapping
+TEST(GraphicsTools_ShaderPermutationCompiler, UnusedMacros)
+{
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("float4 main() : SV_Target { return float4(USED_MACRO, 0, 0, 1); }")};
+
+    const ShaderMacro Perm0[] = {{"USED_MACRO", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"USED_MACRO", "1"}, {"UNUSED_MACRO", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm2[] = {{"USED_MACRO", "1"}, {"UNUSED_MACRO", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm3[] = {{"USED_MACRO", "2"}, {"UNUSED_MACRO", "1"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    const auto Idx2 = Compiler.AddPermutation(Perm2);
+    const auto Idx3 = Compiler.AddPermutation(Perm3);
+
+    EXPECT_EQ(Compiler.GetNumPermutations(), 4u);
+    EXPECT_EQ(Compiler.GetNumUniqueShaders(), 2u);
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx2));
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx3));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, CommentsAndStrings)
+{
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("// COMMENT_MACRO\n"
+                                                            "/* BLOCK_COMMENT_MACRO */\n"
+                                                            "float4 main() : SV_Target { printf(\"STRING_MACRO\"); return float4(0, 0, 0, 1); }")};
+
+    const ShaderMacro Perm0[] = {{"COMMENT_MACRO", "1"}, {"BLOCK_COMMENT_MACRO", "1"}, {"STRING_MACRO", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{nullptr, nullptr}};
+
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm0)), Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm1)));
+    EXPECT_EQ(Compiler.GetNumUniqueShaders(), 1u);
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, MacroOrder)
+{
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("float4 main() : SV_Target { return float4(MACRO_A, MACRO_B, 0, 1); }")};
+
+    const ShaderMacro Perm0[] = {{"MACRO_A", "1"}, {"MACRO_B", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"MACRO_B", "2"}, {"MACRO_A", "1"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    EXPECT_EQ(Compiler.GetNumUniqueShaders(), 1u);
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, Overrides)
+{
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("float4 main() : SV_Target { return float4(MACRO_A, 0, 0, 1); }")};
+
+    // Later definitions override earlier ones
+    const ShaderMacro Perm0[] = {{"MACRO_A", "1"}, {"MACRO_A", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"MACRO_A", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm2[] = {{"MACRO_A", "2"}, {"MACRO_A", "1"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    const auto Idx2 = Compiler.AddPermutation(Perm2);
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx2));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, MacrosReferencedByMacros)
+{
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("float4 main() : SV_Target { return float4(MACRO_A, 0, 0, 1); }")};
+
+    // MACRO_B is only referenced through the definition of MACRO_A
+    const ShaderMacro Perm0[] = {{"MACRO_A", "MACRO_B"}, {"MACRO_B", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"MACRO_A", "MACRO_B"}, {"MACRO_B", "2"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, TokenPasting)
+{
+    {
+        // PREFIX_VALUE never occurs in the source, but is formed by token pasting
+        ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("#define CONCAT(a, b) a##b\n"
+                                                                "float4 main() : SV_Target { return float4(CONCAT(PREFIX, _VALUE), 0, 0, 1); }")};
+
+        const ShaderMacro Perm0[] = {{"PREFIX_VALUE", "1"}, {nullptr, nullptr}};
+        const ShaderMacro Perm1[] = {{"PREFIX_VALUE", "2"}, {nullptr, nullptr}};
+
+        const auto Idx0 = Compiler.AddPermutation(Perm0);
+        const auto Idx1 = Compiler.AddPermutation(Perm1);
+        EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    }
+
+    {
+        // Token pasting in a macro definition
+        ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("float4 main() : SV_Target { return float4(MACRO_A(_VALUE), 0, 0, 1); }")};
+
+        const ShaderMacro Perm0[] = {{"MACRO_A(x)", "PREFIX##x"}, {"PREFIX_VALUE", "1"}, {nullptr, nullptr}};
+        const ShaderMacro Perm1[] = {{"MACRO_A(x)", "PREFIX##x"}, {"PREFIX_VALUE", "2"}, {nullptr, nullptr}};
+
+        const auto Idx0 = Compiler.AddPermutation(Perm0);
+        const auto Idx1 = Compiler.AddPermutation(Perm1);
+        EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    }
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, Includes)
+{
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory{
+        MakeNewRCObj<TestShaderSourceFactory>()(std::unordered_map<String, String>{
+            {"Common.fxh", "#pragma once\nstruct CommonStruct { float Value; };\n"},
+            {"A.fxh", "#include \"Common.fxh\"\nfloat GetA() { return INCLUDED_MACRO; }\n"},
+            {"B.fxh", "#include \"Common.fxh\"\nfloat GetB() { return 0; }\n"} //
+        })};
+
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("#include \"A.fxh\"\n"
+                                                            "#include \"B.fxh\"\n"
+                                                            "float4 main() : SV_Target { return float4(GetA(), GetB(), 0, 1); }\n",
+                                                            pFactory)};
+
+    const auto& Stats = Compiler.GetStatistics();
+    EXPECT_EQ(Stats.NumExpandedIncludes, 3u);
+    EXPECT_EQ(Stats.NumRepeatedIncludes, 1u);
+    EXPECT_EQ(Stats.NumUnresolvedIncludes, 0u);
+
+    // Common.fxh is expanded once, and line directives restore the line numbers of every file
+    EXPECT_STREQ(Compiler.GetExpandedSource().c_str(),
+                 "#line 1\n"
+                 "#line 1\n"
+                 "\n"
+                 "struct CommonStruct { float Value; };\n"
+                 "#line 2\n"
+                 "float GetA() { return INCLUDED_MACRO; }\n"
+                 "#line 2\n"
+                 "#line 1\n"
+                 "\n"
+                 "float GetB() { return 0; }\n"
+                 "#line 3\n"
+                 "float4 main() : SV_Target { return float4(GetA(), GetB(), 0, 1); }\n");
+
+    // Macros referenced by the included files are not dropped
+    const ShaderMacro Perm0[] = {{"INCLUDED_MACRO", "1"}, {"UNUSED_MACRO", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"INCLUDED_MACRO", "1"}, {"UNUSED_MACRO", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm2[] = {{"INCLUDED_MACRO", "2"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    const auto Idx2 = Compiler.AddPermutation(Perm2);
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx2));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, IncludesInConditionalBranches)
+{
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory{
+        MakeNewRCObj<TestShaderSourceFactory>()(std::unordered_map<String, String>{
+            {"Guarded.fxh", "#ifndef GUARDED_FXH\n#define GUARDED_FXH\nfloat GetValue() { return 1; }\n#endif\n"} //
+        })};
+
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("#if USE_FIRST\n"
+                                                            "#    include \"Guarded.fxh\"\n"
+                                                            "#else\n"
+                                                            "#    include \"Guarded.fxh\"\n"
+                                                            "#endif\n"
+                                                            "float4 main() : SV_Target { return float4(GetValue(), 0, 0, 1); }\n",
+                                                            pFactory)};
+
+    // The file has no '#pragma once', so it must be expanded in both branches
+    const auto& Stats = Compiler.GetStatistics();
+    EXPECT_EQ(Stats.NumExpandedIncludes, 2u);
+    EXPECT_EQ(Stats.NumRepeatedIncludes, 0u);
+    EXPECT_EQ(Stats.NumUnresolvedIncludes, 0u);
+
+    EXPECT_STREQ(Compiler.GetExpandedSource().c_str(),
+                 "#if USE_FIRST\n"
+                 "#line 1\n"
+                 "#ifndef GUARDED_FXH\n"
+                 "#define GUARDED_FXH\n"
+                 "float GetValue() { return 1; }\n"
+                 "#endif\n"
+                 "#line 3\n"
+                 "#else\n"
+                 "#line 1\n"
+                 "#ifndef GUARDED_FXH\n"
+                 "#define GUARDED_FXH\n"
+                 "float GetValue() { return 1; }\n"
+                 "#endif\n"
+                 "#line 5\n"
+                 "#endif\n"
+                 "float4 main() : SV_Target { return float4(GetValue(), 0, 0, 1); }\n");
+
+    const ShaderMacro Perm0[] = {{"USE_FIRST", "0"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"USE_FIRST", "1"}, {nullptr, nullptr}};
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm0)), Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm1)));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, RepeatedXMacroIncludes)
+{
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory{
+        MakeNewRCObj<TestShaderSourceFactory>()(std::unordered_map<String, String>{
+            {"Items.fxh", "ITEM(First)\nITEM(Second)\n"},
+            {"Recursive.fxh", "float Recursive;\n#include \"Recursive.fxh\"\n"} //
+        })};
+
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("#define ITEM(Name) float Name;\n"
+                                                            "#include \"Items.fxh\"\n"
+                                                            "#undef ITEM\n"
+                                                            "#define ITEM(Name) Name = ITEM_VALUE;\n"
+                                                            "#include \"Items.fxh\"\n"
+                                                            "#include \"Recursive.fxh\"\n",
+                                                            pFactory)};
+
+    // Every include of the table is expanded, while the recursive include is stopped
+    const auto& Stats = Compiler.GetStatistics();
+    EXPECT_EQ(Stats.NumExpandedIncludes, 3u);
+    EXPECT_EQ(Stats.NumRepeatedIncludes, 1u);
+    EXPECT_EQ(Stats.NumUnresolvedIncludes, 0u);
+
+    EXPECT_STREQ(Compiler.GetExpandedSource().c_str(),
+                 "#define ITEM(Name) float Name;\n"
+                 "#line 1\n"
+                 "ITEM(First)\n"
+                 "ITEM(Second)\n"
+                 "#line 3\n"
+                 "#undef ITEM\n"
+                 "#define ITEM(Name) Name = ITEM_VALUE;\n"
+                 "#line 1\n"
+                 "ITEM(First)\n"
+                 "ITEM(Second)\n"
+                 "#line 6\n"
+                 "#line 1\n"
+                 "float Recursive;\n"
+                 "\n"
+                 "#line 7\n");
+
+    // The macro is only referenced through the second expansion of the table
+    const ShaderMacro Perm0[] = {{"ITEM_VALUE", "0"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"ITEM_VALUE", "1"}, {nullptr, nullptr}};
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm0)), Compiler.GetUniqueShaderIndex(Compiler.AddPermutation(Perm1)));
+}
+
+TEST(GraphicsTools_ShaderPermutationCompiler, UnresolvedIncludeFallback)
+{
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory{
+        MakeNewRCObj<TestShaderSourceFactory>()(std::unordered_map<String, String>{})};
+
+    ShaderPermutationCompiler Compiler{nullptr, GetShaderCI("#include \"Missing.fxh\"\n"
+                                                            "float4 main() : SV_Target { return float4(USED_MACRO, 0, 0, 1); }\n",
+                                                            pFactory)};
+    EXPECT_EQ(Compiler.GetStatistics().NumUnresolvedIncludes, 1u);
+    // The directive is left to the shader compiler
+    EXPECT_NE(Compiler.GetExpandedSource().find("#include \"Missing.fxh\""), String::npos);
+
+    // The missing file may reference any macro, so all macros are kept
+    const ShaderMacro Perm0[] = {{"USED_MACRO", "1"}, {"OTHER_MACRO", "1"}, {nullptr, nullptr}};
+    const ShaderMacro Perm1[] = {{"USED_MACRO", "1"}, {"OTHER_MACRO", "2"}, {nullptr, nullptr}};
+    const ShaderMacro Perm2[] = {{"OTHER_MACRO", "1"}, {"USED_MACRO", "1"}, {nullptr, nullptr}};
+
+    const auto Idx0 = Compiler.AddPermutation(Perm0);
+    const auto Idx1 = Compiler.AddPermutation(Perm1);
+    const auto Idx2 = Compiler.AddPermutation(Perm2);
+    EXPECT_NE(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx1));
+    // Macro order still does not matter
+    EXPECT_EQ(Compiler.GetUniqueShaderIndex(Idx0), Compiler.GetUniqueShaderIndex(Idx2));
+}
+
+} // namespace
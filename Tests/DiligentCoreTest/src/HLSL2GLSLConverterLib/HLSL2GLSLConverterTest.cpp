@@ -0,0 +1,547 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "HLSL2GLSLConverterImpl.hpp"
+
+#include <cstring>
+#include <thread>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+#include "CachingShaderSourceStreamFactory.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+using ConversionAttribs        = HLSL2GLSLConverterImpl::ConversionAttribs;
+using DeadCodeEliminationStats = HLSL2GLSLConverterImpl::DeadCodeEliminationStats;
+
+struct GLSLSymbols
+{
+    // Identifiers used by the code, including the bodies of the macros the code uses
+    std::unordered_set<String> Identifiers;
+
+    // Names of macros, structures, functions and uniforms declared at global scope
+    std::unordered_set<String> Declarations;
+};
+
+bool IsIdentifierChar(char c)
+{
+    return isalnum(c) || c == '_';
+}
+
+// A simple scanner that finds global declarations in the converted GLSL source.
+// It does not need to handle everything GLSL allows, only what the converter emits.
+GLSLSymbols ParseGLSL(const String& GLSL)
+{
+    // Tokens are identifiers, numbers and single punctuation characters.
+    // Comments are skipped, directives are kept as one '#' token followed by their tokens.
+    struct Token
+    {
+        String Literal;
+        bool   IsIdentifier = false;
+        bool   StartsLine   = false;
+    };
+    std::vector<Token> Tokens;
+
+    bool NewLine = true;
+    for (size_t Pos = 0; Pos < GLSL.length();)
+    {
+        const auto c = GLSL[Pos];
+        if (c == '\n')
+        {
+            NewLine = true;
+            ++Pos;
+        }
+        else if (c == '\\' && GLSL.compare(Pos + 1, 1, "\n") == 0)
+        {
+            // Line continuation
+            Pos += 2;
+        }
+        else if (isspace(c) || c == '\\')
+        {
+            ++Pos;
+        }
+        else if (GLSL.compare(Pos, 2, "//") == 0)
+        {
+            Pos = GLSL.find('\n', Pos);
+            if (Pos == String::npos)
+                break;
+        }
+        else if (GLSL.compare(Pos, 2, "/*") == 0)
+        {
+            Pos = GLSL.find("*/", Pos + 2);
+            if (Pos == String::npos)
+                break;
+            Pos += 2;
+        }
+        else
+        {
+            Token NewToken;
+            NewToken.StartsLine = NewLine;
+            NewLine             = false;
+
+            auto End = Pos + 1;
+            if (IsIdentifierChar(c))
+            {
+                while (End < GLSL.length() && IsIdentifierChar(GLSL[End]))
+                    ++End;
+                NewToken.IsIdentifier = !isdigit(c);
+            }
+            NewToken.Literal.assign(GLSL, Pos, End - Pos);
+            Tokens.emplace_back(std::move(NewToken));
+            Pos = End;
+        }
+    }
+
+    GLSLSymbols Symbols;
+
+    // Identifiers used by the bodies of every macro. Unused macros are never expanded,
+    // so the symbols they reference do not have to be declared.
+    std::unordered_map<String, std::vector<String>> MacroRefs;
+
+    int BraceDepth = 0;
+    for (size_t i = 0; i < Tokens.size(); ++i)
+    {
+        const auto& Tok = Tokens[i];
+        if (Tok.Literal == "#")
+        {
+            // #define NAME
+            std::vector<String>* pRefs = nullptr;
+            if (i + 2 < Tokens.size() && Tokens[i + 1].Literal == "define" && Tokens[i + 2].IsIdentifier)
+            {
+                Symbols.Declarations.insert(Tokens[i + 2].Literal);
+                pRefs = &MacroRefs[Tokens[i + 2].Literal];
+                i += 2;
+            }
+            // Skip the rest of the directive
+            while (i + 1 < Tokens.size() && !Tokens[i + 1].StartsLine)
+            {
+                ++i;
+                if (!Tokens[i].IsIdentifier)
+                    continue;
+                if (pRefs != nullptr)
+                    pRefs->push_back(Tokens[i].Literal);
+                else
+                    Symbols.Identifiers.insert(Tokens[i].Literal);
+            }
+            continue;
+        }
+
+        if (Tok.IsIdentifier)
+            Symbols.Identifiers.insert(Tok.Literal);
+
+        if (Tok.Literal == "{")
+            ++BraceDepth;
+        else if (Tok.Literal == "}")
+            --BraceDepth;
+
+        if (BraceDepth != 0 || !Tok.IsIdentifier || i + 1 >= Tokens.size())
+            continue;
+
+        const auto& Next = Tokens[i + 1];
+        if (Tok.Literal == "struct" && Next.IsIdentifier)
+        {
+            // struct Name
+            Symbols.Declarations.insert(Next.Literal);
+        }
+        else if (Next.Literal == "(" && i > 0 && Tokens[i - 1].IsIdentifier && Tokens[i - 1].Literal != "return")
+        {
+            // Type Name(...) {
+            int  BracketDepth = 0;
+            auto j            = i + 1;
+            for (; j < Tokens.size(); ++j)
+            {
+                if (Tokens[j].Literal == "(")
+                    ++BracketDepth;
+                else if (Tokens[j].Literal == ")" && --BracketDepth == 0)
+                    break;
+            }
+            if (j + 1 < Tokens.size() && Tokens[j + 1].Literal == "{")
+                Symbols.Declarations.insert(Tok.Literal);
+        }
+        else if (Tok.Literal == "uniform")
+        {
+            // uniform Type Name;
+            // uniform BlockName {
+            for (auto j = i + 1; j < Tokens.size(); ++j)
+            {
+                if (Tokens[j].Literal == ";" || Tokens[j].Literal == "{")
+                {
+                    if (Tokens[j - 1].IsIdentifier)
+                        Symbols.Declarations.insert(Tokens[j - 1].Literal);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Add the identifiers of the macros that are used
+    std::vector<String> MacrosToExpand{Symbols.Identifiers.begin(), Symbols.Identifiers.end()};
+    while (!MacrosToExpand.empty())
+    {
+        auto it = MacroRefs.find(MacrosToExpand.back());
+        MacrosToExpand.pop_back();
+        if (it == MacroRefs.end())
+            continue;
+        for (const auto& Ref : it->second)
+        {
+            if (Symbols.Identifiers.insert(Ref).second)
+                MacrosToExpand.push_back(Ref);
+        }
+    }
+
+    return Symbols;
+}
+
+RefCntAutoPtr<IShaderSourceInputStreamFactory> CreateShaderSourceFactory()
+{
+    CachingShaderSourceStreamFactoryCreateInfo CreateInfo;
+    CreateInfo.SearchDirectories = HLSL2GLSL_CONVERTER_TEST_SHADERS_DIR;
+
+    RefCntAutoPtr<ICachingShaderSourceStreamFactory> pFactory;
+    CreateCachingShaderSourceStreamFactory(CreateInfo, &pFactory);
+    return RefCntAutoPtr<IShaderSourceInputStreamFactory>{pFactory, IID_IShaderSourceInputStreamFactory};
+}
+
+String ConvertSource(const Char* Source, const ShaderMacro* Macros, DeadCodeEliminationStats& Stats)
+{
+    ConversionAttribs Attribs;
+    Attribs.HLSLSource    = Source;
+    Attribs.NumSymbols    = strlen(Source);
+    Attribs.EntryPoint    = "main";
+    Attribs.ShaderType    = SHADER_TYPE_PIXEL;
+    Attribs.InputFileName = "DCE test shader";
+    Attribs.Macros        = Macros;
+    Attribs.pDCEStats     = &Stats;
+    return HLSL2GLSLConverterImpl::GetInstance().Convert(Attribs);
+}
+
+const Char* DCETestShader = R"(
+struct UsedStruct
+{
+    float4 f;
+};
+
+struct UnusedStruct
+{
+    float4 f;
+};
+
+cbuffer UsedCB
+{
+    float4 g_Used;
+};
+
+cbuffer UnusedCB
+{
+    float4 g_Unused;
+};
+
+Texture2D g_UnusedTex;
+
+static const float UsedConst   = 2.0;
+static const float UnusedConst = 1.0;
+
+float4 UnusedFunc(float4 x)
+{
+    return x;
+}
+
+float4 Helper(UsedStruct s)
+{
+    return s.f * UsedConst;
+}
+
+float4 main(in float4 Pos : SV_Position) : SV_Target
+{
+    UsedStruct s;
+    s.f = g_Used;
+    return Helper(s);
+}
+)";
+
+TEST(HLSL2GLSLConverterLib_HLSL2GLSLConverter, DCEStats)
+{
+    DeadCodeEliminationStats Stats;
+
+    const auto GLSL = ConvertSource(DCETestShader, nullptr, Stats);
+    ASSERT_FALSE(GLSL.empty());
+
+    EXPECT_EQ(Stats.NumRemovedFunctions, 1u);
+    EXPECT_EQ(Stats.NumRemovedStructs, 1u);
+    EXPECT_EQ(Stats.NumRemovedResources, 2u);
+    EXPECT_EQ(Stats.NumRemovedVariables, 1u);
+
+    const auto Symbols = ParseGLSL(GLSL);
+    for (const auto* Name : {"UsedStruct", "UsedCB", "Helper", "main"})
+        EXPECT_EQ(Symbols.Declarations.count(Name), 1u) << Name;
+    for (const auto* Name : {"UnusedStruct", "UnusedCB", "g_UnusedTex", "UnusedConst", "UnusedFunc"})
+        EXPECT_EQ(Symbols.Identifiers.count(Name), 0u) << Name;
+
+    // Identifiers used by the macros are referenced
+    ShaderMacro Macros[] = {{"EXTRA_COLOR", "UnusedFunc(g_Used)"}, {}};
+
+    const auto GLSLWithMacros = ConvertSource(DCETestShader, Macros, Stats);
+    ASSERT_FALSE(GLSLWithMacros.empty());
+    EXPECT_EQ(Stats.NumRemovedFunctions, 0u);
+    EXPECT_EQ(Stats.NumRemovedStructs, 1u);
+    EXPECT_EQ(Stats.NumRemovedResources, 2u);
+    EXPECT_EQ(Stats.NumRemovedVariables, 1u);
+    EXPECT_EQ(ParseGLSL(GLSLWithMacros).Declarations.count("UnusedFunc"), 1u);
+}
+
+TEST(HLSL2GLSLConverterLib_HLSL2GLSLConverter, DCEKeepsReferencedSymbols)
+{
+    auto pFactory = CreateShaderSourceFactory();
+    ASSERT_TRUE(pFactory);
+
+    struct TestShaderInfo
+    {
+        const Char* FileName;
+        const Char* EntryPoint;
+        SHADER_TYPE ShaderType;
+    };
+    // clang-format off
+    const TestShaderInfo Shaders[] =
+    {
+        {"VS_PS.hlsl",        "TestVS", SHADER_TYPE_VERTEX },
+        {"VS_PS.hlsl",        "TestPS", SHADER_TYPE_PIXEL  },
+        {"CS_RWTex1D.hlsl",   "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWTex2D_1.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWTex2D_2.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWBuff.hlsl",    "TestCS", SHADER_TYPE_COMPUTE}
+    };
+    // clang-format on
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+    for (const auto& Shader : Shaders)
+    {
+        ConversionAttribs Attribs;
+        Attribs.pSourceStreamFactory = pFactory;
+        Attribs.InputFileName        = Shader.FileName;
+        Attribs.EntryPoint           = Shader.EntryPoint;
+        Attribs.ShaderType           = Shader.ShaderType;
+        Attribs.IncludeDefinitions   = true;
+
+        Attribs.EliminateDeadCode = false;
+        const auto FullGLSL       = Converter.Convert(Attribs);
+        ASSERT_FALSE(FullGLSL.empty()) << Shader.FileName << ' ' << Shader.EntryPoint;
+
+        DeadCodeEliminationStats Stats;
+        Attribs.EliminateDeadCode = true;
+        Attribs.pDCEStats         = &Stats;
+        const auto GLSL           = Converter.Convert(Attribs);
+        ASSERT_FALSE(GLSL.empty()) << Shader.FileName << ' ' << Shader.EntryPoint;
+
+        // Most of GLSL definitions are not used by any shader
+        EXPECT_GT(Stats.NumRemovedFunctions, 0u) << Shader.FileName << ' ' << Shader.EntryPoint;
+        EXPECT_LT(GLSL.length(), FullGLSL.length()) << Shader.FileName << ' ' << Shader.EntryPoint;
+
+        const auto FullSymbols = ParseGLSL(FullGLSL);
+        const auto Symbols     = ParseGLSL(GLSL);
+        EXPECT_LT(Symbols.Declarations.size(), FullSymbols.Declarations.size()) << Shader.FileName << ' ' << Shader.EntryPoint;
+
+        // Every symbol that the remaining code or the macros it uses reference must still be declared
+        for (const auto& Name : FullSymbols.Declarations)
+        {
+            if (Symbols.Identifiers.count(Name) != 0)
+            {
+                EXPECT_EQ(Symbols.Declarations.count(Name), 1u)
+                    << "'" << Name << "' is referenced, but its declaration was removed from " << Shader.FileName << ' ' << Shader.EntryPoint;
+            }
+        }
+        // The entry point is renamed to main()
+        EXPECT_EQ(Symbols.Declarations.count("main"), 1u) << Shader.FileName << ' ' << Shader.EntryPoint;
+    }
+}
+
+void CheckStats(const DeadCodeEliminationStats& Stats, const DeadCodeEliminationStats& RefStats)
+{
+    EXPECT_EQ(Stats.NumRemovedFunctions, RefStats.NumRemovedFunctions);
+    EXPECT_EQ(Stats.NumRemovedStructs, RefStats.NumRemovedStructs);
+    EXPECT_EQ(Stats.NumRemovedResources, RefStats.NumRemovedResources);
+    EXPECT_EQ(Stats.NumRemovedVariables, RefStats.NumRemovedVariables);
+}
+
+TEST(HLSL2GLSLConverterLib_HLSL2GLSLConverter, ConcurrentConversion)
+{
+    auto pFactory = CreateShaderSourceFactory();
+    ASSERT_TRUE(pFactory);
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+
+    ConversionAttribs Attribs;
+    Attribs.pSourceStreamFactory = pFactory;
+    Attribs.InputFileName        = "VS_PS.hlsl";
+    Attribs.IncludeDefinitions   = true;
+
+    const Char*       EntryPoints[] = {"TestVS", "TestPS"};
+    const SHADER_TYPE ShaderTypes[] = {SHADER_TYPE_VERTEX, SHADER_TYPE_PIXEL};
+
+    // Reference output of serial conversion without a stream
+    String                   RefGLSL[2];
+    DeadCodeEliminationStats RefStats[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto SerialAttribs       = Attribs;
+        SerialAttribs.EntryPoint = EntryPoints[i];
+        SerialAttribs.ShaderType = ShaderTypes[i];
+        SerialAttribs.pDCEStats  = &RefStats[i];
+        RefGLSL[i]               = Converter.Convert(SerialAttribs);
+        ASSERT_FALSE(RefGLSL[i].empty()) << EntryPoints[i];
+    }
+
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    Converter.CreateStream(Attribs.InputFileName, pFactory, nullptr, 0, &pStream);
+    ASSERT_TRUE(pStream);
+    IHLSL2GLSLConversionStream* pRawStream = pStream;
+
+    constexpr Uint32 NumThreads     = 4;
+    constexpr Uint32 NumEntryPoints = 16;
+
+    // Batch conversion with a temporary stream and with the reusable stream
+    for (bool UseStream : {false, true})
+    {
+        auto BatchAttribs               = Attribs;
+        BatchAttribs.ppConversionStream = UseStream ? &pRawStream : nullptr;
+
+        std::vector<HLSL2GLSLConverterImpl::BatchEntryPoint> Entries(NumEntryPoints);
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+        {
+            Entries[i].EntryPoint = EntryPoints[i % 2];
+            Entries[i].ShaderType = ShaderTypes[i % 2];
+        }
+        EXPECT_EQ(Converter.ConvertBatch(BatchAttribs, Entries.data(), NumEntryPoints, NumThreads), NumEntryPoints);
+        EXPECT_EQ(pRawStream, pStream.RawPtr());
+
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+        {
+            EXPECT_EQ(Entries[i].GLSLSource, RefGLSL[i % 2]) << "Entry " << i;
+            CheckStats(Entries[i].DCEStats, RefStats[i % 2]);
+        }
+    }
+
+    // Concurrent Convert() calls on the same reusable stream
+    constexpr Uint32 NumIterations = 4;
+
+    std::vector<String>                   Results(NumThreads * NumIterations);
+    std::vector<DeadCodeEliminationStats> Stats(NumThreads * NumIterations);
+
+    std::vector<std::thread> Workers;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Workers.emplace_back(
+            [&](Uint32 Thread) {
+                for (Uint32 i = 0; i < NumIterations; ++i)
+                {
+                    const auto Idx = Thread * NumIterations + i;
+
+                    auto ThreadAttribs               = Attribs;
+                    ThreadAttribs.ppConversionStream = &pRawStream;
+                    ThreadAttribs.EntryPoint         = EntryPoints[Idx % 2];
+                    ThreadAttribs.ShaderType         = ShaderTypes[Idx % 2];
+                    ThreadAttribs.pDCEStats          = &Stats[Idx];
+                    Results[Idx]                     = Converter.Convert(ThreadAttribs);
+                }
+            },
+            t);
+    }
+    for (auto& Worker : Workers)
+        Worker.join();
+
+    EXPECT_EQ(pRawStream, pStream.RawPtr());
+    for (Uint32 Idx = 0; Idx < NumThreads * NumIterations; ++Idx)
+    {
+        EXPECT_EQ(Results[Idx], RefGLSL[Idx % 2]) << "Conversion " << Idx;
+        CheckStats(Stats[Idx], RefStats[Idx % 2]);
+    }
+}
+
+TEST(HLSL2GLSLConverterLib_HLSL2GLSLConverter, ConcurrentStreamCreation)
+{
+    auto pFactory = CreateShaderSourceFactory();
+    ASSERT_TRUE(pFactory);
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+
+    ConversionAttribs Attribs;
+    Attribs.pSourceStreamFactory = pFactory;
+    Attribs.InputFileName        = "VS_PS.hlsl";
+    Attribs.IncludeDefinitions   = true;
+    Attribs.EntryPoint           = "TestPS";
+    Attribs.ShaderType           = SHADER_TYPE_PIXEL;
+
+    const auto RefGLSL = Converter.Convert(Attribs);
+    ASSERT_FALSE(RefGLSL.empty());
+
+    constexpr Uint32 NumThreads = 4;
+
+    // Threads either create the stream or replace the stream that was created for another file
+    for (bool ReplaceStream : {false, true})
+    {
+        IHLSL2GLSLConversionStream* pStream = nullptr;
+        if (ReplaceStream)
+        {
+            static constexpr char OtherSource[] = "void main(){}";
+            Converter.CreateStream("Other.hlsl", pFactory, OtherSource, sizeof(OtherSource) - 1, &pStream);
+            ASSERT_NE(pStream, nullptr);
+        }
+
+        std::vector<String>      Results(NumThreads);
+        std::vector<std::thread> Workers;
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Workers.emplace_back(
+                [&](Uint32 Thread) {
+                    auto ThreadAttribs               = Attribs;
+                    ThreadAttribs.ppConversionStream = &pStream;
+                    Results[Thread]                  = Converter.Convert(ThreadAttribs);
+                },
+                t);
+        }
+        for (auto& Worker : Workers)
+            Worker.join();
+
+        for (Uint32 t = 0; t < NumThreads; ++t)
+            EXPECT_EQ(Results[t], RefGLSL) << "Thread " << t;
+
+        ASSERT_NE(pStream, nullptr);
+        // The stream is owned by the pointer only, all references taken by the threads have been released
+        pStream->AddRef();
+        EXPECT_EQ(pStream->Release(), 1);
+        pStream->Release();
+    }
+}
+
+} // namespace
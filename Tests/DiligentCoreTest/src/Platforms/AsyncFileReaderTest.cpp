@@ -0,0 +1,179 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+class Platforms_AsyncFileReader : public ::testing::Test
+{
+protected:
+    static constexpr const char* FileName = "AsyncFileReaderTest.tmp";
+
+    static void SetUpTestSuite()
+    {
+        Data.resize(1 << 20);
+        for (size_t i = 0; i < Data.size(); ++i)
+            Data[i] = static_cast<Uint8>((i * 131u + (i >> 8)) & 0xFFu);
+
+        FileWrapper File{FileName, EFileAccessMode::Overwrite};
+        ASSERT_NE(static_cast<CFile*>(File), nullptr);
+        EXPECT_TRUE(File->Write(Data.data(), Data.size()));
+    }
+
+    static void TearDownTestSuite()
+    {
+        std::remove(FileName);
+        Data.clear();
+    }
+
+    static void TestReader(BasicAsyncFileReader& Reader)
+    {
+        auto pFile = Reader.OpenFile(FileName);
+        ASSERT_TRUE(pFile);
+        EXPECT_EQ(pFile->GetSize(), Data.size());
+
+        EXPECT_FALSE(Reader.OpenFile("AsyncFileReaderTest_Missing.tmp"));
+
+        // Both slash symbols are accepted by all backends
+        {
+            auto pFile2 = Reader.OpenFile((std::string{".\\"} + FileName).c_str());
+            ASSERT_TRUE(pFile2);
+            EXPECT_EQ(pFile2->GetSize(), Data.size());
+            pFile2 = Reader.OpenFile((std::string{"./"} + FileName).c_str());
+            ASSERT_TRUE(pFile2);
+            EXPECT_EQ(pFile2->GetSize(), Data.size());
+        }
+
+        constexpr Uint32 NumBatches    = 8;
+        constexpr Uint32 ReadsPerBatch = 32;
+        constexpr size_t ChunkSize     = 4096 + 17;
+
+        std::vector<std::vector<Uint8>> Buffers(NumBatches * ReadsPerBatch);
+        std::vector<AsyncReadRequest>   Requests(Buffers.size());
+        for (size_t i = 0; i < Requests.size(); ++i)
+        {
+            Buffers[i].resize(ChunkSize);
+            Requests[i].pFile   = pFile.get();
+            Requests[i].Offset  = (i * 7919 * ChunkSize) % (Data.size() - ChunkSize);
+            Requests[i].pBuffer = Buffers[i].data();
+            Requests[i].Size    = ChunkSize;
+        }
+
+        std::atomic<Uint32> NumCompletedBatches{0};
+        std::atomic<Uint32> NumFailedReads{0};
+        for (Uint32 b = 0; b < NumBatches; ++b)
+        {
+            Reader.SubmitReads(&Requests[b * ReadsPerBatch], ReadsPerBatch,
+                               [&](const AsyncReadResult* pResults, Uint32 NumResults) {
+                                   EXPECT_EQ(NumResults, ReadsPerBatch);
+                                   for (Uint32 i = 0; i < NumResults; ++i)
+                                   {
+                                       if (!pResults[i].Succeeded || pResults[i].BytesRead != ChunkSize)
+                                           ++NumFailedReads;
+                                   }
+                                   ++NumCompletedBatches;
+                               });
+        }
+        Reader.WaitIdle();
+        EXPECT_EQ(NumCompletedBatches, NumBatches);
+        EXPECT_EQ(NumFailedReads, Uint32{0});
+
+        for (size_t i = 0; i < Requests.size(); ++i)
+        {
+            EXPECT_EQ(memcmp(Buffers[i].data(), &Data[static_cast<size_t>(Requests[i].Offset)], ChunkSize), 0) << "Read " << i;
+        }
+
+        // Read that crosses the end of the file
+        {
+            std::vector<Uint8> Buffer(1024);
+            AsyncReadRequest   Request;
+            Request.pFile   = pFile.get();
+            Request.Offset  = Data.size() - 100;
+            Request.pBuffer = Buffer.data();
+            Request.Size    = Buffer.size();
+
+            AsyncReadResult Result;
+            Reader.SubmitReads(&Request, 1,
+                               [&](const AsyncReadResult* pResults, Uint32 NumResults) {
+                                   ASSERT_EQ(NumResults, Uint32{1});
+                                   Result = pResults[0];
+                               });
+            Reader.WaitIdle();
+            EXPECT_TRUE(Result.Succeeded);
+            EXPECT_EQ(Result.BytesRead, size_t{100});
+            EXPECT_EQ(memcmp(Buffer.data(), &Data[Data.size() - 100], 100), 0);
+        }
+
+        // Empty batch
+        bool EmptyBatchCompleted = false;
+        Reader.SubmitReads(nullptr, 0, [&](const AsyncReadResult*, Uint32 NumResults) {
+            EXPECT_EQ(NumResults, Uint32{0});
+            EmptyBatchCompleted = true;
+        });
+        Reader.WaitIdle();
+        EXPECT_TRUE(EmptyBatchCompleted);
+    }
+
+    static std::vector<Uint8> Data;
+};
+
+std::vector<Uint8> Platforms_AsyncFileReader::Data;
+
+TEST_F(Platforms_AsyncFileReader, ThreadPool)
+{
+    AsyncFileReaderCreateInfo CI;
+    CI.NumWorkerThreads = 3;
+
+    auto pReader = BasicFileSystem::CreateAsyncFileReader(CI);
+    ASSERT_TRUE(pReader);
+    TestReader(*pReader);
+}
+
+TEST_F(Platforms_AsyncFileReader, Native)
+{
+    AsyncFileReaderCreateInfo CI;
+    // Small queue depth makes most reads wait for free slots
+    CI.QueueDepth = 4;
+
+    auto pReader = FileSystem::CreateAsyncFileReader(CI);
+    ASSERT_TRUE(pReader);
+    TestReader(*pReader);
+}
+
+} // namespace
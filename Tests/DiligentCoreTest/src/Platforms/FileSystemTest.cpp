@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+#include <cstdio>
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Platforms_FileSystem, GetFileModificationTime)
+{
+    const char* FileName = "FileSystemTest_ModificationTime.tmp";
+    {
+        FileWrapper File{FileName, EFileAccessMode::Overwrite};
+        ASSERT_NE(static_cast<CFile*>(File), nullptr);
+        const char Data[] = "data";
+        EXPECT_TRUE(File->Write(Data, sizeof(Data)));
+    }
+
+    Uint64 Time = 0;
+    Uint64 Size = 0;
+    EXPECT_TRUE(FileSystem::GetFileModificationTime(FileName, Time, Size));
+    EXPECT_GT(Time, Uint64{0});
+    EXPECT_EQ(Size, Uint64{sizeof("data")});
+
+    std::remove(FileName);
+    EXPECT_FALSE(FileSystem::GetFileModificationTime(FileName, Time, Size));
+}
+
+} // namespace
@@ -0,0 +1,294 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "SPIRVShaderResources.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#if !DILIGENT_NO_GLSLANG
+#    include "GLSLangUtils.hpp"
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+#if !DILIGENT_NO_GLSLANG
+
+namespace
+{
+
+// Fragment shader that uses every resource type GLSL can declare in Vulkan
+const char* const GLSLFragmentShader = R"(
+#version 450
+
+layout(std140) uniform UniformBuffer
+{
+    vec4 g_Color;
+};
+
+layout(std430) buffer StorageBuffer
+{
+    vec4 g_Data[];
+};
+
+layout(rgba8) uniform image2D g_RWTex;
+uniform sampler2D             g_CombinedTex[2];
+uniform texture2D             g_SepTex;
+uniform sampler               g_SepSampler;
+
+layout(input_attachment_index = 0) uniform subpassInput g_SubpassInput;
+
+layout(location = 0) out vec4 out_Color;
+
+void main()
+{
+    out_Color = g_Color + g_Data[0] +
+                imageLoad(g_RWTex, ivec2(0, 0)) +
+                texture(g_CombinedTex[0], vec2(0.5, 0.5)) +
+                texture(g_CombinedTex[1], vec2(0.5, 0.5)) +
+                texture(sampler2D(g_SepTex, g_SepSampler), vec2(0.5, 0.5)) +
+                subpassLoad(g_SubpassInput);
+}
+)";
+
+// Vertex shader with HLSL-style combined samplers and stage inputs
+const char* const HLSLVertexShader = R"(
+cbuffer Constants
+{
+    float4x4 g_WorldViewProj;
+};
+
+Texture2D    g_HeightMap;
+SamplerState g_HeightMap_sampler;
+
+float4 main(float3 Pos : ATTRIB0,
+            float2 UV  : ATTRIB1) : SV_Position
+{
+    float Height = g_HeightMap.SampleLevel(g_HeightMap_sampler, UV, 0).r;
+    return mul(float4(Pos.x, Height, Pos.z, 1.0), g_WorldViewProj);
+}
+)";
+
+class ShaderTools_SPIRVShaderResources : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        GLSLangUtils::InitializeGlslang();
+    }
+
+    static void TearDownTestCase()
+    {
+        GLSLangUtils::FinalizeGlslang();
+    }
+};
+
+std::vector<uint32_t> CompileGLSL(SHADER_TYPE ShaderType, const char* Source)
+{
+    auto SPIRV = GLSLangUtils::GLSLtoSPIRV(ShaderType, Source, static_cast<int>(strlen(Source)), nullptr, nullptr, nullptr);
+    return std::vector<uint32_t>{SPIRV.begin(), SPIRV.end()};
+}
+
+std::vector<uint32_t> CompileHLSL(SHADER_TYPE ShaderType, const char* Source)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Source          = Source;
+    ShaderCI.EntryPoint      = "main";
+    ShaderCI.Desc.ShaderType = ShaderType;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+
+    auto SPIRV = GLSLangUtils::HLSLtoSPIRV(ShaderCI, nullptr, nullptr);
+    return std::vector<uint32_t>{SPIRV.begin(), SPIRV.end()};
+}
+
+std::unique_ptr<SPIRVShaderResources> ReflectResources(const std::vector<uint32_t>& SPIRV,
+                                                       const ShaderDesc&            Desc,
+                                                       const char*                  CombinedSamplerSuffix,
+                                                       std::string&                 EntryPoint)
+{
+    const bool LoadShaderStageInputs = Desc.ShaderType == SHADER_TYPE_VERTEX;
+    return std::unique_ptr<SPIRVShaderResources>{
+        new SPIRVShaderResources{DefaultRawMemoryAllocator::GetAllocator(), nullptr, SPIRV, Desc, CombinedSamplerSuffix, LoadShaderStageInputs, EntryPoint}};
+}
+
+std::unique_ptr<SPIRVShaderResources> RestoreResources(const std::vector<Uint8>&    Data,
+                                                       size_t                       DataSize,
+                                                       const std::vector<uint32_t>& SPIRV,
+                                                       const ShaderDesc&            Desc,
+                                                       const char*                  CombinedSamplerSuffix,
+                                                       std::string&                 EntryPoint)
+{
+    return std::unique_ptr<SPIRVShaderResources>{
+        new SPIRVShaderResources{DefaultRawMemoryAllocator::GetAllocator(), Data.data(), DataSize, SPIRV, Desc, CombinedSamplerSuffix, EntryPoint}};
+}
+
+void CompareResources(const SPIRVShaderResources& Ref, const SPIRVShaderResources& Res)
+{
+    EXPECT_EQ(Ref.GetShaderType(), Res.GetShaderType());
+    EXPECT_EQ(Ref.IsHLSLSource(), Res.IsHLSLSource());
+
+    EXPECT_EQ(Ref.GetNumUBs(), Res.GetNumUBs());
+    EXPECT_EQ(Ref.GetNumSBs(), Res.GetNumSBs());
+    EXPECT_EQ(Ref.GetNumImgs(), Res.GetNumImgs());
+    EXPECT_EQ(Ref.GetNumSmpldImgs(), Res.GetNumSmpldImgs());
+    EXPECT_EQ(Ref.GetNumACs(), Res.GetNumACs());
+    EXPECT_EQ(Ref.GetNumSepSmplrs(), Res.GetNumSepSmplrs());
+    EXPECT_EQ(Ref.GetNumSepImgs(), Res.GetNumSepImgs());
+    EXPECT_EQ(Ref.GetNumInptAtts(), Res.GetNumInptAtts());
+    ASSERT_EQ(Ref.GetTotalResources(), Res.GetTotalResources());
+    ASSERT_EQ(Ref.GetNumShaderStageInputs(), Res.GetNumShaderStageInputs());
+
+    for (Uint32 n = 0; n < Ref.GetTotalResources(); ++n)
+    {
+        const auto& RefAttribs = Ref.GetResource(n);
+        const auto& Attribs    = Res.GetResource(n);
+        EXPECT_STREQ(RefAttribs.Name, Attribs.Name);
+        EXPECT_TRUE(RefAttribs.IsCompatibleWith(Attribs)) << RefAttribs.Name;
+        EXPECT_EQ(RefAttribs.BindingDecorationOffset, Attribs.BindingDecorationOffset) << RefAttribs.Name;
+        EXPECT_EQ(RefAttribs.DescriptorSetDecorationOffset, Attribs.DescriptorSetDecorationOffset) << RefAttribs.Name;
+    }
+
+    for (Uint32 n = 0; n < Ref.GetNumShaderStageInputs(); ++n)
+    {
+        const auto& RefInput = Ref.GetShaderStageInputAttribs(n);
+        const auto& Input    = Res.GetShaderStageInputAttribs(n);
+        EXPECT_STREQ(RefInput.Semantic, Input.Semantic);
+        EXPECT_EQ(RefInput.LocationDecorationOffset, Input.LocationDecorationOffset);
+    }
+
+    if (Ref.GetCombinedSamplerSuffix() != nullptr)
+        EXPECT_STREQ(Ref.GetCombinedSamplerSuffix(), Res.GetCombinedSamplerSuffix());
+    else
+        EXPECT_EQ(Res.GetCombinedSamplerSuffix(), nullptr);
+}
+
+void TestRoundTrip(const std::vector<uint32_t>& SPIRV, SHADER_TYPE ShaderType, const char* CombinedSamplerSuffix)
+{
+    ShaderDesc Desc;
+    Desc.Name       = "Reflected shader";
+    Desc.ShaderType = ShaderType;
+
+    std::string EntryPoint;
+    auto        pRefResources = ReflectResources(SPIRV, Desc, CombinedSamplerSuffix, EntryPoint);
+    EXPECT_EQ(EntryPoint, "main");
+
+    std::vector<Uint8> Data;
+    pRefResources->Serialize(SPIRV, EntryPoint, Data);
+
+    // The shader name belongs to the shader object and must not be serialized
+    const std::string RefName{Desc.Name};
+    EXPECT_EQ(std::search(Data.begin(), Data.end(), RefName.begin(), RefName.end()), Data.end());
+
+    ShaderDesc RestoredDesc = Desc;
+    RestoredDesc.Name       = "Restored shader";
+
+    std::string RestoredEntryPoint;
+    auto        pResources = RestoreResources(Data, Data.size(), SPIRV, RestoredDesc, CombinedSamplerSuffix, RestoredEntryPoint);
+    EXPECT_EQ(RestoredEntryPoint, EntryPoint);
+    EXPECT_STREQ(pResources->GetShaderName(), RestoredDesc.Name);
+    CompareResources(*pRefResources, *pResources);
+
+    // Data serialized from the restored resources must be identical
+    std::vector<Uint8> RestoredData;
+    pResources->Serialize(SPIRV, RestoredEntryPoint, RestoredData);
+    EXPECT_EQ(Data, RestoredData);
+}
+
+TEST_F(ShaderTools_SPIRVShaderResources, SerializationRoundTripGLSL)
+{
+    auto SPIRV = CompileGLSL(SHADER_TYPE_PIXEL, GLSLFragmentShader);
+    ASSERT_FALSE(SPIRV.empty());
+    TestRoundTrip(SPIRV, SHADER_TYPE_PIXEL, nullptr);
+}
+
+TEST_F(ShaderTools_SPIRVShaderResources, SerializationRoundTripHLSL)
+{
+    auto SPIRV = CompileHLSL(SHADER_TYPE_VERTEX, HLSLVertexShader);
+    ASSERT_FALSE(SPIRV.empty());
+    TestRoundTrip(SPIRV, SHADER_TYPE_VERTEX, "_sampler");
+}
+
+TEST_F(ShaderTools_SPIRVShaderResources, RejectInvalidSerializedData)
+{
+    auto SPIRV = CompileHLSL(SHADER_TYPE_VERTEX, HLSLVertexShader);
+    ASSERT_FALSE(SPIRV.empty());
+
+    ShaderDesc Desc;
+    Desc.Name       = "Invalid data test";
+    Desc.ShaderType = SHADER_TYPE_VERTEX;
+
+    const char* const Suffix = "_sampler";
+
+    std::string EntryPoint;
+    auto        pRefResources = ReflectResources(SPIRV, Desc, Suffix, EntryPoint);
+
+    std::vector<Uint8> Data;
+    pRefResources->Serialize(SPIRV, EntryPoint, Data);
+
+    auto ExpectRejected = [&](const std::vector<Uint8>& TestData, size_t DataSize, const std::vector<uint32_t>& TestSPIRV, const char* TestSuffix, const char* TestEntryPoint) {
+        std::string TestEntryPointStr{TestEntryPoint};
+        EXPECT_THROW(RestoreResources(TestData, DataSize, TestSPIRV, Desc, TestSuffix, TestEntryPointStr), std::runtime_error);
+    };
+
+    // Truncated data
+    ExpectRejected(Data, 0, SPIRV, Suffix, "");
+    ExpectRejected(Data, 16, SPIRV, Suffix, "");
+    ExpectRejected(Data, Data.size() / 2, SPIRV, Suffix, "");
+    ExpectRejected(Data, Data.size() - 1, SPIRV, Suffix, "");
+
+    // Wrong version
+    {
+        auto BadVersionData = Data;
+        ++BadVersionData[sizeof(Uint32)];
+        ExpectRejected(BadVersionData, BadVersionData.size(), SPIRV, Suffix, "");
+    }
+
+    // Different byte code with the same size
+    {
+        auto OtherSPIRV = SPIRV;
+        OtherSPIRV.back() ^= 1u;
+        ExpectRejected(Data, Data.size(), OtherSPIRV, Suffix, "");
+    }
+
+    // Different combined sampler suffix
+    ExpectRejected(Data, Data.size(), SPIRV, nullptr, "");
+    ExpectRejected(Data, Data.size(), SPIRV, "_smplr", "");
+
+    // Different entry point
+    ExpectRejected(Data, Data.size(), SPIRV, Suffix, "VSMain");
+
+    // The original data is still accepted
+    std::string RestoredEntryPoint;
+    EXPECT_NO_THROW(RestoreResources(Data, Data.size(), SPIRV, Desc, Suffix, RestoredEntryPoint));
+}
+
+} // namespace
+
+#endif
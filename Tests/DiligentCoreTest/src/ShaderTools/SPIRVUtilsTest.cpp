@@ -0,0 +1,269 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "SPIRVUtils.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Opcodes of the instructions used by the test module
+enum SPIRVOpcode : uint32_t
+{
+    OpSource          = 3,
+    OpName            = 5,
+    OpString          = 7,
+    OpLine            = 8,
+    OpExtension       = 10,
+    OpExtInstImport   = 11,
+    OpExtInst         = 12,
+    OpMemoryModel     = 14,
+    OpEntryPoint      = 15,
+    OpExecutionMode   = 16,
+    OpCapability      = 17,
+    OpTypeVoid        = 19,
+    OpTypeFunction    = 33,
+    OpFunction        = 54,
+    OpFunctionEnd     = 56,
+    OpDecorate        = 71,
+    OpLabel           = 248,
+    OpReturn          = 253,
+    OpNoLine          = 317,
+    OpModuleProcessed = 330
+};
+
+class SPIRVModuleBuilder
+{
+public:
+    SPIRVModuleBuilder()
+    {
+        // Magic, version 1.0, generator, bound, schema
+        m_Words = {0x07230203, 0x00010000, 0, 32, 0};
+    }
+
+    SPIRVModuleBuilder& Add(uint32_t Opcode, std::vector<uint32_t> Operands = {}, const char* String = nullptr)
+    {
+        if (String != nullptr)
+        {
+            // Literal strings are null-terminated and padded with zeros to the word boundary
+            const auto Len      = strlen(String);
+            const auto NumWords = Len / 4 + 1;
+            const auto Offset   = Operands.size();
+            Operands.resize(Offset + NumWords, 0);
+            memcpy(&Operands[Offset], String, Len);
+        }
+        m_Words.push_back(static_cast<uint32_t>((Operands.size() + 1) << 16) | Opcode);
+        m_Words.insert(m_Words.end(), Operands.begin(), Operands.end());
+        return *this;
+    }
+
+    const std::vector<uint32_t>& GetWords() const { return m_Words; }
+
+private:
+    std::vector<uint32_t> m_Words;
+};
+
+// Builds a small compute shader module. If DebugInfo is true, the module also contains
+// source, line and non-semantic debug instructions that StripSPIRVNonSemanticInfo() removes.
+std::vector<uint32_t> BuildTestModule(bool DebugInfo)
+{
+    enum ID : uint32_t
+    {
+        GLSLStd450 = 1,
+        DebugInfoSet,
+        File,
+        Void,
+        VoidFunc,
+        DebugSource,
+        Sin,
+        Main,
+        Label
+    };
+
+    SPIRVModuleBuilder Builder;
+    Builder.Add(OpCapability, {1}); // Shader
+    if (DebugInfo)
+        Builder.Add(OpExtension, {}, "SPV_KHR_non_semantic_info");
+    Builder.Add(OpExtInstImport, {GLSLStd450}, "GLSL.std.450");
+    if (DebugInfo)
+        Builder.Add(OpExtInstImport, {DebugInfoSet}, "NonSemantic.Shader.DebugInfo.100");
+    Builder.Add(OpMemoryModel, {0, 1}); // Logical GLSL450
+    Builder.Add(OpEntryPoint, {5, Main}, "main");
+    Builder.Add(OpExecutionMode, {Main, 17, 8, 8, 1}); // LocalSize 8 8 1
+    if (DebugInfo)
+    {
+        Builder.Add(OpString, {File}, "shader.hlsl");
+        Builder.Add(OpSource, {5, 500, File}); // HLSL 500
+        Builder.Add(OpModuleProcessed, {}, "entry-point main");
+    }
+    Builder.Add(OpName, {Main}, "main");
+    Builder.Add(OpDecorate, {Void, 1, 0xFFFFFFFFu}); // SpecId with the largest literal
+    Builder.Add(OpTypeVoid, {Void});
+    Builder.Add(OpTypeFunction, {VoidFunc, Void});
+    if (DebugInfo)
+        Builder.Add(OpExtInst, {Void, DebugSource, DebugInfoSet, 35, File}); // DebugSource
+    Builder.Add(OpFunction, {Void, Main, 0, VoidFunc});
+    Builder.Add(OpLabel, {Label});
+    if (DebugInfo)
+        Builder.Add(OpLine, {File, 10, 1});
+    Builder.Add(OpExtInst, {Void, Sin, GLSLStd450, 13, Void});
+    if (DebugInfo)
+        Builder.Add(OpNoLine);
+    Builder.Add(OpReturn);
+    Builder.Add(OpFunctionEnd);
+    return Builder.GetWords();
+}
+
+std::vector<uint32_t> GetOpcodes(const std::vector<uint32_t>& SPIRV)
+{
+    std::vector<uint32_t> Opcodes;
+    for (size_t Offset = 5; Offset < SPIRV.size();)
+    {
+        const uint32_t WordCount = SPIRV[Offset] >> 16;
+        if (WordCount == 0)
+            break;
+        Opcodes.push_back(SPIRV[Offset] & 0xFFFF);
+        Offset += WordCount;
+    }
+    return Opcodes;
+}
+
+TEST(ShaderTools_SPIRVUtils, StripNonSemanticInfo)
+{
+    const auto SPIRV    = BuildTestModule(true);
+    const auto Stripped = StripSPIRVNonSemanticInfo(SPIRV);
+    EXPECT_EQ(Stripped, BuildTestModule(false));
+
+    const auto Opcodes = GetOpcodes(Stripped);
+    auto       Count   = [&Opcodes](uint32_t Opcode) {
+        return std::count(Opcodes.begin(), Opcodes.end(), Opcode);
+    };
+    EXPECT_EQ(Count(OpLine), 0);
+    EXPECT_EQ(Count(OpNoLine), 0);
+    EXPECT_EQ(Count(OpString), 0);
+    EXPECT_EQ(Count(OpSource), 0);
+    EXPECT_EQ(Count(OpModuleProcessed), 0);
+    EXPECT_EQ(Count(OpExtension), 0);
+    // GLSL.std.450 and its instruction are kept
+    EXPECT_EQ(Count(OpExtInstImport), 1);
+    EXPECT_EQ(Count(OpExtInst), 1);
+    // Names and decorations are required for reflection
+    EXPECT_EQ(Count(OpName), 1);
+    EXPECT_EQ(Count(OpDecorate), 1);
+
+    // Stripping a stripped module does not change it
+    EXPECT_EQ(StripSPIRVNonSemanticInfo(Stripped), Stripped);
+}
+
+TEST(ShaderTools_SPIRVUtils, CompressionRoundTrip)
+{
+    for (bool DebugInfo : {false, true})
+    {
+        const auto SPIRV = BuildTestModule(DebugInfo);
+
+        const auto Compressed = CompressSPIRV(SPIRV);
+        ASSERT_FALSE(Compressed.empty());
+        EXPECT_LT(Compressed.size(), SPIRV.size() * sizeof(uint32_t));
+        EXPECT_TRUE(IsCompressedSPIRV(Compressed.data(), Compressed.size()));
+        EXPECT_FALSE(IsCompressedSPIRV(SPIRV.data(), SPIRV.size() * sizeof(uint32_t)));
+
+        std::vector<uint32_t> Decompressed;
+        EXPECT_TRUE(DecompressSPIRV(Compressed.data(), Compressed.size(), Decompressed));
+        EXPECT_EQ(Decompressed, SPIRV);
+    }
+}
+
+TEST(ShaderTools_SPIRVUtils, RejectInvalidCompressedData)
+{
+    const auto Compressed = CompressSPIRV(BuildTestModule(true));
+    ASSERT_FALSE(Compressed.empty());
+
+    std::vector<uint32_t> SPIRV;
+
+    // Truncated data
+    for (size_t Size = 0; Size < Compressed.size(); ++Size)
+        EXPECT_FALSE(DecompressSPIRV(Compressed.data(), Size, SPIRV)) << "Size: " << Size;
+
+    // Wrong version
+    {
+        auto Data = Compressed;
+        ++Data[sizeof(Uint32)];
+        EXPECT_TRUE(IsCompressedSPIRV(Data.data(), Data.size()));
+        EXPECT_FALSE(DecompressSPIRV(Data.data(), Data.size(), SPIRV));
+    }
+
+    // Trailing bytes
+    {
+        auto Data = Compressed;
+        Data.push_back(0);
+        EXPECT_FALSE(DecompressSPIRV(Data.data(), Data.size(), SPIRV));
+    }
+
+    // Uncompressed byte code
+    {
+        const auto Module = BuildTestModule(true);
+        EXPECT_FALSE(DecompressSPIRV(Module.data(), Module.size() * sizeof(uint32_t), SPIRV));
+    }
+
+    EXPECT_FALSE(DecompressSPIRV(nullptr, 0, SPIRV));
+    EXPECT_TRUE(SPIRV.empty());
+
+    // Not a SPIRV module
+    EXPECT_TRUE(CompressSPIRV({1, 2, 3, 4, 5, 6}).empty());
+}
+
+TEST(ShaderTools_SPIRVUtils, PostProcess)
+{
+    const auto SPIRV = BuildTestModule(true);
+
+    SPIRVPostProcessAttribs Attribs;
+    // ID remapping requires a valid module, which the test module is not
+    Attribs.RemapIds = false;
+
+    const auto Compressed = PostProcessSPIRV(SPIRV, Attribs);
+
+    std::vector<uint32_t> Decompressed;
+    ASSERT_TRUE(DecompressSPIRV(Compressed.data(), Compressed.size(), Decompressed));
+    EXPECT_EQ(Decompressed, BuildTestModule(false));
+
+    Attribs.Compress = false;
+
+    const auto Stripped = PostProcessSPIRV(SPIRV, Attribs);
+    ASSERT_EQ(Stripped.size() % sizeof(uint32_t), size_t{0});
+    std::vector<uint32_t> StrippedSPIRV(Stripped.size() / sizeof(uint32_t));
+    memcpy(StrippedSPIRV.data(), Stripped.data(), Stripped.size());
+    EXPECT_EQ(StrippedSPIRV, BuildTestModule(false));
+}
+
+} // namespace